@@ -2,7 +2,7 @@
 
 #include <SDI12AnalogMux.h>
 
-SDI12AnalogMux::SDI12AnalogMux(SDI12Talon& talon_, uint8_t talonPort_, uint8_t sensorPort_, uint8_t version): talon(talon_)
+SDI12AnalogMux::SDI12AnalogMux(ISDI12Talon& talon_, uint8_t talonPort_, uint8_t sensorPort_, uint8_t version): talon(talon_)
 {
 	//Only update values if they are in range, otherwise stick with default values
 	if(talonPort_ > 0) talonPort = talonPort_ - 1;
@@ -110,7 +110,7 @@ String SDI12AnalogMux::getData(time_t time)
 		int adr = -1;
 
 		// First, get the sensor address (only need to do this once)
-		for(int retry = 0; retry < talon.retryCount; retry++) {
+		for(int retry = 0; retry < RETRY_COUNT; retry++) {
 			if(!isPresent()) continue; //If presence check fails, try again
 			adr = talon.getAddress();
 			if(adr >= 0) break; //Address found successfully
@@ -119,7 +119,7 @@ String SDI12AnalogMux::getData(time_t time)
 		if(adr >= 0) {
 			// Read all 9 temperature channels (M1-M9)
 			for(int channel = 1; channel <= 9; channel++) {
-				for(int retry = 0; retry < talon.retryCount; retry++) {
+				for(int retry = 0; retry < RETRY_COUNT; retry++) {
 					// Send measurement command (aM1! through aM9!)
 					int waitTime = talon.startMeasurmentIndex(channel, adr);
 					if(waitTime < 0) {
@@ -142,7 +142,7 @@ String SDI12AnalogMux::getData(time_t time)
 			}
 		}
 
-		if(readDone == false) throwError(talon.SDI12_READ_FAIL); //Throw error if no channels read successfully
+		if(readDone == false) throwError(SDI12_READ_FAIL); //Throw error if no channels read successfully
 	}
 	else throwError(FIND_FAIL);
 
@@ -4,17 +4,19 @@
 #define SDI12ANALOGMUX_h
 
 #include <Sensor.h>
-#include <SDI12Talon.h>
+#include <ISDI12Talon.h>
 
 class SDI12AnalogMux: public Sensor
 {
 	constexpr static int DEFAULT_PORT = 2; ///<Use port 2 by default
 	constexpr static int DEFAULT_SENSOR_PORT = 0; ///<Use port 0 by default
 	constexpr static int DEFAULT_VERSION = 0x00; ///<Use hardware version unknown by default
+	constexpr static int RETRY_COUNT = 3; ///<Attempts per address read and per channel, as other SDI-12 drivers
+	constexpr static uint32_t SDI12_READ_FAIL = 0xF0140000; ///<Same code SDI12Talon reports, see ERRORCODES.md
 	const String FIRMWARE_VERSION = "1.0.0";
 
 	public:
-		SDI12AnalogMux(SDI12Talon& talon_, uint8_t talonPort_ = DEFAULT_PORT, uint8_t sensorPort_ = DEFAULT_SENSOR_PORT, uint8_t version = DEFAULT_VERSION);
+		SDI12AnalogMux(ISDI12Talon& talon_, uint8_t talonPort_ = DEFAULT_PORT, uint8_t sensorPort_ = DEFAULT_SENSOR_PORT, uint8_t version = DEFAULT_VERSION);
 		String begin(time_t time, bool &criticalFault, bool &fault);
 		String getData(time_t time);
 		String selfDiagnostic(uint8_t diagnosticLevel = 4, time_t time = 0);
@@ -23,7 +25,7 @@ class SDI12AnalogMux: public Sensor
 		bool isPresent();
 
 	private:
-		SDI12Talon& talon;
+		ISDI12Talon& talon; ///<Interface, so concurrent measurement and the tests can stand in for the Talon
 		String appendData(float data, String label, uint8_t precision = 2, bool appendComma = true);
 		bool parseTemperature(String input, float &temperature);
 
@@ -20,6 +20,7 @@ String getErrorString();
 String getDataString();
 String getDiagnosticString(uint8_t level);
 String getMetadataString();
+void getSensorStrings(String& dataString, String* diagnosticString, uint8_t level, String* metadataString);
 String initSensors();
 void quickTalonShutdown();
 bool serialConnected();
@@ -28,6 +29,11 @@ int sleepSensors();
 int wakeSensors();
 int detectTalons(String dummyStr);
 int detectSensors(String dummyStr);
+int findTalons(String dummyStr);
+int findSensors(String dummyStr);
+void beginTalons();
+bool restoreDetection();
+void saveDetection();
 int setNodeID(String nodeID);
 int takeSample(String dummy);
 int commandExe(String command);
@@ -37,10 +43,14 @@ int updateConfiguration(String configJson);
 int getSystemConfiguration(String dummy);
 int getSensorConfiguration(String dummy);
 bool loadConfiguration();
+void applySystemConfiguration();
+bool applyConfiguration(uint16_t changes);
 void updateSensorVectors();
 void initializeSensorSystem();
 
 #define WAIT_GPS false
+#define CONCURRENT_SDI12 true //Measure all SDI-12 sensors at once before each data pass
+#define FRAM_RING false //Queue cloud bound records in RecordRing (upper half of FRAM). Must stay off until KestrelFileHandler is limited to the lower half, it uses the whole part today and would overwrite the ring
 #define USE_CELL  //System attempts to connect to cell
 #include <AuxTalon.h>
 #include <PCAL9535A.h>
@@ -66,6 +76,7 @@ void initializeSensorSystem();
 #include <vector>
 #include <memory>
 
+#ifndef TESTING
 #include "platform/ParticleTimeProvider.h"
 #include "platform/ParticleGpio.h"
 #include "platform/ParticleSystem.h"
@@ -74,7 +85,6 @@ void initializeSensorSystem();
 #include "platform/ParticleSerial.h"
 
 #include "hardware/IOExpanderPCAL9535A.h"
-#include "hardware/SDI12TalonAdapter.h"
 #include "hardware/CurrentSenseAmplifierPAC1934.h"
 #include "hardware/LedPCA9634.h"
 #include "hardware/RtcMCP79412.h"
@@ -83,20 +93,91 @@ void initializeSensorSystem();
 #include "hardware/HumidityTemperatureAdafruit_SHT4X.h"
 #include "hardware/AccelerometerMXC6655.h"
 #include "hardware/AccelerometerBMA456.h"
+#include "hardware/FramMB85RC256V.h"
+#else
+#include "SimulatorPlatform.h" //Mock backed platform objects for the host simulator
+#endif
+#include "hardware/SDI12TalonAdapter.h"
+#include "hardware/ConcurrentSDI12Talon.h"
 
 #include "configuration/ConfigurationManager.h"
 #include "configuration/SensorManager.h"
+#include "configuration/DetectionMap.h"
+
+#include "telemetry/PacketWriter.h"
+#include "telemetry/PacketHeaderCache.h"
+#include "telemetry/PacketCodec.h"
+#include "telemetry/DataDiff.h"
+#include "telemetry/BackhaulBatcher.h"
+#include "telemetry/RecordRing.h"
+#include "telemetry/WriteBehindBuffer.h"
+#include "telemetry/BackhaulWorker.h"
+#include "telemetry/HeapMonitor.h"
+#include "acquisition/PortTransitionPlanner.h"
+#include "acquisition/TalonRestartTracker.h"
+#include "acquisition/TalonPortIndex.h"
+#include "acquisition/TaskScheduler.h"
+#include "acquisition/SensorSchedule.h"
+#include "acquisition/SensorProfiler.h"
+#include "acquisition/EnergyLedger.h"
 
 int getIndexOfPort(int port);
+void updateTalonPortIndex();
+void writePacketLeader(PacketWriter& output, const char* packetType);
+void writeDataLeader(PacketWriter& output);
+void capturePacketHeader();
+void planSensorPass(bool allSensors, bool dataPass);
+int openSensorPort(uint16_t step, bool allowRestart);
+void closeSensorPort(uint16_t step, int talonIndex);
+int enableSensorPort(uint16_t step, bool allowRestart, uint32_t& restartUs);
+void disableSensorPort(uint16_t step, int talonIndex);
+void restartTalon(int talonIndex);
+void measureSDI12Concurrent();
+void writeCycleDiagnostic(PacketWriter& output);
+void writeSystemMetadata(PacketWriter& output);
+void writeRecord(const String& record, uint8_t dataType, uint8_t destination);
+void publishRecord(const String& record, const char* eventName);
+const String& packetSchemaVersion();
+void writeBatch(const char* payload, size_t len, uint8_t dataType, uint8_t destination);
+void dumpRecords();
+void flushRecords();
+void writeSdBlock(const char* block, size_t len, uint8_t dataType);
+bool appendToRing(const char* payload, size_t len, uint8_t dataType);
+void dumpRing();
+void runBackhaulWorker();
+void markHeap(HeapMonitor::Phase phase);
+uint32_t profileMicros();
+#ifndef TESTING
+void readDeviceHeap(HeapMonitor::Sample& sample);
+uint32_t readDeviceMicros();
+#endif
+void profileStage(int sensor, SensorProfiler::Stage stage, uint32_t start);
+void writeSensorProfile(PacketWriter& output);
+void chargeSensors(uint32_t phaseUs);
+void meterPhase(int phase);
+void startSensorMeter();
+void endSensorMeter(int sensor, uint8_t talonPort);
+void writeEnergyDiagnostic(PacketWriter& output);
+void countDropped(const PacketWriter& output);
+void lockSampling();
+void unlockSampling();
+void scheduleTasks();
+void runTask(int task, unsigned long now);
+void runSampleTask(int task, unsigned long now);
+unsigned long secondsUntilNextTask();
 
 const String firmwareVersion = "2.9.11";
-const String schemaVersion = "2.2.9";
+const String schemaVersion = "2.3.0"; //2.3: diff data packets, binary encoded records, Devices in port order
+const String batchSchemaVersion = "2.4.0"; //2.4: as 2.3, a JSON payload may be an array of packets, used while batching is enabled
 
 const unsigned long maxConnectTime = 180000; //Wait up to 180 seconds for systems to connect 
 const unsigned long indicatorTimeout = 60000; //Wait for up to 1 minute with indicator lights on
 const uint64_t balancedDiagnosticPeriod = 3600000; //Report diagnostics once an hour //DEBUG!
+const unsigned long timeSyncPeriod = 3600000; //Sync the clock to the best available source once an hour
+const unsigned long locationPeriod = 21600000; //Force a GPS position update every 6 hours
 int powerSaveMode = 0; //Default to 0, update when configure power save mode is called 
 
+#ifndef TESTING
 ParticleTimeProvider realTimeProvider;
 ParticleGpio realGpio;
 ParticleSystem realSystem;
@@ -116,8 +197,10 @@ GpsSFE_UBLOX_GNSS realGps;
 HumidityTemperatureAdafruit_SHT4X realTempHumidity;
 AccelerometerMXC6655 realAccel;
 AccelerometerBMA456 realBackupAccel;
+FramMB85RC256V realFram;
 IOExpanderPCAL9535A ioAlpha(0x20);
 IOExpanderPCAL9535A ioBeta(0x21);
+#endif
 
 Kestrel logger(realTimeProvider, 
 			   realGpio,
@@ -147,6 +230,15 @@ namespace LogModes {
 	constexpr uint8_t NO_LOCAL = 3; //Same as standard log, but no attempt to log to SD card
 };
 
+namespace Tasks { //TaskScheduler IDs, SAMPLE, DIAGNOSTIC and METADATA share one sensor pass when due together
+	constexpr uint8_t SAMPLE = 0;
+	constexpr uint8_t DIAGNOSTIC = 1;
+	constexpr uint8_t METADATA = 2;
+	constexpr uint8_t BACKHAUL = 3;
+	constexpr uint8_t TIME_SYNC = 4;
+	constexpr uint8_t LOCATION = 5;
+};
+
 PRODUCT_VERSION(41)
 
 //global variables affected by configuration manager
@@ -154,6 +246,7 @@ int backhaulCount;
 unsigned long logPeriod;
 int desiredPowerSaveMode;
 int loggingMode;
+int packetEncoding; //PacketCodec::ENCODING_JSON or ENCODING_BINARY
 
 int systemConfigUid = 0; //Used to track the UID of the configuration file
 int sensorConfigUid = 0; //Used to track the UID of the sensor configuration file
@@ -162,9 +255,10 @@ String globalNodeID = ""; //Store current node ID
 
 ConfigurationManager configManager;
 SensorManager sensorManager(configManager);
-std::vector<Sensor*> sensors;
-std::vector<Talon*> talons;
+const std::vector<Sensor*>& sensors = sensorManager.getDevices(); //Core devices, Talons, then sensors, kept current by sensorManager
+const std::vector<Talon*>& talons = sensorManager.getAllTalons();
 SDI12TalonAdapter* realSdi12 = nullptr;
+ConcurrentSDI12Talon* concurrentSdi12 = nullptr; //Wraps realSdi12, sensors built on ISDI12Talon read through this
 namespace PinsIO { //For Kestrel v1.1
 	constexpr uint16_t VUSB = 5;
 }
@@ -209,6 +303,60 @@ SYSTEM_THREAD(ENABLED); //SYSTEM_THREAD enabled means Network processign runs on
 int detectTalons(String dummyStr = "");
 int detectSensors(String dummyStr = "");
 
+//Static RAM budget for packet handling, about 36 KB of the ~80 KB left to the application:
+//packet 8 KB, streams 12 KB, codec scratch 2 KB, keyframe 4 KB, batches 4 KB, SD blocks 6 KB
+const size_t DIAGNOSTIC_ARENA_SIZE = 8192;
+const size_t METADATA_ARENA_SIZE = 4096;
+char packetArena[8192]; //Shared buffer all packets are built in, each builder copies its result out before returning
+char streamArena[DIAGNOSTIC_ARENA_SIZE + METADATA_ARENA_SIZE]; //Diagnostic and metadata streams built alongside data by getSensorStrings()
+char* const diagnosticArena = streamArena;
+char* const metadataArena = streamArena + DIAGNOSTIC_ARENA_SIZE;
+PacketCodec packetCodec(streamArena, sizeof(streamArena)); //Records are copied out of the streams before they are encoded, so the codec output shares them
+char keyframeArena[4096]; //Device entries of the last data keyframe
+DataDiffEncoder dataDiff(keyframeArena, sizeof(keyframeArena)); //Changed fields only data packets between keyframes
+char batchArena[BackhaulBatcher::MAX_GROUPS * (Kestrel::MAX_MESSAGE_LENGTH + 1)]; //One publish payload and its terminator per group
+BackhaulBatcher backhaulBatcher(batchArena, sizeof(batchArena), writeBatch); //Packs records into publish sized payloads before FRAM
+float lastRecordsPerPublish = 0; //Packets per publish payload over the last backhaul
+unsigned long backhaulAirtime = 0; //Time spent in dumpFRAM() since boot, ms
+unsigned int devicesDropped = 0; //Device entries left out of a full packet arena since the last diagnostic
+unsigned long headerReadsSaved = 0; //RTC and GPS reads the packet header cache avoided since the last diagnostic
+unsigned int headersTruncated = 0; //Header snapshots with a field cut short since the last diagnostic
+RecordRing recordRing(realFram, 16384, 16384); //Upper half of the 32 KB FRAM
+char sdArena[WriteBehindBuffer::MAX_STREAMS * 1536]; //Three SD blocks per DataType
+WriteBehindBuffer sdWriteBehind(sdArena, sizeof(sdArena), writeSdBlock); //SD bound lines written in block sized appends
+float lastRecordsPerSdWrite = 0; //Lines per SD append since the last backhaul
+bool recordRingReady = false;
+BackhaulWorker backhaulWorker; //Connect, time sync and FRAM dump run off the sampling path
+HeapMonitor heapMonitor; //Free heap and largest block at each loop phase, low points reported in the diagnostic
+#ifndef TESTING
+HeapMonitor::Probe heapProbe = readDeviceHeap;
+SensorProfiler::Clock profileClock = readDeviceMicros;
+#else
+HeapMonitor::Probe heapProbe = nullptr; //Installed by the host simulator before setup()
+SensorProfiler::Clock profileClock = nullptr;
+#endif
+#ifndef TESTING
+RecursiveMutex samplingLock; //Held by loop() while sampling and by the backhaul worker while transferring, both use I2C, FRAM and SD. Also guards backhaulWorker state
+Thread* backhaulThread = nullptr;
+#endif
+PacketHeaderCache headerCache; //Time, location and ID shared by all packets in a log event
+PortTransitionPlanner portPlanner; //Orders each sensor pass by port and skips redundant expander writes
+TalonRestartTracker talonRestarts; //Restart each Talon once per cycle unless its state is invalidated
+TalonPortIndex talonPortIndex; //Port to talons vector index, rebuilt whenever a Talon port or the vector changes
+DetectionMap detectionMap; //Talon and sensor ports from the last full detection, restored on boot
+SensorSchedule sensorSchedule; //Per sensor sampling periods, sensors not due are left out of data passes
+std::vector<bool> sensorDue; //Data is read from these sensors this pass, by index in sensors
+SensorProfiler sensorProfiler; //Time of each pass stage per sensor, reported at diagnostic level 6
+uint32_t sensorOpenedAt = 0; //Start of the open sensor's port enable, for its SENSOR_TOTAL
+EnergyLedger energyLedger; //Energy per cycle phase (csaAlpha) and per sensor (csaBeta), reported in the diagnostic
+int meteredPhase = -1; //EnergyLedger::Phase with an open csaAlpha window, -1 for none
+uint32_t phaseMeterStart = 0;
+uint32_t sensorMeterStart = 0;
+uint32_t sensorOnUs[EnergyLedger::MAX_SENSORS]; //Powered time of each sensor in the open phase, its Talon port's energy is split by it
+const uint8_t systemCsaChannel = 0; //csaAlpha channel 1 senses the logger supply
+const uint8_t talonCsaPorts = 4; //csaBeta channel n - 1 senses Kestrel Talon port n
+TaskScheduler scheduler; //Deadlines for sampling, reports, backhaul, time sync and location, the RTC alarm is set for the earliest
+
 String diagnostic = "";
 String errors = "";
 String metadata = "";
@@ -228,15 +376,13 @@ void setup() {
 	Particle.function("getSystemConfig", getSystemConfiguration);
 	Particle.function("getSensorConfig", getSensorConfiguration);
 	Particle.function("nodeID", setNodeID);
-	Particle.function("findSensors", detectSensors);
-	Particle.function("findTalons", detectTalons);
+	Particle.function("findSensors", findSensors);
+	Particle.function("findTalons", findTalons);
 	Particle.function("systemRestart", systemRestart);
 	Particle.function("takeSample", takeSample);
 	Particle.function("commandExe", commandExe);
 	Serial.begin(1000000); 
 	waitFor(serialConnected, 10000); //DEBUG! Wait until serial starts sending or 10 seconds 
-	Serial.print("RESET CAUSE: "); //DEBUG!
-	Serial.println(System.resetReason()); //DEBUG!
 	bool hasCriticalError = false;
 	bool hasError = false;
 	// logger.begin(Time.now(), hasCriticalError, hasError); //Needs to be called the first time with Particle time since I2C not yet initialized 
@@ -251,6 +397,7 @@ void setup() {
 	if(batState) battery.setIndicatorState(GonkIndicatorMode::SOLID); //Turn on charge indication LEDs during setup 
 	else battery.setIndicatorState(GonkIndicatorMode::BLINKING); //If battery not switched on, set to blinking 
 	fileSys.begin(0, hasCriticalError, hasError); //Initialzie, but do not attempt backhaul
+	if(FRAM_RING) recordRingReady = realFram.begin() && recordRing.begin(); //Records left unsent before a reset are picked up again
 	Serial.println("Critial error: " + String(hasCriticalError)); //DEBUG!
 	Serial.println("Error: " + String(hasError)); //DEBUG!
 	if(hasCriticalError) {
@@ -301,8 +448,11 @@ void setup() {
     // Apply power save mode
 	configurePowerSave(desiredPowerSaveMode); //Setup power mode of the system (Talons and Sensors)
 
-	detectTalons();
-	detectSensors();
+	if(!restoreDetection()) { //Confirm ports from the last boot, only probe everything if wiring or config changed
+		detectTalons();
+		detectSensors();
+		saveDetection();
+	}
 
 	// I2C_OnBoardEn(false);	
 	// I2C_GlobalEn(true);
@@ -318,11 +468,11 @@ void setup() {
 	Serial.print("DIAGNOSTIC: ");
 	Serial.println(initDiagnostic);
 	if(loggingMode == LogModes::NO_LOCAL) {
-		fileSys.writeToFRAM(initDiagnostic, DataType::Diagnostic, DestCodes::Particle);
+		writeRecord(initDiagnostic, DataType::Diagnostic, DestCodes::Particle);
 		logEvents(4, DestCodes::Particle); //Grab data log with metadata, no diagnostics 
 	}
 	else {
-		fileSys.writeToFRAM(initDiagnostic, DataType::Diagnostic, DestCodes::Both);
+		writeRecord(initDiagnostic, DataType::Diagnostic, DestCodes::Both);
 		logEvents(4, DestCodes::Both); //Grab data log with metadata, no diagnostics 
 	}
 	// fileSys.writeToParticle(initDiagnostic, "diagnostic"); 
@@ -363,7 +513,16 @@ void setup() {
 
 	// fileSys.writeToFRAM(getDiagnosticString(1), DataType::Diagnostic, DestCodes::Both); //DEBUG!
 	// logEvents(3); //Grab data log with metadata //DEBUG!
-	fileSys.dumpFRAM(); //Backhaul this data right away
+	dumpRecords(); //Backhaul this data right away
+	#ifndef TESTING
+	backhaulThread = new Thread("backhaul", []() {
+		while(true) {
+			runBackhaulWorker();
+			delay(100); //Connect progress only needs checking a few times a second
+		}
+	}, OS_THREAD_PRIORITY_DEFAULT, 8192); //dumpFRAM() builds its payloads on the stack
+	#endif
+	logger.startTimer(secondsUntilNextTask()); //First wake up for the earliest task
 	// Particle.publish("diagnostic", initDiagnostic);
 
 	// logger.enableData(3, true);
@@ -375,7 +534,9 @@ void setup() {
 
 void loop() {
   // aux.sleep(false);
-  static int count = 1; //Keep track of number of cycles
+	lockSampling(); //Wait for a backhaul transfer in progress, the connect wait does not hold this
+	energyLedger.beginCycle();
+	meterPhase(EnergyLedger::WAKE);
 	logger.wake(); //Wake up logger system
 	fileSys.wake(); //Wake up file handling 
 	wakeSensors(); //Wake each sensor
@@ -387,42 +548,19 @@ void loop() {
 		battery.setIndicatorState(GonkIndicatorMode::PUSH_BUTTON); //Turn off indicator lights on battery, return to push button control
 		logger.enableI2C_External(false); //Turn off external I2C
 	}
-	bool alarm = logger.waitUntilTimerDone(); //Wait until the timer period has finished  //REPLACE FOR NON-SLEEP
+	meterPhase(-1); //Waiting for the alarm is left out, as is sleep
+	unlockSampling();
+	bool alarm = logger.waitUntilTimerDone(); //Wait for the RTC alarm set for the earliest task  //REPLACE FOR NON-SLEEP
+	unsigned long early = scheduler.timeUntilNext(millis());
+	if(early <= 2000) delay(early); //RTC alarm has whole second resolution and its own oscillator
 	// if(alarm) Serial.println("RTC Wakeup"); //DEBUG!
 	// else Serial.println("Timeout Wakeup"); //DEBUG!
-	// Serial.print("RAM, Start Log Events: "); //DEBUG!
-	// Serial.println(System.freeMemory()); //DEBUG!
-	logger.startTimer(logPeriod); //Start timer as soon done reading sensors //REPLACE FOR NON-SLEEP
-	switch(loggingMode) {
-		static uint64_t lastDiagnostic = System.millis(); 
-		case (LogModes::PERFORMANCE):
-			logEvents(6, DestCodes::Both);
-			break;
-		case (LogModes::STANDARD):
-			if((count % 16) == 0) logEvents(3, DestCodes::Both);
-			else if((count % 8) == 0) logEvents(2, DestCodes::Both);
-			else if((count % 1) == 0) logEvents(1, DestCodes::Both);
-			break;
-		case (LogModes::BALANCED):
-			logEvents(7, DestCodes::Both);
-			if((System.millis() - lastDiagnostic) > balancedDiagnosticPeriod) {
-				logEvents(3, DestCodes::Both); //Do a full diagnostic and metadata report once an hour
-				lastDiagnostic = System.millis();
-			}
-			break;
-		case (LogModes::NO_LOCAL):
-			if((count % 10) == 0) logEvents(3, DestCodes::Particle);
-			else if((count % 5) == 0) logEvents(2, DestCodes::Particle);
-			else if((count % 1) == 0) logEvents(1, DestCodes::Particle);
-			break;
-		default:
-			logEvents(1, DestCodes::Both); //If unknown configuration, use general call 
-			// break;
-	}
-	
-	
-	// Serial.print("RAM, End Log Events: "); //DEBUG!
-	// Serial.println(System.freeMemory()); //DEBUG!
+	lockSampling();
+	markHeap(HeapMonitor::WAKE); //Under the lock, the backhaul worker marks its own phase
+	int task;
+	while((task = scheduler.takeNext(millis())) >= 0) runTask(task, millis()); //Highest priority first, sampling before backhaul
+	backhaulBatcher.poll(millis()); //Batches held past the flush deadline go to FRAM now
+	sdWriteBehind.poll(millis());
 	Serial.println("Log Done"); //DEBUG!
 	Serial.print("WDT Status: "); //DEBUG!
 	Serial.println(logger.feedWDT()); 
@@ -447,18 +585,19 @@ void loop() {
 	// logger.enableI2C_Global(false);
 	// fileSys.writeToFRAM(diagnostic, "diagnostic", DestCodes::Particle);
 
-	if((count % backhaulCount) == 0) {
-		Serial.println("BACKHAUL"); //DEBUG!
-		if(powerSaveMode >= PowerSaveModes::LOW_POWER) {
-			Particle.connect();
-			waitFor(Particle.connected, 300000); //Wait up to 5 minutes to connect if using low power modes
-		}
-		logger.syncTime();
-		fileSys.dumpFRAM(); //dump FRAM every Nth log
+	#ifdef TESTING
+	while(backhaulWorker.isBusy()) { //No worker thread in the simulator, run the backhaul to completion here
+		runBackhaulWorker();
+		if(backhaulWorker.isBusy()) delay(10);
+	}
+	#endif
+	markHeap(HeapMonitor::SLEEP);
+	logger.startTimer(secondsUntilNextTask()); //Sleep until the earliest deadline, not a fixed period //REPLACE FOR NON-SLEEP
+	if(!backhaulWorker.isBusy()) { //Sleeping would drop the connection the worker is waiting on, stay awake until the next cycle instead
+		fileSys.sleep(); //Wait to sleep until after backhaul attempt
+		logger.sleep(); //Put system into sleep mode
 	}
-	count++;
-	fileSys.sleep(); //Wait to sleep until after backhaul attempt
-	logger.sleep(); //Put system into sleep mode
+	unlockSampling();
 
 	// SystemSleepConfiguration config;
 	// config.mode(SystemSleepMode::STOP)
@@ -481,6 +620,9 @@ void logEvents(uint8_t type, uint8_t destination)
 	data = "";
 	Serial.print("LOG: "); //DEBUG!
 	Serial.println(type); 
+	capturePacketHeader(); //Take one time/location snapshot for every packet built this cycle
+	portPlanner.resetCounters();
+	sensorSchedule.resetCounters();
 	if(type == 0) { //Grab errors only
 		// data = getDataString();
 		// diagnostic = getDiagnosticString(4); //DEBUG! RESTORE
@@ -493,14 +635,13 @@ void logEvents(uint8_t type, uint8_t destination)
 
 		if(errors.equals("") == false) {
 			// Serial.println("Write Errors to FRAM"); //DEBUG!
-			fileSys.writeToFRAM(errors, DataType::Error, destination); //Write value out only if errors are reported 
+			writeRecord(errors, DataType::Error, destination); //Write value out only if errors are reported 
 		}
 		// fileSys.writeToFRAM(data, DataType::Data, DestCodes::Both);
 		// fileSys.writeToFRAM(diagnostic, DataType::Diagnostic, DestCodes::Both);
 	}
 	if(type == 1) {
-		data = getDataString();
-		diagnostic = getDiagnosticString(4); //DEBUG! RESTORE
+		getSensorStrings(data, &diagnostic, 4, nullptr); //Single pass over sensors for data and diagnostic //DEBUG! RESTORE
 		errors = getErrorString(); //Get errors last to wait for error codes to be updated //DEBUG! RESTORE
 		// logger.enableI2C_OB(true);
 		// logger.enableI2C_Global(false);
@@ -510,51 +651,46 @@ void logEvents(uint8_t type, uint8_t destination)
 
 		if(errors.equals("") == false) {
 			// Serial.println("Write Errors to FRAM"); //DEBUG!
-			fileSys.writeToFRAM(errors, DataType::Error, destination); //Write value out only if errors are reported 
+			writeRecord(errors, DataType::Error, destination); //Write value out only if errors are reported 
 		}
-		fileSys.writeToFRAM(data, DataType::Data, destination);
-		fileSys.writeToFRAM(diagnostic, DataType::Diagnostic, destination);
+		writeRecord(data, DataType::Data, destination);
+		writeRecord(diagnostic, DataType::Diagnostic, destination);
 	}
 	else if(type == 2) {
-		data = getDataString();
-		diagnostic = getDiagnosticString(3);
+		getSensorStrings(data, &diagnostic, 3, nullptr);
 		errors = getErrorString();
 		// logger.enableI2C_OB(true);
 		// logger.enableI2C_Global(false);
-		if(errors.equals("") == false) fileSys.writeToFRAM(errors, DataType::Error, destination); //Write value out only if errors are reported 
-		fileSys.writeToFRAM(data, DataType::Data, destination);
-		fileSys.writeToFRAM(diagnostic, DataType::Diagnostic, destination);
+		if(errors.equals("") == false) writeRecord(errors, DataType::Error, destination); //Write value out only if errors are reported 
+		writeRecord(data, DataType::Data, destination);
+		writeRecord(diagnostic, DataType::Diagnostic, destination);
 	}
 	else if(type == 3) {
-		data = getDataString();
-		diagnostic = getDiagnosticString(2);
-		metadata = getMetadataString();
+		getSensorStrings(data, &diagnostic, 2, &metadata); //Single pass over sensors for all three streams
 		errors = getErrorString();
 		// logger.enableI2C_OB(true);
 		// logger.enableI2C_Global(false);
-		if(errors.equals("") == false) fileSys.writeToFRAM(errors, DataType::Error, destination); //Write value out only if errors are reported 
-		fileSys.writeToFRAM(data, DataType::Data, destination);
-		fileSys.writeToFRAM(diagnostic, DataType::Diagnostic, destination);
-		fileSys.writeToFRAM(metadata, DataType::Metadata, destination);
+		if(errors.equals("") == false) writeRecord(errors, DataType::Error, destination); //Write value out only if errors are reported 
+		writeRecord(data, DataType::Data, destination);
+		writeRecord(diagnostic, DataType::Diagnostic, destination);
+		writeRecord(metadata, DataType::Metadata, destination);
 	}
 	else if(type == 4) { //To be used on startup, don't grab diagnostics since init already got them
-		data = getDataString();
+		getSensorStrings(data, nullptr, 0, &metadata);
 		// diagnostic = getDiagnosticString(2);
-		metadata = getMetadataString();
 		errors = getErrorString();
 		// logger.enableI2C_OB(true);
 		// logger.enableI2C_Global(false);
 		Serial.println(errors); //DEBUG!
 		Serial.println(data); //DEBUG
 		Serial.println(metadata); //DEBUG!
-		if(errors.equals("") == false) fileSys.writeToFRAM(errors, DataType::Error, destination); //Write value out only if errors are reported 
-		fileSys.writeToFRAM(data, DataType::Data, destination);
+		if(errors.equals("") == false) writeRecord(errors, DataType::Error, destination); //Write value out only if errors are reported 
+		writeRecord(data, DataType::Data, destination);
 		// fileSys.writeToFRAM(diagnostic, DataType::Diagnostic, DestCodes::Both);
-		fileSys.writeToFRAM(metadata, DataType::Metadata, destination);
+		writeRecord(metadata, DataType::Metadata, destination);
 	}
 	else if(type == 5) { //To be used on startup, don't grab diagnostics since init already got them
-		data = getDataString();
-		diagnostic = getDiagnosticString(5);
+		getSensorStrings(data, &diagnostic, 5, nullptr);
 		// metadata = getMetadataString();
 		errors = getErrorString();
 		// logger.enableI2C_OB(true);
@@ -562,9 +698,9 @@ void logEvents(uint8_t type, uint8_t destination)
 		Serial.println(errors); //DEBUG!
 		Serial.println(data); //DEBUG
 		// Serial.println(metadata); //DEBUG!
-		if(errors.equals("") == false) fileSys.writeToFRAM(errors, DataType::Error, DestCodes::SD); //Write value out only if errors are reported 
-		fileSys.writeToFRAM(data, DataType::Data, DestCodes::SD);
-		fileSys.writeToFRAM(diagnostic, DataType::Diagnostic, DestCodes::SD);
+		if(errors.equals("") == false) writeRecord(errors, DataType::Error, DestCodes::SD); //Write value out only if errors are reported 
+		writeRecord(data, DataType::Data, DestCodes::SD);
+		writeRecord(diagnostic, DataType::Diagnostic, DestCodes::SD);
 		// fileSys.writeToFRAM(metadata, DataType::Metadata, DestCodes::Both);
 	}
 	else if(type == 6) { //Log ONLY data - fastest method
@@ -578,7 +714,7 @@ void logEvents(uint8_t type, uint8_t destination)
 		// Serial.println(data); //DEBUG
 		// Serial.println(metadata); //DEBUG!
 		// if(errors.equals("") == false) fileSys.writeToFRAM(errors, DataType::Error, DestCodes::SD); //Write value out only if errors are reported 
-		fileSys.writeToFRAM(data, DataType::Data, destination);
+		writeRecord(data, DataType::Data, destination);
 		// fileSys.writeToFRAM(diagnostic, DataType::Diagnostic, DestCodes::SD);
 		// fileSys.writeToFRAM(metadata, DataType::Metadata, DestCodes::Both);
 	}
@@ -592,8 +728,8 @@ void logEvents(uint8_t type, uint8_t destination)
 		// Serial.println(errors); //DEBUG!
 		// Serial.println(data); //DEBUG
 		// Serial.println(metadata); //DEBUG!
-		if(errors.equals("") == false) fileSys.writeToFRAM(errors, DataType::Error, destination); //Write value out only if errors are reported 
-		fileSys.writeToFRAM(data, DataType::Data, destination);
+		if(errors.equals("") == false) writeRecord(errors, DataType::Error, destination); //Write value out only if errors are reported 
+		writeRecord(data, DataType::Data, destination);
 		// fileSys.writeToFRAM(diagnostic, DataType::Diagnostic, DestCodes::SD);
 		// fileSys.writeToFRAM(metadata, DataType::Metadata, DestCodes::Both);
 	}
@@ -646,287 +782,769 @@ void logEvents(uint8_t type, uint8_t destination)
 	// data* = (const char*)NULL;
 	// metadata* = (const char*)NULL;
 	// errors* = (const char*)NULL;
-	
+	headerReadsSaved += headerCache.getReadsSaved();
+	headerCache.invalidate(); //Next cycle (or cloud function) must read fresh values
 }
+void capturePacketHeader()
+{
+	bool isNodeID = (globalNodeID != "");
+	headerCache.capture(logger.getTimeString(), logger.getPosLat(), logger.getPosLong(), logger.getPosAlt(), logger.getPosTimeString(), isNodeID ? globalNodeID : System.deviceID(), isNodeID); //Read RTC and GPS once for all packets in this cycle
+	if(headerCache.isTruncated()) headersTruncated++;
+}
+
+void writePacketLeader(PacketWriter& output, const char* packetType)
+{
+	bool cycleHeader = headerCache.isValid(); //Snapshot is only held for the duration of a log event
+	if(!cycleHeader) capturePacketHeader(); //Called outside of a log event (cloud function etc), read live values
+	output.append("{\"").append(packetType).append("\":{");
+	headerCache.writeTo(output); //Concatonate time, location and node/device ID
+	output.append("\"Packet ID\":").append(logger.getMessageID()).append(','); //Concatonate unique packet hash
+	output.append("\"NumDevices\":").append((unsigned long)sensors.size()).append(','); //Concatonate number of sensors 
+	if(!cycleHeader) headerCache.invalidate();
+}
+
+void writeDataLeader(PacketWriter& output)
+{
+	dataDiff.beginPacket(); //Decide keyframe or diff before the leader is written
+	writePacketLeader(output, "Data");
+	dataDiff.writeLeader(output);
+	output.append("\"Devices\":[");
+	output.endLeader();
+}
+
 String getErrorString()
 {
 	unsigned long numErrors = 0; //Used to keep track of total errors across all devices 
-	String errors = "{\"Error\":{";
-	errors = errors + "\"Time\":" + logger.getTimeString() + ","; //Concatonate time
-	errors = errors + "\"Loc\":[" + logger.getPosLat() + "," + logger.getPosLong() + "," + logger.getPosAlt() + "," + logger.getPosTimeString() + "],";
-	if(globalNodeID != "") errors = errors + "\"Node ID\":\"" + globalNodeID + "\","; //Concatonate node ID
-	else errors = errors + "\"Device ID\":\"" + System.deviceID() + "\","; //If node ID not initialized, use device ID
-	errors = errors + "\"Packet ID\":" + logger.getMessageID() + ","; //Concatonate unique packet hash
-	errors = errors + "\"NumDevices\":" + String(sensors.size()) + ","; //Concatonate number of sensors 
-	errors = errors + "\"Devices\":[";
+	PacketWriter output(packetArena, sizeof(packetArena), Kestrel::MAX_MESSAGE_LENGTH);
+	writePacketLeader(output, "Error");
+	output.append("\"Devices\":[");
+	output.endLeader();
 	for(int i = 0; i < sensors.size(); i++) {
 		if(sensors[i]->totalErrors() > 0) {
 			numErrors = numErrors + sensors[i]->totalErrors(); //Increment the total error count
-			if(!errors.endsWith("[")) errors = errors + ","; //Only append if not first entry
-			errors = errors + "{" + sensors[i]->getErrors() + "}";
+			output.appendDevice(sensors[i]->getErrors());
 		}
 	}
-	errors = errors + "]}}"; //Close data
+	output.close(); //Close data
+	countDropped(output);
 	Serial.print("Num Errors: "); //DEBUG!
 	Serial.println(numErrors); 
-	if(numErrors > 0) return errors;
+	if(numErrors > 0) return output.toString();
 	else return ""; //Return null string if no errors reported 
 }
 
 String getDataString()
 {
-	String leader = "{\"Data\":{";
-	leader = leader + "\"Time\":" + logger.getTimeString() + ","; //Concatonate time
-	leader = leader + "\"Loc\":[" + logger.getPosLat() + "," + logger.getPosLong() + "," + logger.getPosAlt() + "," + logger.getPosTimeString() + "],";
-	if(globalNodeID != "") leader = leader + "\"Node ID\":\"" + globalNodeID + "\","; //Concatonate node ID
-	else leader = leader + "\"Device ID\":\"" + System.deviceID() + "\","; //If node ID not initialized, use device ID
-	leader = leader + "\"Packet ID\":" + logger.getMessageID() + ","; //Concatonate unique packet hash
-	leader = leader + "\"NumDevices\":" + String(sensors.size()) + ","; //Concatonate number of sensors 
-	leader = leader + "\"Devices\":[";
-	const String closer = "]}}";
-	String output = leader;
-
-	uint8_t deviceCount = 0; //Used to keep track of how many devices have been appended 
-	for(int i = 0; i < sensors.size(); i++) {
-		logger.disableDataAll(); //Turn off data to all ports, then just enable those needed
-		if(sensors[i]->sensorInterface != BusType::CORE && sensors[i]->getTalonPort() != 0) {
-			logger.enablePower(sensors[i]->getTalonPort(), true); //Turn on kestrel port for needed Talon, only if not core system and port is valid
-			Serial.println("Enabled power for Talon: " + String(sensors[i]->getTalonPort())); //DEBUG!	
-		} 
-		if(sensors[i]->sensorInterface != BusType::CORE && sensors[i]->getTalonPort() != 0) {
-			logger.enableData(sensors[i]->getTalonPort(), true); //Turn on kestrel port for needed Talon, only if not core system and port is valid
-			Serial.println("Enabled data for Talon: " + String(sensors[i]->getTalonPort())); //DEBUG!
-		}		
-		logger.enableI2C_OB(false);
-		logger.enableI2C_Global(true);
-		bool dummy1;
-		bool dummy2;
-		
-		int currentTalonIndex = getIndexOfPort(sensors[i]->getTalonPort()); //Find the talon associated with this sensor
-		
-		if((sensors[i]->getTalonPort() > 0) && (currentTalonIndex >= 0)) { //DEBUG! REPALCE!
-			Serial.print("TALON CALL: "); //DEBUG!
-			Serial.println(sensors[i]->getTalonPort());
-			logger.configTalonSense(); //Setup to allow for current testing
-			// talons[sensors[i]->getTalonPort() - 1]->begin(logger.getTime(), dummy1, dummy2); //DEBUG! Do only if talon is associated with sensor, and object exists 
-			talons[currentTalonIndex]->restart(); //DEBUG! Do only if talon is associated with sensor, and object exists 
-			// logger.enableI2C_OB(false); //Return to isolation mode
-			// logger.enableI2C_Global(true);
-		}
-		if(sensors[i]->getSensorPort() > 0 && sensors[i]->getTalonPort() > 0) { //If not a Talon
-			Serial.print("Device "); //DEBUG!
-			Serial.print(i);
-			Serial.println(" is a sensor");
-			if(currentTalonIndex >= 0) { //DEBUG! REPALCE!
-				talons[currentTalonIndex]->disableDataAll(); //Turn off all data ports to start for the given Talon
-				// talons[sensors[i]->getTalonPort() - 1]->disablePowerAll(); //Turn off all power ports to start for the given Talon
-				// talons[sensors[i]->getTalonPort() - 1]->enablePower(sensors[i]->getSensorPort(), true); //Turn on power for the given port on the Talon
-				talons[currentTalonIndex]->enableData(sensors[i]->getSensorPort(), true); //Turn on data for the given port on the Talon
-				// bool dummy1;
-				// bool dummy2;
-				// sensors[i]->begin(Time.now(), dummy1, dummy2); //DEBUG!
-			}
-		}
-		// delay(100); //DEBUG!
-		logger.enableI2C_OB(false);
-		logger.enableI2C_Global(true);
+	PacketWriter output(packetArena, sizeof(packetArena), Kestrel::MAX_MESSAGE_LENGTH);
+	writeDataLeader(output);
+
+	planSensorPass(false, true);
+	measureSDI12Concurrent();
+	for(uint16_t step = 0; step < portPlanner.size(); step++) {
+		int i = portPlanner.getSensorIndex(step);
+		int currentTalonIndex = openSensorPort(step, true); //Switch ports and bus only as far as needed to reach this sensor
 		Serial.print("Data string from sensor "); //DEBUG!
 		Serial.print(i);
 		Serial.print(": ");
+		uint32_t stageStart = profileMicros();
 		String val = sensors[i]->getData(logger.getTime());
+		profileStage(i, SensorProfiler::GET_DATA, stageStart);
 		Serial.println(val);
-		if(!val.equals("")) {  //Only append if not empty string
-			if(output.length() - output.lastIndexOf('\n') + val.length() + closer.length() + 1 < Kestrel::MAX_MESSAGE_LENGTH) { //Add +1 to account for comma appending, subtract any previous lines from count
-				if(deviceCount > 0) output = output + ","; //Add preceeding comma if not the first entry
-				output = output + "{" + val + "}"; //Append result 
-				deviceCount++;
-				// if(i + 1 < sensors.size()) diagnostic = diagnostic + ","; //Only append if not last entry
-			}
-			else {
-				output = output + closer + "\n"; //End this packet
-				output = output + leader + "{" + val + "}"; //Start a new packet and add new payload 
-			}
-		}
-		// if(!val.equals("")) { //Only append if real result
-		// 	if(deviceCount > 0) data = data + ","; //Preappend comma only if not first addition
-		// 	data = data + "{" + val + "}";
-		// 	deviceCount++;
-		// 	// if(i + 1 < sensors.size()) metadata = metadata + ","; //Only append if not last entry
-		// }
+		dataDiff.appendDevice(output, i, val.c_str(), val.length()); //Full or changed fields only, splits into a new packet if needed
 		Serial.print("Cumulative data string: "); //DEBUG!
-		Serial.println(output); //DEBUG!
-		// data = data + sensors[i]->getData(logger.getTime()); //DEBUG! REPLACE!
-		// if(i + 1 < sensors.size()) data = data + ","; //Only append if not last entry
-		if((sensors[i]->getSensorPort() > 0) && (sensors[i]->getTalonPort() > 0) && (currentTalonIndex >= 0)) {
-			talons[currentTalonIndex]->enableData(sensors[i]->getSensorPort(), false); //Turn off data for the given port on the Talon
-			// talons[sensors[i]->getTalonPort() - 1]->enablePower(sensors[i]->getSensorPort(), false); //Turn off power for the given port on the Talon //DEBUG!
-		}
+		Serial.println(output.c_str()); //DEBUG!
+		closeSensorPort(step, currentTalonIndex);
 	}
-	output = output + "]}}"; //Close data
-	return output;
+	talonRestarts.releaseAll(); //SDI-12 results read, a fault seen during the pass restarts its Talon on next use
+	output.close(); //Close data
+	countDropped(output);
+	return output.toString();
 }
 
 String getDiagnosticString(uint8_t level)
 {
-	String leader = "{\"Diagnostic\":{";
-	leader = leader + "\"Time\":" + logger.getTimeString() + ","; //Concatonate time
-	leader = leader + "\"Loc\":[" + logger.getPosLat() + "," + logger.getPosLong() + "," + logger.getPosAlt() + "," + logger.getPosTimeString() + "],";
-	if(globalNodeID != "") leader = leader + "\"Node ID\":\"" + globalNodeID + "\","; //Concatonate node ID
-	else leader = leader + "\"Device ID\":\"" + System.deviceID() + "\","; //If node ID not initialized, use device ID
-	leader = leader + "\"Packet ID\":" + logger.getMessageID() + ","; //Concatonate unique packet hash
-	leader = leader + "\"NumDevices\":" + String(sensors.size()) + ",\"Level\":" + String(level) + ",\"Devices\":["; //Concatonate number of sensors and level 
-	const String closer = "]}}";
-	String output = leader;
-
-	uint8_t deviceCount = 0; //Used to keep track of how many devices have been appended 
+	PacketWriter output(packetArena, sizeof(packetArena), Kestrel::MAX_MESSAGE_LENGTH);
+	writePacketLeader(output, "Diagnostic");
+	output.append("\"Level\":").append(level).append(",\"Devices\":["); //Concatonate level 
+	output.endLeader();
+
+	if(level == SensorProfiler::DIAGNOSTIC_LEVEL) writeSensorProfile(output); //Timing collected by earlier passes, no sensor is read
+	else {
+		planSensorPass(true, false);
+		for(uint16_t step = 0; step < portPlanner.size(); step++) {
+			int i = portPlanner.getSensorIndex(step);
+			int currentTalonIndex = openSensorPort(step, false);
+			uint32_t stageStart = profileMicros();
+			output.appendDevice(sensors[i]->selfDiagnostic(level, logger.getTime())); //Splits into a new packet if needed
+			profileStage(i, SensorProfiler::SELF_DIAGNOSTIC, stageStart);
+			closeSensorPort(step, currentTalonIndex);
+		}
+	}
+	writeCycleDiagnostic(output); //Logger cycle statistics go last so they include this pass
+	output.close(); //Close diagnostic
+	countDropped(output);
+	return output.toString();
+}
+
+String getMetadataString()
+{
+	PacketWriter output(packetArena, sizeof(packetArena), Kestrel::MAX_MESSAGE_LENGTH);
+	writePacketLeader(output, "Metadata");
+	output.append("\"Devices\":[");
+	output.endLeader();
+	
+	writeSystemMetadata(output); //System block is streamed in as the first device
+	
+	planSensorPass(true, false);
+	for(uint16_t step = 0; step < portPlanner.size(); step++) {
+		int i = portPlanner.getSensorIndex(step);
+		int currentTalonIndex = openSensorPort(step, false);
+		uint32_t stageStart = profileMicros();
+		output.appendDevice(sensors[i]->getMetadata()); //Splits into a new packet if needed
+		profileStage(i, SensorProfiler::GET_METADATA, stageStart);
+		closeSensorPort(step, currentTalonIndex);
+	}
+
+	output.close(); //Close metadata
+	countDropped(output);
+	return output.toString();
+}
+
+void planSensorPass(bool allSensors, bool dataPass)
+{
+	portPlanner.beginPass();
+	unsigned long now = millis();
+	sensorDue.assign(sensors.size(), false);
 	for(int i = 0; i < sensors.size(); i++) {
+		if(dataPass) sensorDue[i] = sensorSchedule.take(i, now); //Deadline moves only when data is read, a sensor not due counts as skipped
+		if(!allSensors && !sensorDue[i]) continue; //Nothing to collect, leave it powered down this pass
+		portPlanner.addSensor(i, sensors[i]->getTalonPort(), sensors[i]->getSensorPort(), sensors[i]->sensorInterface == BusType::CORE);
+	}
+	portPlanner.plan(); //Group by Talon port and sensor port so consecutive reads share switched ports
+}
+
+int openSensorPort(uint16_t step, bool allowRestart)
+{
+	int sensorIndex = portPlanner.getSensorIndex(step);
+	uint32_t openStart = profileMicros();
+	uint32_t restartUs = 0;
+	startSensorMeter();
+	int currentTalonIndex = enableSensorPort(step, allowRestart, restartUs);
+	if(restartUs > 0) sensorProfiler.record(sensorIndex, SensorProfiler::TALON_RESTART, restartUs); //Recorded here so the SDI-12 pre-pass, which enables ports directly, is never profiled
+	sensorProfiler.record(sensorIndex, SensorProfiler::PORT_ENABLE, profileMicros() - openStart - restartUs);
+	sensorOpenedAt = openStart;
+	return currentTalonIndex;
+}
+
+int enableSensorPort(uint16_t step, bool allowRestart, uint32_t& restartUs)
+{
+	int sensorIndex = portPlanner.getSensorIndex(step);
+	Sensor* sensor = sensors[sensorIndex];
+	bool isCore = (sensor->sensorInterface == BusType::CORE);
+	uint8_t talonPort = sensor->getTalonPort();
+	if(portPlanner.selectKestrelPort(talonPort, isCore)) {
 		logger.disableDataAll(); //Turn off data to all ports, then just enable those needed
-		if(sensors[i]->sensorInterface != BusType::CORE && sensors[i]->getTalonPort() != 0) logger.enablePower(sensors[i]->getTalonPort(), true); //Turn on kestrel port for needed Talon, only if not core system and port is valid
-		if(sensors[i]->sensorInterface != BusType::CORE && sensors[i]->getTalonPort() != 0) logger.enableData(sensors[i]->getTalonPort(), true); //Turn on kestrel port for needed Talon, only if not core system and port is valid
+		if(!isCore && talonPort != 0) {
+			logger.enablePower(talonPort, true); //Turn on kestrel port for needed Talon, only if not core system and port is valid
+			logger.enableData(talonPort, true);
+		}
+	}
+	if(portPlanner.selectBus()) {
 		logger.enableI2C_OB(false);
 		logger.enableI2C_Global(true);
-		// if(!sensors[i]->isTalon()) { //If sensor is not Talon
-		
-		int currentTalonIndex = getIndexOfPort(sensors[i]->getTalonPort()); //Find the talon associated with this sensor
+	}
 
-		if((sensors[i]->getSensorPort() > 0) && (sensors[i]->getTalonPort() > 0) && (currentTalonIndex >= 0)) { //If a Talon is associated with the sensor, turn that port on
-			talons[currentTalonIndex]->disableDataAll(); //Turn off all data on Talon
-			// talons[sensors[i]->getTalonPort() - 1]->enablePower(sensors[i]->getSensorPort(), true); //Turn on power for the given port on the Talon
-			talons[currentTalonIndex]->enableData(sensors[i]->getSensorPort(), true); //Turn back on only port used
-			
+	int currentTalonIndex = getIndexOfPort(talonPort); //Find the talon associated with this sensor
+	if(concurrentSdi12 != nullptr) concurrentSdi12->setActivePort(talonPort, sensor->getSensorPort()); //Match SDI-12 requests to this sensor
+
+	if(allowRestart && (talonPort > 0) && (currentTalonIndex >= 0)) { //DEBUG! REPALCE!
+		if(portPlanner.checkFault(talonPort) && logger.getFault(talonPort)) talonRestarts.invalidate(talonPort); //Fault reported since last restart, Talon state can not be trusted. Read once per Talon per pass
+		if(talonRestarts.needsRestart(talonPort)) { //Only if not already restarted this cycle
+			logger.configTalonSense(); //Setup to allow for current testing
+			uint32_t restartStart = profileMicros();
+			restartTalon(currentTalonIndex);
+			restartUs = profileMicros() - restartStart;
+			portPlanner.invalidateBus(); //Talon sense setup uses the on board bus
+			portPlanner.invalidateTalonPorts(); //Restart turns on all ports it can
 		}
+	}
+	if((sensor->getSensorPort() > 0) && (talonPort > 0) && (currentTalonIndex >= 0)) { //If a Talon is associated with the sensor, turn that port on
+		if(portPlanner.clearTalonPorts()) talons[currentTalonIndex]->disableDataAll(); //Turn off all data on Talon
+		if(portPlanner.selectSensorPort(sensor->getSensorPort())) talons[currentTalonIndex]->enableData(sensor->getSensorPort(), true); //Turn back on only port used
+	}
+	if(portPlanner.selectBus()) {
+		logger.enableI2C_OB(false);
+		logger.enableI2C_Global(true);
+	}
+	return currentTalonIndex;
+}
 
-  		String diagnostic = sensors[i]->selfDiagnostic(level, logger.getTime());
-		if(!diagnostic.equals("")) {  //Only append if not empty string
-			if(output.length() - output.lastIndexOf('\n') + diagnostic.length() + closer.length() + 1 < Kestrel::MAX_MESSAGE_LENGTH) { //Add +1 to account for comma appending, subtract any previous lines from count
-				if(deviceCount > 0) output = output + ","; //Add preceeding comma if not the first entry
-				output = output + "{" + diagnostic + "}"; //Append result 
-				deviceCount++;
-				// if(i + 1 < sensors.size()) diagnostic = diagnostic + ","; //Only append if not last entry
-			}
-			else {
-				output = output + closer + "\n"; //End this packet
-				output = output + leader + "{" + diagnostic + "}"; //Start a new packet and add new payload 
-			}
+void restartTalon(int talonIndex)
+{
+	unsigned long restartStart = millis();
+	talons[talonIndex]->restart();
+	talonRestarts.recordRestart(talons[talonIndex]->getTalonPort(), millis() - restartStart); //Time is used to report what skipped restarts save
+}
+
+void writeCycleDiagnostic(PacketWriter& output)
+{
+	char entry[640];
+	PacketWriter block(entry, sizeof(entry), sizeof(entry)); //Built separately so it can split onto a new packet like any device
+	block.append("\"FlightControl\":{");
+	block.append("\"TalonRestarts\":").append((unsigned int)talonRestarts.getRestarts()).append(',');
+	block.append("\"RestartsSkipped\":").append((unsigned int)talonRestarts.getRestartsSkipped()).append(',');
+	block.append("\"RestartSaved\":").append((unsigned long)talonRestarts.getTimeSavedMs()).append(',');
+	block.append("\"PortWritesSkipped\":").append((unsigned int)portPlanner.getWritesSkipped()).append(',');
+	block.append("\"SensorsSkipped\":").append((unsigned int)sensorSchedule.getSkipped()).append(',');
+	block.append("\"SDI12WaitSaved\":").append((unsigned long)(concurrentSdi12 != nullptr ? concurrentSdi12->getWaitSavedMs() : 0)).append(',');
+	block.append("\"RecordsPerPublish\":").append(String(lastRecordsPerPublish, 2)).append(',');
+	block.append("\"Airtime\":").append(backhaulAirtime).append(',');
+	block.append("\"RecordsPerSDWrite\":").append(String(lastRecordsPerSdWrite, 2)).append(',');
+	block.append("\"ConnectTime\":").append(backhaulWorker.getLastConnectMs()).append(',');
+	block.append("\"ConnectTimeouts\":").append((unsigned int)backhaulWorker.getTimeouts()).append(',');
+	block.append("\"SampleLate\":").append(scheduler.getMaxLateMs(Tasks::SAMPLE)).append(',');
+	block.append("\"SamplesMissed\":").append(scheduler.getMissed(Tasks::SAMPLE)).append(',');
+	block.append("\"DevicesDropped\":").append(devicesDropped).append(',');
+	block.append("\"HeaderReadsSaved\":").append(headerReadsSaved).append(',');
+	block.append("\"HeadersTruncated\":").append(headersTruncated);
+	devicesDropped = 0;
+	headerReadsSaved = 0;
+	headersTruncated = 0;
+	if(FRAM_RING) {
+		block.append(",\"RingRecords\":").append((unsigned int)recordRing.getCount());
+		block.append(",\"RingUtil\":").append((unsigned int)recordRing.getUtilisation());
+	}
+	if(heapMonitor.hasSamples()) {
+		block.append(",\"HeapMin\":").append((unsigned long)heapMonitor.getMinFree());
+		block.append(",\"HeapMinAt\":\"").append(HeapMonitor::phaseName(heapMonitor.getMinFreePhase())).append('"');
+		block.append(",\"HeapBlock\":").append((unsigned long)heapMonitor.getMinLargestBlock());
+		block.append(",\"HeapTrend\":").append(heapMonitor.getTrend());
+		if(heapMonitor.getMaxAllocations() > 0) block.append(",\"HeapAllocs\":").append((unsigned long)heapMonitor.getMaxAllocations()); //Only counted in the simulator
+		heapMonitor.resetWindow();
+	}
+	block.append('}');
+	output.appendDevice(block.c_str(), block.length());
+	writeEnergyDiagnostic(output);
+}
+
+void countDropped(const PacketWriter& output)
+{
+	devicesDropped += output.droppedCount(); //Reported by the next diagnostic so a full arena does not lose devices silently
+}
+
+void writeEnergyDiagnostic(PacketWriter& output)
+{
+	if(energyLedger.getCycles() == 0) return; //No cycle ended since the last report
+	char entry[384];
+	PacketWriter block(entry, sizeof(entry), sizeof(entry));
+	block.append("\"Energy\":{");
+	block.append("\"Cycles\":").append((unsigned int)energyLedger.getCycles());
+	for(int phase = 0; phase < EnergyLedger::NUM_PHASES; phase++) { //Mean per cycle, microjoules
+		block.append(",\"").append(EnergyLedger::phaseName((EnergyLedger::Phase)phase)).append("\":").append((unsigned long)energyLedger.getPhaseMeanUj((EnergyLedger::Phase)phase));
+	}
+	block.append(",\"Sensors\":[");
+	int count = sensors.size();
+	if(count > EnergyLedger::MAX_SENSORS) count = EnergyLedger::MAX_SENSORS;
+	for(int i = 0; i < count; i++) {
+		if(i > 0) block.append(',');
+		block.append((unsigned long)energyLedger.getSensorMeanUj(i)); //By device index, 0 for devices not on a Talon port
+	}
+	block.append(']');
+	block.append(",\"Power\":").append(String(energyLedger.estimatePowerMw(scheduler.getPeriod(Tasks::SAMPLE)), 2)); //Awake energy over the log period, mW
+	block.append('}');
+	output.appendDevice(block.c_str(), block.length());
+	energyLedger.resetWindow();
+}
+
+void writeSystemMetadata(PacketWriter& output)
+{
+	output.beginDevice();
+	output.append("\"System\":{");
+	output.append("\"Schema\":\"").append(packetSchemaVersion()).append("\",");
+	output.append("\"Firm\":\"").append(firmwareVersion).append("\",");
+	output.append("\"OS\":\"").append(System.version()).append("\",");
+	output.append("\"ID\":\"").append(System.deviceID()).append("\",");
+	output.append("\"Update\":").append(logPeriod).append(',');
+	output.append("\"Backhaul\":").append(backhaulCount).append(',');
+	output.append("\"LogMode\":").append(loggingMode).append(',');
+	output.append("\"Sleep\":").append(powerSaveMode).append(',');
+	output.append("\"SysConfigUID\":").append(configManager.updateSystemConfigurationUid()).append(',');
+	output.append("\"SensorConfigUID\":").append(configManager.updateSensorConfigurationUid()).append('}');
+	output.endDevice();
+	//FIX! Add support for device name 
+}
+
+void writeRecord(const String& record, uint8_t dataType, uint8_t destination)
+{
+	if(packetEncoding == PacketCodec::ENCODING_BINARY && packetCodec.encode(record.c_str(), record.length(), packetSchemaVersion().c_str())) {
+		backhaulBatcher.add(packetCodec.c_str(), packetCodec.length(), dataType, destination, millis());
+	}
+	else backhaulBatcher.add(record.c_str(), record.length(), dataType, destination, millis()); //JSON selected, or record could not be encoded
+	if(dataType == DataType::Data) markHeap(HeapMonitor::DATA); //Record String still held, the usual low point of a cycle
+	else if(dataType == DataType::Diagnostic) markHeap(HeapMonitor::DIAGNOSTIC);
+}
+
+void writeBatch(const char* payload, size_t len, uint8_t dataType, uint8_t destination)
+{
+	if(sdWriteBehind.isEnabled() && (destination == DestCodes::SD || destination == DestCodes::Both)) {
+		sdWriteBehind.add(payload, len, dataType, millis()); //SD copy waits for a full block, writeSdBlock() times its own FRAM write
+		if(destination == DestCodes::SD) {
+			markHeap(HeapMonitor::FRAM_WRITE);
+			return;
 		}
+		destination = DestCodes::Particle;
+	}
+	uint32_t writeStart = profileMicros();
+	if(FRAM_RING && recordRingReady && (destination == DestCodes::Particle || destination == DestCodes::Both) && appendToRing(payload, len, dataType)) {
+		if(destination == DestCodes::Both) fileSys.writeToFRAM(String(payload, len), dataType, DestCodes::SD); //SD copy still goes through KestrelFileHandler
+	}
+	else fileSys.writeToFRAM(String(payload, len), dataType, destination); //Ring disabled or full, a packet sent on its own is not null terminated
+	profileStage(SensorProfiler::LOGGER, SensorProfiler::FRAM_WRITE, writeStart);
+	markHeap(HeapMonitor::FRAM_WRITE);
+}
+
+void writeSdBlock(const char* block, size_t len, uint8_t dataType)
+{
+	uint32_t writeStart = profileMicros();
+	fileSys.writeToFRAM(String(block, len), dataType, DestCodes::SD); //One record, so one SD append when FRAM is dumped
+	profileStage(SensorProfiler::LOGGER, SensorProfiler::FRAM_WRITE, writeStart);
+}
+
+bool appendToRing(const char* payload, size_t len, uint8_t dataType)
+{
+	size_t needed = 0; //One ring record per line, so each record is one publish and one acknowledge
+	for(size_t start = 0; start < len;) {
+		const char* end = (const char*)memchr(payload + start, '\n', len - start);
+		size_t lineLength = end == nullptr ? len - start : (size_t)(end - (payload + start));
+		if(lineLength > 0) needed += RecordRing::HEADER_SIZE + lineLength;
+		start += lineLength + 1;
+	}
+	if(needed == 0 || needed > recordRing.getFree()) return false; //All lines or none, so a fallback never duplicates
+	for(size_t start = 0; start < len;) {
+		const char* end = (const char*)memchr(payload + start, '\n', len - start);
+		size_t lineLength = end == nullptr ? len - start : (size_t)(end - (payload + start));
+		if(lineLength > 0) recordRing.append(payload + start, lineLength, dataType, DestCodes::Particle);
+		start += lineLength + 1;
+	}
+	return true;
+}
+
+void dumpRing()
+{
+	if(!FRAM_RING || !recordRingReady) return;
+	RecordRing::Header header;
+	while(Particle.connected() && recordRing.peek(header, packetArena, sizeof(packetArena))) { //No packet is being built during a backhaul
+		const char* eventName = "data/v2"; //Same events as publishRecord()
+		if(header.dataType == DataType::Diagnostic) eventName = "diagnostic/v2";
+		else if(header.dataType == DataType::Error) eventName = "error/v2";
+		else if(header.dataType == DataType::Metadata) eventName = "metadata/v2";
+		if(!Particle.publish(eventName, packetArena, WITH_ACK)) break; //Not confirmed, resume from this record next backhaul
+		recordRing.acknowledge();
+	}
+}
+
+void scheduleTasks()
+{
+	unsigned long now = millis();
+	unsigned long samplePeriod = (logPeriod > 0 ? logPeriod : 300) * 1000UL; //0 meant the logger timer default of 5 minutes
+	unsigned long diagnosticPeriod = 0;
+	unsigned long metadataPeriod = 0;
+	switch(loggingMode) {
+		case (LogModes::STANDARD):
+			diagnosticPeriod = 8 * samplePeriod;
+			metadataPeriod = 16 * samplePeriod;
+			break;
+		case (LogModes::BALANCED):
+			diagnosticPeriod = (unsigned long)balancedDiagnosticPeriod; //Full diagnostic and metadata report
+			break;
+		case (LogModes::NO_LOCAL):
+			diagnosticPeriod = 5 * samplePeriod;
+			metadataPeriod = 10 * samplePeriod;
+			break;
+		default:
+			break;
+	}
+	scheduler.setTask(Tasks::SAMPLE, samplePeriod, 0, now);
+	scheduler.setTask(Tasks::DIAGNOSTIC, diagnosticPeriod, 1, now);
+	scheduler.setTask(Tasks::METADATA, metadataPeriod, 1, now);
+	scheduler.setTask(Tasks::BACKHAUL, backhaulCount * samplePeriod, 2, now);
+	scheduler.setTask(Tasks::TIME_SYNC, timeSyncPeriod, 3, now);
+	scheduler.setTask(Tasks::LOCATION, locationPeriod, 4, now);
+}
+
+void runTask(int task, unsigned long now)
+{
+	switch(task) {
+		case (Tasks::SAMPLE):
+		case (Tasks::DIAGNOSTIC):
+		case (Tasks::METADATA):
+			runSampleTask(task, now);
+			break;
+		case (Tasks::BACKHAUL):
+			Serial.println("BACKHAUL"); //DEBUG!
+			backhaulWorker.request(now, powerSaveMode >= PowerSaveModes::LOW_POWER, 300000); //Connect for up to 5 minutes if using low power modes, then sync time and dump FRAM
+			break;
+		case (Tasks::TIME_SYNC):
+			logger.syncTime();
+			break;
+		case (Tasks::LOCATION):
+			logger.updateLocation(true);
+			break;
+		default:
+			break;
+	}
+}
+
+void runSampleTask(int task, unsigned long now)
+{
+	meterPhase(EnergyLedger::SAMPLE);
+	bool metadataDue = scheduler.take(Tasks::METADATA, now) || task == Tasks::METADATA; //One pass covers every sampling task due now
+	bool diagnosticDue = scheduler.take(Tasks::DIAGNOSTIC, now) || task == Tasks::DIAGNOSTIC;
+	scheduler.take(Tasks::SAMPLE, now);
+	switch(loggingMode) {
+		case (LogModes::PERFORMANCE):
+			logEvents(6, DestCodes::Both);
+			break;
+		case (LogModes::STANDARD):
+			if(metadataDue) logEvents(3, DestCodes::Both);
+			else if(diagnosticDue) logEvents(2, DestCodes::Both);
+			else logEvents(1, DestCodes::Both);
+			break;
+		case (LogModes::BALANCED):
+			if(diagnosticDue) logEvents(3, DestCodes::Both); //Full diagnostic and metadata report includes the data
+			else logEvents(7, DestCodes::Both);
+			break;
+		case (LogModes::NO_LOCAL):
+			if(metadataDue) logEvents(3, DestCodes::Particle);
+			else if(diagnosticDue) logEvents(2, DestCodes::Particle);
+			else logEvents(1, DestCodes::Particle);
+			break;
+		default:
+			logEvents(1, DestCodes::Both); //If unknown configuration, use general call 
+	}
+	meterPhase(-1);
+}
+
+unsigned long secondsUntilNextTask()
+{
+	unsigned long wait = scheduler.timeUntilNext(millis());
+	if(wait == 0) return 1; //Already due, 0 would start the default period
+	return (wait + 999) / 1000;
+}
+
+void runBackhaulWorker()
+{
+	lockSampling(); //Worker state is shared with loop(), which requests and polls it under the same lock
+	BackhaulWorker::Action action = backhaulWorker.step(millis(), Particle.connected());
+	unlockSampling();
+	switch(action) {
+		case BackhaulWorker::CONNECT:
+			Particle.connect(); //Not under the lock, sampling continues while connecting
+			break;
+		case BackhaulWorker::TRANSFER:
+			lockSampling(); //Between samples, not while connecting
+			meterPhase(EnergyLedger::BACKHAUL);
+			logger.syncTime();
+			dumpRecords(); //dump FRAM every Nth log
+			markHeap(HeapMonitor::BACKHAUL);
+			meterPhase(-1);
+			backhaulWorker.transferDone(millis());
+			unlockSampling();
+			break;
+		default:
+			break;
+	}
+}
+
+void markHeap(HeapMonitor::Phase phase)
+{
+	if(heapProbe == nullptr) return;
+	HeapMonitor::Sample sample;
+	heapProbe(sample);
+	heapMonitor.record(phase, sample);
+}
+
+uint32_t profileMicros()
+{
+	return profileClock != nullptr ? profileClock() : 0; //Simulator clock must not move when read, so it is not micros()
+}
+
+#ifndef TESTING
+void readDeviceHeap(HeapMonitor::Sample& sample)
+{
+	runtime_info_t info;
+	memset(&info, 0, sizeof(info));
+	info.size = sizeof(info);
+	HAL_Core_Runtime_Info(&info, NULL);
+	sample.freeBytes = info.freeheap;
+	sample.largestFreeBlock = info.largest_free_block_heap;
+	sample.allocations = 0; //Device OS does not count allocations
+}
 
-		if((sensors[i]->getSensorPort() > 0) && (sensors[i]->getTalonPort() > 0) && (currentTalonIndex >= 0)) {
-			talons[currentTalonIndex]->enableData(sensors[i]->getSensorPort(), false); //Turn off data for the given port on the Talon
-			// talons[sensors[i]->getTalonPort() - 1]->enablePower(sensors[i]->getSensorPort(), false); //Turn off power for the given port on the Talon //DEBUG!
+uint32_t readDeviceMicros()
+{
+	return micros();
+}
+#endif
+
+void profileStage(int sensor, SensorProfiler::Stage stage, uint32_t start)
+{
+	sensorProfiler.record(sensor, stage, profileMicros() - start); //Unsigned difference is correct across micros() rollover
+}
+
+void meterPhase(int phase)
+{
+	uint32_t now = profileMicros();
+	if(meteredPhase >= 0 || phase >= 0) { //One refresh of each CSA per phase boundary, each refresh restarts its accumulators
+		realCsaAlpha.update(1);
+		realCsaBeta.update(1);
+	}
+	if(meteredPhase >= 0) {
+		energyLedger.addPhase((EnergyLedger::Phase)meteredPhase, realCsaAlpha.getPowerAvg(systemCsaChannel), now - phaseMeterStart);
+		chargeSensors(now - phaseMeterStart);
+	}
+	memset(sensorOnUs, 0, sizeof(sensorOnUs)); //Windows outside a metered phase are not charged
+	meteredPhase = phase;
+	phaseMeterStart = now;
+}
+
+void chargeSensors(uint32_t phaseUs)
+{
+	for(uint8_t port = 1; port <= talonCsaPorts; port++) {
+		uint32_t portOnUs = 0;
+		for(size_t i = 0; i < sensors.size() && i < EnergyLedger::MAX_SENSORS; i++) {
+			if(sensors[i]->getTalonPort() == port) portOnUs += sensorOnUs[i];
+		}
+		if(portOnUs == 0) continue;
+		float onPowerMw = realCsaBeta.getPowerAvg(port - 1) * ((float)phaseUs / portOnUs); //Port energy over the phase, spread over the time its sensors were powered
+		for(size_t i = 0; i < sensors.size() && i < EnergyLedger::MAX_SENSORS; i++) {
+			if(sensors[i]->getTalonPort() == port && sensorOnUs[i] > 0) energyLedger.addSensor(i, onPowerMw, sensorOnUs[i]);
 		}
-		
 	}
-	output = output + closer; //Close diagnostic
-	return output;
 }
 
-String getMetadataString()
+void startSensorMeter()
 {
-	String leader = "{\"Metadata\":{";
-	leader = leader + "\"Time\":" + logger.getTimeString() + ","; //Concatonate time
-	leader = leader + "\"Loc\":[" + logger.getPosLat() + "," + logger.getPosLong() + "," + logger.getPosAlt() + "," + logger.getPosTimeString() + "],";
-	if(globalNodeID != "") leader = leader + "\"Node ID\":\"" + globalNodeID + "\","; //Concatonate node ID
-	else leader = leader + "\"Device ID\":\"" + System.deviceID() + "\","; //If node ID not initialized, use device ID
-	leader = leader + "\"Packet ID\":" + logger.getMessageID() + ","; //Concatonate unique packet hash
-	leader = leader + "\"NumDevices\":" + String(sensors.size()) + ","; //Concatonate number of sensors 
-	leader = leader + "\"Devices\":[";
-	const String closer = "]}}";
-	String output = leader;
-	
-	output = output + "{\"System\":{";
-	// output = output + "\"DUMMY\":\"BLOODYMARYBLOODYMARYBLODDYMARY\",";
-	output = output + "\"Schema\":\"" + schemaVersion + "\",";
-	output = output + "\"Firm\":\"" + firmwareVersion + "\",";
-	output = output + "\"OS\":\"" + System.version() + "\",";
-	output = output + "\"ID\":\"" + System.deviceID() + "\",";
-	output = output + "\"Update\":" + String(logPeriod) + ",";
-	output = output + "\"Backhaul\":" + String(backhaulCount) + ",";
-	output = output + "\"LogMode\":" + String(loggingMode) + ",";
-	output = output + "\"Sleep\":" + String(powerSaveMode) + ",";
-	output = output + "\"SysConfigUID\":" + String(configManager.updateSystemConfigurationUid()) + ",";
-	output = output + "\"SensorConfigUID\":" + String(configManager.updateSensorConfigurationUid()) + "}},";
-	//FIX! Add support for device name 
-	
-	uint8_t deviceCount = 0; //Used to keep track of how many devices have been appended 
-	for(int i = 0; i < sensors.size(); i++) {
-		logger.disableDataAll(); //Turn off data to all ports, then just enable those needed
-		if(sensors[i]->sensorInterface != BusType::CORE && sensors[i]->getTalonPort() != 0) logger.enableData(sensors[i]->getTalonPort(), true); //Turn on data to required Talon port only if not core and port is valid
-			// if(!sensors[i]->isTalon()) { //If sensor is not Talon
-		
-		int currentTalonIndex = getIndexOfPort(sensors[i]->getTalonPort()); //Find the talon associated with this sensor
+	sensorMeterStart = profileMicros(); //No refresh, the CSAs are only read at phase boundaries
+}
 
-		if((sensors[i]->getSensorPort() > 0) && (sensors[i]->getTalonPort() > 0) && (currentTalonIndex >= 0)) { //If a Talon is associated with the sensor, turn that port on
-			talons[currentTalonIndex]->disableDataAll(); //Turn off all data on Talon
-			talons[currentTalonIndex]->enableData(sensors[i]->getSensorPort(), true); //Turn back on only port used
+void endSensorMeter(int sensor, uint8_t talonPort)
+{
+	if(talonPort == 0 || talonPort > talonCsaPorts || sensor < 0 || sensor >= EnergyLedger::MAX_SENSORS) return; //Core devices draw from the logger supply, counted in the phase
+	sensorOnUs[sensor] += profileMicros() - sensorMeterStart;
+}
+
+void writeSensorProfile(PacketWriter& output)
+{
+	char entry[384];
+	for(int i = SensorProfiler::LOGGER; i < (int)sensors.size(); i++) {
+		if(!sensorProfiler.hasSamples(i)) continue;
+		PacketWriter block(entry, sizeof(entry), sizeof(entry));
+		block.append("\"Profile\":{");
+		if(i == SensorProfiler::LOGGER) block.append("\"Device\":\"Logger\"");
+		else block.append("\"Device\":").append(i).append(",\"Pos\":[").append((unsigned int)sensors[i]->getTalonPort()).append(',').append((unsigned int)sensors[i]->getSensorPort()).append(']');
+		for(int stage = 0; stage < SensorProfiler::NUM_STAGES; stage++) {
+			const SensorProfiler::Stats& stats = sensorProfiler.get(i, (SensorProfiler::Stage)stage);
+			if(stats.count == 0) continue;
+			block.append(",\"").append(SensorProfiler::stageName((SensorProfiler::Stage)stage)).append("\":[");
+			block.append((unsigned long)stats.minUs).append(',').append((unsigned long)stats.getMeanUs()).append(',').append((unsigned long)stats.maxUs).append(']'); //Microseconds
 		}
-		// logger.enablePower(sensors[i]->getTalon(), true); //Turn on power to port
-		// logger.enableData(sensors[i]->getTalon(), true); //Turn on data to port
-		logger.enableI2C_OB(false);
-		logger.enableI2C_Global(true);
-		String val = sensors[i]->getMetadata();
-		// metadata = metadata + sensors[i]->getMetadata();
-		// if(!val.equals("")) { //Only append if real result
-		// 	if(deviceCount > 0) metadata = metadata + ","; //Preappend comma only if not first addition
-		// 	metadata = metadata + val;
-		// 	deviceCount++;
-		// 	// if(i + 1 < sensors.size()) metadata = metadata + ","; //Only append if not last entry
-		// }
-		if(!val.equals("")) {  //Only append if not empty string
-			if(output.length() - output.lastIndexOf('\n') + val.length() + closer.length() + 1 < Kestrel::MAX_MESSAGE_LENGTH) { //Add +1 to account for comma appending, subtract any previous lines from count
-				if(deviceCount > 0) output = output + ","; //Add preceeding comma if not the first entry
-				output = output + "{" + val + "}"; //Append result 
-				deviceCount++;
-				// if(i + 1 < sensors.size()) diagnostic = diagnostic + ","; //Only append if not last entry
+		block.append('}');
+		output.appendDevice(block.c_str(), block.length());
+	}
+	sensorProfiler.reset(); //Each report covers the passes since the last one
+}
+
+void lockSampling()
+{
+	#ifndef TESTING
+	samplingLock.lock();
+	#endif
+}
+
+void unlockSampling()
+{
+	#ifndef TESTING
+	samplingLock.unlock();
+	#endif
+}
+
+void dumpRecords()
+{
+	backhaulBatcher.flush(); //Nothing held in RAM is left behind by a backhaul
+	sdWriteBehind.flush(); //After the batcher, which may add SD lines
+	unsigned long dumpStart = millis();
+	fileSys.dumpFRAM();
+	dumpRing();
+	backhaulAirtime += millis() - dumpStart;
+	lastRecordsPerPublish = backhaulBatcher.getPacketsPerPayload();
+	backhaulBatcher.resetStats();
+	lastRecordsPerSdWrite = sdWriteBehind.getLinesPerWrite();
+	sdWriteBehind.resetStats();
+}
+
+void flushRecords()
+{
+	lockSampling();
+	backhaulBatcher.flush(); //Batches first, their SD copies go to the write-behind buffer
+	sdWriteBehind.flush();
+	unlockSampling();
+}
+
+const String& packetSchemaVersion()
+{
+	return backhaulBatcher.isEnabled() ? batchSchemaVersion : schemaVersion; //Batched JSON is a top level array, ingestion must know before parsing
+}
+
+void publishRecord(const String& record, const char* eventName)
+{
+	if(packetEncoding == PacketCodec::ENCODING_BINARY && packetCodec.encode(record.c_str(), record.length(), packetSchemaVersion().c_str())) {
+		fileSys.writeToParticle(String(packetCodec.c_str()), eventName);
+	}
+	else fileSys.writeToParticle(record, eventName);
+}
+
+void measureSDI12Concurrent()
+{
+	if(!CONCURRENT_SDI12 || concurrentSdi12 == nullptr) return;
+	concurrentSdi12->endCycle(); //Drop anything not consumed by the last pass
+	uint8_t participants = concurrentSdi12->getParticipantCount();
+	if(participants == 0) return; //Nothing learned yet, sensors measure normally this pass
+	for(uint8_t phase = 0; phase < 2; phase++) { //Start every measurement, then collect every result
+		uint32_t done = 0; //Participants handled this phase, one bit each
+		if(phase == 1) concurrentSdi12->waitForMeasurements(); //Only the longest announced measurement is waited out
+		for(uint16_t step = 0; step < portPlanner.size(); step++) {
+			if(!sensorDue[portPlanner.getSensorIndex(step)]) continue; //In the pass for diagnostics only, no measurement to start
+			Sensor* sensor = sensors[portPlanner.getSensorIndex(step)];
+			bool match = false;
+			for(uint8_t p = 0; p < participants; p++) {
+				if(concurrentSdi12->getParticipantTalonPort(p) == sensor->getTalonPort() && concurrentSdi12->getParticipantSensorPort(p) == sensor->getSensorPort()) match = true;
 			}
-			else {
-				output = output + closer + "\n"; //End this packet
-				output = output + leader + "{" + val + "}"; //Start a new packet and add new payload 
+			if(!match) continue;
+			uint32_t restartUs = 0;
+			int currentTalonIndex = enableSensorPort(step, phase == 0, restartUs); //Ports only, the sensor's own pass records its timing and energy
+			for(uint8_t p = 0; p < participants; p++) {
+				if((done & (1UL << p)) || concurrentSdi12->getParticipantTalonPort(p) != sensor->getTalonPort() || concurrentSdi12->getParticipantSensorPort(p) != sensor->getSensorPort()) continue;
+				if(phase == 0) {
+					concurrentSdi12->startConcurrent(p);
+					talonRestarts.hold(sensor->getTalonPort()); //A restart would abort the measurement, deferred until the pass has read it
+				}
+				else concurrentSdi12->collect(p);
+				done |= (1UL << p);
 			}
+			disableSensorPort(step, currentTalonIndex);
 		}
 	}
+}
+
+void closeSensorPort(uint16_t step, int talonIndex)
+{
+	int sensorIndex = portPlanner.getSensorIndex(step);
+	uint32_t closeStart = profileMicros();
+	disableSensorPort(step, talonIndex);
+	profileStage(sensorIndex, SensorProfiler::PORT_DISABLE, closeStart);
+	endSensorMeter(sensorIndex, sensors[sensorIndex]->getTalonPort());
+	profileStage(sensorIndex, SensorProfiler::SENSOR_TOTAL, sensorOpenedAt);
+}
+
+void disableSensorPort(uint16_t step, int talonIndex)
+{
+	Sensor* sensor = sensors[portPlanner.getSensorIndex(step)];
+	if((sensor->getSensorPort() > 0) && (sensor->getTalonPort() > 0) && (talonIndex >= 0)) {
+		if(portPlanner.releaseSensorPort(step)) talons[talonIndex]->enableData(sensor->getSensorPort(), false); //Turn off data for the given port on the Talon, unless the next sensor uses it
+	}
+}
+
+void getSensorStrings(String& dataString, String* diagnosticString, uint8_t level, String* metadataString)
+{
+	PacketWriter dataOutput(packetArena, sizeof(packetArena), Kestrel::MAX_MESSAGE_LENGTH);
+	PacketWriter diagnosticOutput(diagnosticArena, DIAGNOSTIC_ARENA_SIZE, Kestrel::MAX_MESSAGE_LENGTH);
+	PacketWriter metadataOutput(metadataArena, METADATA_ARENA_SIZE, Kestrel::MAX_MESSAGE_LENGTH);
+	writeDataLeader(dataOutput);
+	if(diagnosticString != nullptr) {
+		writePacketLeader(diagnosticOutput, "Diagnostic");
+		diagnosticOutput.append("\"Level\":").append(level).append(",\"Devices\":["); //Concatonate level 
+		diagnosticOutput.endLeader();
+	}
+	if(metadataString != nullptr) {
+		writePacketLeader(metadataOutput, "Metadata");
+		metadataOutput.append("\"Devices\":[");
+		metadataOutput.endLeader();
+		writeSystemMetadata(metadataOutput);
+	}
 
-	output = output + closer; //Close metadata
-	return output;
+	planSensorPass(diagnosticString != nullptr || metadataString != nullptr, true); //Diagnostic and metadata reports cover every sensor, data only those due
+	measureSDI12Concurrent();
+	for(uint16_t step = 0; step < portPlanner.size(); step++) { //Open each sensor port once and collect every requested stream while it is open
+		int i = portPlanner.getSensorIndex(step);
+		int currentTalonIndex = openSensorPort(step, true);
+		uint32_t stageStart;
+		if(sensorDue[i]) { //Not due sensors are only in the pass for their diagnostic or metadata
+			Serial.print("Data string from sensor "); //DEBUG!
+			Serial.print(i);
+			Serial.print(": ");
+			stageStart = profileMicros();
+			String val = sensors[i]->getData(logger.getTime());
+			profileStage(i, SensorProfiler::GET_DATA, stageStart);
+			Serial.println(val);
+			dataDiff.appendDevice(dataOutput, i, val.c_str(), val.length()); //Full or changed fields only, splits into a new packet if needed
+		}
+		if(diagnosticString != nullptr) {
+			stageStart = profileMicros();
+			diagnosticOutput.appendDevice(sensors[i]->selfDiagnostic(level, logger.getTime()));
+			profileStage(i, SensorProfiler::SELF_DIAGNOSTIC, stageStart);
+		}
+		if(metadataString != nullptr) {
+			stageStart = profileMicros();
+			metadataOutput.appendDevice(sensors[i]->getMetadata());
+			profileStage(i, SensorProfiler::GET_METADATA, stageStart);
+		}
+		closeSensorPort(step, currentTalonIndex);
+	}
+	talonRestarts.releaseAll(); //SDI-12 results read, a fault seen during the pass restarts its Talon on next use
+
+	dataOutput.close(); //Close data
+	countDropped(dataOutput);
+	dataString = dataOutput.toString();
+	if(diagnosticString != nullptr) {
+		writeCycleDiagnostic(diagnosticOutput); //Logger cycle statistics go last so they include this pass
+		diagnosticOutput.close(); //Close diagnostic
+		countDropped(diagnosticOutput);
+		*diagnosticString = diagnosticOutput.toString();
+	}
+	if(metadataString != nullptr) {
+		metadataOutput.close(); //Close metadata
+		countDropped(metadataOutput);
+		*metadataString = metadataOutput.toString();
+	}
 }
 
 String initSensors()
 {
-	String leader = "{\"Diagnostic\":{";
-	leader = leader + "\"Time\":" + logger.getTimeString() + ","; //Concatonate time
-	leader = leader + "\"Loc\":[" + logger.getPosLat() + "," + logger.getPosLong() + "," + logger.getPosAlt() + "," + logger.getPosTimeString() + "],";
-	if(globalNodeID != "") leader = leader + "\"Node ID\":\"" + globalNodeID + "\","; //Concatonate node ID
-	else leader = leader + "\"Device ID\":\"" + System.deviceID() + "\","; //If node ID not initialized, use device ID
-	leader = leader + "\"Packet ID\":" + logger.getMessageID() + ","; //Concatonate unique packet hash
-	leader = leader + "\"NumDevices\":" + String(sensors.size()) + ",\"Devices\":["; //Concatonate number of sensors and level 
+	PacketWriter output(packetArena, sizeof(packetArena), Kestrel::MAX_MESSAGE_LENGTH);
+	writePacketLeader(output, "Diagnostic");
+	output.append("\"Devices\":[");
+	output.endLeader();
 	
-	String closer = "]}}";
-	String output = leader;
 	bool reportCriticalError = false; //Used to keep track of the global status of the error indications for all sensors
 	bool reportError = false;
 	bool missingSensor = false;
-	// output = output + "\"Devices\":[";
-	uint8_t deviceCount = 0; //Used to keep track of how many devices have been appended 
 	for(int i = 0; i < sensors.size(); i++) {
 		logger.disableDataAll(); //Turn off data to all ports, then just enable those needed
 		if(sensors[i]->sensorInterface != BusType::CORE && sensors[i]->getTalonPort() != 0) logger.enableData(sensors[i]->getTalonPort(), true); //Turn on data to required Talon port only if not core and the port is valid
 		logger.enableI2C_OB(false);
 		logger.enableI2C_Global(true);
-		bool dummy1;
-		bool dummy2;
-		// if(!sensors[i]->isTalon()) { //If sensor is not Talon
 		logger.configTalonSense(); //Setup to allow for current testing
-		// if(sensors[i]->getTalonPort() > 0 && talons[sensors[i]->getTalonPort() - 1]) talons[sensors[i]->getTalonPort() - 1]->begin(logger.getTime(), dummy1, dummy2); //DEBUG! Do only if talon is associated with sensor, and object exists //DEBUG! REPLACE!
 		
 		int currentTalonIndex = getIndexOfPort(sensors[i]->getTalonPort());
 
 		if(currentTalonIndex >= 0)
 		{
-			if(sensors[i]->getTalonPort() > 0) { //DEBUG! REPLACE!
-				talons[currentTalonIndex]->restart(); //DEBUG! Do only if talon is associated with sensor, and object exists //DEBUG! REPLACE!
+			if(sensors[i]->getTalonPort() > 0 && talonRestarts.needsRestart(sensors[i]->getTalonPort())) { //DEBUG! REPLACE!
+				restartTalon(currentTalonIndex); //DEBUG! Do only if talon is associated with sensor, and object exists //DEBUG! REPLACE!
 			} 
 			if(sensors[i]->getSensorPort() > 0 && sensors[i]->getTalonPort() > 0) { //If a Talon is associated with the sensor, turn that port on
 				talons[currentTalonIndex]->disableDataAll(); //Turn off all data on Talon
-				// talons[sensors[i]->getTalonPort() - 1]->enablePower(sensors[i]->getSensorPort(), true); //Turn on power for the given port on the Talon
 				talons[currentTalonIndex]->enableData(sensors[i]->getSensorPort(), true); //Turn back on only port used
 			}
 		}
@@ -945,18 +1563,7 @@ String initSensors()
 		else if(sensors[i]->getTalonPort() > 0 && sensors[i]->getSensorPort() == 0 || sensors[i]->sensorInterface == BusType::CORE) val = sensors[i]->selfDiagnostic(2, logger.getTime()); //If sensor is a Talon or CORE type, run diagnostic, begin has already been run
 		if(hasError) reportError = true; //Set if any of them throw an error
 		if(hasCriticalError) reportCriticalError = true; //Set if any of them throw a critical error
-		if(!val.equals("")) {  //Only append if not empty string
-			if(output.length() - output.lastIndexOf('\n') + val.length() + closer.length() + 1 < Kestrel::MAX_MESSAGE_LENGTH) { //Add +1 to account for comma appending, subtract any previous lines from count
-				if(deviceCount > 0) output = output + ","; //Add preceeding comma if not the first entry
-				output = output + "{" + val + "}"; //Append result 
-				deviceCount++;
-				// if(i + 1 < sensors.size()) diagnostic = diagnostic + ","; //Only append if not last entry
-			}
-			else {
-				output = output + closer + "\n"; //End this packet
-				output = output + leader + "{" + val + "}"; //Start a new packet and add new payload 
-			}
-		}
+		output.appendDevice(val); //Splits into a new packet if needed
 		
 	}
 	if(missingSensor) logger.setIndicatorState(IndicatorLight::SENSORS, IndicatorMode::ERROR);
@@ -966,8 +1573,9 @@ String initSensors()
 	// else if(reportError) logger.setIndicatorState(IndicatorLight::SENSORS, IndicatorMode::ERROR); //Only set minimal error state if critical error is not thrown
 	// else logger.setIndicatorState(IndicatorLight::SENSORS, IndicatorMode::PASS); //If no errors are reported, set to pass state
 	
-	output = output + closer; //Close diagnostic
-	return output;
+	output.close(); //Close diagnostic
+	countDropped(output);
+	return output.toString();
 }
 
 void quickTalonShutdown()
@@ -1155,6 +1763,7 @@ int sleepSensors()
 				Serial.print("Power Down Talon "); //DEBUG!
 				Serial.println(talons[t]->getTalonPort());
 				logger.enablePower(talons[t]->getTalonPort(), false); //Turn off power to given port 
+				talonRestarts.invalidate(talons[t]->getTalonPort()); //Power cycled, must restart before next use
 			}
 			else if(!talons[t]) {
 				Serial.print("Power Down Empty Port "); //DEBUG!
@@ -1172,11 +1781,12 @@ int wakeSensors()
 	logger.enableI2C_Global(true); //Connect to external bus to talk to sensors/Talons
 	logger.enableI2C_OB(false);
 	logger.disableDataAll(); //Turn off all data to start
+	talonRestarts.beginCycle(); //Every Talon is restarted below, start counting restarts for this cycle
 	for(int p = 1; p <= Kestrel::numTalonPorts; p++) logger.enablePower(p, true); //Turn power back on to all Kestrel ports
 	for(int t = 0; t < talons.size(); t++) {
 		if(talons[t] && talons[t]->getTalonPort() != 0) {
 			logger.enableData(talons[t]->getTalonPort(), true); //Turn on data for given port
-			talons[t]->restart(); //Restart all Talons, this turns on all ports it can
+			restartTalon(t); //Restart all Talons, this turns on all ports it can
 			logger.enableData(talons[t]->getTalonPort(), false); //Turn data back off for given port
 		}
 	}
@@ -1209,6 +1819,7 @@ int detectTalons(String dummyStr)
 		logger.enableData(port, true); //Turn on specific channel
 		logger.enablePower(port, false); 
 		logger.enablePower(port, true); 
+		talonRestarts.invalidate(port); //Power cycled
 		// logger.enableAuxPower(true);
 		// logger.enableI2C_Global(true);
 		// logger.enableI2C_OB(false);
@@ -1230,6 +1841,7 @@ int detectTalons(String dummyStr)
 				// logger.enablePower(port, false);
 				if(talons[t]->isPresent()) { //Test if that Talon is present, if it is, configure the port
 					talons[t]->setTalonPort(port);
+					updateTalonPortIndex();
 					Serial.print("Talon Port Result "); //DEBUG!
 					Serial.print(t);
 					Serial.print(": ");
@@ -1246,6 +1858,13 @@ int detectTalons(String dummyStr)
 	// talons[aux.getTalonPort() - 1] = &aux; //Place talon objects at detected positions in array
 	// talons[aux1.getTalonPort() - 1] = &aux1; 
 	// talons[i2c.getTalonPort() - 1] = &i2c;
+	beginTalons();
+	//Serial.println("TALON DETECTION DONE"); //DEBUG!
+	return 0; //DEBUG!
+}
+
+void beginTalons()
+{
 	bool dummy;
 	bool dummy1;
 	for(int i = 0; i < talons.size(); i++) {
@@ -1265,6 +1884,7 @@ int detectTalons(String dummyStr)
 				logger.enablePower(talons[i]->getTalonPort(), true); //Toggle power just before testing to get result within 10ms
 				logger.enablePower(talons[i]->getTalonPort(), false); 
 				logger.enablePower(talons[i]->getTalonPort(), true);
+				talonRestarts.invalidate(talons[i]->getTalonPort());
 			} 
 			
 			logger.configTalonSense(); //Setup to allow for current testing 
@@ -1286,13 +1906,13 @@ int detectTalons(String dummyStr)
 			//delay(10000); //DEBUG!
 		}
 	}
-	//Serial.println("TALON DETECTION DONE"); //DEBUG!
-	return 0; //DEBUG!
 }
 
 int detectSensors(String dummyStr)
 {
 	Serial.println(">>> FlightControl: detectSensors() START - Power should still be ON from detectTalons"); //DEBUG!
+	if(concurrentSdi12 != nullptr) concurrentSdi12->clearParticipants(); //Ports may change, learn participants again
+	dataDiff.invalidate(); //Device set may change, next data packet is a keyframe
 	/////////////// SENSOR AUTO DETECTION //////////////////////
 	for(int t = 0; t < talons.size(); t++) { //Iterate over each Talon
 	// Serial.println(talons[t]->talonInterface); //DEBUG!
@@ -1336,7 +1956,11 @@ int detectSensors(String dummyStr)
 				Serial.print(talons[t]->getTalonPort());
 				Serial.print(",");
 				Serial.println(p);
-				for(int s = 0; s < sensors.size(); s++) { //Iterate over all sensors objects
+				bool portTaken = false; //A sensor kept from before a live reload already answers here
+				for(int s = 0; s < sensors.size(); s++) {
+					if(sensors[s]->sensorInterface != BusType::CORE && sensors[s]->getTalonPort() == talons[t]->getTalonPort() && sensors[s]->getSensorPort() == p) portTaken = true;
+				}
+				for(int s = 0; s < sensors.size() && !portTaken; s++) { //Iterate over all sensors objects
 					if((sensors[s]->getTalonPort() == 0) && (talons[t]->talonInterface == sensors[s]->sensorInterface)) { //If Talon not already specified AND sensor bus is compatible with Talon bus
 						Serial.print("Test Sensor: "); //DEBUG!
 						Serial.println(s);
@@ -1375,6 +1999,105 @@ int detectSensors(String dummyStr)
 	return 0; //DEBUG!
 }
 
+int findTalons(String dummyStr)
+{
+	int result = detectTalons(dummyStr);
+	saveDetection(); //Keep stored map in step with a forced rescan
+	return result;
+}
+
+int findSensors(String dummyStr)
+{
+	int result = detectSensors(dummyStr);
+	saveDetection();
+	return result;
+}
+
+void saveDetection()
+{
+	if(!detectionMap.clear(talons.size(), sensors.size())) { //Too many objects to store, always run full detection
+		detectionMap.erase();
+		return;
+	}
+	for(int t = 0; t < talons.size(); t++) {
+		detectionMap.setTalonPort(t, talons[t]->getTalonPort());
+	}
+	for(int s = 0; s < sensors.size(); s++) {
+		if(sensors[s]->sensorInterface == BusType::CORE) continue; //Core devices are not detected
+		detectionMap.setSensor(s, sensors[s]->getTalonPort(), sensors[s]->getSensorPort(), sensors[s]->sensorInterface);
+	}
+	detectionMap.save(configManager.updateSensorConfigurationUid());
+}
+
+bool restoreDetection()
+{
+	if(!detectionMap.load(configManager.updateSensorConfigurationUid(), talons.size(), sensors.size())) {
+		return false; //No map stored for this config
+	}
+	for(int s = 0; s < sensors.size(); s++) { //Same objects in the same order as when saved
+		if(sensors[s]->sensorInterface != BusType::CORE && detectionMap.getSensorInterface(s) != sensors[s]->sensorInterface) return false;
+	}
+	//Confirm each Talon and sensor answers at its stored port before applying anything, any miss falls back to full detection
+	logger.enableI2C_Global(true);
+	logger.enableI2C_OB(false);
+	for(int t = 0; t < talons.size(); t++) {
+		uint8_t port = detectionMap.getTalonPort(t);
+		if(port == 0) continue; //Not found last time, full detection would not find it either unless wiring changed
+		logger.enableData(port, true);
+		logger.enablePower(port, true);
+		unsigned long localTime = millis();
+		while((millis() - localTime) < 10) { //Wait up to 10ms for connection to be established 
+			Wire.beginTransmission(0);
+			if(Wire.endTransmission() == 0) break;
+		}
+		bool present = talons[t]->isPresent();
+		logger.enableData(port, false);
+		if(!present) {
+			return false;
+		}
+	}
+	for(int s = 0; s < sensors.size(); s++) {
+		uint8_t talonPort = detectionMap.getSensorTalonPort(s);
+		uint8_t sensorPort = detectionMap.getSensorPort(s);
+		if(talonPort == 0 || sensorPort == 0) continue; //Core, Talon, or sensor not found last time
+		int t = -1;
+		for(int i = 0; i < talons.size(); i++) {
+			if(detectionMap.getTalonPort(i) == talonPort) t = i;
+		}
+		if(t < 0) return false;
+		logger.enableData(talonPort, true);
+		talons[t]->disableDataAll();
+		talons[t]->enableData(sensorPort, true);
+		delay(10); //Wait to make sure sensor is responsive after power up command 
+		bool present = sensors[s]->isPresent();
+		talons[t]->enableData(sensorPort, false);
+		logger.enableData(talonPort, false);
+		if(!present) {
+			return false;
+		}
+	}
+	//Everything confirmed, apply the stored ports
+	for(int t = 0; t < talons.size(); t++) {
+		if(detectionMap.getTalonPort(t) != 0) talons[t]->setTalonPort(detectionMap.getTalonPort(t));
+	}
+	updateTalonPortIndex();
+	for(int s = 0; s < sensors.size(); s++) {
+		uint8_t talonPort = detectionMap.getSensorTalonPort(s);
+		uint8_t sensorPort = detectionMap.getSensorPort(s);
+		if(talonPort == 0 || sensorPort == 0) continue;
+		sensors[s]->setTalonPort(talonPort);
+		sensors[s]->setSensorPort(sensorPort);
+		if(sensors[s]->keepPowered == true) {
+			int currentTalonIndex = getIndexOfPort(talonPort);
+			if(currentTalonIndex >= 0) talons[currentTalonIndex]->keepPowered = true; //If any of the sensors on a Talon require power, set the flag for the Talon
+		}
+	}
+	if(concurrentSdi12 != nullptr) concurrentSdi12->clearParticipants();
+	dataDiff.invalidate();
+	beginTalons();
+	return true;
+}
+
 int setNodeID(String nodeID)
 {
 	if(nodeID.length() > 8 || nodeID.length() < 0) return -1; //Return failure if string is not valid 
@@ -1425,9 +2148,10 @@ int updateConfiguration(String configJson) {
 	}
 
 	// First, try to parse and apply the configuration (this will also save to EEPROM)
+	ConfigurationManager previousConfig(configManager); //Kept to work out what needs applying
 	bool configParsed = configManager.setConfiguration(configJson.c_str());
 	if (!configParsed) {
-		Serial.println("Error: Failed to parse configuration.");
+		Serial.printlnf("Error: Failed to parse configuration, %s at byte %u.", configManager.getParseError(), (unsigned)configManager.getParseErrorOffset());
 		return -8; // Failed to parse config
 	}
 	Serial.println("Configuration parsed successfully and saved to EEPROM.");
@@ -1447,7 +2171,12 @@ int updateConfiguration(String configJson) {
 	}
 
 	// Success if config was parsed (EEPROM updated), regardless of SD card status
-	Serial.println("Configuration update completed. System will restart to apply changes.");
+	if(applyConfiguration(configManager.compare(previousConfig))) {
+		Serial.println("Configuration update completed and applied.");
+		return 1; //Success
+	}
+	Serial.println("Configuration update completed. System will restart to apply Talon changes.");
+	flushRecords(); //Records held in RAM would be lost by the reset
 	System.reset(); //restart the system to apply new configuration
 	return 1; //Success
 }
@@ -1464,15 +2193,17 @@ int getSensorConfiguration(String dummy) {
 
 int takeSample(String dummy)
 {
+	lockSampling();
 	logger.wake(); //Wake logger in case it was sleeping
 	wakeSensors(); //Wake up sensors from sleep
 	if(dummy == "true") { //If told to use backhaul, use normal FRAM method
-		fileSys.writeToFRAM(getDataString(), DataType::Data, DestCodes::Both); 
-		fileSys.dumpFRAM(); //Dump data
+		writeRecord(getDataString(), DataType::Data, DestCodes::Both); 
+		dumpRecords(); //Dump data, batches held in RAM included
 	}
-	else fileSys.writeToParticle(getDataString(), "data/v2"); //Otherwise fast return
+	else publishRecord(getDataString(), "data/v2"); //Otherwise fast return
 	sleepSensors(); //
-	logger.sleep();
+	if(!backhaulWorker.isBusy()) logger.sleep();
+	unlockSampling();
 	return 1;
 }
 
@@ -1482,69 +2213,69 @@ int commandExe(String command)
 		logger.releaseWDT();
 		return 1; //DEBUG!
 	}
+	int result = 1;
+	lockSampling(); //Sensors, records, FRAM and the batcher are shared with loop() and the backhaul worker
 	if(command == "102") {
 		logger.wake(); //Wake logger in case it was sleeping
 		wakeSensors(); //Wake up sensors from sleep
-		fileSys.writeToParticle(getDiagnosticString(2), "diagnostic/v2"); 
+		publishRecord(getDiagnosticString(2), "diagnostic/v2"); 
 		sleepSensors(); //
-		logger.sleep();
-		return 1; //DEBUG!
+		if(!backhaulWorker.isBusy()) logger.sleep();
 	}
-	if(command == "103") {
+	else if(command == "103") {
 		logger.wake(); //Wake logger in case it was sleeping
 		wakeSensors(); //Wake up sensors from sleep
-		fileSys.writeToParticle(getDiagnosticString(3), "diagnostic/v2"); 
+		publishRecord(getDiagnosticString(3), "diagnostic/v2"); 
 		sleepSensors(); //
-		logger.sleep();
-		return 1; //DEBUG!
+		if(!backhaulWorker.isBusy()) logger.sleep();
 	}
-	if(command == "104") {
+	else if(command == "104") {
 		logger.wake(); //Wake logger in case it was sleeping
 		wakeSensors(); //Wake up sensors from sleep
-		fileSys.writeToParticle(getDiagnosticString(4), "diagnostic/v2"); 
+		publishRecord(getDiagnosticString(4), "diagnostic/v2"); 
 		sleepSensors(); //
-		logger.sleep();
-		return 1; //DEBUG!
+		if(!backhaulWorker.isBusy()) logger.sleep();
+	}
+	else if(command == "106") {
+		publishRecord(getDiagnosticString(SensorProfiler::DIAGNOSTIC_LEVEL), "diagnostic/v2"); //Stage timing only, sensors stay asleep
 	}
-	if(command == "111") {
+	else if(command == "111") {
 		logger.wake(); //Wake logger in case it was sleeping
 		wakeSensors(); //Wake up sensors from sleep
-		fileSys.writeToParticle(getDataString(), "data/v2"); 
+		publishRecord(getDataString(), "data/v2"); 
 		sleepSensors(); //
-		logger.sleep();
-		return 1; //DEBUG!
+		if(!backhaulWorker.isBusy()) logger.sleep();
 	}
-	if(command == "120") {
-		fileSys.writeToParticle(getErrorString(), "error/v2"); 
-		return 1; //DEBUG!
+	else if(command == "120") {
+		publishRecord(getErrorString(), "error/v2"); 
 	}
-	if(command == "130") {
+	else if(command == "130") {
 		logger.wake(); //Wake logger in case it was sleeping
 		wakeSensors(); //Wake up sensors from sleep
-		fileSys.writeToParticle(getMetadataString(), "metadata/v2"); 
+		publishRecord(getMetadataString(), "metadata/v2"); 
 		sleepSensors(); //
-		logger.sleep();
-		return 1; //DEBUG!
+		if(!backhaulWorker.isBusy()) logger.sleep();
 	}
-	if(command == "401") {
+	else if(command == "401") {
 		fileSys.wake();
-		fileSys.dumpFRAM();
+		dumpRecords(); //Batches held in RAM go first, and the dump counts toward the backhaul statistics
 		fileSys.sleep();
-		return 1;
 	}
-	if(command == "410") {
+	else if(command == "410") {
 		fileSys.wake();
 		fileSys.eraseFRAM(); //Clear FRAM and start over
 		fileSys.sleep();
-		return 1; //DEBUG!
 	}
 	else {
-		return -1; //Return unknown command 
+		result = -1; //Return unknown command 
 	}
+	unlockSampling();
+	return result;
 }
 
 int systemRestart(String resetType)
 {
+	flushRecords(); //Records held in RAM would be lost by the reset
 	if(resetType.equalsIgnoreCase("hard")) System.reset(RESET_NO_WAIT); //Perform a hard reset
 	else System.reset(); //Attempt to inform cloud of a reset first 
 	return 1;
@@ -1570,6 +2301,7 @@ bool loadConfiguration() {
     if (!configStr.empty()) {
         Serial.println("Loading configuration from SD card...");
         configLoaded = configManager.setConfiguration(configStr);
+        if (!configLoaded) Serial.printlnf("config.json: %s at byte %u", configManager.getParseError(), (unsigned)configManager.getParseErrorOffset());
     }
     
     // If SD card config failed, try EEPROM backup
@@ -1602,32 +2334,69 @@ bool loadConfiguration() {
         }
     }
     
+    applySystemConfiguration();
+
+	return configLoaded;
+}
+
+void applySystemConfiguration() {
     // Set global variables from configuration
     logPeriod = configManager.getLogPeriod();
     backhaulCount = configManager.getBackhaulCount();
     desiredPowerSaveMode = configManager.getPowerSaveMode();
     loggingMode = configManager.getLoggingMode();
+    packetEncoding = configManager.getPacketEncoding();
+    dataDiff.configure(configManager.getKeyframeInterval(), configManager.getDiffDeadband());
+    backhaulBatcher.configure(Kestrel::MAX_MESSAGE_LENGTH, configManager.getBatchDeadline() * 1000UL);
+    sdWriteBehind.configure(configManager.getSdDeadline() * 1000UL);
+    scheduleTasks();
+}
 
-	return configLoaded;
+bool applyConfiguration(uint16_t changes) {
+    if(changes & ConfigurationManager::CHANGE_TALONS) return false; //Talon objects back the SDI12 adapter and sensor buses, only rebuilt at boot
+    lockSampling(); //Backhaul worker may be mid transfer
+    applySystemConfiguration(); //Unchanged tasks keep their deadlines, buffers flush before taking new limits
+    bool resized = false;
+    if(changes & ConfigurationManager::CHANGE_SENSORS) resized = sensorManager.resizeSensors(realTimeProvider, concurrentSdi12); //No SDI12 Talon, no SDI12 sensors
+    if(resized) {
+        dataDiff.invalidate(); //Device indexes moved, next data packet is a keyframe
+        updateSensorVectors();
+        configurePowerSave(desiredPowerSaveMode); //New sensors start in the configured mode
+        beginTalons(); //Power Talons back up for detection
+        detectSensors(); //Sensors kept from before hold their ports, only new ones are probed
+        saveDetection();
+        String initDiagnostic = initSensors();
+        writeRecord(initDiagnostic, DataType::Diagnostic, loggingMode == LogModes::NO_LOCAL ? DestCodes::Particle : DestCodes::Both);
+    }
+    else {
+        if(changes & (ConfigurationManager::CHANGE_SCHEDULE | ConfigurationManager::CHANGE_SAMPLE_PERIODS)) updateSensorVectors(); //Same objects, new periods or due tolerance
+        if(changes & ConfigurationManager::CHANGE_POWER_SAVE) configurePowerSave(desiredPowerSaveMode);
+    }
+    logger.startTimer(secondsUntilNextTask()); //Timer was set for the old schedule
+    unlockSampling();
+    return true;
 }
 
 void initializeSensorSystem() {
+    sensorManager.setCoreDevices({&fileSys, &battery, &logger});
+    
     // First initialize talons only (without sensors)
     sensorManager.initializeTalons();
     
     // Create SDI12 adapter from actual talons if needed
-    auto& sdi12Talons = sensorManager.getSDI12Talons();
+    SDI12Talon* firstSDI12Talon = sensorManager.getSDI12Talon(0);
 	Serial.println("Got sdi12 talons");
-	Serial.println(sdi12Talons.size());
-    if (!sdi12Talons.empty() && realSdi12 == nullptr) {
+	Serial.println(sensorManager.getCount(SensorTypes::SDI12_TALON));
+    if (firstSDI12Talon != nullptr && realSdi12 == nullptr) {
 		Serial.println("Creating real SDI12 adapter");
-        realSdi12 = new SDI12TalonAdapter(*sdi12Talons[0]);
+        realSdi12 = new SDI12TalonAdapter(*firstSDI12Talon);
+        concurrentSdi12 = new ConcurrentSDI12Talon(*realSdi12, realTimeProvider);
     }
     
     // Now initialize sensors with proper adapter
-    if (realSdi12 != nullptr) {
+    if (concurrentSdi12 != nullptr) {
 		Serial.println("Using real SDI12 adapter");
-        sensorManager.initializeSensorsOnly(realTimeProvider, *realSdi12);
+        sensorManager.initializeSensorsOnly(realTimeProvider, *concurrentSdi12);
     } else {
 		Serial.println("Creating dummy adapter");
         SDI12Talon dummyTalon(0, 0x14);
@@ -1639,36 +2408,27 @@ void initializeSensorSystem() {
 }
 
 void updateSensorVectors() {
-    sensors.clear();
-    talons.clear();
-    
-    // Add core sensors
-	Serial.println("Adding core sensors"); //DEBUG!
-    sensors.push_back(&fileSys);
-    sensors.push_back(&battery);
-    sensors.push_back(&logger);
-    
-    // Get vectors from sensor manager
-    talons = sensorManager.getAllTalons();
-	Serial.println("Adding talons"); //DEBUG!
-	Serial.println(talons.size());
-    for (auto* talon : talons) {
-        sensors.push_back(talon);
-    }
+    // sensors and talons are views kept by sensorManager, only the indexes built on them need refreshing
+	Serial.println("Devices"); //DEBUG!
+	Serial.println(sensors.size()); //DEBUG!
+	updateTalonPortIndex();
+	sensorProfiler.reset(); //Indexes now refer to different sensors
+
     
-    auto configuredSensors = sensorManager.getAllSensors();
-	Serial.println("Adding sensors"); //DEBUG!
-    for (auto* sensor : configuredSensors) {
-        sensors.push_back(sensor);
+    std::vector<unsigned long> periods(sensors.size() - sensorManager.getAllSensors().size(), 0); // Core devices and Talons on every pass
+    for (unsigned long period : sensorManager.getSamplePeriods()) {
+        periods.push_back(period * 1000UL);
     }
-	Serial.println(sensors.size()); //DEBUG!
+    sensorSchedule.configure(periods, scheduler.getPeriod(Tasks::SAMPLE) / 2, millis()); // A log up to half a period early still reads a sensor
 }
 
-int getIndexOfPort(int port) {
+void updateTalonPortIndex() {
+    talonPortIndex.clear();
     for (int i = 0; i < talons.size(); i++) {
-        if (talons[i]->getTalonPort() == port) {
-            return i;
-        }
+        talonPortIndex.assign(talons[i]->getTalonPort(), i);
     }
-    return -1;
+}
+
+int getIndexOfPort(int port) {
+    return talonPortIndex.indexOf(port);
 }
\ No newline at end of file
@@ -0,0 +1,120 @@
+/**
+ * @file EnergyLedger.cpp
+ * @brief Implementation of EnergyLedger class
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "EnergyLedger.h"
+#include <string.h>
+
+EnergyLedger::EnergyLedger()
+    : m_cycleOpen(false),
+      m_cycles(0)
+{
+    memset(m_phases, 0, sizeof(m_phases));
+    memset(m_sensors, 0, sizeof(m_sensors));
+    memset(m_metered, 0, sizeof(m_metered));
+}
+
+void EnergyLedger::beginCycle()
+{
+    if (m_cycleOpen) {
+        for (int phase = 0; phase < NUM_PHASES; phase++) close(m_phases[phase]);
+        for (int sensor = 0; sensor < MAX_SENSORS; sensor++) close(m_sensors[sensor]);
+        if (m_cycles < UINT16_MAX) m_cycles++;
+    }
+    m_cycleOpen = true;
+}
+
+void EnergyLedger::addPhase(Phase phase, float powerMw, uint32_t durationUs)
+{
+    if (phase >= NUM_PHASES) return;
+    add(m_phases[phase].currentUj, energyUj(powerMw, durationUs));
+}
+
+void EnergyLedger::addSensor(int sensor, float powerMw, uint32_t durationUs)
+{
+    if (sensor < 0 || sensor >= MAX_SENSORS) return;
+    add(m_sensors[sensor].currentUj, energyUj(powerMw, durationUs));
+    m_metered[sensor] = true;
+}
+
+void EnergyLedger::resetWindow()
+{
+    for (int phase = 0; phase < NUM_PHASES; phase++) m_phases[phase].totalUj = 0;
+    for (int sensor = 0; sensor < MAX_SENSORS; sensor++) m_sensors[sensor].totalUj = 0;
+    m_cycles = 0;
+}
+
+uint32_t EnergyLedger::getPhaseLastUj(Phase phase) const
+{
+    return phase < NUM_PHASES ? m_phases[phase].lastUj : 0;
+}
+
+uint32_t EnergyLedger::getPhaseMeanUj(Phase phase) const
+{
+    return phase < NUM_PHASES ? mean(m_phases[phase]) : 0;
+}
+
+uint32_t EnergyLedger::getSensorLastUj(int sensor) const
+{
+    return hasSensor(sensor) ? m_sensors[sensor].lastUj : 0;
+}
+
+uint32_t EnergyLedger::getSensorMeanUj(int sensor) const
+{
+    return hasSensor(sensor) ? mean(m_sensors[sensor]) : 0;
+}
+
+bool EnergyLedger::hasSensor(int sensor) const
+{
+    return sensor >= 0 && sensor < MAX_SENSORS && m_metered[sensor];
+}
+
+uint32_t EnergyLedger::getCycleMeanUj() const
+{
+    uint32_t total = 0;
+    for (int phase = 0; phase < NUM_PHASES; phase++) add(total, mean(m_phases[phase]));
+    return total;
+}
+
+float EnergyLedger::estimatePowerMw(uint32_t periodMs) const
+{
+    if (periodMs == 0) return 0;
+    return (float)getCycleMeanUj() / (float)periodMs; //uJ per ms is mW
+}
+
+const char* EnergyLedger::phaseName(Phase phase)
+{
+    switch (phase) {
+        case WAKE: return "Wake";
+        case SAMPLE: return "Sample";
+        case BACKHAUL: return "Backhaul";
+        default: return "Unknown";
+    }
+}
+
+uint32_t EnergyLedger::energyUj(float powerMw, uint32_t durationUs)
+{
+    if (!(powerMw > 0)) return 0; //Negative, NaN or a failed read
+    float energy = powerMw * (float)durationUs / 1000.0f;
+    return energy >= 4294967295.0f ? UINT32_MAX : (uint32_t)energy;
+}
+
+void EnergyLedger::add(uint32_t& total, uint32_t energy)
+{
+    total = (total > UINT32_MAX - energy) ? UINT32_MAX : total + energy;
+}
+
+void EnergyLedger::close(Account& account)
+{
+    account.lastUj = account.currentUj;
+    add(account.totalUj, account.currentUj);
+    account.currentUj = 0;
+}
+
+uint32_t EnergyLedger::mean(const Account& account) const
+{
+    return m_cycles > 0 ? account.totalUj / m_cycles : 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file EnergyLedger.h
+ * @brief Energy per cycle phase and per sensor, from current sense snapshots.
+ *
+ * The Kestrel CSAs (PAC1934) accumulate power between refreshes, which is
+ * how average power over a window is read. FlightControl refreshes them at
+ * the boundaries of each cycle phase only, and splits each Talon port's
+ * energy over the phase among its sensors by their powered time. It hands
+ * the average power and window length here. The ledger turns them into
+ * energy per cycle, which is what logPeriod and keepPowered choices for a
+ * battery limited site come down to.
+ *
+ * Power and time are taken by the caller, so the same logic runs on the
+ * device and in the host simulator.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef ENERGY_LEDGER_H
+#define ENERGY_LEDGER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Energy of the last cycle and mean per cycle over a reporting window
+ *
+ * Energies are in microjoules (mW x ms). Phases are metered on the logger
+ * supply, so they add up to the awake energy of a cycle. Sensors are metered
+ * on their Talon port, a breakdown of the SAMPLE phase rather than an addition
+ * to it. Sensors are indexes into the FlightControl sensors vector.
+ */
+class EnergyLedger {
+public:
+    enum Phase : uint8_t {
+        WAKE,      ///< Logger and sensor wake up
+        SAMPLE,    ///< Sensor passes, record building and FRAM writes
+        BACKHAUL,  ///< Time sync and FRAM dump
+        NUM_PHASES
+    };
+
+    static const uint8_t MAX_SENSORS = 20;
+
+    EnergyLedger();
+
+    /**
+     * @brief End the cycle in progress and start a new one
+     *
+     * The first call only starts a cycle. Each later call moves the energy of
+     * the ended cycle into the last cycle values and the window means.
+     */
+    void beginCycle();
+
+    /**
+     * @brief Add a metered window
+     * @param powerMw Average power over the window
+     * @param durationUs Window length
+     */
+    void addPhase(Phase phase, float powerMw, uint32_t durationUs);
+    void addSensor(int sensor, float powerMw, uint32_t durationUs);
+
+    /**
+     * @brief Start a new reporting window, last cycle values are kept
+     */
+    void resetWindow();
+
+    uint32_t getPhaseLastUj(Phase phase) const;
+    uint32_t getPhaseMeanUj(Phase phase) const;
+    uint32_t getSensorLastUj(int sensor) const;
+    uint32_t getSensorMeanUj(int sensor) const;
+    bool hasSensor(int sensor) const;
+
+    /**
+     * @brief Mean awake energy per cycle over the window, every phase
+     */
+    uint32_t getCycleMeanUj() const;
+
+    /**
+     * @brief Average power of the awake energy spread over a log period
+     *
+     * For comparing logPeriod and keepPowered settings. Sleep draw between
+     * cycles is not metered and is not included.
+     */
+    float estimatePowerMw(uint32_t periodMs) const;
+
+    uint16_t getCycles() const { return m_cycles; }
+
+    static const char* phaseName(Phase phase);
+
+private:
+    struct Account {
+        uint32_t currentUj; ///< Cycle in progress
+        uint32_t lastUj;    ///< Last ended cycle
+        uint32_t totalUj;   ///< Ended cycles in the window, saturates
+    };
+
+    static uint32_t energyUj(float powerMw, uint32_t durationUs);
+    static void add(uint32_t& total, uint32_t energy);
+    void close(Account& account);
+    uint32_t mean(const Account& account) const;
+
+    Account m_phases[NUM_PHASES];
+    Account m_sensors[MAX_SENSORS];
+    bool m_metered[MAX_SENSORS]; ///< Sensor has had a window since boot
+    bool m_cycleOpen;
+    uint16_t m_cycles; ///< Ended cycles in the window
+};
+
+#endif // ENERGY_LEDGER_H
@@ -0,0 +1,116 @@
+/**
+ * @file PortTransitionPlanner.cpp
+ * @brief Implementation of PortTransitionPlanner class
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "PortTransitionPlanner.h"
+
+PortTransitionPlanner::PortTransitionPlanner()
+    : m_kestrelPort(0),
+      m_sensorPort(0),
+      m_portValid(false),
+      m_busValid(false),
+      m_talonCleared(false),
+      m_coreStep(false),
+      m_faultsChecked(0),
+      m_writesIssued(0),
+      m_writesSkipped(0) {
+}
+
+void PortTransitionPlanner::beginPass() {
+    m_steps.clear();
+    m_kestrelPort = 0;
+    m_sensorPort = 0;
+    m_portValid = false;
+    m_busValid = false;
+    m_talonCleared = false;
+    m_coreStep = false;
+    m_faultsChecked = 0;
+}
+
+void PortTransitionPlanner::addSensor(uint16_t sensorIndex, uint8_t talonPort, uint8_t sensorPort, bool isCore) {
+    Step step = {sensorIndex, talonPort, sensorPort, isCore};
+    m_steps.push_back(step);
+}
+
+uint16_t PortTransitionPlanner::sortKey(const Step& step) {
+    if (step.isCore || step.talonPort == 0) return 0; //Core and undetected sensors first
+    return ((uint16_t)step.talonPort << 8) | step.sensorPort;
+}
+
+void PortTransitionPlanner::plan() {
+    //Insertion sort, stable and in place. Passes are a few dozen sensors at most
+    for (size_t i = 1; i < m_steps.size(); i++) {
+        Step current = m_steps[i];
+        uint16_t key = sortKey(current);
+        size_t j = i;
+        while (j > 0 && sortKey(m_steps[j - 1]) > key) {
+            m_steps[j] = m_steps[j - 1];
+            j--;
+        }
+        m_steps[j] = current;
+    }
+}
+
+bool PortTransitionPlanner::count(bool needed, uint8_t writes) {
+    if (needed) m_writesIssued += writes;
+    else m_writesSkipped += writes;
+    return needed;
+}
+
+bool PortTransitionPlanner::selectKestrelPort(uint8_t talonPort, bool isCore) {
+    if (m_coreStep) { //Previous device was core, assume it left ports and bus in any state
+        m_portValid = false;
+        m_busValid = false;
+        m_coreStep = false;
+    }
+    bool isTalonPort = (!isCore && talonPort != 0);
+    bool needed = isCore || !m_portValid || m_kestrelPort != talonPort;
+    if (needed) {
+        m_kestrelPort = talonPort;
+        m_portValid = true;
+        invalidateTalonPorts(); //Different Talon (or none), nothing is known about its ports
+    }
+    m_coreStep = isCore;
+    return count(needed, isTalonPort ? WRITES_KESTREL_PORT : WRITES_KESTREL_CLEAR);
+}
+
+bool PortTransitionPlanner::selectBus() {
+    bool needed = !m_busValid;
+    m_busValid = true;
+    return count(needed, WRITES_BUS);
+}
+
+bool PortTransitionPlanner::clearTalonPorts() {
+    bool needed = !m_talonCleared;
+    if (needed) m_sensorPort = 0;
+    m_talonCleared = true;
+    return count(needed, WRITES_TALON_CLEAR);
+}
+
+bool PortTransitionPlanner::selectSensorPort(uint8_t sensorPort) {
+    bool needed = (m_sensorPort != sensorPort);
+    m_sensorPort = sensorPort;
+    return count(needed, WRITES_SENSOR_PORT);
+}
+
+bool PortTransitionPlanner::releaseSensorPort(uint16_t step) {
+    bool needed = true;
+    if ((size_t)step + 1 < m_steps.size()) {
+        const Step& current = m_steps[step];
+        const Step& next = m_steps[step + 1];
+        if (!next.isCore && next.talonPort == current.talonPort && next.sensorPort == current.sensorPort) needed = false; //Next sensor reads from the same port
+    }
+    if (needed) m_sensorPort = 0;
+    return count(needed, WRITES_SENSOR_PORT);
+}
+
+bool PortTransitionPlanner::checkFault(uint8_t talonPort) {
+    if (talonPort == 0 || talonPort > 32) return true; //Not tracked
+    uint32_t bit = 1UL << (talonPort - 1);
+    bool needed = !(m_faultsChecked & bit);
+    m_faultsChecked |= bit;
+    return count(needed, READS_FAULT);
+}
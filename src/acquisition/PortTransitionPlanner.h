@@ -0,0 +1,143 @@
+/**
+ * @file PortTransitionPlanner.h
+ * @brief Orders a sensor pass by port and elides redundant port/bus switching.
+ *
+ * Each sensor read needs the Kestrel data port for its Talon, the external I2C
+ * bus and the sensor port on the Talon enabled. Every one of those calls is an
+ * I2C write to a PCAL9535A. Visiting sensors grouped by Talon port and sensor
+ * port, and tracking what is already switched on, lets consecutive sensors on
+ * the same Talon (or the same sensor port) skip the writes entirely.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef PORT_TRANSITION_PLANNER_H
+#define PORT_TRANSITION_PLANNER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Plans the visiting order for one pass and tracks switched state
+ *
+ * Usage per pass: beginPass(), addSensor() for every sensor, plan(), then for
+ * each step ask the select/release methods whether the matching write must be
+ * issued. Anything that may disturb the tracked state (Talon restart,
+ * configTalonSense()) must be reported with the invalidate methods.
+ */
+class PortTransitionPlanner {
+public:
+    // Expander writes behind each transition, used for the skipped write count
+    static const uint8_t WRITES_KESTREL_PORT = 3; ///< disableDataAll, enablePower, enableData
+    static const uint8_t WRITES_KESTREL_CLEAR = 1; ///< disableDataAll only (core or undetected sensor)
+    static const uint8_t WRITES_BUS = 2; ///< enableI2C_OB, enableI2C_Global
+    static const uint8_t WRITES_TALON_CLEAR = 1; ///< Talon disableDataAll
+    static const uint8_t WRITES_SENSOR_PORT = 1; ///< Talon enableData on or off
+    static const uint8_t READS_FAULT = 1; ///< Kestrel getFault, counted with the writes
+
+    PortTransitionPlanner();
+
+    /**
+     * @brief Discard the previous plan and all tracked port state
+     */
+    void beginPass();
+
+    /**
+     * @brief Register a sensor for this pass
+     * @param sensorIndex Index of the sensor in the caller's sensors vector
+     * @param isCore true for core devices, these are read first and in the given order
+     */
+    void addSensor(uint16_t sensorIndex, uint8_t talonPort, uint8_t sensorPort, bool isCore);
+
+    /**
+     * @brief Order the pass by Talon port then sensor port
+     *
+     * Core and undetected sensors keep their registration order at the front.
+     * The sort is stable, so sensors sharing a port keep their relative order.
+     */
+    void plan();
+
+    uint16_t size() const { return m_steps.size(); }
+    uint16_t getSensorIndex(uint16_t step) const { return m_steps[step].sensorIndex; }
+
+    /**
+     * @brief Whether the Kestrel data ports must be switched for this sensor
+     * @return true if the caller must disableDataAll() and, for a valid non core
+     * port, enablePower()/enableData() the Talon port
+     */
+    bool selectKestrelPort(uint8_t talonPort, bool isCore);
+
+    /**
+     * @brief Whether the external I2C bus must be (re)selected
+     */
+    bool selectBus();
+
+    /**
+     * @brief Whether the Talon must have all data ports turned off before use
+     */
+    bool clearTalonPorts();
+
+    /**
+     * @brief Whether the sensor port on the current Talon must be turned on
+     */
+    bool selectSensorPort(uint8_t sensorPort);
+
+    /**
+     * @brief Whether the sensor port must be turned off after reading this step
+     *
+     * Left on when the next step reads from the same Talon and sensor port.
+     */
+    bool releaseSensorPort(uint16_t step);
+
+    /**
+     * @brief Whether the fault line of this Talon port must be read
+     *
+     * true only for the first step on each Talon in a pass, a fault raised
+     * later in the pass is seen by the next one. Undetected ports (0) always
+     * return true, the caller does not read those.
+     */
+    bool checkFault(uint8_t talonPort);
+
+    /**
+     * @brief Bus selection may have changed (on-board bus used, e.g. configTalonSense())
+     */
+    void invalidateBus() { m_busValid = false; }
+
+    /**
+     * @brief Talon port state is unknown (e.g. restart turns on every port)
+     */
+    void invalidateTalonPorts() { m_talonCleared = false; m_sensorPort = 0; }
+
+    /**
+     * @brief Reset the write counters, call once per log cycle
+     */
+    void resetCounters() { m_writesIssued = 0; m_writesSkipped = 0; }
+
+    uint16_t getWritesIssued() const { return m_writesIssued; }
+    uint16_t getWritesSkipped() const { return m_writesSkipped; }
+
+private:
+    struct Step {
+        uint16_t sensorIndex;
+        uint8_t talonPort;
+        uint8_t sensorPort;
+        bool isCore;
+    };
+
+    static uint16_t sortKey(const Step& step);
+    bool count(bool needed, uint8_t writes);
+
+    std::vector<Step> m_steps; ///< Capacity is kept between passes, no allocation once sized
+    uint8_t m_kestrelPort;
+    uint8_t m_sensorPort; ///< Sensor port currently on for the selected Talon, 0 if none
+    bool m_portValid;
+    bool m_busValid;
+    bool m_talonCleared;
+    bool m_coreStep; ///< Core devices may switch ports and bus while read, state is stale after them
+    uint32_t m_faultsChecked; ///< Talon ports whose fault line was read this pass, one bit each
+    uint16_t m_writesIssued;
+    uint16_t m_writesSkipped;
+};
+
+#endif // PORT_TRANSITION_PLANNER_H
@@ -0,0 +1,85 @@
+/**
+ * @file SensorProfiler.cpp
+ * @brief Implementation of SensorProfiler class
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "SensorProfiler.h"
+#include <string.h>
+
+const SensorProfiler::Stats SensorProfiler::EMPTY = {0, 0, 0, 0};
+
+SensorProfiler::SensorProfiler()
+{
+    reset();
+}
+
+void SensorProfiler::record(int sensor, Stage stage, uint32_t elapsedUs)
+{
+    int index = row(sensor);
+    if (index < 0 || stage >= NUM_STAGES) return;
+    Stats& stats = m_stats[index][stage];
+    if (stats.count == 0 || elapsedUs < stats.minUs) stats.minUs = elapsedUs;
+    if (elapsedUs > stats.maxUs) stats.maxUs = elapsedUs;
+    stats.totalUs = (stats.totalUs > UINT32_MAX - elapsedUs) ? UINT32_MAX : stats.totalUs + elapsedUs;
+    stats.count++;
+}
+
+void SensorProfiler::reset()
+{
+    memset(m_stats, 0, sizeof(m_stats));
+}
+
+const SensorProfiler::Stats& SensorProfiler::get(int sensor, Stage stage) const
+{
+    int index = row(sensor);
+    if (index < 0 || stage >= NUM_STAGES) return EMPTY;
+    return m_stats[index][stage];
+}
+
+bool SensorProfiler::hasSamples(int sensor) const
+{
+    int index = row(sensor);
+    if (index < 0) return false;
+    for (int stage = 0; stage < NUM_STAGES; stage++) {
+        if (m_stats[index][stage].count > 0) return true;
+    }
+    return false;
+}
+
+int SensorProfiler::getSlowestSensor() const
+{
+    int slowest = -1;
+    uint32_t slowestMean = 0;
+    for (int sensor = 0; sensor < MAX_SENSORS; sensor++) {
+        const Stats& total = m_stats[sensor][SENSOR_TOTAL];
+        if (total.count > 0 && (slowest < 0 || total.getMeanUs() > slowestMean)) {
+            slowest = sensor;
+            slowestMean = total.getMeanUs();
+        }
+    }
+    return slowest;
+}
+
+const char* SensorProfiler::stageName(Stage stage)
+{
+    switch (stage) {
+        case PORT_ENABLE: return "Enable";
+        case TALON_RESTART: return "Restart";
+        case GET_DATA: return "Data";
+        case SELF_DIAGNOSTIC: return "Diag";
+        case GET_METADATA: return "Meta";
+        case PORT_DISABLE: return "Disable";
+        case SENSOR_TOTAL: return "Total";
+        case FRAM_WRITE: return "FRAMWrite";
+        default: return "Unknown";
+    }
+}
+
+int SensorProfiler::row(int sensor) const
+{
+    if (sensor == LOGGER) return MAX_SENSORS;
+    if (sensor < 0 || sensor >= MAX_SENSORS) return -1;
+    return sensor;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file SensorProfiler.h
+ * @brief Per sensor timing of each stage of a sensor pass.
+ *
+ * A cycle that overruns logPeriod only shows up as a late sample, with no
+ * sign of which sensor caused it. FlightControl times each stage of a pass
+ * (port enable, Talon restart, getData, selfDiagnostic, getMetadata, port
+ * disable) for every sensor, and each FRAM write for the logger, and the
+ * profiler keeps min, mean and max of each in RAM until they are reported.
+ *
+ * Timing is in microseconds, taken by the caller, so the same logic runs on
+ * the device and in the host simulator.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef SENSOR_PROFILER_H
+#define SENSOR_PROFILER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Min, mean and max duration of each pass stage per sensor
+ *
+ * Sensors are indexes into the FlightControl sensors vector. Indexes at or
+ * above MAX_SENSORS are not profiled. LOGGER is the row for work done once
+ * per record rather than per sensor.
+ */
+class SensorProfiler {
+public:
+    enum Stage : uint8_t {
+        PORT_ENABLE,     ///< Kestrel port, bus and Talon port selection
+        TALON_RESTART,   ///< Talon restart before the sensor is read
+        GET_DATA,
+        SELF_DIAGNOSTIC,
+        GET_METADATA,
+        PORT_DISABLE,
+        SENSOR_TOTAL,    ///< Port enable to port disable, restart included
+        FRAM_WRITE,      ///< Records handed to FRAM, LOGGER row only
+        NUM_STAGES
+    };
+
+    static const uint8_t MAX_SENSORS = 20; ///< Core devices, Talons and sensors, 2.7 KB of statistics
+    static const int LOGGER = -1;
+    static const uint8_t DIAGNOSTIC_LEVEL = 6; ///< Diagnostic level that reports the profile instead of sensor diagnostics
+
+    typedef uint32_t (*Clock)(); ///< Microsecond clock stages are timed with, set by the firmware or the simulator
+
+    struct Stats {
+        uint32_t count;
+        uint32_t minUs;
+        uint32_t maxUs;
+        uint32_t totalUs; ///< Saturates, the window is normally one diagnostic period
+
+        uint32_t getMeanUs() const { return count > 0 ? totalUs / count : 0; }
+    };
+
+    SensorProfiler();
+
+    /**
+     * @brief Add one timed stage
+     * @param sensor Sensor index, or LOGGER
+     */
+    void record(int sensor, Stage stage, uint32_t elapsedUs);
+
+    /**
+     * @brief Clear every statistic, after a report or when sensor indexes change
+     */
+    void reset();
+
+    const Stats& get(int sensor, Stage stage) const;
+    bool hasSamples(int sensor) const;
+
+    /**
+     * @brief Sensor with the largest mean SENSOR_TOTAL, the usual cause of an overrun
+     * @return Sensor index, -1 if nothing was recorded
+     */
+    int getSlowestSensor() const;
+
+    static const char* stageName(Stage stage);
+
+private:
+    int row(int sensor) const;
+
+    Stats m_stats[MAX_SENSORS + 1][NUM_STAGES]; ///< Last row is LOGGER
+    static const Stats EMPTY;
+};
+
+#endif // SENSOR_PROFILER_H
@@ -0,0 +1,40 @@
+/**
+ * @file SensorSchedule.cpp
+ * @brief Implementation of the per sensor sampling schedule
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "SensorSchedule.h"
+
+SensorSchedule::SensorSchedule()
+    : m_tolerance(0),
+      m_skipped(0)
+{
+}
+
+void SensorSchedule::configure(const std::vector<unsigned long>& periodsMs, unsigned long toleranceMs, unsigned long now)
+{
+    m_entries.clear();
+    for (unsigned long period : periodsMs) m_entries.push_back({period, now});
+    m_tolerance = toleranceMs;
+}
+
+bool SensorSchedule::isDue(uint16_t index, unsigned long now) const
+{
+    if (index >= m_entries.size() || m_entries[index].period == 0) return true;
+    return (long)(m_entries[index].due - now) <= (long)m_tolerance;
+}
+
+bool SensorSchedule::take(uint16_t index, unsigned long now)
+{
+    if (!isDue(index, now)) {
+        m_skipped++;
+        return false;
+    }
+    if (index < m_entries.size()) {
+        Entry& entry = m_entries[index];
+        while (entry.period > 0 && (long)(entry.due - now) <= (long)m_tolerance) entry.due += entry.period; //Next deadline on the grid, skipping any missed
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file SensorSchedule.h
+ * @brief Per sensor sampling periods on top of the log period.
+ *
+ * A slow changing sensor (soil moisture) does not need reading as often as a
+ * fast one (solar). Each sensor can be given its own period. A data pass then
+ * only powers up and reads the sensors that are due, so slow sensors stop
+ * costing port switching and bus time on every log. A sensor is due once its
+ * deadline is less than the tolerance away, so a log landing just before a
+ * deadline still reads it rather than waiting a whole log period.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef SENSOR_SCHEDULE_H
+#define SENSOR_SCHEDULE_H
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Sampling deadline of every sensor, by index in the sensors vector
+ *
+ * Sensors with period 0, or beyond the configured range, are due on every pass.
+ */
+class SensorSchedule {
+public:
+    SensorSchedule();
+
+    /**
+     * @brief Set the period of every sensor, all are due on the next pass
+     * @param periodsMs Period of each sensor index, 0 for every pass
+     * @param toleranceMs How early a sensor may be read, usually half the log period
+     */
+    void configure(const std::vector<unsigned long>& periodsMs, unsigned long toleranceMs, unsigned long now);
+
+    bool isDue(uint16_t index, unsigned long now) const;
+
+    /**
+     * @brief Take the sensor for this pass if it is due and move it to its next deadline
+     *
+     * A sensor that is not due is counted as skipped.
+     */
+    bool take(uint16_t index, unsigned long now);
+
+    uint16_t getSkipped() const { return m_skipped; } ///< Sensor reads left out since resetCounters()
+    void resetCounters() { m_skipped = 0; }
+
+private:
+    struct Entry {
+        unsigned long period;
+        unsigned long due;
+    };
+
+    std::vector<Entry> m_entries;
+    unsigned long m_tolerance;
+    uint16_t m_skipped;
+};
+
+#endif // SENSOR_SCHEDULE_H
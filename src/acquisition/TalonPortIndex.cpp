@@ -0,0 +1,25 @@
+/**
+ * @file TalonPortIndex.cpp
+ * @brief Implementation of TalonPortIndex class
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "TalonPortIndex.h"
+
+const uint8_t TalonPortIndex::MAX_PORTS;
+
+TalonPortIndex::TalonPortIndex() {
+    clear();
+}
+
+void TalonPortIndex::clear() {
+    for (uint8_t port = 0; port <= MAX_PORTS; port++) {
+        m_index[port] = -1;
+    }
+}
+
+void TalonPortIndex::assign(uint8_t port, int talonIndex) {
+    if (port > MAX_PORTS || talonIndex < 0) return;
+    if (m_index[port] < 0) m_index[port] = talonIndex;
+}
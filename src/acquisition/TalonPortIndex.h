@@ -0,0 +1,57 @@
+/**
+ * @file TalonPortIndex.h
+ * @brief Port indexed table from Kestrel Talon port to position in the talons vector.
+ *
+ * getIndexOfPort() is called for every sensor in every pass, in sleepSensors()
+ * and during detection. A table indexed by port answers in constant time
+ * instead of scanning the talons vector each call.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef TALON_PORT_INDEX_H
+#define TALON_PORT_INDEX_H
+
+#include <stdint.h>
+
+/**
+ * @brief Maps a Talon port to the index of the Talon assigned to it
+ *
+ * The table does not observe the Talons, it must be rebuilt (clear() then
+ * assign() for each Talon in vector order) whenever the talons vector is
+ * rebuilt or any Talon port changes. Port 0 maps to the first Talon that has
+ * not been assigned a port, matching the linear search it replaces.
+ */
+class TalonPortIndex {
+public:
+    static const uint8_t MAX_PORTS = 8;
+
+    TalonPortIndex();
+
+    /**
+     * @brief Forget every assignment
+     */
+    void clear();
+
+    /**
+     * @brief Record the Talon at talonIndex as using port
+     *
+     * The first Talon assigned to a port wins, later ones on the same port are
+     * ignored, as the linear search would never have reached them.
+     */
+    void assign(uint8_t port, int talonIndex);
+
+    /**
+     * @brief Index of the Talon on port
+     * @return Index in the talons vector, -1 if no Talon uses the port
+     */
+    int indexOf(int port) const {
+        if (port < 0 || port > MAX_PORTS) return -1;
+        return m_index[port];
+    }
+
+private:
+    int16_t m_index[MAX_PORTS + 1]; ///< Entry 0 holds the first undetected Talon
+};
+
+#endif // TALON_PORT_INDEX_H
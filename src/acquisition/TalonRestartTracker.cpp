@@ -0,0 +1,54 @@
+/**
+ * @file TalonRestartTracker.cpp
+ * @brief Implementation of TalonRestartTracker class
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "TalonRestartTracker.h"
+
+TalonRestartTracker::TalonRestartTracker()
+    : m_restarts(0), m_restartsSkipped(0), m_timeSavedMs(0) {
+    for (uint8_t i = 0; i < MAX_PORTS; i++) {
+        m_valid[i] = false;
+        m_held[i] = false;
+        m_lastDurationMs[i] = 0;
+    }
+}
+
+void TalonRestartTracker::beginCycle() {
+    for (uint8_t i = 0; i < MAX_PORTS; i++) {
+        m_valid[i] = false;
+        m_held[i] = false;
+    }
+    m_restarts = 0;
+    m_restartsSkipped = 0;
+    m_timeSavedMs = 0;
+}
+
+bool TalonRestartTracker::needsRestart(uint8_t port) {
+    if (isHeld(port)) return false; // Not a skip, the restart is only deferred
+    if (!isValid(port)) return true;
+    m_restartsSkipped++;
+    m_timeSavedMs += m_lastDurationMs[port - 1];
+    return false;
+}
+
+void TalonRestartTracker::recordRestart(uint8_t port, uint32_t durationMs) {
+    m_restarts++;
+    if (!tracked(port)) return;
+    m_valid[port - 1] = true;
+    m_lastDurationMs[port - 1] = durationMs;
+}
+
+void TalonRestartTracker::invalidate(uint8_t port) {
+    if (tracked(port)) m_valid[port - 1] = false;
+}
+
+void TalonRestartTracker::hold(uint8_t port) {
+    if (tracked(port)) m_held[port - 1] = true;
+}
+
+void TalonRestartTracker::releaseAll() {
+    for (uint8_t i = 0; i < MAX_PORTS; i++) m_held[i] = false;
+}
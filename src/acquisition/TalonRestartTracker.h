@@ -0,0 +1,88 @@
+/**
+ * @file TalonRestartTracker.h
+ * @brief Tracks which Talons have a valid state so restarts happen once per cycle.
+ *
+ * wakeSensors() restarts every Talon at the start of a cycle. Restarting it
+ * again for each attached sensor only repeats the same work, so a Talon is
+ * restarted again only once its state is invalidated, by a power cycle of its
+ * Kestrel port or a reported fault.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef TALON_RESTART_TRACKER_H
+#define TALON_RESTART_TRACKER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Per Talon port restart state and per cycle restart statistics
+ *
+ * Ports are the Kestrel Talon ports (1 based). Ports outside the tracked range
+ * are never considered valid, so they always restart as before.
+ */
+class TalonRestartTracker {
+public:
+    static const uint8_t MAX_PORTS = 8;
+
+    TalonRestartTracker();
+
+    /**
+     * @brief Start a new cycle, every Talon is invalid and counters are reset
+     */
+    void beginCycle();
+
+    /**
+     * @brief Whether the Talon on this port must be restarted before use
+     *
+     * A false result is counted as a skipped restart, with the last measured
+     * restart duration of the port added to the time saved.
+     */
+    bool needsRestart(uint8_t port);
+
+    /**
+     * @brief Mark the Talon on this port as restarted and valid
+     * @param durationMs Time the restart took, used to estimate time saved
+     */
+    void recordRestart(uint8_t port, uint32_t durationMs);
+
+    /**
+     * @brief Talon state can no longer be trusted (power cycled, fault reported)
+     */
+    void invalidate(uint8_t port);
+
+    /**
+     * @brief Keep the Talon on this port running until release()
+     *
+     * Used while SDI-12 measurements started on the Talon are in progress, a
+     * restart would abort them. needsRestart() returns false for a held port
+     * without counting a skip, an invalidation is kept and acted on once the
+     * port is released.
+     */
+    void hold(uint8_t port);
+
+    /**
+     * @brief Release every held port
+     */
+    void releaseAll();
+
+    bool isHeld(uint8_t port) const { return tracked(port) && m_held[port - 1]; }
+
+    bool isValid(uint8_t port) const { return tracked(port) && m_valid[port - 1]; }
+
+    uint16_t getRestarts() const { return m_restarts; }
+    uint16_t getRestartsSkipped() const { return m_restartsSkipped; }
+    uint32_t getTimeSavedMs() const { return m_timeSavedMs; }
+
+private:
+    static bool tracked(uint8_t port) { return port > 0 && port <= MAX_PORTS; }
+
+    bool m_valid[MAX_PORTS];
+    bool m_held[MAX_PORTS];
+    uint32_t m_lastDurationMs[MAX_PORTS]; ///< Kept across cycles, restart time is fairly constant per Talon
+    uint16_t m_restarts;
+    uint16_t m_restartsSkipped;
+    uint32_t m_timeSavedMs;
+};
+
+#endif // TALON_RESTART_TRACKER_H
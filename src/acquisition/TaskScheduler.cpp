@@ -0,0 +1,69 @@
+/**
+ * @file TaskScheduler.cpp
+ * @brief Implementation of the deadline driven task schedule
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "TaskScheduler.h"
+#include <string.h>
+
+TaskScheduler::TaskScheduler()
+{
+    memset(m_tasks, 0, sizeof(m_tasks));
+}
+
+void TaskScheduler::setTask(uint8_t id, unsigned long periodMs, uint8_t priority, unsigned long now)
+{
+    if (id >= MAX_TASKS) return;
+    Task& task = m_tasks[id];
+    task.priority = priority;
+    if (task.period == periodMs) return; //Keep the phase
+    task.period = periodMs;
+    task.due = now + periodMs;
+    task.runs = 0;
+    task.missed = 0;
+    task.maxLate = 0;
+}
+
+int TaskScheduler::takeNext(unsigned long now)
+{
+    int next = -1;
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        if (isDue(m_tasks[i], now) && (next < 0 || m_tasks[i].priority < m_tasks[next].priority)) next = i;
+    }
+    if (next >= 0) complete(m_tasks[next], now);
+    return next;
+}
+
+bool TaskScheduler::take(uint8_t id, unsigned long now)
+{
+    if (id >= MAX_TASKS || !isDue(m_tasks[id], now)) return false;
+    complete(m_tasks[id], now);
+    return true;
+}
+
+unsigned long TaskScheduler::timeUntilNext(unsigned long now) const
+{
+    unsigned long earliest = 0xFFFFFFFFUL;
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        const Task& task = m_tasks[i];
+        if (task.period == 0) continue;
+        if (isDue(task, now)) return 0;
+        if (task.due - now < earliest) earliest = task.due - now;
+    }
+    return earliest;
+}
+
+void TaskScheduler::complete(Task& task, unsigned long now)
+{
+    unsigned long late = now - task.due;
+    if (late > task.maxLate) task.maxLate = late;
+    task.runs++;
+    task.due += task.period;
+    if ((long)(task.due - now) <= 0) { //Whole periods passed, run once and rejoin the grid
+        unsigned long skipped = (now - task.due) / task.period + 1;
+        task.missed += skipped;
+        task.due += skipped * task.period;
+    }
+}
@@ -0,0 +1,85 @@
+/**
+ * @file TaskScheduler.h
+ * @brief Deadline driven schedule for the periodic work of loop().
+ *
+ * Sampling, diagnostics, metadata, backhaul, time sync and location update
+ * each get a period and a priority instead of being derived from a cycle
+ * count. Deadlines sit on a fixed grid from when the task was scheduled, so a
+ * late run does not push the following ones back, and a run that misses whole
+ * periods skips them rather than running them back to back. The caller sets
+ * the RTC alarm for timeUntilNext() and sleeps until then.
+ *
+ * Times are millis(), compared so that rollover is harmless.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Fixed table of periodic tasks, identified by the caller's task IDs
+ */
+class TaskScheduler {
+public:
+    static const uint8_t MAX_TASKS = 8;
+
+    TaskScheduler();
+
+    /**
+     * @brief Set the period and priority of a task
+     *
+     * A task whose period is unchanged keeps its deadline, so reloading the
+     * configuration does not shift the schedule. Otherwise it is first due one
+     * period from now.
+     *
+     * @param id Task ID, below MAX_TASKS
+     * @param periodMs Period, 0 disables the task
+     * @param priority Lower runs first when several tasks are due
+     */
+    void setTask(uint8_t id, unsigned long periodMs, uint8_t priority, unsigned long now);
+
+    bool isEnabled(uint8_t id) const { return id < MAX_TASKS && m_tasks[id].period > 0; }
+    unsigned long getPeriod(uint8_t id) const { return id < MAX_TASKS ? m_tasks[id].period : 0; }
+
+    /**
+     * @brief Take the highest priority task that is due and move it to its next deadline
+     * @return Task ID, or -1 if nothing is due
+     */
+    int takeNext(unsigned long now);
+
+    /**
+     * @brief Take this task if it is due, used to fold it into a run of another task
+     */
+    bool take(uint8_t id, unsigned long now);
+
+    /**
+     * @brief Time until the earliest deadline, 0 if a task is due
+     * @return Milliseconds, or 0xFFFFFFFF if no task is enabled
+     */
+    unsigned long timeUntilNext(unsigned long now) const;
+
+    // Statistics since the task was last set
+    unsigned long getRuns(uint8_t id) const { return id < MAX_TASKS ? m_tasks[id].runs : 0; }
+    unsigned long getMissed(uint8_t id) const { return id < MAX_TASKS ? m_tasks[id].missed : 0; } ///< Deadlines skipped because a run was more than a period late
+    unsigned long getMaxLateMs(uint8_t id) const { return id < MAX_TASKS ? m_tasks[id].maxLate : 0; } ///< Longest a run started after its deadline
+
+private:
+    struct Task {
+        unsigned long period;
+        unsigned long due;
+        uint8_t priority;
+        unsigned long runs;
+        unsigned long missed;
+        unsigned long maxLate;
+    };
+
+    static bool isDue(const Task& task, unsigned long now) { return task.period > 0 && (long)(task.due - now) <= 0; }
+    void complete(Task& task, unsigned long now);
+
+    Task m_tasks[MAX_TASKS];
+};
+
+#endif // TASK_SCHEDULER_H
@@ -0,0 +1,99 @@
+/**
+ * @file ConfigImage.cpp
+ * @brief Implementation of ConfigImage class
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "ConfigImage.h"
+#include <stddef.h>
+#include <string.h>
+
+#ifndef TESTING
+#include "Particle.h"
+#else
+#include "MockParticle.h"
+#endif
+
+const int ConfigImage::EEPROM_ADDR;
+const uint8_t ConfigImage::VERSION;
+const uint8_t ConfigImage::MAX_PERIODS;
+const uint8_t ConfigImage::VALID_MARKER;
+
+ConfigImage::ConfigImage() {
+    clear();
+}
+
+void ConfigImage::clear() {
+    memset(&m_image, 0, sizeof(m_image)); //Padding included, so equal images have equal checksums
+}
+
+void ConfigImage::setValue(Field field, int32_t value) {
+    if (field < FIELD_COUNT) m_image.values[field] = value;
+}
+
+int32_t ConfigImage::getValue(Field field) const {
+    if (field >= FIELD_COUNT) return 0;
+    return m_image.values[field];
+}
+
+bool ConfigImage::addPeriod(uint8_t type, uint8_t instance, uint32_t seconds) {
+    if (m_image.periodCount >= MAX_PERIODS) return false;
+    Period& period = m_image.periods[m_image.periodCount++];
+    period.seconds = seconds;
+    period.type = type;
+    period.instance = instance;
+    return true;
+}
+
+uint8_t ConfigImage::getPeriodType(uint8_t index) const {
+    if (index >= m_image.periodCount) return 0;
+    return m_image.periods[index].type;
+}
+
+uint8_t ConfigImage::getPeriodInstance(uint8_t index) const {
+    if (index >= m_image.periodCount) return 0;
+    return m_image.periods[index].instance;
+}
+
+uint32_t ConfigImage::getPeriodSeconds(uint8_t index) const {
+    if (index >= m_image.periodCount) return 0;
+    return m_image.periods[index].seconds;
+}
+
+uint16_t ConfigImage::computeChecksum(const Image& image) {
+    //CRC-16/CCITT over everything but the checksum itself
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(&image);
+    size_t len = offsetof(Image, checksum);
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+bool ConfigImage::save() {
+    m_image.marker = VALID_MARKER;
+    m_image.version = VERSION;
+    m_image.fieldCount = FIELD_COUNT;
+    m_image.checksum = computeChecksum(m_image);
+    EEPROM.put(EEPROM_ADDR, m_image);
+    return true;
+}
+
+bool ConfigImage::load() {
+    Image stored;
+    EEPROM.get(EEPROM_ADDR, stored);
+    if (stored.marker != VALID_MARKER || stored.version != VERSION) return false; //Never written, or another layout
+    if (stored.fieldCount != FIELD_COUNT || stored.periodCount > MAX_PERIODS) return false;
+    if (stored.checksum != computeChecksum(stored)) return false;
+    m_image = stored;
+    return true;
+}
+
+void ConfigImage::erase() {
+    EEPROM.put(EEPROM_ADDR, (uint8_t)0xFF); //Clearing the marker is enough to invalidate the image
+}
@@ -0,0 +1,119 @@
+/**
+ * @file ConfigImage.h
+ * @brief Versioned binary copy of the full configuration in EEPROM.
+ *
+ * The EEPROM backup used to be the system and sensor configuration UIDs,
+ * decoded back into values on load. The UIDs pack logPeriod into 16 bits,
+ * Talon counts into 2 and sensor counts into 4, and leave out the encoding,
+ * buffering and sampling period settings, so larger stations could not be
+ * restored. The image holds every value at full width plus the sampling
+ * periods, behind a version byte and a CRC, and loads with one EEPROM read.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef CONFIG_IMAGE_H
+#define CONFIG_IMAGE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Configuration values and sampling periods, saved to and loaded from EEPROM
+ *
+ * Values are indexed by Field. Periods are stored by sensor type index and
+ * instance, the caller maps type names to indexes. A layout change must bump
+ * VERSION, an image of another version does not load.
+ */
+class ConfigImage {
+public:
+    static const int EEPROM_ADDR = 1024; ///< Clear of accel offsets (0-11), UID backup (16-24) and DetectionMap (512)
+    static const uint8_t VERSION = 1;
+    static const uint8_t MAX_PERIODS = 32;
+
+    enum Field : uint8_t {
+        LOG_PERIOD = 0,
+        BACKHAUL_COUNT,
+        POWER_SAVE_MODE,
+        LOGGING_MODE,
+        NUM_AUX_TALONS,
+        NUM_I2C_TALONS,
+        NUM_SDI12_TALONS,
+        PACKET_ENCODING,
+        KEYFRAME_INTERVAL,
+        DIFF_DEADBAND,
+        BATCH_DEADLINE,
+        SD_DEADLINE,
+        NUM_ET,
+        NUM_HAAR,
+        NUM_SOIL,
+        NUM_APOGEE_SOLAR,
+        NUM_CO2,
+        NUM_O2,
+        NUM_PRESSURE,
+        NUM_ANALOG_MUX,
+        FIELD_COUNT
+    };
+
+    ConfigImage();
+
+    /**
+     * @brief Zero all values and drop all periods
+     */
+    void clear();
+
+    void setValue(Field field, int32_t value);
+    int32_t getValue(Field field) const;
+
+    /**
+     * @brief Add a sampling period
+     * @param type Caller's sensor type index
+     * @param instance 1 based instance, 0 for every instance of the type
+     * @return false if MAX_PERIODS are already held
+     */
+    bool addPeriod(uint8_t type, uint8_t instance, uint32_t seconds);
+    uint8_t getPeriodCount() const { return m_image.periodCount; }
+    uint8_t getPeriodType(uint8_t index) const;
+    uint8_t getPeriodInstance(uint8_t index) const;
+    uint32_t getPeriodSeconds(uint8_t index) const;
+
+    /**
+     * @brief Write the image to EEPROM
+     */
+    bool save();
+
+    /**
+     * @brief Read the image from EEPROM
+     * @return true only if an intact image of this VERSION is stored
+     */
+    bool load();
+
+    /**
+     * @brief Invalidate the stored image
+     */
+    void erase();
+
+private:
+    struct Period {
+        uint32_t seconds;
+        uint8_t type;
+        uint8_t instance;
+    };
+
+    struct Image {
+        uint8_t marker;
+        uint8_t version;
+        uint8_t fieldCount;
+        uint8_t periodCount;
+        int32_t values[FIELD_COUNT];
+        Period periods[MAX_PERIODS];
+        uint16_t checksum;
+    };
+
+    static const uint8_t VALID_MARKER = 0xC5;
+
+    static uint16_t computeChecksum(const Image& image);
+
+    Image m_image;
+};
+
+#endif // CONFIG_IMAGE_H
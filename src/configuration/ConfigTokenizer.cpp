@@ -0,0 +1,257 @@
+/**
+ * @file ConfigTokenizer.cpp
+ * @brief Implementation of the single pass configuration scanner
+ *
+ * Nesting is tracked on a fixed stack rather than by recursion, so malformed
+ * input can not run the stack out.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "ConfigTokenizer.h"
+#include <limits.h>
+#include <string.h>
+
+ConfigTokenizer::ConfigTokenizer()
+    : m_json(nullptr),
+      m_length(0),
+      m_pos(0),
+      m_depth(0),
+      m_handler(nullptr),
+      m_context(nullptr),
+      m_error(ERROR_NONE),
+      m_errorOffset(0)
+{
+}
+
+bool ConfigTokenizer::parse(const char* json, size_t length, FieldHandler handler, void* context)
+{
+    m_json = json;
+    m_length = json == nullptr ? 0 : length;
+    m_pos = 0;
+    m_depth = 0;
+    m_handler = handler;
+    m_context = context;
+    m_error = ERROR_NONE;
+    m_errorOffset = 0;
+
+    skipWhitespace();
+    if (!parseValue(nullptr, 0)) return false; //Top level value has no name and is not reported
+    while (m_depth > 0) {
+        Frame& frame = m_stack[m_depth - 1];
+        char close = frame.isObject ? '}' : ']';
+        skipWhitespace();
+        if (m_pos >= m_length) return fail(ERROR_UNEXPECTED_END);
+        char c = m_json[m_pos];
+        if (frame.needsSeparator) {
+            if (c == ',') {
+                m_pos++;
+                frame.needsSeparator = false;
+                frame.afterComma = true;
+            }
+            else if (c == close) {
+                m_pos++;
+                m_depth--;
+            }
+            else return fail(ERROR_UNEXPECTED_CHARACTER);
+            continue;
+        }
+        if (c == close && !frame.afterComma) { //Empty object or array
+            m_pos++;
+            m_depth--;
+            continue;
+        }
+        frame.needsSeparator = true; //Set before the value, which may push a new frame
+        frame.afterComma = false;
+        if (frame.isObject) {
+            const char* name;
+            size_t nameLength;
+            if (c != '"') return fail(ERROR_UNEXPECTED_CHARACTER);
+            if (!parseString(name, nameLength)) return false;
+            skipWhitespace();
+            if (m_pos >= m_length) return fail(ERROR_UNEXPECTED_END);
+            if (m_json[m_pos] != ':') return fail(ERROR_UNEXPECTED_CHARACTER);
+            m_pos++;
+            skipWhitespace();
+            if (!parseValue(name, nameLength)) return false;
+        }
+        else if (!parseValue(nullptr, 0)) return false;
+    }
+    skipWhitespace();
+    if (m_pos < m_length) return fail(ERROR_TRAILING_CHARACTERS);
+    return true;
+}
+
+const char* ConfigTokenizer::describe(Error error)
+{
+    switch (error) {
+        case ERROR_NONE: return "no error";
+        case ERROR_UNEXPECTED_END: return "unexpected end of input";
+        case ERROR_UNEXPECTED_CHARACTER: return "unexpected character";
+        case ERROR_BAD_STRING: return "invalid string";
+        case ERROR_BAD_NUMBER: return "invalid number";
+        case ERROR_BAD_LITERAL: return "invalid literal";
+        case ERROR_TOO_DEEP: return "nesting too deep";
+        case ERROR_TRAILING_CHARACTERS: return "characters after the document";
+    }
+    return "unknown error";
+}
+
+bool ConfigTokenizer::matches(const char* span, size_t length, const char* name)
+{
+    return strlen(name) == length && memcmp(span, name, length) == 0;
+}
+
+bool ConfigTokenizer::parseValue(const char* name, size_t nameLength)
+{
+    if (m_pos >= m_length) return fail(ERROR_UNEXPECTED_END);
+    const char* start = m_json + m_pos;
+    char c = *start;
+    if (c == '{' || c == '[') {
+        if (m_depth >= MAX_DEPTH) return fail(ERROR_TOO_DEEP);
+        report(name, nameLength, c == '{' ? VALUE_OBJECT : VALUE_ARRAY, start, 1, 0);
+        m_stack[m_depth++] = {c == '{', name == nullptr ? "" : name, name == nullptr ? 0 : nameLength, false, false};
+        m_pos++;
+        return true;
+    }
+    if (c == '"') {
+        const char* value;
+        size_t valueLength;
+        if (!parseString(value, valueLength)) return false;
+        report(name, nameLength, VALUE_STRING, value, valueLength, 0);
+        return true;
+    }
+    if (c == '-' || (c >= '0' && c <= '9')) {
+        long number;
+        if (!parseNumber(number)) return false;
+        report(name, nameLength, VALUE_NUMBER, start, (m_json + m_pos) - start, number);
+        return true;
+    }
+    if (c == 't') {
+        if (!parseLiteral("true")) return false;
+        report(name, nameLength, VALUE_TRUE, start, 4, 1);
+        return true;
+    }
+    if (c == 'f') {
+        if (!parseLiteral("false")) return false;
+        report(name, nameLength, VALUE_FALSE, start, 5, 0);
+        return true;
+    }
+    if (c == 'n') {
+        if (!parseLiteral("null")) return false;
+        report(name, nameLength, VALUE_NULL, start, 4, 0);
+        return true;
+    }
+    return fail(ERROR_UNEXPECTED_CHARACTER);
+}
+
+bool ConfigTokenizer::parseString(const char*& start, size_t& length)
+{
+    m_pos++; //Opening quote
+    start = m_json + m_pos;
+    while (m_pos < m_length) {
+        unsigned char c = (unsigned char)m_json[m_pos];
+        if (c == '"') {
+            length = (m_json + m_pos) - start;
+            m_pos++;
+            return true;
+        }
+        if (c < 0x20) return fail(ERROR_BAD_STRING);
+        if (c == '\\') {
+            m_pos++;
+            if (m_pos >= m_length) break;
+            c = (unsigned char)m_json[m_pos];
+            if (c == 'u') {
+                for (uint8_t i = 0; i < 4; i++) {
+                    m_pos++;
+                    if (m_pos >= m_length) return fail(ERROR_UNEXPECTED_END);
+                    char h = m_json[m_pos];
+                    if (!((h >= '0' && h <= '9') || (h >= 'a' && h <= 'f') || (h >= 'A' && h <= 'F'))) return fail(ERROR_BAD_STRING);
+                }
+            }
+            else if (strchr("\"\\/bfnrt", c) == nullptr || c == '\0') return fail(ERROR_BAD_STRING);
+        }
+        m_pos++;
+    }
+    return fail(ERROR_UNEXPECTED_END);
+}
+
+bool ConfigTokenizer::parseNumber(long& number)
+{
+    bool negative = false;
+    if (m_json[m_pos] == '-') {
+        negative = true;
+        m_pos++;
+    }
+    if (m_pos >= m_length) return fail(ERROR_UNEXPECTED_END);
+    char c = m_json[m_pos];
+    if (c < '0' || c > '9') return fail(ERROR_BAD_NUMBER);
+    number = 0;
+    if (c == '0') m_pos++; //No leading zeros
+    else {
+        while (m_pos < m_length && m_json[m_pos] >= '0' && m_json[m_pos] <= '9') {
+            int digit = m_json[m_pos] - '0';
+            if (negative) number = number < (LONG_MIN + digit) / 10 ? LONG_MIN : number * 10 - digit;
+            else number = number > (LONG_MAX - digit) / 10 ? LONG_MAX : number * 10 + digit;
+            m_pos++;
+        }
+    }
+    if (m_pos < m_length && m_json[m_pos] == '.') {
+        m_pos++;
+        if (m_pos >= m_length) return fail(ERROR_UNEXPECTED_END);
+        if (m_json[m_pos] < '0' || m_json[m_pos] > '9') return fail(ERROR_BAD_NUMBER);
+        while (m_pos < m_length && m_json[m_pos] >= '0' && m_json[m_pos] <= '9') m_pos++;
+    }
+    if (m_pos < m_length && (m_json[m_pos] == 'e' || m_json[m_pos] == 'E')) {
+        m_pos++;
+        if (m_pos < m_length && (m_json[m_pos] == '+' || m_json[m_pos] == '-')) m_pos++;
+        if (m_pos >= m_length) return fail(ERROR_UNEXPECTED_END);
+        if (m_json[m_pos] < '0' || m_json[m_pos] > '9') return fail(ERROR_BAD_NUMBER);
+        while (m_pos < m_length && m_json[m_pos] >= '0' && m_json[m_pos] <= '9') m_pos++;
+    }
+    return true;
+}
+
+bool ConfigTokenizer::parseLiteral(const char* literal)
+{
+    for (const char* l = literal; *l != '\0'; l++) {
+        if (m_pos >= m_length) return fail(ERROR_UNEXPECTED_END);
+        if (m_json[m_pos] != *l) return fail(ERROR_BAD_LITERAL);
+        m_pos++;
+    }
+    return true;
+}
+
+void ConfigTokenizer::skipWhitespace()
+{
+    while (m_pos < m_length) {
+        char c = m_json[m_pos];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') return;
+        m_pos++;
+    }
+}
+
+bool ConfigTokenizer::fail(Error error)
+{
+    m_error = error;
+    m_errorOffset = m_pos < m_length ? m_pos : m_length;
+    return false;
+}
+
+void ConfigTokenizer::report(const char* name, size_t nameLength, ValueType type, const char* value, size_t valueLength, long number)
+{
+    if (m_handler == nullptr || name == nullptr) return; //Top level value or array element
+    for (uint8_t i = 0; i < m_depth; i++) {
+        if (!m_stack[i].isObject) return; //Inside an array
+    }
+    Field field;
+    field.section = m_depth > 0 ? m_stack[m_depth - 1].name : "";
+    field.sectionLength = m_depth > 0 ? m_stack[m_depth - 1].nameLength : 0;
+    field.name = name;
+    field.nameLength = nameLength;
+    field.type = type;
+    field.value = value;
+    field.valueLength = valueLength;
+    field.number = number;
+    m_handler(field, m_context);
+}
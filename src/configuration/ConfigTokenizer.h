@@ -0,0 +1,110 @@
+/**
+ * @file ConfigTokenizer.h
+ * @brief Single pass, allocation free JSON scanner for the configuration.
+ *
+ * The configuration parser used to strip whitespace into a copy, then search
+ * the copy once per key and once more per section bracket, so parse time grew
+ * with keys times length. The tokenizer walks the input once, validates it as
+ * JSON and hands every object member to a callback as it passes. Names and
+ * values are spans into the input, nothing is copied or allocated. On a syntax
+ * error parsing stops and the byte offset of the error is kept.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef CONFIG_TOKENIZER_H
+#define CONFIG_TOKENIZER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Validating JSON scanner reporting object members through a callback
+ *
+ * Array elements are validated but not reported, the configuration has none.
+ */
+class ConfigTokenizer {
+public:
+    static const uint8_t MAX_DEPTH = 16; ///< Deepest nesting of objects and arrays accepted
+
+    enum Error {
+        ERROR_NONE = 0,
+        ERROR_UNEXPECTED_END,       ///< Input ended inside a value
+        ERROR_UNEXPECTED_CHARACTER, ///< Character not valid at this point
+        ERROR_BAD_STRING,           ///< Control character or bad escape in a string
+        ERROR_BAD_NUMBER,           ///< Malformed number
+        ERROR_BAD_LITERAL,          ///< Not true, false or null
+        ERROR_TOO_DEEP,             ///< Nesting beyond MAX_DEPTH
+        ERROR_TRAILING_CHARACTERS   ///< Anything but whitespace after the top level value
+    };
+
+    enum ValueType {
+        VALUE_OBJECT, ///< Reported when the object opens, its members follow
+        VALUE_ARRAY,  ///< Reported when the array opens, its elements are not reported
+        VALUE_STRING, ///< value spans the contents, escapes left as written
+        VALUE_NUMBER, ///< number holds the integer part, value spans the text
+        VALUE_TRUE,
+        VALUE_FALSE,
+        VALUE_NULL
+    };
+
+    struct Field {
+        const char* section;   ///< Name of the enclosing object, empty for the top level object
+        size_t sectionLength;
+        const char* name;      ///< Member name, escapes left as written
+        size_t nameLength;
+        ValueType type;
+        const char* value;
+        size_t valueLength;
+        long number;           ///< Integer part of a number (saturated), 1 for true, 0 otherwise
+    };
+
+    typedef void (*FieldHandler)(const Field& field, void* context);
+
+    ConfigTokenizer();
+
+    /**
+     * @brief Scan a complete JSON document
+     * @param handler Called for every object member in document order, may be null to only validate
+     * @return true if the whole input is one valid JSON value
+     */
+    bool parse(const char* json, size_t length, FieldHandler handler, void* context);
+
+    Error getError() const { return m_error; }
+    size_t getErrorOffset() const { return m_errorOffset; } ///< Byte offset of the first invalid character, or length if it ended early
+    static const char* describe(Error error);
+
+    /**
+     * @brief Compare a span from a Field against a null terminated name
+     */
+    static bool matches(const char* span, size_t length, const char* name);
+
+private:
+    struct Frame {
+        bool isObject;
+        const char* name; ///< Name of this object or array in its parent
+        size_t nameLength;
+        bool needsSeparator; ///< A member was read, next comes ',' or the close
+        bool afterComma; ///< A ',' was read, next comes a member
+    };
+
+    bool parseValue(const char* name, size_t nameLength);
+    bool parseString(const char*& start, size_t& length);
+    bool parseNumber(long& number);
+    bool parseLiteral(const char* literal);
+    void skipWhitespace();
+    bool fail(Error error);
+    void report(const char* name, size_t nameLength, ValueType type, const char* value, size_t valueLength, long number);
+
+    const char* m_json;
+    size_t m_length;
+    size_t m_pos;
+    Frame m_stack[MAX_DEPTH];
+    uint8_t m_depth;
+    FieldHandler m_handler;
+    void* m_context;
+    Error m_error;
+    size_t m_errorOffset;
+};
+
+#endif // CONFIG_TOKENIZER_H
@@ -6,8 +6,10 @@
  */
 
  #include "ConfigurationManager.h"
+ #include "ConfigImage.h"
  #include <algorithm>
  #include <cctype>
+ #include <string.h>
  
  #ifndef TESTING
  #include "Particle.h"
@@ -22,7 +24,91 @@
  const int ConfigurationManager::EEPROM_CONFIG_VALID_FLAG;
  const uint8_t ConfigurationManager::EEPROM_VALID_MARKER;
 
- ConfigurationManager::ConfigurationManager() {};
+ namespace {
+
+ using SensorTypes::Kind;
+
+ struct ParseContext {
+     ConfigurationManager* config;
+     bool system;  // A system section was seen
+     bool sensors; // A sensors section was seen
+ };
+
+ // Integer value of a field, strings are read as numbers as before, anything else keeps the default
+ int fieldInt(const ConfigTokenizer::Field& field, int defaultValue) {
+     switch (field.type) {
+         case ConfigTokenizer::VALUE_NUMBER:
+         case ConfigTokenizer::VALUE_TRUE:
+         case ConfigTokenizer::VALUE_FALSE:
+             return (int)field.number;
+         case ConfigTokenizer::VALUE_STRING: {
+             char digits[16];
+             size_t length = std::min(field.valueLength, sizeof(digits) - 1);
+             memcpy(digits, field.value, length);
+             digits[length] = '\0';
+             return atoi(digits);
+         }
+         default:
+             return defaultValue;
+     }
+ }
+
+ bool isSection(const ConfigTokenizer::Field& field, const char* name) {
+     return ConfigTokenizer::matches(field.section, field.sectionLength, name);
+ }
+
+ bool isField(const ConfigTokenizer::Field& field, const char* name) {
+     return ConfigTokenizer::matches(field.name, field.nameLength, name);
+ }
+
+ // Type named by a field after a prefix, as in "numSoil" or "periodSoil"
+ bool fieldType(const ConfigTokenizer::Field& field, const char* prefix, SensorTypes::Section section, size_t nameLength, Kind& kind) {
+     size_t prefixLength = strlen(prefix);
+     if (nameLength <= prefixLength || memcmp(field.name, prefix, prefixLength) != 0) return false;
+     return SensorTypes::find(section, field.name + prefixLength, nameLength - prefixLength, kind);
+ }
+
+ // Place of a count in its UID, Talons 2 bits each in the system UID from bit 6 down, sensors 4 bits each in the sensor UID from bit 28 down
+ int uidShift(const SensorTypes::TypeInfo& type) {
+     return type.section == SensorTypes::SECTION_SYSTEM ? 6 - 2 * type.slot : 28 - 4 * type.slot;
+ }
+
+ int uidMask(const SensorTypes::TypeInfo& type) {
+     return type.section == SensorTypes::SECTION_SYSTEM ? 0x3 : 0xF;
+ }
+
+ // ConfigImage holds the counts of each section in slot order
+ static_assert(ConfigImage::NUM_SDI12_TALONS == ConfigImage::NUM_AUX_TALONS + SensorTypes::NUM_SYSTEM_SLOTS - 1, "Talon count fields must follow slot order");
+ static_assert(ConfigImage::NUM_ANALOG_MUX == ConfigImage::NUM_ET + SensorTypes::NUM_SENSOR_SLOTS - 1, "Sensor count fields must follow slot order");
+
+ ConfigImage::Field imageField(Kind kind) {
+     const SensorTypes::TypeInfo& type = SensorTypes::get(kind);
+     int first = type.section == SensorTypes::SECTION_SYSTEM ? ConfigImage::NUM_AUX_TALONS : ConfigImage::NUM_ET;
+     return (ConfigImage::Field)(first + type.slot);
+ }
+
+ // "num<Type>":count of each type in a section, in slot order
+ void appendCounts(std::string& config, const int* counts, SensorTypes::Section section, uint8_t slots) {
+     for (uint8_t slot = 0; slot < slots; slot++) {
+         Kind kind;
+         if (!SensorTypes::findSlot(section, slot, kind)) continue;
+         config += "\"num";
+         config += SensorTypes::get(kind).name;
+         config += "\":" + std::to_string(counts[kind]) + ",";
+     }
+ }
+
+ } // namespace
+
+ ConfigurationManager::ConfigurationManager() : m_SystemConfigUid(0), m_SensorConfigUid(0), m_parseError(ConfigTokenizer::ERROR_NONE), m_parseErrorOffset(0) {
+     resetSystemDefaults();
+     resetSensorDefaults();
+ }
+
+ std::string ConfigurationManager::getDefaultConfigurationJson() const {
+     ConfigurationManager defaults;
+     return defaults.getConfiguration();
+ }
  
 
  bool ConfigurationManager::setConfiguration(std::string config) {
@@ -44,22 +130,22 @@
      config += "\"backhaulCount\":" + std::to_string(m_backhaulCount) + ",";
      config += "\"powerSaveMode\":" + std::to_string(m_powerSaveMode) + ",";
      config += "\"loggingMode\":" + std::to_string(m_loggingMode) + ",";
-     config += "\"numAuxTalons\":" + std::to_string(m_numAuxTalons) + ",";
-     config += "\"numI2CTalons\":" + std::to_string(m_numI2CTalons) + ",";
-     config += "\"numSDI12Talons\":" + std::to_string(m_numSDI12Talons);
+     appendCounts(config, m_counts, SensorTypes::SECTION_SYSTEM, SensorTypes::NUM_SYSTEM_SLOTS);
+     config += "\"packetEncoding\":" + std::to_string(m_packetEncoding) + ",";
+     config += "\"keyframeInterval\":" + std::to_string(m_keyframeInterval) + ",";
+     config += "\"diffDeadband\":" + std::to_string(m_diffDeadband) + ",";
+     config += "\"batchDeadline\":" + std::to_string(m_batchDeadline) + ",";
+     config += "\"sdDeadline\":" + std::to_string(m_sdDeadline);
      config += "},";
      
      // Sensor configuration
      config += "\"sensors\":{";
-     config += "\"numET\":" + std::to_string(m_numET) + ",";
-     config += "\"numHaar\":" + std::to_string(m_numHaar) + ",";
-     config += "\"numSoil\":" + std::to_string(m_numSoil) + ",";
-     config += "\"numApogeeSolar\":" + std::to_string(m_numApogeeSolar) + ",";
-     config += "\"numCO2\":" + std::to_string(m_numCO2) + ",";
-     config += "\"numO2\":" + std::to_string(m_numO2) + ",";
-     config += "\"numPressure\":" + std::to_string(m_numPressure) + ",";
-     config += "\"numAnalogMux\":" + std::to_string(m_numAnalogMux);
-     config += "}}}";
+     appendCounts(config, m_counts, SensorTypes::SECTION_SENSORS, SensorTypes::NUM_SENSOR_SLOTS);
+     for (const auto& period : m_samplePeriods) {
+         config += "\"period" + period.first + "\":" + std::to_string(period.second) + ",";
+     }
+     config.back() = '}'; //Replaces the last ','
+     config += "}}";
 
      return config;
  }
@@ -69,200 +155,196 @@
     tempUid |= m_backhaulCount << 12;
     tempUid |= m_powerSaveMode << 10;
     tempUid |= m_loggingMode << 8;
-    tempUid |= m_numAuxTalons << 6;
-    tempUid |= m_numI2CTalons << 4;
-    tempUid |= m_numSDI12Talons << 2;
+    for (uint8_t i = 0; i < SensorTypes::NUM_KINDS; i++) {
+        const SensorTypes::TypeInfo& type = SensorTypes::get((Kind)i);
+        if (type.section == SensorTypes::SECTION_SYSTEM) tempUid |= m_counts[i] << uidShift(type);
+    }
+    tempUid |= m_packetEncoding & 0x3;
     m_SystemConfigUid = tempUid; 
     return m_SystemConfigUid;
  }
 
  int ConfigurationManager::updateSensorConfigurationUid() {
-    int tempUid = m_numET << 28;
-    tempUid |= m_numHaar << 24;
-    tempUid |= m_numSoil << 20;
-    tempUid |= m_numApogeeSolar << 16;
-    tempUid |= m_numCO2 << 12;
-    tempUid |= m_numO2 << 8;
-    tempUid |= m_numPressure << 4;
-    tempUid |= m_numAnalogMux;
+    int tempUid = 0;
+    for (uint8_t i = 0; i < SensorTypes::NUM_KINDS; i++) {
+        const SensorTypes::TypeInfo& type = SensorTypes::get((Kind)i);
+        if (type.section == SensorTypes::SECTION_SENSORS) tempUid |= m_counts[i] << uidShift(type);
+    }
     m_SensorConfigUid = tempUid; 
     return m_SensorConfigUid;
  }
- 
 
  bool ConfigurationManager::parseConfiguration(const std::string& configStr) {
-     // Remove all whitespace characters from the config string
-     std::string cleanedConfig = configStr;
-     cleanedConfig.erase(std::remove_if(cleanedConfig.begin(), cleanedConfig.end(),
-                                        [](char c) { return std::isspace(c); }),
-                         cleanedConfig.end());
-     
-     // Find the system configuration section
-     size_t systemStart = cleanedConfig.find("\"system\":{");
-     if (systemStart != std::string::npos) {
-         size_t systemEnd = findMatchingBracket(cleanedConfig, systemStart + 9);
-         if (systemEnd > 0) {
-             std::string systemJson = cleanedConfig.substr(systemStart + 9, systemEnd - (systemStart + 9));
-             
-             // Parse system settings
-             m_logPeriod = extractJsonIntField(systemJson, "logPeriod", 300);
-             m_backhaulCount = extractJsonIntField(systemJson, "backhaulCount", 4);
-             m_powerSaveMode = extractJsonIntField(systemJson, "powerSaveMode", 1);
-             m_loggingMode = extractJsonIntField(systemJson, "loggingMode", 0);
-             m_numAuxTalons = extractJsonIntField(systemJson, "numAuxTalons", 1);
-             m_numI2CTalons = extractJsonIntField(systemJson, "numI2CTalons", 1);
-             m_numSDI12Talons = extractJsonIntField(systemJson, "numSDI12Talons", 1);
-             
-             updateSystemConfigurationUid();
-         }
-     }
-     // Find the sensor configuration section
-     size_t sensorsStart = cleanedConfig.find("\"sensors\":{");
-     if (sensorsStart != std::string::npos) {
-         size_t sensorsEnd = findMatchingBracket(cleanedConfig, sensorsStart + 10);
-         if (sensorsEnd > 0) {
-             std::string sensorsJson = cleanedConfig.substr(sensorsStart + 10, sensorsEnd - (sensorsStart + 10));
-            
-             // Parse sensor settings
-             m_numET = extractJsonIntField(sensorsJson, "numET", 0);
-             m_numHaar = extractJsonIntField(sensorsJson, "numHaar", 0);
-             m_numSoil = extractJsonIntField(sensorsJson, "numSoil", 3);
-             m_numApogeeSolar = extractJsonIntField(sensorsJson, "numApogeeSolar", 0);
-             m_numCO2 = extractJsonIntField(sensorsJson, "numCO2", 0);
-             m_numO2 = extractJsonIntField(sensorsJson, "numO2", 0);
-             m_numPressure = extractJsonIntField(sensorsJson, "numPressure", 0);
-             m_numAnalogMux = extractJsonIntField(sensorsJson, "numAnalogMux", 0);
-
-             updateSensorConfigurationUid();
-         }
+     // One scan over the input into a copy, applied only if the whole document is valid
+     ConfigurationManager staged(*this);
+     ParseContext context = {&staged, false, false};
+     ConfigTokenizer tokenizer;
+     if (!tokenizer.parse(configStr.data(), configStr.length(), applyField, &context)) {
+         m_parseError = tokenizer.getError();
+         m_parseErrorOffset = tokenizer.getErrorOffset();
+         return false;
      }
-     
+     *this = staged;
+     m_parseError = ConfigTokenizer::ERROR_NONE;
+     m_parseErrorOffset = 0;
+     if (context.system) updateSystemConfigurationUid();
+     if (context.sensors) updateSensorConfigurationUid();
      return true;
  }
- 
- std::string ConfigurationManager::extractJsonField(const std::string& json, const std::string& fieldName) {
-     std::string searchStr = "\"" + fieldName + "\":";
-     size_t fieldStart = json.find(searchStr);
-     if (fieldStart == std::string::npos) return "";
-     
-     fieldStart += searchStr.length();
-     // Skip whitespace
-     while (fieldStart < json.length() && isspace(json[fieldStart])) {
-         fieldStart++;
+
+ void ConfigurationManager::applyField(const ConfigTokenizer::Field& field, void* contextPtr) {
+     ParseContext& context = *static_cast<ParseContext*>(contextPtr);
+     ConfigurationManager& config = *context.config;
+     if (field.type == ConfigTokenizer::VALUE_OBJECT) {
+         // A section present in the document starts from defaults, as before
+         if (isField(field, "system")) {
+             config.resetSystemDefaults();
+             context.system = true;
+         }
+         else if (isField(field, "sensors")) {
+             config.resetSensorDefaults();
+             context.sensors = true;
+         }
+         return;
      }
-     
-     // Check if string value
-     if (json[fieldStart] == '"') {
-         size_t valueEnd = json.find('"', fieldStart + 1);
-         if (valueEnd == std::string::npos) return "";
-         return json.substr(fieldStart + 1, valueEnd - fieldStart - 1);
+
+     Kind kind;
+     if (isSection(field, "system")) {
+         if (fieldType(field, "num", SensorTypes::SECTION_SYSTEM, field.nameLength, kind)) config.m_counts[kind] = fieldInt(field, SensorTypes::get(kind).defaultCount);
+         else if (isField(field, "logPeriod")) config.m_logPeriod = fieldInt(field, 300);
+         else if (isField(field, "backhaulCount")) config.m_backhaulCount = fieldInt(field, 4);
+         else if (isField(field, "powerSaveMode")) config.m_powerSaveMode = fieldInt(field, 1);
+         else if (isField(field, "loggingMode")) config.m_loggingMode = fieldInt(field, 0);
+         else if (isField(field, "packetEncoding")) config.m_packetEncoding = fieldInt(field, 0);
+         else if (isField(field, "keyframeInterval")) config.m_keyframeInterval = fieldInt(field, 0);
+         else if (isField(field, "diffDeadband")) config.m_diffDeadband = fieldInt(field, 0);
+         else if (isField(field, "batchDeadline")) config.m_batchDeadline = fieldInt(field, 0);
+         else if (isField(field, "sdDeadline")) config.m_sdDeadline = fieldInt(field, 0);
      }
-     
-     // Must be numeric or boolean value
-     size_t valueEnd = fieldStart;
-     while (valueEnd < json.length() && 
-           (isalnum(json[valueEnd]) || json[valueEnd] == '.' || json[valueEnd] == '-')) {
-         valueEnd++;
+     else if (isSection(field, "sensors")) {
+         if (fieldType(field, "num", SensorTypes::SECTION_SENSORS, field.nameLength, kind)) config.m_counts[kind] = fieldInt(field, SensorTypes::get(kind).defaultCount);
+         else {
+             // Optional sampling periods, "period<Type>" or "period<Type>_<instance>"
+             const char* underscore = (const char*)memchr(field.name, '_', field.nameLength);
+             size_t typeEnd = underscore == nullptr ? field.nameLength : underscore - field.name;
+             if (fieldType(field, "period", SensorTypes::SECTION_SENSORS, typeEnd, kind)) {
+                 std::string key(field.name + 6, field.nameLength - 6);
+                 int period = fieldInt(field, 0);
+                 if (period > 0) config.m_samplePeriods[key] = period;
+                 else config.m_samplePeriods.erase(key);
+             }
+         }
      }
-     
-     return json.substr(fieldStart, valueEnd - fieldStart);
  }
- 
- int ConfigurationManager::extractJsonIntField(const std::string& json, const std::string& fieldName, int defaultValue) {
-     std::string value = extractJsonField(json, fieldName);
-     if (value.empty()) return defaultValue;
-     return atoi(value.c_str());
+
+ void ConfigurationManager::resetSystemDefaults() {
+     m_logPeriod = 300;
+     m_backhaulCount = 4;
+     m_powerSaveMode = 1;
+     m_loggingMode = 0;
+     for (uint8_t i = 0; i < SensorTypes::NUM_KINDS; i++) {
+         const SensorTypes::TypeInfo& type = SensorTypes::get((Kind)i);
+         if (type.section == SensorTypes::SECTION_SYSTEM) m_counts[i] = type.defaultCount;
+     }
+     m_packetEncoding = 0;
+     m_keyframeInterval = 0;
+     m_diffDeadband = 0;
+     m_batchDeadline = 0;
+     m_sdDeadline = 0;
  }
- 
- bool ConfigurationManager::extractJsonBoolField(const std::string& json, const std::string& fieldName, bool defaultValue) {
-     std::string value = extractJsonField(json, fieldName);
-     if (value.empty()) return defaultValue;
-     return (value == "true" || value == "True" || value == "TRUE" || value == "1");
+
+ void ConfigurationManager::resetSensorDefaults() {
+     for (uint8_t i = 0; i < SensorTypes::NUM_KINDS; i++) {
+         const SensorTypes::TypeInfo& type = SensorTypes::get((Kind)i);
+         if (type.section == SensorTypes::SECTION_SENSORS) m_counts[i] = type.defaultCount;
+     }
+     m_samplePeriods.clear();
  }
  
- int ConfigurationManager::findMatchingBracket(const std::string& str, int openPos) {
-     char open = str[openPos];
-     char close;
-     
-     if (open == '{') close = '}';
-     else if (open == '[') close = ']';
-     else if (open == '(') close = ')';
-     else return -1;
-     
-     int depth = 1;
-     for (size_t i = openPos + 1; i < str.length(); i++) {
-         if (str[i] == open) depth++;
-         else if (str[i] == close) {
-             depth--;
-             if (depth == 0) return i;
-         }
-     }
-     
-     return -1; // No matching bracket found
+ int ConfigurationManager::getSamplePeriod(const std::string& type, int instance) const {
+     auto it = m_samplePeriods.find(type + "_" + std::to_string(instance));
+     if (it == m_samplePeriods.end()) it = m_samplePeriods.find(type);
+     return it == m_samplePeriods.end() ? 0 : it->second;
  }
 
- // ConfigurationManager.cpp - Updated factory methods
-std::unique_ptr<AuxTalon> ConfigurationManager::createAuxTalon() {
-    return std::make_unique<AuxTalon>(0, 0x14); // Default port and hardware version
-}
-
-std::unique_ptr<I2CTalon> ConfigurationManager::createI2CTalon() {
-    return std::make_unique<I2CTalon>(0, 0x21); // Default port and hardware version
-}
-
-std::unique_ptr<SDI12Talon> ConfigurationManager::createSDI12Talon() {
-    return std::make_unique<SDI12Talon>(0, 0x14); // Default port and hardware version
-}
-
-std::unique_ptr<Haar> ConfigurationManager::createHaarSensor() {
-    return std::make_unique<Haar>(0, 0, 0x20); // Default ports and version
-}
-
-std::unique_ptr<SO421> ConfigurationManager::createO2Sensor(SDI12Talon& talon) {
-    return std::make_unique<SO421>(talon, 0, 0); // Default ports and version
-}
-
-std::unique_ptr<SP421> ConfigurationManager::createSolarSensor(SDI12Talon& talon) {
-    return std::make_unique<SP421>(talon, 0, 0); // Default ports and version
-}
-
-std::unique_ptr<TDR315H> ConfigurationManager::createSoilSensor(SDI12Talon& talon) {
-    return std::make_unique<TDR315H>(talon, 0, 0); // Default ports and version
-}
+ uint16_t ConfigurationManager::compare(const ConfigurationManager& previous) const {
+     uint16_t changes = 0;
+     if (m_logPeriod != previous.m_logPeriod || m_backhaulCount != previous.m_backhaulCount || m_loggingMode != previous.m_loggingMode) {
+         changes |= CHANGE_SCHEDULE;
+     }
+     if (m_powerSaveMode != previous.m_powerSaveMode) changes |= CHANGE_POWER_SAVE;
+     if (m_packetEncoding != previous.m_packetEncoding || m_keyframeInterval != previous.m_keyframeInterval || m_diffDeadband != previous.m_diffDeadband) {
+         changes |= CHANGE_ENCODING;
+     }
+     if (m_batchDeadline != previous.m_batchDeadline || m_sdDeadline != previous.m_sdDeadline) changes |= CHANGE_BUFFERING;
+     for (uint8_t i = 0; i < SensorTypes::NUM_KINDS; i++) {
+         if (m_counts[i] == previous.m_counts[i]) continue;
+         changes |= SensorTypes::get((Kind)i).section == SensorTypes::SECTION_SYSTEM ? CHANGE_TALONS : CHANGE_SENSORS;
+     }
+     if (m_samplePeriods != previous.m_samplePeriods) changes |= CHANGE_SAMPLE_PERIODS;
+     return changes;
+ }
 
-std::unique_ptr<Hedorah> ConfigurationManager::createCO2Sensor() {
-    return std::make_unique<Hedorah>(0, 0, 0x10); // Default ports and version
-}
+// EEPROM backup functionality
+bool ConfigurationManager::saveConfigToEEPROM() {
+    ConfigImage image;
+    image.setValue(ConfigImage::LOG_PERIOD, (int32_t)m_logPeriod);
+    image.setValue(ConfigImage::BACKHAUL_COUNT, m_backhaulCount);
+    image.setValue(ConfigImage::POWER_SAVE_MODE, m_powerSaveMode);
+    image.setValue(ConfigImage::LOGGING_MODE, m_loggingMode);
+    image.setValue(ConfigImage::PACKET_ENCODING, m_packetEncoding);
+    image.setValue(ConfigImage::KEYFRAME_INTERVAL, m_keyframeInterval);
+    image.setValue(ConfigImage::DIFF_DEADBAND, m_diffDeadband);
+    image.setValue(ConfigImage::BATCH_DEADLINE, m_batchDeadline);
+    image.setValue(ConfigImage::SD_DEADLINE, m_sdDeadline);
+    for (uint8_t i = 0; i < SensorTypes::NUM_KINDS; i++) image.setValue(imageField((Kind)i), m_counts[i]);
 
-std::unique_ptr<T9602> ConfigurationManager::createHumiditySensor() {
-    return std::make_unique<T9602>(0, 0, 0x00); // Default ports and version
-}
+    // Periods by type slot and instance, "Soil" is instance 0, "Soil_2" instance 2
+    bool complete = true;
+    for (const auto& period : m_samplePeriods) {
+        size_t split = period.first.find('_');
+        std::string type = period.first.substr(0, split);
+        int instance = split == std::string::npos ? 0 : atoi(period.first.c_str() + split + 1);
+        Kind kind;
+        if (!SensorTypes::find(SensorTypes::SECTION_SENSORS, type.data(), type.length(), kind) || instance < 0 || instance > 255) continue;
+        complete &= image.addPeriod(SensorTypes::get(kind).slot, (uint8_t)instance, (uint32_t)period.second);
+    }
+    image.save();
 
-std::unique_ptr<LI710> ConfigurationManager::createETSensor(ITimeProvider& timeProvider, ISDI12Talon& talon) {
-    return std::make_unique<LI710>(timeProvider, talon, 0, 0); // Default ports and version
+    // The UID backup can not hold every configuration, never fall back to a stale one
+    EEPROM.put(EEPROM_CONFIG_VALID_FLAG, (uint8_t)0x00);
+    return complete;
 }
 
-std::unique_ptr<BaroVue10> ConfigurationManager::createPressureSensor(SDI12Talon& talon) {
-    return std::make_unique<BaroVue10>(talon, 0, 0x00); // Default ports and version
-}
+bool ConfigurationManager::loadConfigFromEEPROM() {
+    ConfigImage image;
+    if (image.load()) {
+        m_logPeriod = (unsigned long)image.getValue(ConfigImage::LOG_PERIOD);
+        m_backhaulCount = image.getValue(ConfigImage::BACKHAUL_COUNT);
+        m_powerSaveMode = image.getValue(ConfigImage::POWER_SAVE_MODE);
+        m_loggingMode = image.getValue(ConfigImage::LOGGING_MODE);
+        m_packetEncoding = image.getValue(ConfigImage::PACKET_ENCODING);
+        m_keyframeInterval = image.getValue(ConfigImage::KEYFRAME_INTERVAL);
+        m_diffDeadband = image.getValue(ConfigImage::DIFF_DEADBAND);
+        m_batchDeadline = image.getValue(ConfigImage::BATCH_DEADLINE);
+        m_sdDeadline = image.getValue(ConfigImage::SD_DEADLINE);
+        for (uint8_t i = 0; i < SensorTypes::NUM_KINDS; i++) m_counts[i] = image.getValue(imageField((Kind)i));
 
-std::unique_ptr<SDI12AnalogMux> ConfigurationManager::createAnalogMuxSensor(SDI12Talon& talon) {
-    return std::make_unique<SDI12AnalogMux>(talon, 0, 0, 0x00); // Default ports and version
-}
+        m_samplePeriods.clear();
+        for (uint8_t i = 0; i < image.getPeriodCount(); i++) {
+            Kind kind;
+            if (!SensorTypes::findSlot(SensorTypes::SECTION_SENSORS, image.getPeriodType(i), kind)) continue;
+            std::string key = SensorTypes::get(kind).name;
+            if (image.getPeriodInstance(i) > 0) key += "_" + std::to_string(image.getPeriodInstance(i));
+            m_samplePeriods[key] = (int)image.getPeriodSeconds(i);
+        }
 
-// EEPROM backup functionality
-bool ConfigurationManager::saveConfigToEEPROM() {
-    // Write system and sensor UIDs (they encode all the config values)
-    EEPROM.put(EEPROM_SYSTEM_UID_ADDR, m_SystemConfigUid);
-    EEPROM.put(EEPROM_SENSOR_UID_ADDR, m_SensorConfigUid);
-    
-    // Write valid flag to indicate EEPROM contains valid config
-    EEPROM.put(EEPROM_CONFIG_VALID_FLAG, EEPROM_VALID_MARKER);
-    
-    return true;
-}
+        updateSystemConfigurationUid();
+        updateSensorConfigurationUid();
+        return true;
+    }
 
-bool ConfigurationManager::loadConfigFromEEPROM() {
+    // Backup written by firmware before the image, holds only what the UIDs encode
     // Check if EEPROM contains valid configuration
     uint8_t validFlag;
     EEPROM.get(EEPROM_CONFIG_VALID_FLAG, validFlag);
@@ -280,19 +362,14 @@ bool ConfigurationManager::loadConfigFromEEPROM() {
     m_backhaulCount = (systemUid >> 12) & 0xF;
     m_powerSaveMode = (systemUid >> 10) & 0x3;
     m_loggingMode = (systemUid >> 8) & 0x3;
-    m_numAuxTalons = (systemUid >> 6) & 0x3;
-    m_numI2CTalons = (systemUid >> 4) & 0x3;
-    m_numSDI12Talons = (systemUid >> 2) & 0x3;
+    m_packetEncoding = systemUid & 0x3;
     
-    // Decode sensor UID back to configuration values (reverse of updateSensorConfigurationUid)
-    m_numET = (sensorUid >> 28) & 0xF;
-    m_numHaar = (sensorUid >> 24) & 0xF;
-    m_numSoil = (sensorUid >> 20) & 0xF;
-    m_numApogeeSolar = (sensorUid >> 16) & 0xF;
-    m_numCO2 = (sensorUid >> 12) & 0xF;
-    m_numO2 = (sensorUid >> 8) & 0xF;
-    m_numPressure = (sensorUid >> 4) & 0xF;
-    m_numAnalogMux = sensorUid & 0xF;
+    // Decode Talon and sensor counts from both UIDs (reverse of the update methods)
+    for (uint8_t i = 0; i < SensorTypes::NUM_KINDS; i++) {
+        const SensorTypes::TypeInfo& type = SensorTypes::get((Kind)i);
+        int uid = type.section == SensorTypes::SECTION_SYSTEM ? systemUid : sensorUid;
+        m_counts[i] = (uid >> uidShift(type)) & uidMask(type);
+    }
 
     // Store the UIDs
     m_SystemConfigUid = systemUid;
@@ -302,6 +379,8 @@ bool ConfigurationManager::loadConfigFromEEPROM() {
 }
 
 void ConfigurationManager::clearConfigEEPROM() {
+    ConfigImage image;
+    image.erase();
     // Clear the valid flag to invalidate EEPROM config
     EEPROM.put(EEPROM_CONFIG_VALID_FLAG, (uint8_t)0x00);
 }
\ No newline at end of file
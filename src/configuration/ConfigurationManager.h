@@ -3,53 +3,33 @@
 #define CONFIGURATION_MANAGER_H
 
 #include "IConfiguration.h"
-#include <vector>
-#include <memory>
-#include <AuxTalon.h>
-#include <I2CTalon.h>
-#include <SDI12Talon.h>
-#include <Haar.h>
-#include <SO421.h>
-#include <SP421.h>
-#include <TDR315H.h>
-#include <Hedorah.h>
-#include <T9602.h>
-#include <Li710.h>
-#include <BaroVue10.h>
-#include <SDI12AnalogMux.h>
+#include "ConfigTokenizer.h"
+#include "SensorTypes.h"
+#include <map>
+#include <string>
 
 class ConfigurationManager : public IConfiguration {
 public:
+    // Groups of settings reported by compare()
+    enum Change : uint16_t {
+        CHANGE_SCHEDULE = 1 << 0,       ///< logPeriod, backhaulCount or loggingMode
+        CHANGE_POWER_SAVE = 1 << 1,     ///< powerSaveMode
+        CHANGE_ENCODING = 1 << 2,       ///< packetEncoding, keyframeInterval or diffDeadband
+        CHANGE_BUFFERING = 1 << 3,      ///< batchDeadline or sdDeadline
+        CHANGE_TALONS = 1 << 4,         ///< Any Talon count
+        CHANGE_SENSORS = 1 << 5,        ///< Any sensor count
+        CHANGE_SAMPLE_PERIODS = 1 << 6  ///< Any sampling period
+    };
+
     ConfigurationManager();
     ~ConfigurationManager() = default;
     
     // IConfiguration implementation
     bool setConfiguration(std::string config) override;
     std::string getConfiguration() override;
-    //{"config":{"system":{"logPeriod":300,"backhaulCount":4,"powerSaveMode":1,"loggingMode":0,"numAuxTalons":1,"numI2CTalons":1,"numSDI12Talons":1},"sensors":{"numET":0,"numHaar":0,"numSoil":3,"numApogeeSolar":0,"numCO2":0,"numO2":0,"numPressure":0}}}
-    std::string getDefaultConfigurationJson() const {
-        return "{\"config\":{"
-               "\"system\":{"
-               "\"logPeriod\":300,"
-               "\"backhaulCount\":4,"
-               "\"powerSaveMode\":1,"
-               "\"loggingMode\":0,"
-               "\"numAuxTalons\":1,"
-               "\"numI2CTalons\":1,"
-               "\"numSDI12Talons\":1"
-               "},"
-               "\"sensors\":{"
-               "\"numET\":0,"
-               "\"numHaar\":0,"
-               "\"numSoil\":3,"
-               "\"numApogeeSolar\":0,"
-               "\"numCO2\":0,"
-               "\"numO2\":0,"
-               "\"numPressure\":0,"
-               "\"numAnalogMux\":0"
-               "}"
-               "}}";
-    }
+    //{"config":{"system":{"logPeriod":300,"backhaulCount":4,"powerSaveMode":1,"loggingMode":0,"numAuxTalons":1,"numI2CTalons":1,"numSDI12Talons":1,...},"sensors":{"numET":0,"numHaar":0,"numSoil":3,...}}}
+    // Every field at its default, Talon and sensor counts from the SensorTypes registry
+    std::string getDefaultConfigurationJson() const;
     int updateSystemConfigurationUid() override;
     int updateSensorConfigurationUid() override;
     
@@ -63,36 +43,46 @@ public:
     int getBackhaulCount() const { return m_backhaulCount; }
     int getPowerSaveMode() const { return m_powerSaveMode; }
     int getLoggingMode() const { return m_loggingMode; }
+    int getPacketEncoding() const { return m_packetEncoding; }
+    int getKeyframeInterval() const { return m_keyframeInterval; }
+    int getDiffDeadband() const { return m_diffDeadband; }
+    int getBatchDeadline() const { return m_batchDeadline; }
+    int getSdDeadline() const { return m_sdDeadline; }
     
-    // Sensor count getters
-    int getNumAuxTalons() const { return m_numAuxTalons; }
-    int getNumI2CTalons() const { return m_numI2CTalons; }
-    int getNumSDI12Talons() const { return m_numSDI12Talons; }
-    int getNumSoil() const { return m_numSoil; }
-    int getNumHaar() const { return m_numHaar; }
-    int getNumET() const { return m_numET; }
-    int getNumApogeeSolar() const { return m_numApogeeSolar; }
-    int getNumCO2() const { return m_numCO2; }
-    int getNumO2() const { return m_numO2; }
-    int getNumPressure() const { return m_numPressure; }
-    int getNumAnalogMux() const { return m_numAnalogMux; }
+    // Talon and sensor counts
+    int getCount(SensorTypes::Kind kind) const { return m_counts[kind]; }
+    int getNumAuxTalons() const { return m_counts[SensorTypes::AUX_TALON]; }
+    int getNumI2CTalons() const { return m_counts[SensorTypes::I2C_TALON]; }
+    int getNumSDI12Talons() const { return m_counts[SensorTypes::SDI12_TALON]; }
+    int getNumSoil() const { return m_counts[SensorTypes::SOIL]; }
+    int getNumHaar() const { return m_counts[SensorTypes::HAAR]; }
+    int getNumET() const { return m_counts[SensorTypes::ET]; }
+    int getNumApogeeSolar() const { return m_counts[SensorTypes::APOGEE_SOLAR]; }
+    int getNumCO2() const { return m_counts[SensorTypes::CO2]; }
+    int getNumO2() const { return m_counts[SensorTypes::O2]; }
+    int getNumPressure() const { return m_counts[SensorTypes::PRESSURE]; }
+    int getNumAnalogMux() const { return m_counts[SensorTypes::ANALOG_MUX]; }
+
+    /**
+     * @brief Sampling period of one sensor, from "period<Type>_<instance>" or else "period<Type>" in the sensors block
+     * @param type Sensor type as in the count fields, e.g. "Soil" for numSoil
+     * @param instance 1 based instance of that type
+     * @return Seconds, 0 samples the sensor on every log
+     */
+    int getSamplePeriod(const std::string& type, int instance) const;
+
+    /**
+     * @brief Which groups of settings differ from another configuration
+     * @return Bitwise OR of Change values, 0 if the two are the same
+     */
+    uint16_t compare(const ConfigurationManager& previous) const;
 
-    // Static factory methods for creating sensors
-    static std::unique_ptr<AuxTalon> createAuxTalon();
-    static std::unique_ptr<I2CTalon> createI2CTalon();
-    static std::unique_ptr<SDI12Talon> createSDI12Talon();
-    static std::unique_ptr<Haar> createHaarSensor();
-    static std::unique_ptr<SO421> createO2Sensor(SDI12Talon& talon);
-    static std::unique_ptr<SP421> createSolarSensor(SDI12Talon& talon);
-    static std::unique_ptr<TDR315H> createSoilSensor(SDI12Talon& talon);
-    static std::unique_ptr<Hedorah> createCO2Sensor();
-    static std::unique_ptr<T9602> createHumiditySensor();
-    static std::unique_ptr<LI710> createETSensor(class ITimeProvider& timeProvider, class ISDI12Talon& talon);
-    static std::unique_ptr<BaroVue10> createPressureSensor(SDI12Talon& talon);
-    static std::unique_ptr<SDI12AnalogMux> createAnalogMuxSensor(SDI12Talon& talon);
+    // Why the last setConfiguration() failed, byte offset into the JSON given
+    const char* getParseError() const { return ConfigTokenizer::describe(m_parseError); }
+    size_t getParseErrorOffset() const { return m_parseErrorOffset; }
 
 private:
-    // EEPROM addresses for configuration backup
+    // EEPROM addresses of the UID backup, replaced by ConfigImage and only read after an upgrade
     static const int EEPROM_CONFIG_START = 16;  // Start at address 16 (after accel offsets at 0-11)
     static const int EEPROM_SYSTEM_UID_ADDR = EEPROM_CONFIG_START;
     static const int EEPROM_SENSOR_UID_ADDR = EEPROM_CONFIG_START + 4;
@@ -104,29 +94,25 @@ private:
     int m_backhaulCount;
     int m_powerSaveMode;
     int m_loggingMode;
+    int m_packetEncoding; // 0 = JSON, 1 = binary (PacketCodec)
+    int m_keyframeInterval; // Every Nth data packet in full, 0 or 1 disables diff packets
+    int m_diffDeadband; // Relative change in 1/1000 below which a field is not resent
+    int m_batchDeadline; // Seconds a record may wait to share a publish, 0 disables batching
+    int m_sdDeadline; // Seconds an SD bound line may wait for a full block, 0 disables the write-behind
     
-    // Sensor counts
-    int m_numAuxTalons;
-    int m_numI2CTalons;
-    int m_numSDI12Talons;
-    int m_numET;
-    int m_numHaar;
-    int m_numSoil;
-    int m_numApogeeSolar;
-    int m_numCO2;
-    int m_numO2;
-    int m_numPressure;
-    int m_numAnalogMux;
+    int m_counts[SensorTypes::NUM_KINDS]; // Talon and sensor counts by Kind
+    std::map<std::string, int> m_samplePeriods; // "Soil" or "Soil_2" to seconds, only sensors not sampled every log
 
     int m_SystemConfigUid;
     int m_SensorConfigUid;
+    ConfigTokenizer::Error m_parseError;
+    size_t m_parseErrorOffset;
 
     // Internal methods
     bool parseConfiguration(const std::string& config);
-    std::string extractJsonField(const std::string& json, const std::string& fieldName);
-    int extractJsonIntField(const std::string& json, const std::string& fieldName, int defaultValue);
-    bool extractJsonBoolField(const std::string& json, const std::string& fieldName, bool defaultValue);
-    int findMatchingBracket(const std::string& str, int openPos);
+    static void applyField(const ConfigTokenizer::Field& field, void* context);
+    void resetSystemDefaults();
+    void resetSensorDefaults();
 };
 
 #endif // CONFIGURATION_MANAGER_H
\ No newline at end of file
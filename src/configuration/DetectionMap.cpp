@@ -0,0 +1,103 @@
+/**
+ * @file DetectionMap.cpp
+ * @brief Implementation of DetectionMap class
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "DetectionMap.h"
+#include <stddef.h>
+#include <string.h>
+
+#ifndef TESTING
+#include "Particle.h"
+#else
+#include "MockParticle.h"
+#endif
+
+const int DetectionMap::EEPROM_ADDR;
+const uint8_t DetectionMap::MAX_TALONS;
+const uint8_t DetectionMap::MAX_SENSORS;
+const uint8_t DetectionMap::VERSION;
+const uint8_t DetectionMap::VALID_MARKER;
+
+DetectionMap::DetectionMap() {
+    clear(0, 0);
+}
+
+bool DetectionMap::clear(uint8_t talonCount, uint8_t sensorCount) {
+    memset(&m_image, 0, sizeof(m_image));
+    if (talonCount > MAX_TALONS || sensorCount > MAX_SENSORS) return false;
+    m_image.talonCount = talonCount;
+    m_image.sensorCount = sensorCount;
+    return true;
+}
+
+void DetectionMap::setTalonPort(uint8_t talonIndex, uint8_t talonPort) {
+    if (talonIndex < m_image.talonCount) m_image.talonPorts[talonIndex] = talonPort;
+}
+
+uint8_t DetectionMap::getTalonPort(uint8_t talonIndex) const {
+    if (talonIndex >= m_image.talonCount) return 0;
+    return m_image.talonPorts[talonIndex];
+}
+
+void DetectionMap::setSensor(uint8_t sensorIndex, uint8_t talonPort, uint8_t sensorPort, uint8_t sensorInterface) {
+    if (sensorIndex >= m_image.sensorCount) return;
+    m_image.sensors[sensorIndex].talonPort = talonPort;
+    m_image.sensors[sensorIndex].sensorPort = sensorPort;
+    m_image.sensors[sensorIndex].sensorInterface = sensorInterface;
+}
+
+uint8_t DetectionMap::getSensorTalonPort(uint8_t sensorIndex) const {
+    if (sensorIndex >= m_image.sensorCount) return 0;
+    return m_image.sensors[sensorIndex].talonPort;
+}
+
+uint8_t DetectionMap::getSensorPort(uint8_t sensorIndex) const {
+    if (sensorIndex >= m_image.sensorCount) return 0;
+    return m_image.sensors[sensorIndex].sensorPort;
+}
+
+uint8_t DetectionMap::getSensorInterface(uint8_t sensorIndex) const {
+    if (sensorIndex >= m_image.sensorCount) return 0;
+    return m_image.sensors[sensorIndex].sensorInterface;
+}
+
+uint16_t DetectionMap::computeChecksum(const Image& image) {
+    //CRC-16/CCITT over everything but the checksum itself
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(&image);
+    size_t len = offsetof(Image, checksum);
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+bool DetectionMap::save(int sensorConfigUid) {
+    m_image.marker = VALID_MARKER;
+    m_image.version = VERSION;
+    m_image.sensorConfigUid = sensorConfigUid;
+    m_image.checksum = computeChecksum(m_image);
+    EEPROM.put(EEPROM_ADDR, m_image);
+    return true;
+}
+
+bool DetectionMap::load(int sensorConfigUid, uint8_t talonCount, uint8_t sensorCount) {
+    Image stored;
+    EEPROM.get(EEPROM_ADDR, stored);
+    if (stored.marker != VALID_MARKER || stored.version != VERSION) return false; //Never written, or older layout
+    if (stored.checksum != computeChecksum(stored)) return false;
+    if (stored.sensorConfigUid != sensorConfigUid) return false; //Different sensor set, ports no longer apply
+    if (stored.talonCount != talonCount || stored.sensorCount != sensorCount) return false;
+    m_image = stored;
+    return true;
+}
+
+void DetectionMap::erase() {
+    EEPROM.put(EEPROM_ADDR, (uint8_t)0xFF); //Clearing the marker is enough to invalidate the map
+}
@@ -0,0 +1,97 @@
+/**
+ * @file DetectionMap.h
+ * @brief Persists detected Talon and sensor ports so boot can skip full probing.
+ *
+ * detectTalons() power cycles and probes every Kestrel port, and
+ * detectSensors() probes every sensor object on every Talon port. On a station
+ * whose wiring has not changed the result is the same each boot. The map keeps
+ * the last result in EEPROM, keyed by the sensor configuration UID, so boot can
+ * restore it and only confirm each device at its stored port.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef DETECTION_MAP_H
+#define DETECTION_MAP_H
+
+#include <stdint.h>
+
+/**
+ * @brief Talon and sensor port assignments, saved to and loaded from EEPROM
+ *
+ * Talon entries follow the order of the talons vector, sensor entries the
+ * order of the sensors vector. A stored map only loads if it was saved for the
+ * same sensor configuration UID and the same number of Talons and sensors.
+ */
+class DetectionMap {
+public:
+    static const int EEPROM_ADDR = 512; ///< Clear of accel offsets (0-11) and config backup (16-24)
+    static const uint8_t MAX_TALONS = 8;
+    static const uint8_t MAX_SENSORS = 48;
+    static const uint8_t VERSION = 1;
+
+    DetectionMap();
+
+    /**
+     * @brief Empty the map and size it for the current configuration
+     * @return false if the counts exceed what can be stored
+     */
+    bool clear(uint8_t talonCount, uint8_t sensorCount);
+
+    void setTalonPort(uint8_t talonIndex, uint8_t talonPort);
+    uint8_t getTalonPort(uint8_t talonIndex) const;
+
+    /**
+     * @brief Record where a sensor was found
+     * @param sensorInterface BusType of the sensor, checked on restore to catch reordered objects
+     */
+    void setSensor(uint8_t sensorIndex, uint8_t talonPort, uint8_t sensorPort, uint8_t sensorInterface);
+    uint8_t getSensorTalonPort(uint8_t sensorIndex) const;
+    uint8_t getSensorPort(uint8_t sensorIndex) const;
+    uint8_t getSensorInterface(uint8_t sensorIndex) const;
+
+    uint8_t getTalonCount() const { return m_image.talonCount; }
+    uint8_t getSensorCount() const { return m_image.sensorCount; }
+
+    /**
+     * @brief Write the map to EEPROM
+     */
+    bool save(int sensorConfigUid);
+
+    /**
+     * @brief Read the map from EEPROM
+     * @return true only if the stored map is intact and matches the UID and counts given
+     */
+    bool load(int sensorConfigUid, uint8_t talonCount, uint8_t sensorCount);
+
+    /**
+     * @brief Invalidate the stored map so the next boot runs a full detection
+     */
+    void erase();
+
+private:
+    struct Entry {
+        uint8_t talonPort;
+        uint8_t sensorPort;
+        uint8_t sensorInterface;
+    };
+
+    struct Image {
+        uint8_t marker;
+        uint8_t version;
+        uint8_t talonCount;
+        uint8_t sensorCount;
+        int32_t sensorConfigUid;
+        uint8_t talonPorts[MAX_TALONS];
+        Entry sensors[MAX_SENSORS];
+        uint16_t checksum;
+    };
+
+    static const uint8_t VALID_MARKER = 0xD7;
+
+    static uint16_t computeChecksum(const Image& image);
+
+    Image m_image;
+};
+
+#endif // DETECTION_MAP_H
@@ -0,0 +1,71 @@
+/**
+ * @file SensorArena.cpp
+ * @brief Implementation of SensorArena class
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "SensorArena.h"
+#include <stdlib.h>
+
+const uint8_t SensorArena::MAX_OBJECTS;
+const size_t SensorArena::ALIGNMENT;
+
+SensorArena::SensorArena()
+    : m_buffer(nullptr),
+      m_capacity(0),
+      m_used(0),
+      m_count(0),
+      m_heapObjects(0)
+{
+}
+
+SensorArena::~SensorArena()
+{
+    clear();
+    free(m_buffer);
+}
+
+bool SensorArena::reserve(size_t bytes)
+{
+    if (m_count > 0) return false; //Objects would move
+    m_heapObjects = 0;
+    if (bytes <= m_capacity) return true; //Keep the block, avoids churning the heap on a reload
+    free(m_buffer);
+    m_buffer = static_cast<uint8_t*>(malloc(bytes)); //malloc aligns for any type
+    m_capacity = m_buffer == nullptr ? 0 : bytes;
+    return m_buffer != nullptr;
+}
+
+void SensorArena::destroy(void* object)
+{
+    for (uint8_t i = m_count; i > 0; i--) { //Newest first, removals are usually of the last object
+        if (m_objects[i - 1].object == object) {
+            release(i - 1);
+            return;
+        }
+    }
+}
+
+void SensorArena::clear()
+{
+    while (m_count > 0) release(m_count - 1);
+    m_used = 0;
+}
+
+void SensorArena::release(uint8_t index)
+{
+    Object removed = m_objects[index];
+    removed.destroy(removed.object, removed.inArena);
+    for (uint8_t i = index; i + 1 < m_count; i++) m_objects[i] = m_objects[i + 1];
+    m_count--;
+    if (!removed.inArena) return;
+    //Space is a stack, give back everything above the highest arena object still held
+    size_t top = 0;
+    for (uint8_t i = 0; i < m_count; i++) {
+        if (!m_objects[i].inArena) continue;
+        size_t end = static_cast<uint8_t*>(m_objects[i].object) - m_buffer + m_objects[i].size;
+        if (end > top) top = end;
+    }
+    m_used = top;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file SensorArena.h
+ * @brief One block of memory holding every Talon and sensor object.
+ *
+ * SensorManager used to allocate each Talon and sensor on the heap
+ * separately. The arena is reserved once, sized from the configuration, and
+ * objects are constructed in it back to back. Objects are destroyed in place.
+ * Only the most recent one gives its space back, so a live reload that adds
+ * sensors beyond the reservation falls back to the heap for those objects
+ * rather than failing.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef SENSOR_ARENA_H
+#define SENSOR_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+#include <utility>
+
+/**
+ * @brief Bump allocator for objects of mixed types with in place destruction
+ */
+class SensorArena {
+public:
+    static const uint8_t MAX_OBJECTS = 64; ///< Talons and sensors held at once
+    static const size_t ALIGNMENT = alignof(max_align_t);
+
+    SensorArena();
+    ~SensorArena();
+
+    SensorArena(const SensorArena&) = delete;
+    SensorArena& operator=(const SensorArena&) = delete;
+
+    /**
+     * @brief Space needed to hold count objects of type T
+     */
+    template <typename T>
+    static size_t bytesFor(size_t count) { return bytesFor(sizeof(T), count); }
+    static size_t bytesFor(size_t size, size_t count) { return count * alignedSize(size); }
+
+    /**
+     * @brief Allocate the block, only while no objects are held
+     * @return false if objects are held or the allocation failed
+     */
+    bool reserve(size_t bytes);
+
+    /**
+     * @brief Construct an object in the arena, or on the heap if the arena is full
+     * @return The object, nullptr if MAX_OBJECTS are already held
+     */
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        if (m_count >= MAX_OBJECTS) return nullptr;
+        size_t size = alignedSize(sizeof(T));
+        T* object;
+        bool inArena = m_buffer != nullptr && m_capacity - m_used >= size;
+        if (inArena) {
+            object = new (m_buffer + m_used) T(std::forward<Args>(args)...);
+            m_used += size;
+        }
+        else {
+            object = new T(std::forward<Args>(args)...);
+            m_heapObjects++;
+        }
+        m_objects[m_count++] = {object, size, inArena, &destroyObject<T>};
+        return object;
+    }
+
+    /**
+     * @brief Destroy one object, its arena space is reused only if it was the last placed
+     */
+    void destroy(void* object);
+
+    /**
+     * @brief Destroy every object, newest first, and keep the block for reuse
+     */
+    void clear();
+
+    size_t getCapacity() const { return m_capacity; }
+    size_t getUsed() const { return m_used; }
+    uint8_t getCount() const { return m_count; }
+    unsigned long getHeapObjects() const { return m_heapObjects; } ///< Objects that did not fit since the last reserve()
+
+private:
+    struct Object {
+        void* object;
+        size_t size;
+        bool inArena;
+        void (*destroy)(void* object, bool inArena);
+    };
+
+    static size_t alignedSize(size_t size) { return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+
+    template <typename T>
+    static void destroyObject(void* object, bool inArena) {
+        if (inArena) static_cast<T*>(object)->~T();
+        else delete static_cast<T*>(object);
+    }
+
+    void release(uint8_t index);
+
+    uint8_t* m_buffer;
+    size_t m_capacity;
+    size_t m_used;
+    Object m_objects[MAX_OBJECTS];
+    uint8_t m_count;
+    unsigned long m_heapObjects;
+};
+
+#endif // SENSOR_ARENA_H
@@ -2,10 +2,16 @@
 #include "SensorManager.h"
 #include "ConfigurationManager.h"
 
+using SensorTypes::Kind;
+
 SensorManager::SensorManager(ConfigurationManager& configManager) 
     : configManager(configManager) {
 }
 
+SensorManager::~SensorManager() {
+    clearAllSensors();
+}
+
 void SensorManager::initializeSensors(ITimeProvider& timeProvider, ISDI12Talon& sdi12Interface) {
     // Clear existing sensors
     clearAllSensors();
@@ -18,140 +24,148 @@ void SensorManager::initializeSensors(ITimeProvider& timeProvider, ISDI12Talon&
 }
 
 void SensorManager::initializeTalons() {
-    // Create Talons
-    for (int i = 0; i < configManager.getNumAuxTalons(); i++) {
-        auxTalons.push_back(ConfigurationManager::createAuxTalon());
-    }
-    
-    for (int i = 0; i < configManager.getNumI2CTalons(); i++) {
-        i2cTalons.push_back(ConfigurationManager::createI2CTalon());
+    // One block for every object in the configuration, sensors included
+    if (m_entries.empty()) {
+        m_arena.reserve(arenaBytes());
+        m_entries.reserve(SensorArena::MAX_OBJECTS);
     }
     
-    for (int i = 0; i < configManager.getNumSDI12Talons(); i++) {
-        sdi12Talons.push_back(ConfigurationManager::createSDI12Talon());
+    // Create Talons
+    for (uint8_t i = 0; i < SensorTypes::NUM_KINDS; i++) {
+        if (SensorTypes::get((Kind)i).bus != SensorTypes::BUS_TALON) continue;
+        for (int n = configuredCount((Kind)i, false); n > 0; n--) create((Kind)i, nullptr, nullptr);
     }
+    updateViews();
 }
 
 void SensorManager::initializeSensorsOnly(ITimeProvider& timeProvider, ISDI12Talon& sdi12Interface) {
-    // Create Sensors
-    for (int i = 0; i < configManager.getNumHaar(); i++) {
-        haarSensors.push_back(ConfigurationManager::createHaarSensor());
-    }
-    
-    // For SDI12-based sensors, use the first available SDI12 talon
-    if (!sdi12Talons.empty()) {
-        SDI12Talon* firstSDI12Talon = sdi12Talons[0].get();
-        
-        for (int i = 0; i < configManager.getNumO2(); i++) {
-            apogeeO2Sensors.push_back(ConfigurationManager::createO2Sensor(*firstSDI12Talon));
-        }
-        
-        for (int i = 0; i < configManager.getNumApogeeSolar(); i++) {
-            apogeeSolarSensors.push_back(ConfigurationManager::createSolarSensor(*firstSDI12Talon));
-        }
-        
-        for (int i = 0; i < configManager.getNumSoil(); i++) {
-            soilSensors.push_back(ConfigurationManager::createSoilSensor(*firstSDI12Talon));
-        }
-        
-        for (int i = 0; i < configManager.getNumET(); i++) {
-            etSensors.push_back(ConfigurationManager::createETSensor(timeProvider, sdi12Interface));
-        }
-        
-        for (int i = 0; i < configManager.getNumPressure(); i++) {
-            pressureSensors.push_back(ConfigurationManager::createPressureSensor(*firstSDI12Talon));
-        }
-
-        for (int i = 0; i < configManager.getNumAnalogMux(); i++) {
-            analogMuxSensors.push_back(ConfigurationManager::createAnalogMuxSensor(*firstSDI12Talon));
-        }
+    // Create Sensors, SDI12-based ones use the first SDI12 talon and exist only if there is one
+    bool hasSDI12 = getSDI12Talon(0) != nullptr;
+    for (uint8_t i = 0; i < SensorTypes::NUM_KINDS; i++) {
+        if (SensorTypes::get((Kind)i).bus == SensorTypes::BUS_TALON) continue;
+        for (int n = configuredCount((Kind)i, hasSDI12); n > 0; n--) create((Kind)i, &timeProvider, &sdi12Interface);
     }
+    updateViews();
+}
 
-    for (int i = 0; i < configManager.getNumCO2(); i++) {
-        gasSensors.push_back(ConfigurationManager::createCO2Sensor());
-    }
+bool SensorManager::resizeSensors(ITimeProvider& timeProvider, ISDI12Talon* sdi12Interface) {
+    bool changed = false;
+    bool hasSDI12 = sdi12Interface != nullptr && getSDI12Talon(0) != nullptr;
+    for (uint8_t i = 0; i < SensorTypes::NUM_KINDS; i++) {
+        if (SensorTypes::get((Kind)i).bus == SensorTypes::BUS_TALON) continue;
+        changed |= resizeKind((Kind)i, configuredCount((Kind)i, hasSDI12), timeProvider, sdi12Interface);
+    }
+    if (changed) updateViews();
+    return changed;
 }
 
 void SensorManager::clearAllSensors() {
-    auxTalons.clear();
-    i2cTalons.clear();
-    sdi12Talons.clear();
-    haarSensors.clear();
-    apogeeO2Sensors.clear();
-    apogeeSolarSensors.clear();
-    soilSensors.clear();
-    gasSensors.clear();
-    humiditySensors.clear();
-    etSensors.clear();
-    pressureSensors.clear();
-    analogMuxSensors.clear();
-}
-
-std::vector<Talon*> SensorManager::getAllTalons() {
-    std::vector<Talon*> allTalons;
-    
-    for (auto& talon : auxTalons) {
-        allTalons.push_back(talon.get());
-    }
-    
-    for (auto& talon : i2cTalons) {
-        allTalons.push_back(talon.get());
-    }
-    
-    for (auto& talon : sdi12Talons) {
-        allTalons.push_back(talon.get());
-    }
-    
-    return allTalons;
+    m_entries.clear();
+    m_arena.clear();
+    updateViews();
 }
 
-std::vector<Sensor*> SensorManager::getAllSensors() {
-    std::vector<Sensor*> allSensors;
-    
-    // Add all sensor types to the vector
-    for (auto& sensor : haarSensors) {
-        allSensors.push_back(sensor.get());
-    }
-    
-    for (auto& sensor : apogeeO2Sensors) {
-        allSensors.push_back(sensor.get());
-    }
-    
-    for (auto& sensor : apogeeSolarSensors) {
-        allSensors.push_back(sensor.get());
-    }
-    
-    for (auto& sensor : soilSensors) {
-        allSensors.push_back(sensor.get());
-    }
-    
-    for (auto& sensor : gasSensors) {
-        allSensors.push_back(sensor.get());
-    }
-    
-    for (auto& sensor : humiditySensors) {
-        allSensors.push_back(sensor.get());
-    }
-    
-    for (auto& sensor : etSensors) {
-        allSensors.push_back(sensor.get());
-    }
-    
-    for (auto& sensor : pressureSensors) {
-        allSensors.push_back(sensor.get());
+void SensorManager::setCoreDevices(const std::vector<Sensor*>& coreDevices) {
+    m_coreDevices = coreDevices;
+    updateViews();
+}
+
+size_t SensorManager::getCount(Kind kind) const {
+    size_t count = 0;
+    for (const Entry& entry : m_entries) {
+        if (entry.kind == kind) count++;
     }
+    return count;
+}
 
-    for (auto& sensor : analogMuxSensors) {
-        allSensors.push_back(sensor.get());
+SDI12Talon* SensorManager::getSDI12Talon(size_t index) const {
+    for (const Entry& entry : m_entries) {
+        if (entry.kind == SensorTypes::SDI12_TALON && index-- == 0) return static_cast<SDI12Talon*>(entry.object);
     }
+    return nullptr;
+}
 
-    return allSensors;
+std::vector<unsigned long> SensorManager::getSamplePeriods() const {
+    std::vector<unsigned long> periods;
+    periods.reserve(m_sensors.size());
+    int instance = 0;
+    for (size_t i = 0; i < m_entries.size(); i++) {
+        Kind kind = m_entries[i].kind;
+        if (m_entries[i].talon != nullptr) continue;
+        instance = (i > 0 && m_entries[i - 1].kind == kind) ? instance + 1 : 1;
+        periods.push_back(configManager.getSamplePeriod(SensorTypes::get(kind).name, instance));
+    }
+    return periods;
 }
 
 int SensorManager::getTotalSensorCount() const {
     // Core sensors (3) + Talons + Other Sensors
-    return 3 + auxTalons.size() + i2cTalons.size() + sdi12Talons.size() +
-           haarSensors.size() + apogeeO2Sensors.size() + apogeeSolarSensors.size() +
-           soilSensors.size() + gasSensors.size() + humiditySensors.size() +
-           etSensors.size() + pressureSensors.size() + analogMuxSensors.size();
-}
\ No newline at end of file
+    return 3 + m_entries.size();
+}
+
+int SensorManager::configuredCount(Kind kind, bool hasSDI12) const {
+    const SensorTypes::TypeInfo& type = SensorTypes::get(kind);
+    if (type.create == nullptr) return 0; // Driver compiled out
+    if (type.bus == SensorTypes::BUS_SDI12 && !hasSDI12) return 0;
+    int count = configManager.getCount(kind);
+    return count < 0 ? 0 : count;
+}
+
+bool SensorManager::create(Kind kind, ITimeProvider* timeProvider, ISDI12Talon* sdi12Interface) {
+    SensorTypes::CreateContext context = {&m_arena, getSDI12Talon(0), timeProvider, sdi12Interface};
+    SensorTypes::Created created = SensorTypes::get(kind).create(context);
+    if (created.sensor == nullptr) return false; // Arena holds MAX_OBJECTS already
+    // Behind the last object of the same or an earlier kind
+    size_t position = m_entries.size();
+    while (position > 0 && m_entries[position - 1].kind > kind) position--;
+    m_entries.insert(m_entries.begin() + position, {kind, created.object, created.sensor, created.talon});
+    return true;
+}
+
+void SensorManager::removeLast(Kind kind) {
+    for (size_t i = m_entries.size(); i > 0; i--) {
+        if (m_entries[i - 1].kind != kind) continue;
+        m_arena.destroy(m_entries[i - 1].object);
+        m_entries.erase(m_entries.begin() + (i - 1));
+        return;
+    }
+}
+
+bool SensorManager::resizeKind(Kind kind, int count, ITimeProvider& timeProvider, ISDI12Talon* sdi12Interface) {
+    int current = getCount(kind);
+    for (int i = current; i > count; i--) removeLast(kind);
+    for (int i = current; i < count; i++) {
+        if (!create(kind, &timeProvider, sdi12Interface)) break;
+    }
+    return current != count;
+}
+
+size_t SensorManager::arenaBytes() const {
+    // SDI12-based sensors only exist with an SDI12 talon
+    bool hasSDI12 = configManager.getNumSDI12Talons() > 0;
+    size_t bytes = 0;
+    for (uint8_t i = 0; i < SensorTypes::NUM_KINDS; i++) {
+        bytes += SensorArena::bytesFor(SensorTypes::get((Kind)i).size, configuredCount((Kind)i, hasSDI12));
+    }
+    return bytes;
+}
+
+void SensorManager::updateViews() {
+    // clear() keeps capacity, so after the first build these only allocate if the registry grew
+    m_talons.clear();
+    m_sensors.clear();
+    m_devices.clear();
+    m_devices.insert(m_devices.end(), m_coreDevices.begin(), m_coreDevices.end());
+    for (const Entry& entry : m_entries) {
+        if (entry.talon != nullptr) {
+            m_talons.push_back(entry.talon);
+            m_devices.push_back(entry.sensor); // Talons are sampled ahead of the sensors
+        }
+    }
+    for (const Entry& entry : m_entries) {
+        if (entry.talon == nullptr) {
+            m_sensors.push_back(entry.sensor);
+            m_devices.push_back(entry.sensor);
+        }
+    }
+}
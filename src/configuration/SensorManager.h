@@ -3,13 +3,14 @@
 #define SENSOR_MANAGER_H
 
 #include <vector>
-#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include "SensorArena.h"
+#include "SensorTypes.h"
 
 // Forward declarations
 class Sensor;
 class Talon;
-class AuxTalon;
-class I2CTalon;
 class SDI12Talon;
 class ConfigurationManager;
 class ITimeProvider;
@@ -18,56 +19,71 @@ class ISDI12Talon;
 class SensorManager {
 public:
     SensorManager(ConfigurationManager& configManager);
-    ~SensorManager() = default;
+    ~SensorManager();
     
     // Initialize all sensor vectors based on configuration
     void initializeSensors(ITimeProvider& timeProvider, ISDI12Talon& sdi12Interface);
     
-    // Initialize only talons
+    // Initialize only talons, reserves the arena for the whole configuration
     void initializeTalons();
     
     // Initialize only sensors (after talons are already initialized)
     void initializeSensorsOnly(ITimeProvider& timeProvider, ISDI12Talon& sdi12Interface);
     
+    // Grow or shrink each sensor type to the configured count, keeping existing objects.
+    // Removes from the end of a type. Talons are left as they are. Returns true if any type changed.
+    // Growth past the arena reserved at initializeTalons() is placed on the heap.
+    // Without an SDI12 interface no SDI12 sensors are configured.
+    bool resizeSensors(ITimeProvider& timeProvider, ISDI12Talon* sdi12Interface = nullptr);
+    
     // Clear all sensors
     void clearAllSensors();
     
-    // Getters for sensor vectors
-    const std::vector<std::unique_ptr<AuxTalon>>& getAuxTalons() const { return auxTalons; }
-    const std::vector<std::unique_ptr<I2CTalon>>& getI2CTalons() const { return i2cTalons; }
-    const std::vector<std::unique_ptr<SDI12Talon>>& getSDI12Talons() const { return sdi12Talons; }
+    // Core devices listed ahead of the Talons in getDevices(), not owned
+    void setCoreDevices(const std::vector<Sensor*>& coreDevices);
     
-    std::vector<std::unique_ptr<AuxTalon>>& getAuxTalons() { return auxTalons; }
-    std::vector<std::unique_ptr<I2CTalon>>& getI2CTalons() { return i2cTalons; }
-    std::vector<std::unique_ptr<SDI12Talon>>& getSDI12Talons() { return sdi12Talons; }
+    // Objects of one type and the first SDI12 Talon, nullptr if there is none
+    size_t getCount(SensorTypes::Kind kind) const;
+    SDI12Talon* getSDI12Talon(size_t index) const;
     
-    // Get all talons as a single vector of base pointers
-    std::vector<Talon*> getAllTalons();
+    // Views kept up to date as objects are created and removed, the references stay valid for the manager's lifetime
+    const std::vector<Talon*>& getAllTalons() const { return m_talons; }
+    const std::vector<Sensor*>& getAllSensors() const { return m_sensors; } // Excluding core devices and Talons
+    const std::vector<Sensor*>& getDevices() const { return m_devices; } // Core devices, Talons, then sensors
     
-    // Get all sensors as a single vector (excluding core sensors)
-    std::vector<Sensor*> getAllSensors();
+    // Configured sampling period (seconds, 0 for every log) of each sensor, in getAllSensors() order
+    std::vector<unsigned long> getSamplePeriods() const;
     
     // Get total sensor count (including core sensors)
     int getTotalSensorCount() const;
     
+    // Arena usage, heap objects are those created after the arena filled
+    size_t getArenaCapacity() const { return m_arena.getCapacity(); }
+    size_t getArenaUsed() const { return m_arena.getUsed(); }
+    unsigned long getHeapObjects() const { return m_arena.getHeapObjects(); }
+    
 private:
+    struct Entry {
+        SensorTypes::Kind kind;
+        void* object;   // As created, for the arena
+        Sensor* sensor;
+        Talon* talon;   // nullptr for sensors
+    };
+
     ConfigurationManager& configManager;
-    
-    // Talon vectors
-    std::vector<std::unique_ptr<AuxTalon>> auxTalons;
-    std::vector<std::unique_ptr<I2CTalon>> i2cTalons;
-    std::vector<std::unique_ptr<SDI12Talon>> sdi12Talons;
-    
-    // Sensor vectors
-    std::vector<std::unique_ptr<class Haar>> haarSensors;
-    std::vector<std::unique_ptr<class SO421>> apogeeO2Sensors;
-    std::vector<std::unique_ptr<class SP421>> apogeeSolarSensors;
-    std::vector<std::unique_ptr<class TDR315H>> soilSensors;
-    std::vector<std::unique_ptr<class Hedorah>> gasSensors;
-    std::vector<std::unique_ptr<class T9602>> humiditySensors;
-    std::vector<std::unique_ptr<class LI710>> etSensors;
-    std::vector<std::unique_ptr<class BaroVue10>> pressureSensors;
-    std::vector<std::unique_ptr<class SDI12AnalogMux>> analogMuxSensors;
+    SensorArena m_arena;
+    std::vector<Entry> m_entries; // Sorted by Kind
+    std::vector<Sensor*> m_coreDevices;
+    std::vector<Talon*> m_talons;
+    std::vector<Sensor*> m_sensors;
+    std::vector<Sensor*> m_devices;
+
+    int configuredCount(SensorTypes::Kind kind, bool hasSDI12) const;
+    bool create(SensorTypes::Kind kind, ITimeProvider* timeProvider, ISDI12Talon* sdi12Interface);
+    void removeLast(SensorTypes::Kind kind);
+    bool resizeKind(SensorTypes::Kind kind, int count, ITimeProvider& timeProvider, ISDI12Talon* sdi12Interface);
+    size_t arenaBytes() const;
+    void updateViews();
 };
 
-#endif // SENSOR_MANAGER_H
\ No newline at end of file
+#endif // SENSOR_MANAGER_H
@@ -0,0 +1,169 @@
+/**
+ * @file SensorTypes.cpp
+ * @brief The type registry and the factory of each type
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "SensorTypes.h"
+#include "SensorArena.h"
+#include <string.h>
+#include <AuxTalon.h>
+#include <I2CTalon.h>
+#include <SDI12Talon.h>
+#if SENSOR_HAAR
+#include <Haar.h>
+#endif
+#if SENSOR_O2
+#include <SO421.h>
+#endif
+#if SENSOR_APOGEE_SOLAR
+#include <SP421.h>
+#endif
+#if SENSOR_SOIL
+#include <TDR315H.h>
+#endif
+#if SENSOR_CO2
+#include <Hedorah.h>
+#endif
+#if SENSOR_ET
+#include <Li710.h>
+#endif
+#if SENSOR_PRESSURE
+#include <BaroVue10.h>
+#endif
+#if SENSOR_ANALOG_MUX
+#include <SDI12AnalogMux.h>
+#endif
+
+namespace SensorTypes {
+
+namespace {
+
+// Overloads pick the Talon base for Talon types and nullptr for sensors
+Talon* asTalon(Talon* talon) { return talon; }
+Talon* asTalon(Sensor*) { return nullptr; }
+
+template <typename T>
+Created place(T* object) {
+    if (object == nullptr) return {nullptr, nullptr, nullptr};
+    return {object, object, asTalon(object)};
+}
+
+// Factories with the default ports and hardware versions of each type, ports are set by detection
+Created createAuxTalon(const CreateContext& c) { return place(c.arena->create<AuxTalon>(0, 0x14)); }
+Created createI2CTalon(const CreateContext& c) { return place(c.arena->create<I2CTalon>(0, 0x21)); }
+Created createSDI12Talon(const CreateContext& c) { return place(c.arena->create<SDI12Talon>(0, 0x14)); }
+#if SENSOR_HAAR
+Created createHaar(const CreateContext& c) { return place(c.arena->create<Haar>(0, 0, 0x20)); }
+#define DRIVER_HAAR sizeof(Haar), createHaar
+#else
+#define DRIVER_HAAR 0, nullptr
+#endif
+#if SENSOR_O2
+Created createO2(const CreateContext& c) { return place(c.arena->create<SO421>(*c.sdi12Talon, 0, 0)); }
+#define DRIVER_O2 sizeof(SO421), createO2
+#else
+#define DRIVER_O2 0, nullptr
+#endif
+#if SENSOR_APOGEE_SOLAR
+Created createApogeeSolar(const CreateContext& c) { return place(c.arena->create<SP421>(*c.sdi12Talon, 0, 0)); }
+#define DRIVER_APOGEE_SOLAR sizeof(SP421), createApogeeSolar
+#else
+#define DRIVER_APOGEE_SOLAR 0, nullptr
+#endif
+#if SENSOR_SOIL
+Created createSoil(const CreateContext& c) { return place(c.arena->create<TDR315H>(*c.sdi12Talon, 0, 0)); }
+#define DRIVER_SOIL sizeof(TDR315H), createSoil
+#else
+#define DRIVER_SOIL 0, nullptr
+#endif
+#if SENSOR_CO2
+Created createCO2(const CreateContext& c) { return place(c.arena->create<Hedorah>(0, 0, 0x10)); }
+#define DRIVER_CO2 sizeof(Hedorah), createCO2
+#else
+#define DRIVER_CO2 0, nullptr
+#endif
+#if SENSOR_ET
+Created createET(const CreateContext& c) { return place(c.arena->create<LI710>(*c.timeProvider, *c.sdi12Interface, 0, 0)); }
+#define DRIVER_ET sizeof(LI710), createET
+#else
+#define DRIVER_ET 0, nullptr
+#endif
+#if SENSOR_PRESSURE
+Created createPressure(const CreateContext& c) { return place(c.arena->create<BaroVue10>(*c.sdi12Talon, 0, 0x00)); }
+#define DRIVER_PRESSURE sizeof(BaroVue10), createPressure
+#else
+#define DRIVER_PRESSURE 0, nullptr
+#endif
+#if SENSOR_ANALOG_MUX
+Created createAnalogMux(const CreateContext& c) { return place(c.arena->create<SDI12AnalogMux>(*c.sdi12Interface, 0, 0, 0x00)); }
+#define DRIVER_ANALOG_MUX sizeof(SDI12AnalogMux), createAnalogMux
+#else
+#define DRIVER_ANALOG_MUX 0, nullptr
+#endif
+
+// Indexed by Kind. Slots follow the released UID layout, sensors also give the JSON order
+constexpr TypeInfo TYPES[NUM_KINDS] = {
+    {"AuxTalons",   SECTION_SYSTEM,  BUS_TALON, 1, 0, sizeof(AuxTalon), createAuxTalon},
+    {"I2CTalons",   SECTION_SYSTEM,  BUS_TALON, 1, 1, sizeof(I2CTalon), createI2CTalon},
+    {"SDI12Talons", SECTION_SYSTEM,  BUS_TALON, 1, 2, sizeof(SDI12Talon), createSDI12Talon},
+    {"Haar",        SECTION_SENSORS, BUS_I2C,   0, 1, DRIVER_HAAR},
+    {"O2",          SECTION_SENSORS, BUS_SDI12, 0, 5, DRIVER_O2},
+    {"ApogeeSolar", SECTION_SENSORS, BUS_SDI12, 0, 3, DRIVER_APOGEE_SOLAR},
+    {"Soil",        SECTION_SENSORS, BUS_SDI12, 3, 2, DRIVER_SOIL},
+    {"CO2",         SECTION_SENSORS, BUS_I2C,   0, 4, DRIVER_CO2},
+    {"ET",          SECTION_SENSORS, BUS_SDI12, 0, 0, DRIVER_ET},
+    {"Pressure",    SECTION_SENSORS, BUS_SDI12, 0, 6, DRIVER_PRESSURE},
+    {"AnalogMux",   SECTION_SENSORS, BUS_SDI12, 0, 7, DRIVER_ANALOG_MUX},
+};
+
+// Slots in range and not shared within a section
+constexpr bool slotsValid() {
+    for (uint8_t i = 0; i < NUM_KINDS; i++) {
+        uint8_t slots = TYPES[i].section == SECTION_SYSTEM ? NUM_SYSTEM_SLOTS : NUM_SENSOR_SLOTS;
+        if (TYPES[i].slot >= slots) return false;
+        for (uint8_t j = 0; j < i; j++) {
+            if (TYPES[j].section == TYPES[i].section && TYPES[j].slot == TYPES[i].slot) return false;
+        }
+    }
+    return true;
+}
+
+// Talons ahead of sensors, so Talon indexes do not move when sensors are added
+constexpr bool talonsFirst() {
+    for (uint8_t i = 1; i < NUM_KINDS; i++) {
+        if (TYPES[i].bus == BUS_TALON && TYPES[i - 1].bus != BUS_TALON) return false;
+    }
+    return true;
+}
+
+static_assert(slotsValid(), "No two types of a section may share a slot");
+static_assert(talonsFirst(), "Talon types must come before sensor types");
+
+} // namespace
+
+const TypeInfo& get(Kind kind) {
+    return TYPES[kind];
+}
+
+bool find(Section section, const char* name, size_t length, Kind& kind) {
+    for (uint8_t i = 0; i < NUM_KINDS; i++) {
+        if (TYPES[i].section != section) continue;
+        if (strlen(TYPES[i].name) != length || memcmp(TYPES[i].name, name, length) != 0) continue;
+        kind = (Kind)i;
+        return true;
+    }
+    return false;
+}
+
+bool findSlot(Section section, uint8_t slot, Kind& kind) {
+    for (uint8_t i = 0; i < NUM_KINDS; i++) {
+        if (TYPES[i].section != section || TYPES[i].slot != slot) continue;
+        kind = (Kind)i;
+        return true;
+    }
+    return false;
+}
+
+} // namespace SensorTypes
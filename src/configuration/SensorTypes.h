@@ -0,0 +1,129 @@
+/**
+ * @file SensorTypes.h
+ * @brief Registry of the Talon and sensor types a configuration can ask for.
+ *
+ * Each type is listed once in SensorTypes.cpp with its configuration name,
+ * bus, default count, slot and factory. ConfigurationManager parses, prints,
+ * compares and backs up the counts from the registry, SensorManager creates
+ * and orders the objects from it. Adding a type is one Kind and one registry
+ * row, plus a ConfigImage field if its count is to survive in EEPROM.
+ *
+ * Sensor drivers can be left out of a product build by defining their flag
+ * false (e.g. -DSENSOR_HAAR=false). The type still parses and keeps its
+ * count, so configurations and UIDs stay the same across builds, but no
+ * object is created and the driver is not linked into the image.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef SENSOR_TYPES_H
+#define SENSOR_TYPES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef SENSOR_HAAR
+#define SENSOR_HAAR true
+#endif
+#ifndef SENSOR_O2
+#define SENSOR_O2 true
+#endif
+#ifndef SENSOR_APOGEE_SOLAR
+#define SENSOR_APOGEE_SOLAR true
+#endif
+#ifndef SENSOR_SOIL
+#define SENSOR_SOIL true
+#endif
+#ifndef SENSOR_CO2
+#define SENSOR_CO2 true
+#endif
+#ifndef SENSOR_ET
+#define SENSOR_ET true
+#endif
+#ifndef SENSOR_PRESSURE
+#define SENSOR_PRESSURE true
+#endif
+#ifndef SENSOR_ANALOG_MUX
+#define SENSOR_ANALOG_MUX true
+#endif
+
+class Sensor;
+class Talon;
+class SDI12Talon;
+class SensorArena;
+class ITimeProvider;
+class ISDI12Talon;
+
+namespace SensorTypes {
+
+// Creation order, Talons first. Reordering moves sensors relative to saved detection maps
+enum Kind : uint8_t {
+    AUX_TALON,
+    I2C_TALON,
+    SDI12_TALON,
+    HAAR,
+    O2,
+    APOGEE_SOLAR,
+    SOIL,
+    CO2,
+    ET,
+    PRESSURE,
+    ANALOG_MUX,
+    NUM_KINDS
+};
+
+enum Section : uint8_t {
+    SECTION_SYSTEM,  ///< Count field in "system", Talons
+    SECTION_SENSORS  ///< Count field in "sensors"
+};
+
+enum Bus : uint8_t {
+    BUS_TALON, ///< A Talon, reached over the I2C bus
+    BUS_I2C,   ///< Sensor on an I2C Talon port
+    BUS_SDI12  ///< Sensor behind the first SDI12 Talon, only created if there is one
+};
+
+static const uint8_t NUM_SYSTEM_SLOTS = 3;  ///< Talon counts held by the system UID, 2 bits each
+static const uint8_t NUM_SENSOR_SLOTS = 8;  ///< Sensor counts held by the sensor UID, 4 bits each
+
+// What a factory may need, fields a type does not use can be null
+struct CreateContext {
+    SensorArena* arena;
+    SDI12Talon* sdi12Talon;
+    ITimeProvider* timeProvider;
+    ISDI12Talon* sdi12Interface;
+};
+
+struct Created {
+    void* object;   ///< As constructed, for SensorArena::destroy()
+    Sensor* sensor; ///< nullptr if the arena was full
+    Talon* talon;   ///< nullptr for sensors
+};
+
+struct TypeInfo {
+    const char* name;      ///< Count field "num" + name, sampling periods "period" + name [+ "_<instance>"]
+    Section section;
+    Bus bus;
+    uint8_t defaultCount;  ///< Count when the section is given without the field
+    uint8_t slot;          ///< Place in the section's JSON, UID, ConfigImage fields and period types, fixed once released
+    size_t size;           ///< sizeof the driver, 0 if compiled out
+    Created (*create)(const CreateContext& context); ///< nullptr if compiled out
+};
+
+const TypeInfo& get(Kind kind);
+
+/**
+ * @brief Type whose name matches a span, as found after "num" or "period"
+ * @return false if no type of that section has the name
+ */
+bool find(Section section, const char* name, size_t length, Kind& kind);
+
+/**
+ * @brief Type held in a slot of a section
+ * @return false if the slot is unused
+ */
+bool findSlot(Section section, uint8_t slot, Kind& kind);
+
+} // namespace SensorTypes
+
+#endif // SENSOR_TYPES_H
@@ -0,0 +1,144 @@
+/**
+ * @file ConcurrentSDI12Talon.cpp
+ * @brief Implementation of the ConcurrentSDI12Talon class.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "ConcurrentSDI12Talon.h"
+#include <string.h>
+
+ConcurrentSDI12Talon::ConcurrentSDI12Talon(ISDI12Talon& talon, ITimeProvider& timeProvider)
+    : m_talon(talon),
+      m_timeProvider(timeProvider),
+      m_participantCount(0),
+      m_activeTalonPort(0),
+      m_activeSensorPort(0),
+      m_serving(-1),
+      m_waitSumMs(0),
+      m_waitMaxMs(0),
+      m_waitSavedMs(0) {
+}
+
+void ConcurrentSDI12Talon::setActivePort(uint8_t talonPort, uint8_t sensorPort) {
+    m_activeTalonPort = talonPort;
+    m_activeSensorPort = sensorPort;
+    m_serving = -1;
+}
+
+int ConcurrentSDI12Talon::find(uint8_t talonPort, uint8_t sensorPort, int address) const {
+    for (uint8_t i = 0; i < m_participantCount; i++) {
+        const Participant& p = m_participants[i];
+        if (p.talonPort == talonPort && p.sensorPort == sensorPort && p.address == address) return i;
+    }
+    return -1;
+}
+
+uint8_t ConcurrentSDI12Talon::countValues(const char* response) {
+    uint8_t count = 0;
+    for (const char* c = response + 1; *c != '\0'; c++) { //Skip address, every value starts with its sign
+        if (*c == '+' || *c == '-') count++;
+    }
+    return count;
+}
+
+bool ConcurrentSDI12Talon::startConcurrent(uint8_t index) {
+    if (index >= m_participantCount) return false;
+    Participant& p = m_participants[index];
+    p.started = false;
+    p.responseCount = 0;
+    String response = m_talon.command("C", p.address); //Response is atttnn, ttt seconds until ready, nn values
+    response.trim();
+    if (response.length() < 4) return false;
+    int seconds = 0;
+    for (uint8_t i = 1; i < 4; i++) {
+        char c = response.charAt(i);
+        if (c < '0' || c > '9') return false;
+        seconds = seconds * 10 + (c - '0');
+    }
+    p.valuesExpected = (uint8_t)response.substring(4).toInt();
+    uint32_t waitMs = (uint32_t)seconds * 1000;
+    p.readyAt = m_timeProvider.millis() + waitMs;
+    p.started = true;
+    m_waitSumMs += waitMs;
+    if (waitMs > m_waitMaxMs) m_waitMaxMs = waitMs;
+    return true;
+}
+
+void ConcurrentSDI12Talon::waitForMeasurements() {
+    uint32_t longest = 0;
+    uint32_t now = m_timeProvider.millis();
+    for (uint8_t i = 0; i < m_participantCount; i++) {
+        const Participant& p = m_participants[i];
+        if (!p.started) continue;
+        int32_t remaining = (int32_t)(p.readyAt - now); //Signed difference is rollover safe
+        if (remaining > 0 && (uint32_t)remaining > longest) longest = remaining;
+    }
+    if (longest > 0) m_timeProvider.delay(longest);
+    m_waitSavedMs = m_waitSumMs > m_waitMaxMs ? m_waitSumMs - m_waitMaxMs : 0;
+}
+
+bool ConcurrentSDI12Talon::collect(uint8_t index) {
+    if (index >= m_participantCount || !m_participants[index].started) return false;
+    Participant& p = m_participants[index];
+    uint8_t values = 0;
+    p.responseCount = 0;
+    char commandStr[3] = {'D', '0', '\0'};
+    for (uint8_t d = 0; d < MAX_DATA_COMMANDS; d++) {
+        commandStr[1] = '0' + d;
+        String response = m_talon.command(commandStr, p.address);
+        if (response.length() == 0) break;
+        response.toCharArray(p.responses[d], MAX_RESPONSE_LENGTH);
+        p.responseCount++;
+        uint8_t found = countValues(p.responses[d]);
+        values += found;
+        if (found == 0 || values >= p.valuesExpected) break; //Empty response or all announced values read
+    }
+    p.started = false;
+    return p.responseCount > 0;
+}
+
+void ConcurrentSDI12Talon::endCycle() {
+    for (uint8_t i = 0; i < m_participantCount; i++) {
+        m_participants[i].started = false;
+        m_participants[i].responseCount = 0;
+    }
+    m_serving = -1;
+    m_waitSumMs = 0;
+    m_waitMaxMs = 0;
+}
+
+void ConcurrentSDI12Talon::clearParticipants() {
+    m_participantCount = 0;
+    m_serving = -1;
+}
+
+int ConcurrentSDI12Talon::startMeasurment(int Address) {
+    int index = find(m_activeTalonPort, m_activeSensorPort, Address);
+    if (index >= 0 && m_participants[index].responseCount > 0) { //Measurement already taken concurrently, data is ready now
+        m_serving = index;
+        return 0;
+    }
+    m_serving = -1;
+    if (index < 0 && m_activeTalonPort > 0 && m_activeSensorPort > 0 && m_participantCount < MAX_PARTICIPANTS) { //Learn this sensor, it is measured concurrently from the next cycle on
+        Participant& p = m_participants[m_participantCount++];
+        p.talonPort = m_activeTalonPort;
+        p.sensorPort = m_activeSensorPort;
+        p.address = Address;
+        p.started = false;
+        p.readyAt = 0;
+        p.valuesExpected = 0;
+        p.responseCount = 0;
+    }
+    return m_talon.startMeasurment(Address);
+}
+
+String ConcurrentSDI12Talon::command(String commandStr, int address) {
+    if (m_serving >= 0 && m_participants[m_serving].address == address && commandStr.length() == 2 && commandStr.charAt(0) == 'D') {
+        Participant& p = m_participants[m_serving];
+        int d = commandStr.charAt(1) - '0';
+        if (d >= 0 && d < p.responseCount) return String(p.responses[d]);
+        //Data command past what was collected, the sensor still holds the values so ask it directly
+    }
+    return m_talon.command(commandStr, address);
+}
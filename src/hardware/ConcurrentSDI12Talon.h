@@ -0,0 +1,135 @@
+/**
+ * @file ConcurrentSDI12Talon.h
+ * @brief ISDI12Talon decorator that takes SDI-12 measurements concurrently.
+ *
+ * Sensors that read through ISDI12Talon normally issue aM!, block for the
+ * announced time and then read aD0!. This decorator learns which sensors
+ * (Talon port, sensor port, address) measure through it, starts aC!
+ * concurrent measurements on all of them at once, waits only for the
+ * longest announced time, and collects the aDn! responses. When the driver
+ * later calls startMeasurment() the wait is reported as 0 and its data
+ * commands are answered from the collected responses, so cycle latency
+ * tracks the slowest sensor instead of the sum of all of them.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef CONCURRENT_SDI12_TALON_H
+#define CONCURRENT_SDI12_TALON_H
+
+#include "ISDI12Talon.h"
+#include "ITimeProvider.h"
+
+/**
+ * @brief Concurrent measurement scheduling on top of an ISDI12Talon
+ *
+ * Usage per cycle: for each participant open its ports and call
+ * startConcurrent(), then waitForMeasurements(), then open each port again
+ * and call collect(). Before each sensor read call setActivePort() so
+ * requests are matched to the right participant. endCycle() drops anything
+ * not consumed. Every ISDI12Talon call not answered from a collected
+ * measurement is passed straight through.
+ */
+class ConcurrentSDI12Talon : public ISDI12Talon {
+public:
+    static const uint8_t MAX_PARTICIPANTS = 16;
+    static const uint8_t MAX_DATA_COMMANDS = 3; ///< aD0! to aD2!, enough for 9+ values per sensor
+    static const uint8_t MAX_RESPONSE_LENGTH = 82; ///< 75 characters of values plus address, CRC and CR LF
+
+    ConcurrentSDI12Talon(ISDI12Talon& talon, ITimeProvider& timeProvider);
+    ~ConcurrentSDI12Talon() override = default;
+
+    /**
+     * @brief Set the ports of the sensor about to be read
+     */
+    void setActivePort(uint8_t talonPort, uint8_t sensorPort);
+
+    uint8_t getParticipantCount() const { return m_participantCount; }
+    uint8_t getParticipantTalonPort(uint8_t index) const { return m_participants[index].talonPort; }
+    uint8_t getParticipantSensorPort(uint8_t index) const { return m_participants[index].sensorPort; }
+
+    /**
+     * @brief Send aC! to a participant, its ports must be open
+     * @return true if the sensor announced a measurement
+     */
+    bool startConcurrent(uint8_t index);
+
+    /**
+     * @brief Block until the longest announced measurement of this cycle is done
+     */
+    void waitForMeasurements();
+
+    /**
+     * @brief Read the aDn! responses of a started participant, its ports must be open
+     * @return true if at least one response was collected
+     */
+    bool collect(uint8_t index);
+
+    /**
+     * @brief Drop collected responses, participants are kept for the next cycle
+     */
+    void endCycle();
+
+    /**
+     * @brief Forget all participants, use when sensors are detected again
+     */
+    void clearParticipants();
+
+    /**
+     * @brief Sum of announced waits minus the longest one, for the last cycle
+     */
+    uint32_t getWaitSavedMs() const { return m_waitSavedMs; }
+
+    // SDI12 communication methods
+    int getAddress() override { return m_talon.getAddress(); }
+    String sendCommand(String command) override { return m_talon.sendCommand(command); }
+    String command(String commandStr, int address) override;
+    int startMeasurment(int Address) override;
+    int startMeasurmentIndex(int index, int Address) override { return m_talon.startMeasurmentIndex(index, Address); }
+    String continuousMeasurmentCRC(int Measure, int Address) override { return m_talon.continuousMeasurmentCRC(Measure, Address); }
+    bool testCRC(String message) override { return m_talon.testCRC(message); }
+
+    // Port management methods
+    int enableData(uint8_t port, bool state) override { return m_talon.enableData(port, state); }
+    int enablePower(uint8_t port, bool state) override { return m_talon.enablePower(port, state); }
+    void disableDataAll() override { m_talon.disableDataAll(); }
+    uint8_t getNumPorts() override { return m_talon.getNumPorts(); }
+
+    // Sensor interrogation
+    bool isPresent() override { return m_talon.isPresent(); }
+
+    // Error handling and state reporting
+    String getSensorPortString() override { return m_talon.getSensorPortString(); }
+    String getTalonPortString() override { return m_talon.getTalonPortString(); }
+    uint8_t getSensorPort() override { return m_talon.getSensorPort(); }
+    uint8_t getTalonPort() override { return m_talon.getTalonPort(); }
+    int restart() override { return m_talon.restart(); }
+
+private:
+    struct Participant {
+        uint8_t talonPort;
+        uint8_t sensorPort;
+        int address;
+        bool started;
+        uint32_t readyAt; ///< millis() when the announced measurement is done
+        uint8_t valuesExpected;
+        uint8_t responseCount;
+        char responses[MAX_DATA_COMMANDS][MAX_RESPONSE_LENGTH];
+    };
+
+    int find(uint8_t talonPort, uint8_t sensorPort, int address) const;
+    static uint8_t countValues(const char* response);
+
+    ISDI12Talon& m_talon;
+    ITimeProvider& m_timeProvider;
+    Participant m_participants[MAX_PARTICIPANTS];
+    uint8_t m_participantCount;
+    uint8_t m_activeTalonPort;
+    uint8_t m_activeSensorPort;
+    int m_serving; ///< Participant whose collected responses answer data commands, -1 if none
+    uint32_t m_waitSumMs;
+    uint32_t m_waitMaxMs;
+    uint32_t m_waitSavedMs;
+};
+
+#endif // CONCURRENT_SDI12_TALON_H
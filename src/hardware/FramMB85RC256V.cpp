@@ -0,0 +1,30 @@
+/**
+ * @file FramMB85RC256V.cpp
+ * @brief Implementation of the FramMB85RC256V class.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+ #include "FramMB85RC256V.h"
+
+ FramMB85RC256V::FramMB85RC256V(int addr) : fram(Wire, addr), addr(addr) {
+     // Same device KestrelFileHandler uses, on the Kestrel internal bus
+ }
+ 
+ bool FramMB85RC256V::begin() {
+     fram.begin(); // Library begin() does not touch the bus
+     Wire.beginTransmission(BASE_ADDRESS | addr);
+     return Wire.endTransmission() == 0; // Missing or unpowered part does not ACK its address
+ }
+ 
+ size_t FramMB85RC256V::length() {
+     return fram.length();
+ }
+ 
+ bool FramMB85RC256V::readData(uint32_t framAddr, uint8_t* data, size_t dataLen) {
+     return fram.readData(framAddr, data, dataLen);
+ }
+ 
+ bool FramMB85RC256V::writeData(uint32_t framAddr, const uint8_t* data, size_t dataLen) {
+     return fram.writeData(framAddr, data, dataLen);
+ }
@@ -0,0 +1,40 @@
+/**
+ * @file FramMB85RC256V.h
+ * @brief Concrete implementation of IFram using the MB85RC256V FRAM.
+ *
+ * Adapts the MB85RC256V (32 KB, I2C) on the Kestrel to the IFram interface
+ * for dependency injection and testing.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+ #ifndef FRAM_MB85RC256V_H
+ #define FRAM_MB85RC256V_H
+ 
+ #include "IFram.h"
+ #include "MB85RC256V-FRAM-RK.h" // Include the actual MB85RC256V library
+ 
+ /**
+  * @brief Concrete implementation of IFram using MB85RC256V
+  */
+ class FramMB85RC256V : public IFram {
+ public:
+     explicit FramMB85RC256V(int addr = 0);
+     ~FramMB85RC256V() override = default;
+ 
+     /**
+      * @brief Start the driver and probe the part
+      * @return true if the FRAM acknowledged its address
+      */
+     bool begin() override;
+     size_t length() override;
+     bool readData(uint32_t framAddr, uint8_t* data, size_t dataLen) override;
+     bool writeData(uint32_t framAddr, const uint8_t* data, size_t dataLen) override;
+ 
+ private:
+     static const uint8_t BASE_ADDRESS = 0x50; ///< 7 bit address with A0-A2 low
+     MB85RC256V fram;
+     int addr;
+ };
+ 
+ #endif // FRAM_MB85RC256V_H
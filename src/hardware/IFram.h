@@ -0,0 +1,27 @@
+/**
+ * @file IFram.h
+ * @brief Interface for byte addressable FRAM.
+ *
+ * Lets storage built on the Kestrel FRAM (RecordRing) run against an in
+ * memory fake in tests.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef IFRAM_H
+#define IFRAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class IFram {
+public:
+    virtual ~IFram() = default;
+
+    virtual bool begin() = 0;
+    virtual size_t length() = 0; ///< Size in bytes
+    virtual bool readData(uint32_t framAddr, uint8_t* data, size_t dataLen) = 0;
+    virtual bool writeData(uint32_t framAddr, const uint8_t* data, size_t dataLen) = 0;
+};
+
+#endif // IFRAM_H
@@ -0,0 +1,195 @@
+/**
+ * @file BackhaulBatcher.cpp
+ * @brief Implementation of publish payload batching
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "BackhaulBatcher.h"
+#include <string.h>
+
+BackhaulBatcher::BackhaulBatcher(char* buffer, size_t capacity, FlushHandler handler)
+    : m_buffer(buffer),
+      m_slotSize(capacity / MAX_GROUPS),
+      m_limit(0),
+      m_deadline(0),
+      m_handler(handler),
+      m_packets(0),
+      m_payloads(0)
+{
+    memset(m_groups, 0, sizeof(m_groups));
+}
+
+void BackhaulBatcher::configure(size_t payloadLimit, unsigned long flushDeadlineMs)
+{
+    flush(); //Pending batches were sized for the old limit
+    m_limit = payloadLimit;
+    if (m_slotSize < 3) m_limit = 0;
+    else if (m_limit > m_slotSize - 2) m_limit = m_slotSize - 2; //Slot holds the reserved '[' byte, the payload and its null terminator
+    m_deadline = m_limit > 0 ? flushDeadlineMs : 0;
+}
+
+void BackhaulBatcher::add(const char* record, size_t len, uint8_t dataType, uint8_t destination, unsigned long now)
+{
+    if (!isEnabled()) {
+        uint16_t lines = 0;
+        for (size_t i = 0; i < len; i++) {
+            if ((i == 0 || record[i - 1] == '\n') && record[i] != '\n') lines++;
+        }
+        m_handler(record, len, dataType, destination);
+        m_packets += lines;
+        m_payloads += lines; //dumpFRAM() publishes each line on its own
+        return;
+    }
+    size_t start = 0;
+    while (start < len) {
+        const char* end = (const char*)memchr(record + start, '\n', len - start);
+        size_t lineLength = end == nullptr ? len - start : (size_t)(end - (record + start));
+        if (lineLength > 0) addPacket(record + start, lineLength, dataType, destination, now);
+        start += lineLength + 1;
+    }
+}
+
+void BackhaulBatcher::poll(unsigned long now)
+{
+    for (uint8_t g = 0; g < MAX_GROUPS; g++) {
+        if (m_groups[g].used && now - m_groups[g].started >= m_deadline) flushGroup(g);
+    }
+}
+
+void BackhaulBatcher::flush()
+{
+    while (true) { //Oldest batch first, so records reach FRAM in the order they were logged
+        int oldest = -1;
+        for (uint8_t g = 0; g < MAX_GROUPS; g++) {
+            if (m_groups[g].used && (oldest < 0 || m_groups[g].started - m_groups[oldest].started > 0x7FFFFFFFUL)) oldest = g;
+        }
+        if (oldest < 0) return;
+        flushGroup(oldest);
+    }
+}
+
+uint8_t BackhaulBatcher::getPendingGroups() const
+{
+    uint8_t pending = 0;
+    for (uint8_t g = 0; g < MAX_GROUPS; g++) {
+        if (m_groups[g].used) pending++;
+    }
+    return pending;
+}
+
+int BackhaulBatcher::findGroup(uint8_t dataType, uint8_t destination)
+{
+    for (uint8_t g = 0; g < MAX_GROUPS; g++) {
+        if (m_groups[g].used && m_groups[g].dataType == dataType && m_groups[g].destination == destination) return g;
+    }
+    return -1;
+}
+
+void BackhaulBatcher::addPacket(const char* packet, size_t len, uint8_t dataType, uint8_t destination, unsigned long now)
+{
+    bool encoded = packet[0] == '~';
+    int index = findGroup(dataType, destination);
+    if (len > m_limit) { //Can never share a payload, send it on its own after what is already queued
+        if (index >= 0) flushGroup(index);
+        emit(packet, len, dataType, destination, 1); //Straight from the record, not null terminated
+        return;
+    }
+    if (index >= 0) {
+        Group& group = m_groups[index];
+        size_t content = group.length - 1;
+        size_t needed = encoded ? content + len : content + 1 + len + 2; //Comma, then brackets around the array
+        if (group.encoded != encoded || needed > m_limit) flushGroup(index);
+    }
+    if (index < 0) {
+        for (uint8_t g = 0; g < MAX_GROUPS && index < 0; g++) {
+            if (!m_groups[g].used) index = g;
+        }
+        if (index < 0) { //Every slot busy with other groups, make room by sending the oldest
+            index = 0;
+            for (uint8_t g = 1; g < MAX_GROUPS; g++) {
+                if (m_groups[g].started - m_groups[index].started > 0x7FFFFFFFUL) index = g;
+            }
+            flushGroup(index);
+        }
+    }
+    if (!m_groups[index].used) { //New group, or the slot was just flushed
+        Group& group = m_groups[index];
+        group.dataType = dataType;
+        group.destination = destination;
+        group.used = true;
+        group.encoded = encoded;
+        group.count = 0;
+        group.length = 1; //Byte 0 is reserved for '['
+        group.started = now;
+    }
+    Group& group = m_groups[index];
+    char* data = slot(index);
+    if (group.count > 0 && !encoded) data[group.length++] = ',';
+    memcpy(data + group.length, packet, len);
+    group.length += len;
+    group.count++;
+}
+
+void BackhaulBatcher::flushGroup(uint8_t index)
+{
+    Group& group = m_groups[index];
+    if (!group.used) return;
+    char* data = slot(index);
+    group.used = false;
+    if (group.count > 1 && !group.encoded) {
+        data[0] = '[';
+        data[group.length] = ']';
+        data[group.length + 1] = '\0';
+        emit(data, group.length + 1, group.dataType, group.destination, group.count);
+    }
+    else {
+        data[group.length] = '\0';
+        emit(data + 1, group.length - 1, group.dataType, group.destination, group.count);
+    }
+}
+
+void BackhaulBatcher::emit(const char* payload, size_t len, uint8_t dataType, uint8_t destination, uint16_t packets)
+{
+    m_handler(payload, len, dataType, destination);
+    m_packets += packets;
+    m_payloads++;
+}
+
+void BackhaulBatcher::split(const char* text, size_t len, std::vector<std::string>& packets)
+{
+    if (len == 0) return;
+    if (text[0] == '~') {
+        size_t start = 0;
+        for (size_t i = 1; i <= len; i++) {
+            if (i == len || text[i] == '~') {
+                packets.push_back(std::string(text + start, i - start));
+                start = i;
+            }
+        }
+        return;
+    }
+    if (text[0] != '[') {
+        packets.push_back(std::string(text, len));
+        return;
+    }
+    int depth = 0;
+    bool inString = false;
+    size_t start = 1;
+    for (size_t i = 1; i < len; i++) {
+        char c = text[i];
+        if (inString) {
+            if (c == '\\') i++;
+            else if (c == '"') inString = false;
+            continue;
+        }
+        if (c == '"') inString = true;
+        else if (c == '{' || c == '[') depth++;
+        else if (c == '}' || (c == ']' && depth > 0)) depth--;
+        else if (depth == 0 && (c == ',' || c == ']')) {
+            if (i > start) packets.push_back(std::string(text + start, i - start));
+            start = i + 1;
+            if (c == ']') return;
+        }
+    }
+}
@@ -0,0 +1,116 @@
+/**
+ * @file BackhaulBatcher.h
+ * @brief Packs several packets into one publish payload before they reach FRAM.
+ *
+ * dumpFRAM() publishes every FRAM record on its own, so each packet costs a
+ * cloud round trip and one event against the publish rate limit. With batching
+ * enabled, records are held in RAM per (DataType, destination) group and
+ * packets of the same group are joined into single line payloads of up to
+ * payloadLimit bytes:
+ *   - JSON packets become a JSON array, [{...},{...}]
+ *   - Encoded packets (PacketCodec, '~' prefix) are concatenated, ~AAA~BBB,
+ *     since '~' never appears in Base64
+ * A group is written out when its next packet would not fit, when its oldest
+ * packet is older than the flush deadline, and before every backhaul. A batch
+ * holding a single packet is written unchanged.
+ *
+ * Host tools split payloads back into packets with split().
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef BACKHAUL_BATCHER_H
+#define BACKHAUL_BATCHER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Groups packets by DataType and destination into publish sized payloads
+ *
+ * Batches live in a caller supplied buffer split into MAX_GROUPS slots, no
+ * heap. Completed payloads go to the flush handler, which writes them to FRAM.
+ * When disabled every record is handed to the handler unchanged, as before.
+ */
+class BackhaulBatcher {
+public:
+    static const uint8_t MAX_GROUPS = 4; ///< Error, Data, Diagnostic and Metadata for one destination
+
+    typedef void (*FlushHandler)(const char* payload, size_t len, uint8_t dataType, uint8_t destination);
+
+    /**
+     * @param buffer Batch storage, split evenly between the groups
+     * @param handler Receives each payload as len bytes. Batches are null terminated, a
+     *                packet sent on its own points into the record and is not
+     */
+    BackhaulBatcher(char* buffer, size_t capacity, FlushHandler handler);
+
+    /**
+     * @param payloadLimit Largest payload in bytes, clamped to the group slot size
+     * @param flushDeadlineMs Longest time a packet is held in RAM, 0 disables batching
+     */
+    void configure(size_t payloadLimit, unsigned long flushDeadlineMs);
+
+    bool isEnabled() const { return m_deadline > 0; }
+
+    /**
+     * @brief Queue a record of one or more packets separated by '\n'
+     * @param now Current millis(), starts the deadline of a new batch
+     */
+    void add(const char* record, size_t len, uint8_t dataType, uint8_t destination, unsigned long now);
+
+    /**
+     * @brief Write out every batch whose oldest packet has passed the deadline
+     */
+    void poll(unsigned long now);
+
+    /**
+     * @brief Write out every pending batch, call before dumpFRAM()
+     */
+    void flush();
+
+    uint8_t getPendingGroups() const;
+
+    // Statistics since the last resetStats()
+    unsigned long getPacketCount() const { return m_packets; } ///< Packets handed to the handler
+    unsigned long getPayloadCount() const { return m_payloads; } ///< Payloads handed to the handler, one publish each
+    float getPacketsPerPayload() const { return m_payloads == 0 ? 0.0f : (float)m_packets / (float)m_payloads; }
+    void resetStats() { m_packets = 0; m_payloads = 0; }
+
+    /**
+     * @brief Split a payload line back into its packets (host side)
+     *
+     * Lines that are not batches yield themselves.
+     */
+    static void split(const char* text, size_t len, std::vector<std::string>& packets);
+
+private:
+    struct Group {
+        uint8_t dataType;
+        uint8_t destination;
+        bool used;
+        bool encoded; ///< Holds '~' packets rather than JSON
+        uint16_t count;
+        size_t length; ///< Bytes in the slot, the slot starts with a reserved '[' byte
+        unsigned long started; ///< millis() of the oldest packet
+    };
+
+    int findGroup(uint8_t dataType, uint8_t destination);
+    void addPacket(const char* packet, size_t len, uint8_t dataType, uint8_t destination, unsigned long now);
+    void flushGroup(uint8_t index);
+    void emit(const char* payload, size_t len, uint8_t dataType, uint8_t destination, uint16_t packets);
+    char* slot(uint8_t index) const { return m_buffer + index * m_slotSize; }
+
+    char* m_buffer;
+    size_t m_slotSize;
+    size_t m_limit;
+    unsigned long m_deadline;
+    FlushHandler m_handler;
+    Group m_groups[MAX_GROUPS];
+    unsigned long m_packets;
+    unsigned long m_payloads;
+};
+
+#endif // BACKHAUL_BATCHER_H
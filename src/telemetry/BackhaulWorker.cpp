@@ -0,0 +1,83 @@
+/**
+ * @file BackhaulWorker.cpp
+ * @brief Implementation of the backhaul state machine
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "BackhaulWorker.h"
+
+BackhaulWorker::BackhaulWorker()
+    : m_state(STATE_IDLE),
+      m_pending(false),
+      m_connect(false),
+      m_timeout(0),
+      m_requested(0),
+      m_transferStarted(0),
+      m_transfers(0),
+      m_timeouts(0),
+      m_merged(0),
+      m_lastConnectMs(0),
+      m_lastTransferMs(0)
+{
+}
+
+void BackhaulWorker::request(unsigned long now, bool connect, unsigned long connectTimeoutMs)
+{
+    if (m_pending) { //Not started yet, one transfer covers both
+        m_merged++;
+        m_connect = m_connect || connect;
+        return;
+    }
+    if (m_state != STATE_IDLE) { //Connecting or transferring, keep its start time and timeout, records stay stored for the next request
+        m_merged++;
+        return;
+    }
+    m_pending = true;
+    m_connect = connect;
+    m_timeout = connectTimeoutMs;
+    m_requested = now;
+}
+
+BackhaulWorker::Action BackhaulWorker::step(unsigned long now, bool connected)
+{
+    switch (m_state) {
+        case STATE_IDLE:
+            if (!m_pending) return IDLE;
+            m_pending = false;
+            if (m_connect && !connected) {
+                m_state = STATE_CONNECTING;
+                return CONNECT;
+            }
+            m_state = STATE_TRANSFERRING; //Already connected, or sending whatever the connection allows as before
+            m_lastConnectMs = 0;
+            m_transferStarted = now;
+            return TRANSFER;
+
+        case STATE_CONNECTING:
+            if (connected) {
+                m_state = STATE_TRANSFERRING;
+                m_lastConnectMs = now - m_requested;
+                m_transferStarted = now;
+                return TRANSFER;
+            }
+            if (now - m_requested >= m_timeout) { //Records stay stored for the next request
+                m_state = STATE_IDLE;
+                m_timeouts++;
+                return IDLE;
+            }
+            return WAIT;
+
+        case STATE_TRANSFERRING:
+        default:
+            return WAIT; //Caller is still transferring
+    }
+}
+
+void BackhaulWorker::transferDone(unsigned long now)
+{
+    if (m_state != STATE_TRANSFERRING) return;
+    m_state = STATE_IDLE;
+    m_transfers++;
+    m_lastTransferMs = now - m_transferStarted;
+}
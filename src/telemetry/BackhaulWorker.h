@@ -0,0 +1,90 @@
+/**
+ * @file BackhaulWorker.h
+ * @brief Backhaul state machine run off the sampling path.
+ *
+ * The backhaul used to run inline in loop(): connect, wait up to five minutes
+ * for the cloud, sync time, dump FRAM. In low power modes that wait delays the
+ * next sample. The worker turns the sequence into steps that a separate thread
+ * (SYSTEM_THREAD is enabled) advances, while loop() keeps sampling on the
+ * logger timer. loop() only queues a request; records stay in FRAM until the
+ * worker is connected and transfers them.
+ *
+ * The worker holds no hardware. step() tells the caller what to do next, so
+ * the same logic runs on a thread on the device and inline in the simulator.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef BACKHAUL_WORKER_H
+#define BACKHAUL_WORKER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Queue of backhaul requests and the connect, transfer sequence for them
+ *
+ * Requests that arrive while one is running are merged into a single follow
+ * up, since a transfer always sends everything stored.
+ *
+ * Not thread safe. Every call, from loop() or the worker thread, must hold the
+ * same lock; the caller releases it while connecting.
+ */
+class BackhaulWorker {
+public:
+    enum Action {
+        IDLE,     ///< Nothing to do
+        CONNECT,  ///< Start connecting (Particle.connect()), then keep stepping
+        WAIT,     ///< Connecting, step again later
+        TRANSFER  ///< Sync time and send stored records, then call transferDone()
+    };
+
+    BackhaulWorker();
+
+    /**
+     * @brief Queue a backhaul, merged into one already queued or in progress
+     * @param connect Connect first and wait for the cloud, used in low power modes that drop the connection
+     * @param connectTimeoutMs Longest wait for the cloud before giving up until the next request
+     */
+    void request(unsigned long now, bool connect, unsigned long connectTimeoutMs);
+
+    /**
+     * @brief Advance the sequence
+     * @param connected Whether the cloud is connected now
+     */
+    Action step(unsigned long now, bool connected);
+
+    /**
+     * @brief The transfer asked for by step() has finished
+     */
+    void transferDone(unsigned long now);
+
+    bool isBusy() const { return m_state != STATE_IDLE || m_pending; }
+
+    // Statistics since boot
+    uint16_t getTransfers() const { return m_transfers; }
+    uint16_t getTimeouts() const { return m_timeouts; }
+    uint16_t getMerged() const { return m_merged; } ///< Requests merged into one already queued or in progress
+    unsigned long getLastConnectMs() const { return m_lastConnectMs; } ///< Request to connected, last transfer
+    unsigned long getLastTransferMs() const { return m_lastTransferMs; }
+
+private:
+    enum State {
+        STATE_IDLE,
+        STATE_CONNECTING,
+        STATE_TRANSFERRING
+    };
+
+    State m_state;
+    bool m_pending;
+    bool m_connect;
+    unsigned long m_timeout;
+    unsigned long m_requested;
+    unsigned long m_transferStarted;
+    uint16_t m_transfers;
+    uint16_t m_timeouts;
+    uint16_t m_merged;
+    unsigned long m_lastConnectMs;
+    unsigned long m_lastTransferMs;
+};
+
+#endif // BACKHAUL_WORKER_H
@@ -0,0 +1,378 @@
+/**
+ * @file DataDiff.cpp
+ * @brief Implementation of DataDiffEncoder and DataDiffDecoder classes
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "DataDiff.h"
+#include "PacketWriter.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const uint8_t DataDiffEncoder::MAX_DEVICES;
+const size_t DataDiffEncoder::MAX_ENTRY_LENGTH;
+
+namespace {
+    const char IDX_KEY[] = "\"Idx\"";
+    const size_t IDX_KEY_LENGTH = sizeof(IDX_KEY) - 1;
+
+    struct Span {
+        const char* ptr;
+        size_t len;
+
+        bool equals(const Span& other) const {
+            return len == other.len && strncmp(ptr, other.ptr, len) == 0;
+        }
+    };
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    /**
+     * @brief Find the end of the JSON value starting at pos
+     * @return Position just past the value, 0 if malformed
+     */
+    size_t skipValue(const char* s, size_t len, size_t pos) {
+        if (pos >= len) return 0;
+        if (s[pos] == '"') {
+            for (size_t i = pos + 1; i < len; i++) {
+                if (s[i] == '\\') i++;
+                else if (s[i] == '"') return i + 1;
+            }
+            return 0;
+        }
+        if (s[pos] == '{' || s[pos] == '[') {
+            int depth = 0;
+            for (size_t i = pos; i < len; i++) {
+                if (s[i] == '"') {
+                    i = skipValue(s, len, i);
+                    if (i == 0) return 0;
+                    i--;
+                }
+                else if (s[i] == '{' || s[i] == '[') depth++;
+                else if (s[i] == '}' || s[i] == ']') {
+                    if (--depth == 0) return i + 1;
+                }
+            }
+            return 0;
+        }
+        size_t i = pos;
+        while (i < len && s[i] != ',' && s[i] != '}' && s[i] != ']' && !isSpace(s[i])) i++;
+        return i > pos ? i : 0;
+    }
+
+    /**
+     * @brief Next "key":value pair of an object body (text between the braces)
+     * @return false at the end of the body or if malformed (ok is cleared)
+     */
+    bool nextField(const char* body, size_t len, size_t& pos, Span& key, Span& value, bool& ok) {
+        while (pos < len && (isSpace(body[pos]) || body[pos] == ',')) pos++;
+        if (pos >= len) return false;
+        size_t keyEnd = (body[pos] == '"') ? skipValue(body, len, pos) : 0;
+        if (keyEnd == 0) { ok = false; return false; }
+        key = {body + pos, keyEnd - pos};
+        pos = keyEnd;
+        while (pos < len && isSpace(body[pos])) pos++;
+        if (pos >= len || body[pos] != ':') { ok = false; return false; }
+        pos++;
+        while (pos < len && isSpace(body[pos])) pos++;
+        size_t valueEnd = skipValue(body, len, pos);
+        if (valueEnd == 0) { ok = false; return false; }
+        value = {body + pos, valueEnd - pos};
+        pos = valueEnd;
+        return true;
+    }
+
+    bool findField(const Span& body, const Span& key, Span& value) {
+        size_t pos = 0;
+        bool ok = true;
+        Span k, v;
+        while (nextField(body.ptr, body.len, pos, k, v, ok)) {
+            if (k.equals(key)) {
+                value = v;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Split a device entry "Name":{body} into its name (with quotes) and body
+     */
+    bool splitEntry(const char* entry, size_t len, Span& name, Span& body) {
+        size_t pos = 0;
+        bool ok = true;
+        Span value;
+        if (!nextField(entry, len, pos, name, value, ok)) return false;
+        while (pos < len && isSpace(entry[pos])) pos++;
+        if (pos != len || value.len < 2 || value.ptr[0] != '{') return false;
+        body = {value.ptr + 1, value.len - 2};
+        return true;
+    }
+
+    bool parseNumber(const Span& value, double& number) {
+        char buf[32];
+        if (value.len == 0 || value.len >= sizeof(buf)) return false;
+        memcpy(buf, value.ptr, value.len);
+        buf[value.len] = '\0';
+        char* end;
+        number = strtod(buf, &end);
+        return end == buf + value.len && isfinite(number);
+    }
+
+    bool extractLeaderValue(const std::string& leader, const char* key, std::string& value) {
+        size_t start = leader.find(key);
+        if (start == std::string::npos) return false;
+        start += strlen(key);
+        size_t end = skipValue(leader.c_str(), leader.length(), start);
+        if (end == 0) return false;
+        value = leader.substr(start, end - start);
+        return true;
+    }
+}
+
+DataDiffEncoder::DataDiffEncoder(char* keyframeBuffer, size_t keyframeCapacity)
+    : m_keyframe(keyframeBuffer),
+      m_keyframeCapacity(keyframeCapacity),
+      m_keyframeLength(0),
+      m_entryCount(0),
+      m_interval(0),
+      m_deadband(0),
+      m_packetCount(0),
+      m_keyframeNumber(0),
+      m_keyframeValid(false),
+      m_isKeyframe(true),
+      m_bytesSaved(0),
+      m_scratchLength(0) {
+}
+
+void DataDiffEncoder::configure(uint16_t keyframeInterval, uint16_t deadbandPermille) {
+    if (keyframeInterval != m_interval || deadbandPermille != m_deadband) m_keyframeValid = false;
+    m_interval = keyframeInterval;
+    m_deadband = deadbandPermille;
+}
+
+bool DataDiffEncoder::beginPacket() {
+    if (!isEnabled()) {
+        m_isKeyframe = true;
+        return true;
+    }
+    m_isKeyframe = !m_keyframeValid || m_packetCount >= m_interval;
+    if (m_isKeyframe) {
+        m_keyframeNumber++;
+        m_keyframeLength = 0;
+        m_entryCount = 0;
+        m_packetCount = 0;
+        m_keyframeValid = (m_keyframe != nullptr);
+    }
+    m_packetCount++;
+    return m_isKeyframe;
+}
+
+void DataDiffEncoder::writeLeader(PacketWriter& output) const {
+    if (!isEnabled()) return;
+    output.append(m_isKeyframe ? "\"KeyFrame\":" : "\"DiffOf\":").append((unsigned int)m_keyframeNumber).append(',');
+}
+
+bool DataDiffEncoder::appendDevice(PacketWriter& output, uint16_t sensorIndex, const char* entry, size_t len) {
+    if (entry == nullptr || len == 0) return true; //Empty entries are not part of Devices
+    if (!isEnabled()) return output.appendDevice(entry, len);
+    if (m_isKeyframe) {
+        bool appended = output.appendDevice(entry, len);
+        if (!appended || !storeKeyEntry(sensorIndex, entry, len)) m_keyframeValid = false; //Positions would not line up, start over next packet
+        return appended;
+    }
+    int position = findKeyEntry(sensorIndex);
+    if (position >= 0 && buildDiff(position, entry, len)) {
+        if (m_scratchLength < len) {
+            m_bytesSaved += len - m_scratchLength;
+            return output.appendDevice(m_scratch, m_scratchLength);
+        }
+        return output.appendDevice(entry, len); //Everything changed, full entry without Idx is shorter
+    }
+    m_keyframeValid = false; //Device not expressible against this keyframe, send it in full and refresh
+    return output.appendDevice(entry, len);
+}
+
+bool DataDiffEncoder::storeKeyEntry(uint16_t sensorIndex, const char* entry, size_t len) {
+    if (m_entryCount >= MAX_DEVICES || m_keyframeLength + len > m_keyframeCapacity || len > UINT16_MAX) return false;
+    memcpy(m_keyframe + m_keyframeLength, entry, len);
+    m_entries[m_entryCount].sensorIndex = sensorIndex;
+    m_entries[m_entryCount].offset = m_keyframeLength;
+    m_entries[m_entryCount].length = len;
+    m_entryCount++;
+    m_keyframeLength += len;
+    return true;
+}
+
+int DataDiffEncoder::findKeyEntry(uint16_t sensorIndex) const {
+    for (uint8_t i = 0; i < m_entryCount; i++) {
+        if (m_entries[i].sensorIndex == sensorIndex) return i;
+    }
+    return -1;
+}
+
+bool DataDiffEncoder::buildDiff(uint8_t position, const char* entry, size_t len) {
+    Span keyName, keyBody, name, body;
+    const KeyEntry& key = m_entries[position];
+    if (!splitEntry(m_keyframe + key.offset, key.length, keyName, keyBody)) return false;
+    if (!splitEntry(entry, len, name, body) || !name.equals(keyName)) return false;
+
+    int written = snprintf(m_scratch, sizeof(m_scratch), "%.*s:{%s:%u", (int)name.len, name.ptr, IDX_KEY, (unsigned int)position);
+    if (written < 0 || (size_t)written >= sizeof(m_scratch)) return false;
+    m_scratchLength = written;
+
+    size_t pos = 0;
+    bool ok = true;
+    Span field, value, keyValue;
+    while (nextField(body.ptr, body.len, pos, field, value, ok)) {
+        if (findField(keyBody, field, keyValue) && (value.equals(keyValue) || withinDeadband(keyValue.ptr, keyValue.len, value.ptr, value.len))) continue;
+        if (m_scratchLength + field.len + value.len + 3 > sizeof(m_scratch)) return false; //Comma, colon and closing brace
+        m_scratch[m_scratchLength++] = ',';
+        memcpy(m_scratch + m_scratchLength, field.ptr, field.len);
+        m_scratchLength += field.len;
+        m_scratch[m_scratchLength++] = ':';
+        memcpy(m_scratch + m_scratchLength, value.ptr, value.len);
+        m_scratchLength += value.len;
+    }
+    if (!ok) return false;
+
+    pos = 0;
+    while (nextField(keyBody.ptr, keyBody.len, pos, field, keyValue, ok)) { //Decoder keeps keyframe fields, none may disappear
+        if (!findField(body, field, value)) return false;
+    }
+    if (!ok) return false;
+    m_scratch[m_scratchLength++] = '}';
+    return true;
+}
+
+bool DataDiffEncoder::withinDeadband(const char* keyValue, size_t keyLength, const char* value, size_t length) const {
+    if (m_deadband == 0 || keyLength == 0 || length == 0) return false;
+    if (keyValue[0] == '[' && value[0] == '[') { //Arrays (PORT_V etc), every element must be within the deadband
+        Span keyArray = {keyValue + 1, keyLength - 2};
+        Span array = {value + 1, length - 2};
+        size_t keyPos = 0;
+        size_t pos = 0;
+        while (true) {
+            while (keyPos < keyArray.len && (isSpace(keyArray.ptr[keyPos]) || keyArray.ptr[keyPos] == ',')) keyPos++;
+            while (pos < array.len && (isSpace(array.ptr[pos]) || array.ptr[pos] == ',')) pos++;
+            bool keyDone = keyPos >= keyArray.len;
+            bool done = pos >= array.len;
+            if (keyDone || done) return keyDone && done; //Different lengths count as changed
+            size_t keyEnd = skipValue(keyArray.ptr, keyArray.len, keyPos);
+            size_t end = skipValue(array.ptr, array.len, pos);
+            if (keyEnd == 0 || end == 0) return false;
+            Span keyElement = {keyArray.ptr + keyPos, keyEnd - keyPos};
+            Span element = {array.ptr + pos, end - pos};
+            if (!element.equals(keyElement) && !withinDeadband(keyElement.ptr, keyElement.len, element.ptr, element.len)) return false;
+            keyPos = keyEnd;
+            pos = end;
+        }
+    }
+    double keyNumber, number;
+    if (!parseNumber({keyValue, keyLength}, keyNumber) || !parseNumber({value, length}, number)) return false;
+    return fabs(number - keyNumber) <= fabs(keyNumber) * m_deadband / 1000.0;
+}
+
+bool DataDiffDecoder::apply(const std::string& json, std::string& full) {
+    full = json;
+    const char DATA_PREFIX[] = "{\"Data\":{";
+    const char DEVICES[] = "\"Devices\":[";
+    if (json.compare(0, sizeof(DATA_PREFIX) - 1, DATA_PREFIX) != 0) return true; //Only data packets are diffed
+    size_t devicesStart = json.find(DEVICES);
+    if (devicesStart == std::string::npos) return true;
+    std::string leader = json.substr(0, devicesStart);
+
+    bool isKeyframe = true;
+    size_t tagStart = leader.find("\"KeyFrame\":");
+    if (tagStart == std::string::npos) {
+        tagStart = leader.find("\"DiffOf\":");
+        if (tagStart == std::string::npos) return true; //Full packet from a logger without diff packets
+        isKeyframe = false;
+    }
+    size_t tagEnd = leader.find(',', tagStart);
+    if (tagEnd == std::string::npos) return false;
+    long number = atol(leader.c_str() + leader.find(':', tagStart) + 1);
+    leader.erase(tagStart, tagEnd - tagStart + 1);
+
+    std::string id, packetId;
+    if (!extractLeaderValue(leader, "\"Device ID\":", id)) extractLeaderValue(leader, "\"Node ID\":", id);
+    extractLeaderValue(leader, "\"Packet ID\":", packetId);
+
+    //Device entries, without their braces
+    std::vector<std::string> devices;
+    const char* s = json.c_str();
+    size_t pos = devicesStart + sizeof(DEVICES) - 1;
+    while (pos < json.length() && json[pos] != ']') {
+        if (json[pos] == ',' || isSpace(json[pos])) { pos++; continue; }
+        if (json[pos] != '{') return false;
+        size_t end = skipValue(s, json.length(), pos);
+        if (end == 0) return false;
+        devices.push_back(json.substr(pos + 1, end - pos - 2));
+        pos = end;
+    }
+    if (pos >= json.length()) return false;
+    std::string tail = json.substr(pos);
+
+    Keyframe& keyframe = m_keyframes[id];
+    if (isKeyframe) {
+        if (keyframe.number != number || keyframe.packetId != packetId) { //New keyframe, not a continuation line of the current one
+            keyframe.devices.clear();
+            keyframe.number = number;
+            keyframe.packetId = packetId;
+        }
+        keyframe.devices.insert(keyframe.devices.end(), devices.begin(), devices.end());
+    }
+    else {
+        if (keyframe.number != number) return false; //Keyframe missing or superseded
+        for (std::string& device : devices) {
+            Span name, body, field, value, idx;
+            const Span idxKey = {IDX_KEY, IDX_KEY_LENGTH};
+            if (!splitEntry(device.c_str(), device.length(), name, body)) return false;
+            if (!findField(body, idxKey, idx)) continue; //Sent in full
+            size_t position = strtoul(std::string(idx.ptr, idx.len).c_str(), nullptr, 10);
+            if (position >= keyframe.devices.size()) return false;
+            const std::string& keyDevice = keyframe.devices[position];
+            Span keyName, keyBody;
+            if (!splitEntry(keyDevice.c_str(), keyDevice.length(), keyName, keyBody) || !keyName.equals(name)) return false;
+
+            std::string rebuilt(name.ptr, name.len);
+            rebuilt += ":{";
+            bool first = true;
+            size_t fieldPos = 0;
+            bool ok = true;
+            while (nextField(keyBody.ptr, keyBody.len, fieldPos, field, value, ok)) { //Keyframe order, changed values replaced
+                Span changed;
+                if (findField(body, field, changed)) value = changed;
+                if (!first) rebuilt += ',';
+                rebuilt.append(field.ptr, field.len).append(":").append(value.ptr, value.len);
+                first = false;
+            }
+            fieldPos = 0;
+            while (nextField(body.ptr, body.len, fieldPos, field, value, ok)) { //Fields the keyframe did not have
+                Span existing;
+                if (field.equals(idxKey) || findField(keyBody, field, existing)) continue;
+                if (!first) rebuilt += ',';
+                rebuilt.append(field.ptr, field.len).append(":").append(value.ptr, value.len);
+                first = false;
+            }
+            if (!ok) return false;
+            rebuilt += '}';
+            device = rebuilt;
+        }
+    }
+
+    full = leader + DEVICES;
+    for (size_t i = 0; i < devices.size(); i++) {
+        if (i > 0) full += ',';
+        full += '{';
+        full += devices[i];
+        full += '}';
+    }
+    full += tail;
+    return true;
+}
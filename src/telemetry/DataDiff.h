@@ -0,0 +1,136 @@
+/**
+ * @file DataDiff.h
+ * @brief Changed-fields-only data packets between periodic keyframes.
+ *
+ * Most fields of a data packet (Talon port voltages, static sensor fields)
+ * repeat from one cycle to the next. With diff packets enabled every Nth data
+ * packet is a full keyframe, tagged "KeyFrame":k in its leader. The packets in
+ * between are tagged "DiffOf":k and every device entry carries "Idx" (its
+ * position in the keyframe Devices array) plus only the fields that moved
+ * beyond the deadband from the keyframe value. The host rebuilds full packets
+ * with DataDiffDecoder.
+ *
+ * A device that can not be expressed against the keyframe (new, renamed, or
+ * missing a keyframe field) is sent in full without "Idx", and the next
+ * packet is forced to be a keyframe.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef DATA_DIFF_H
+#define DATA_DIFF_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+class PacketWriter;
+
+/**
+ * @brief Builds data packet device entries against the last keyframe
+ *
+ * Keyframe entries are kept in the caller's buffer, diff entries are built in
+ * a fixed internal scratch buffer, so the encoder never allocates.
+ */
+class DataDiffEncoder {
+public:
+    static const uint8_t MAX_DEVICES = 64;
+    static const size_t MAX_ENTRY_LENGTH = 1024; ///< Longest diff entry, matches Kestrel::MAX_MESSAGE_LENGTH
+
+    /**
+     * @param keyframeBuffer Storage for the keyframe device entries
+     */
+    DataDiffEncoder(char* keyframeBuffer, size_t keyframeCapacity);
+
+    /**
+     * @param keyframeInterval Every Nth data packet is a keyframe, 0 or 1 sends every packet in full
+     * @param deadbandPermille Numeric changes up to this fraction (in 1/1000) of the keyframe value are not sent
+     */
+    void configure(uint16_t keyframeInterval, uint16_t deadbandPermille);
+
+    bool isEnabled() const { return m_interval > 1; }
+
+    /**
+     * @brief Start a data packet
+     * @return true if this packet is a keyframe
+     */
+    bool beginPacket();
+
+    /**
+     * @brief Append the leader field identifying this packet as keyframe or diff
+     *
+     * Nothing is written when diff packets are disabled.
+     */
+    void writeLeader(PacketWriter& output) const;
+
+    /**
+     * @brief Append a device entry ("Name":{...}), in full or as a diff
+     * @param sensorIndex Stable identifier of the device, its index in the sensors vector
+     */
+    bool appendDevice(PacketWriter& output, uint16_t sensorIndex, const char* entry, size_t len);
+
+    /**
+     * @brief Force the next packet to be a keyframe, e.g. after sensors are detected again
+     */
+    void invalidate() { m_keyframeValid = false; }
+
+    uint16_t getKeyframeNumber() const { return m_keyframeNumber; }
+    unsigned long getBytesSaved() const { return m_bytesSaved; }
+
+private:
+    struct KeyEntry {
+        uint16_t sensorIndex;
+        uint16_t offset;
+        uint16_t length;
+    };
+
+    bool storeKeyEntry(uint16_t sensorIndex, const char* entry, size_t len);
+    int findKeyEntry(uint16_t sensorIndex) const;
+    bool buildDiff(uint8_t position, const char* entry, size_t len);
+    bool withinDeadband(const char* keyValue, size_t keyLength, const char* value, size_t length) const;
+
+    char* m_keyframe;
+    size_t m_keyframeCapacity;
+    size_t m_keyframeLength;
+    KeyEntry m_entries[MAX_DEVICES];
+    uint8_t m_entryCount;
+    uint16_t m_interval;
+    uint16_t m_deadband;
+    uint16_t m_packetCount; ///< Packets since the last keyframe
+    uint16_t m_keyframeNumber;
+    bool m_keyframeValid;
+    bool m_isKeyframe;
+    unsigned long m_bytesSaved;
+    char m_scratch[MAX_ENTRY_LENGTH];
+    size_t m_scratchLength;
+};
+
+/**
+ * @brief Host side reconstruction of full data packets from keyframes and diffs
+ *
+ * Feed packets in the order they were logged, one JSON packet per call. State
+ * is kept per device/node ID so interleaved streams from several loggers work.
+ */
+class DataDiffDecoder {
+public:
+    /**
+     * @brief Rebuild one packet
+     * @param json A packet as logged, any packet type
+     * @param full Set to the full packet. Non data packets and full data packets are copied unchanged
+     * @return false if a diff references a keyframe that has not been seen, or is malformed
+     */
+    bool apply(const std::string& json, std::string& full);
+
+private:
+    struct Keyframe {
+        std::string packetId;
+        long number = -1;
+        std::vector<std::string> devices; ///< Entries in Devices order, across all lines of the keyframe
+    };
+
+    std::map<std::string, Keyframe> m_keyframes; ///< By Device ID or Node ID
+};
+
+#endif // DATA_DIFF_H
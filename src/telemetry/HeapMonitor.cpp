@@ -0,0 +1,72 @@
+/**
+ * @file HeapMonitor.cpp
+ * @brief Implementation of HeapMonitor class
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "HeapMonitor.h"
+#include <string.h>
+
+HeapMonitor::HeapMonitor()
+    : m_samples(0),
+      m_minFree(UINT32_MAX),
+      m_minFreePhase(WAKE),
+      m_minLargestBlock(UINT32_MAX),
+      m_maxAllocations(0),
+      m_cycles(0),
+      m_hasTrendStart(false),
+      m_trendStartFree(0)
+{
+    memset(m_last, 0, sizeof(m_last));
+}
+
+void HeapMonitor::record(Phase phase, const Sample& sample)
+{
+    if (phase >= NUM_PHASES) return;
+    if (phase == SLEEP) {
+        if (!m_hasTrendStart) { //First sleep ever only starts the trend
+            m_hasTrendStart = true;
+            m_trendStartFree = sample.freeBytes;
+        }
+        else if (m_cycles < UINT16_MAX) m_cycles++;
+    }
+    m_last[phase] = sample;
+    m_samples++;
+    if (sample.freeBytes < m_minFree) {
+        m_minFree = sample.freeBytes;
+        m_minFreePhase = phase;
+    }
+    if (sample.largestFreeBlock < m_minLargestBlock) m_minLargestBlock = sample.largestFreeBlock;
+    if (sample.allocations > m_maxAllocations) m_maxAllocations = sample.allocations;
+}
+
+void HeapMonitor::resetWindow()
+{
+    if (m_cycles > 0) m_trendStartFree = m_last[SLEEP].freeBytes;
+    m_samples = 0;
+    m_minFree = UINT32_MAX;
+    m_minFreePhase = WAKE;
+    m_minLargestBlock = UINT32_MAX;
+    m_maxAllocations = 0;
+    m_cycles = 0;
+}
+
+long HeapMonitor::getTrend() const
+{
+    if (m_cycles == 0) return 0;
+    return ((long)m_last[SLEEP].freeBytes - (long)m_trendStartFree) / (long)m_cycles;
+}
+
+const char* HeapMonitor::phaseName(Phase phase)
+{
+    switch (phase) {
+        case WAKE: return "wake";
+        case DATA: return "data";
+        case DIAGNOSTIC: return "diagnostic";
+        case FRAM_WRITE: return "fram";
+        case BACKHAUL: return "backhaul";
+        case SLEEP: return "sleep";
+        default: return "unknown";
+    }
+}
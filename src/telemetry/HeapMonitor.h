@@ -0,0 +1,90 @@
+/**
+ * @file HeapMonitor.h
+ * @brief Free heap, largest free block and allocations at each loop phase.
+ *
+ * The only memory signal used to be System.freeMemory(), printed by commented
+ * out debug lines. A node that leaks or fragments its heap resets in the field
+ * with nothing in the data to show why. loop() now hands the monitor a heap
+ * sample at each phase boundary; the monitor keeps the low points and the
+ * cycle to cycle trend of free heap at sleep, reported in the diagnostic.
+ *
+ * The monitor does not read the heap itself, so the same logic runs on the
+ * device (Device OS runtime info) and in the simulator (counting allocator).
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef HEAP_MONITOR_H
+#define HEAP_MONITOR_H
+
+#include <stdint.h>
+
+/**
+ * @brief Heap low points and trend over a reporting window
+ *
+ * The window runs from one resetWindow() to the next, normally one
+ * diagnostic report. A cycle ends at the SLEEP phase.
+ */
+class HeapMonitor {
+public:
+    enum Phase : uint8_t {
+        WAKE,        ///< Awake, before any task runs
+        DATA,        ///< Data record built
+        DIAGNOSTIC,  ///< Diagnostic record built
+        FRAM_WRITE,  ///< Records handed to FRAM
+        BACKHAUL,    ///< Stored records sent
+        SLEEP,       ///< About to sleep, ends the cycle
+        NUM_PHASES
+    };
+
+    struct Sample {
+        uint32_t freeBytes;
+        uint32_t largestFreeBlock;
+        uint32_t allocations; ///< Live allocations, 0 where the platform does not count them
+    };
+
+    typedef void (*Probe)(Sample& sample); ///< Reads the platform heap, set by the firmware or the simulator
+
+    HeapMonitor();
+
+    /**
+     * @brief Take the heap state at a phase boundary
+     */
+    void record(Phase phase, const Sample& sample);
+
+    /**
+     * @brief Start a new window, the trend continues from the last sleep sample
+     */
+    void resetWindow();
+
+    // Over the current window
+    uint32_t getMinFree() const { return m_minFree; }
+    Phase getMinFreePhase() const { return m_minFreePhase; }
+    uint32_t getMinLargestBlock() const { return m_minLargestBlock; }
+    uint32_t getMaxAllocations() const { return m_maxAllocations; }
+    uint16_t getCycles() const { return m_cycles; }
+
+    /**
+     * @brief Change of free heap at sleep per cycle, negative while the heap shrinks
+     * @return Bytes per cycle, 0 until a cycle has ended after a previous sleep sample
+     */
+    long getTrend() const;
+
+    const Sample& getLast(Phase phase) const { return m_last[phase < NUM_PHASES ? phase : SLEEP]; }
+    bool hasSamples() const { return m_samples > 0; }
+
+    static const char* phaseName(Phase phase);
+
+private:
+    Sample m_last[NUM_PHASES];
+    uint32_t m_samples;       ///< In the window
+    uint32_t m_minFree;
+    Phase m_minFreePhase;
+    uint32_t m_minLargestBlock;
+    uint32_t m_maxAllocations;
+    uint16_t m_cycles;        ///< Sleep samples in the window
+    bool m_hasTrendStart;
+    uint32_t m_trendStartFree; ///< Free heap at the sleep before the window's first
+};
+
+#endif // HEAP_MONITOR_H
@@ -0,0 +1,414 @@
+/**
+ * @file PacketCodec.cpp
+ * @brief Implementation of PacketCodec class
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "PacketCodec.h"
+#include <stdlib.h>
+#include <string.h>
+
+const uint8_t PacketCodec::FORMAT_VERSION;
+const char PacketCodec::TEXT_PREFIX;
+const size_t PacketCodec::MAX_BINARY_LENGTH;
+const uint8_t PacketCodec::ENCODING_JSON;
+const uint8_t PacketCodec::ENCODING_BINARY;
+
+namespace {
+    // Tokens
+    const uint8_t T_OBJ_BEGIN = 0x01;
+    const uint8_t T_OBJ_END = 0x02;
+    const uint8_t T_ARR_BEGIN = 0x03;
+    const uint8_t T_ARR_END = 0x04;
+    const uint8_t T_TRUE = 0x05;
+    const uint8_t T_FALSE = 0x06;
+    const uint8_t T_NULL = 0x07;
+    const uint8_t T_STR = 0x08; ///< varint length, raw string bytes (escapes kept as written)
+    const uint8_t T_RAW = 0x09; ///< varint length, scalar text that is not a plain decimal number
+    const uint8_t T_NUM = 0x10; ///< 0x10-0x1F, low nibble is decimal places, zigzag varint mantissa follows
+    const uint8_t T_DICT = 0x80; ///< 0x80-0xFF, low 7 bits index DICTIONARY
+
+    const uint8_t HEADER_LENGTH = 4;
+    const uint8_t MAX_DEPTH = 16;
+    const uint8_t MAX_DECIMALS = 15;
+    const uint8_t MAX_DIGITS = 18; //Always fits an int64_t
+
+    // Strings seen in every packet type. Append only, reordering or removing entries needs a new FORMAT_VERSION
+    const char* const DICTIONARY[] = {
+        "Data", "Diagnostic", "Error", "Metadata", "Time", "Loc", "Node ID", "Device ID",
+        "Packet ID", "NumDevices", "Devices", "Pos", "Kestrel", "Talon-Aux", "Talon-I2C", "Talon-SDI12",
+        "File", "Gonk", "FlightControl", "System", "Schema", "Firm", "OS", "ID",
+        "Update", "Backhaul", "LogMode", "Sleep", "SysConfigUID", "SensorConfigUID", "CODES", "OW",
+        "NUM", "Temperature", "RH", "Pressure", "VWC", "EC", "Permitivity", "Apogee_V",
+        "TDR315H", "TEROS11", "ATMOS22", "Li710", "SO421", "SP421", "T9602", "Haar",
+        "Hedorah", "BaroVue10", "SDI12AnalogMux", "Aleppo", "ADRs", "I2C", "I2C_OB", "ALPHA",
+        "BETA", "MUX", "PORT_V", "PORT_I", "Vi", "Vo", "PVset", "OVF",
+        "Fault", "PORT_1", "PORT_2", "PORT_3", "PORT_4", "5V_BUS", "StackPointer", "FRAM_Util",
+        "SD_Free", "SD_Size", "SD_SN", "SD_MFG", "SD_TYPE", "Files", "RTC", "GPS",
+        "CELL", "ACCEL", "ALS", "FreeMem", "CellV", "CellVAvg", "SoC", "CapLeft",
+        "CapTotal", "Cycles", "TTF", "TTFF", "SIV", "FIX", "Times", "TimeSource",
+        "TimeFix", "LastSync", "TalonRestarts", "RestartsSkipped", "RestartSaved", "PortWritesSkipped", "SDI12WaitSaved", "Level",
+        "KeyFrame", "DiffOf", "Idx",
+    };
+    const uint8_t DICTIONARY_SIZE = sizeof(DICTIONARY) / sizeof(DICTIONARY[0]);
+    static_assert(sizeof(DICTIONARY) / sizeof(DICTIONARY[0]) <= 128, "Dictionary references are 7 bit");
+
+    const char BASE64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    int findDictionary(const char* str, size_t len) {
+        for (uint8_t i = 0; i < DICTIONARY_SIZE; i++) {
+            if (strncmp(DICTIONARY[i], str, len) == 0 && DICTIONARY[i][len] == '\0') return i;
+        }
+        return -1;
+    }
+
+    int base64Value(char c) {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+') return 62;
+        if (c == '/') return 63;
+        return -1;
+    }
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    bool isScalarChar(char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '.' || c == '-' || c == '+';
+    }
+
+    /**
+     * @brief Bounded writer over the binary scratch buffer
+     */
+    struct ByteWriter {
+        uint8_t* data;
+        size_t capacity;
+        size_t length;
+        bool overflow;
+
+        void put(uint8_t b) {
+            if (length >= capacity) { overflow = true; return; }
+            data[length++] = b;
+        }
+        void putVarint(uint64_t value) {
+            do {
+                uint8_t b = value & 0x7F;
+                value >>= 7;
+                put(value ? (b | 0x80) : b);
+            } while (value);
+        }
+        void putBytes(const char* str, size_t len) {
+            putVarint(len);
+            for (size_t i = 0; i < len; i++) put((uint8_t)str[i]);
+        }
+    };
+
+    /**
+     * @brief Parse a plain decimal number ("-12.50") into mantissa and decimal places
+     * @return false if the text would not be reproduced exactly (exponents, leading zeros, -0, too many digits)
+     */
+    bool parseDecimal(const char* str, size_t len, int64_t& mantissa, uint8_t& decimals) {
+        size_t i = 0;
+        bool negative = false;
+        if (i < len && str[i] == '-') { negative = true; i++; }
+        size_t intStart = i;
+        uint8_t digits = 0;
+        uint64_t value = 0;
+        while (i < len && str[i] >= '0' && str[i] <= '9') { value = value * 10 + (str[i] - '0'); i++; digits++; }
+        size_t intDigits = i - intStart;
+        if (intDigits == 0 || (intDigits > 1 && str[intStart] == '0')) return false;
+        decimals = 0;
+        if (i < len && str[i] == '.') {
+            i++;
+            while (i < len && str[i] >= '0' && str[i] <= '9') { value = value * 10 + (str[i] - '0'); i++; digits++; decimals++; }
+            if (decimals == 0 || decimals > MAX_DECIMALS) return false;
+        }
+        if (i != len || digits > MAX_DIGITS) return false;
+        if (negative && value == 0) return false; //Sign would be lost
+        mantissa = negative ? -(int64_t)value : (int64_t)value;
+        return true;
+    }
+
+    bool readVarint(const uint8_t* data, size_t len, size_t& pos, uint64_t& value) {
+        value = 0;
+        for (uint8_t shift = 0; shift < 64; shift += 7) {
+            if (pos >= len) return false;
+            uint8_t b = data[pos++];
+            value |= (uint64_t)(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    void appendDecimal(std::string& json, int64_t mantissa, uint8_t decimals) {
+        char digits[24];
+        uint64_t magnitude = mantissa < 0 ? (uint64_t)(-(mantissa + 1)) + 1 : (uint64_t)mantissa;
+        int n = 0;
+        do { digits[n++] = '0' + (magnitude % 10); magnitude /= 10; } while (magnitude);
+        while (n < decimals + 1) digits[n++] = '0'; //Leading zeros of fractions below one
+        if (mantissa < 0) json += '-';
+        for (int i = n - 1; i >= 0; i--) {
+            json += digits[i];
+            if (i == decimals && decimals > 0) json += '.';
+        }
+    }
+}
+
+PacketCodec::PacketCodec(char* buffer, size_t capacity)
+    : m_buffer(buffer),
+      m_capacity(capacity),
+      m_length(0) {
+    if (m_buffer != nullptr && m_capacity > 0) m_buffer[0] = '\0';
+}
+
+bool PacketCodec::encode(const char* json, size_t len, const char* schemaVersion) {
+    m_length = 0;
+    if (m_buffer == nullptr || m_capacity == 0) return false;
+    m_buffer[0] = '\0';
+    if (json == nullptr) return false;
+
+    uint8_t header[HEADER_LENGTH] = {FORMAT_VERSION, 0, 0, 0};
+    const char* version = schemaVersion;
+    for (uint8_t i = 1; i < HEADER_LENGTH && version != nullptr && *version != '\0'; i++) {
+        char* end;
+        header[i] = (uint8_t)strtoul(version, &end, 10);
+        version = (*end == '.') ? end + 1 : nullptr;
+    }
+
+    size_t lineStart = 0;
+    for (size_t i = 0; i <= len; i++) {
+        if (i < len && json[i] != '\n') continue;
+        if (i > lineStart) { //Skip empty lines
+            if (m_length > 0) {
+                if (m_length + 1 >= m_capacity) return false;
+                m_buffer[m_length++] = '\n';
+            }
+            if (!encodeLine(json + lineStart, i - lineStart, header)) {
+                m_length = 0;
+                m_buffer[0] = '\0';
+                return false;
+            }
+        }
+        lineStart = i + 1;
+    }
+    m_buffer[m_length] = '\0';
+    return m_length > 0;
+}
+
+bool PacketCodec::encodeLine(const char* json, size_t len, const uint8_t* header) {
+    enum Expect : uint8_t { VALUE, KEY, KEY_OR_END, VALUE_OR_END, COLON, COMMA_OR_END, DONE };
+    ByteWriter out = {m_binary, sizeof(m_binary), 0, false};
+    for (uint8_t i = 0; i < HEADER_LENGTH; i++) out.put(header[i]);
+
+    bool isObject[MAX_DEPTH];
+    uint8_t depth = 0;
+    Expect expect = VALUE;
+    size_t i = 0;
+    while (i < len) {
+        char c = json[i];
+        if (isSpace(c)) { i++; continue; }
+        if (expect == DONE) return false; //Trailing content after the packet
+        if (c == ':') {
+            if (expect != COLON) return false;
+            expect = VALUE;
+            i++;
+            continue;
+        }
+        if (c == ',') {
+            if (expect != COMMA_OR_END) return false;
+            expect = isObject[depth - 1] ? KEY : VALUE;
+            i++;
+            continue;
+        }
+        if (c == '}' || c == ']') {
+            bool object = (c == '}');
+            if (depth == 0 || isObject[depth - 1] != object) return false;
+            if (expect != COMMA_OR_END && expect != (object ? KEY_OR_END : VALUE_OR_END)) return false;
+            out.put(object ? T_OBJ_END : T_ARR_END);
+            depth--;
+            expect = (depth == 0) ? DONE : COMMA_OR_END;
+            i++;
+            continue;
+        }
+        bool isKey = (expect == KEY || expect == KEY_OR_END);
+        if (!isKey && expect != VALUE && expect != VALUE_OR_END) return false;
+        if (c == '"') {
+            size_t start = ++i;
+            while (i < len && json[i] != '"') {
+                if (json[i] == '\\') i++; //Keep escapes as written, skip the escaped character
+                i++;
+            }
+            if (i >= len) return false;
+            int id = findDictionary(json + start, i - start);
+            if (id >= 0) out.put(T_DICT | id);
+            else {
+                out.put(T_STR);
+                out.putBytes(json + start, i - start);
+            }
+            i++;
+            expect = isKey ? COLON : COMMA_OR_END;
+        }
+        else if (isKey) return false; //Keys must be strings
+        else if (c == '{' || c == '[') {
+            if (depth >= MAX_DEPTH) return false;
+            bool object = (c == '{');
+            if (depth == 0 && !object) return false; //Packets are always objects
+            isObject[depth++] = object;
+            out.put(object ? T_OBJ_BEGIN : T_ARR_BEGIN);
+            expect = object ? KEY_OR_END : VALUE_OR_END;
+            i++;
+        }
+        else {
+            size_t start = i;
+            while (i < len && isScalarChar(json[i])) i++;
+            size_t scalarLen = i - start;
+            if (scalarLen == 0) return false;
+            int64_t mantissa;
+            uint8_t decimals;
+            if (scalarLen == 4 && strncmp(json + start, "true", 4) == 0) out.put(T_TRUE);
+            else if (scalarLen == 5 && strncmp(json + start, "false", 5) == 0) out.put(T_FALSE);
+            else if (scalarLen == 4 && strncmp(json + start, "null", 4) == 0) out.put(T_NULL);
+            else if (parseDecimal(json + start, scalarLen, mantissa, decimals)) {
+                out.put(T_NUM | decimals);
+                out.putVarint(((uint64_t)mantissa << 1) ^ (uint64_t)(mantissa >> 63)); //Zigzag, small negatives stay short
+            }
+            else {
+                out.put(T_RAW);
+                out.putBytes(json + start, scalarLen);
+            }
+            expect = COMMA_OR_END;
+        }
+        if (depth == 0 && expect == COMMA_OR_END) return false; //Packets are always objects
+    }
+    if (expect != DONE || out.overflow) return false;
+
+    size_t textLength = 1 + ((out.length + 2) / 3) * 4;
+    if (m_length + textLength + 1 > m_capacity) return false;
+    m_buffer[m_length++] = TEXT_PREFIX;
+    for (size_t b = 0; b < out.length; b += 3) {
+        uint32_t triple = (uint32_t)m_binary[b] << 16;
+        if (b + 1 < out.length) triple |= (uint32_t)m_binary[b + 1] << 8;
+        if (b + 2 < out.length) triple |= m_binary[b + 2];
+        m_buffer[m_length++] = BASE64[(triple >> 18) & 0x3F];
+        m_buffer[m_length++] = BASE64[(triple >> 12) & 0x3F];
+        m_buffer[m_length++] = (b + 1 < out.length) ? BASE64[(triple >> 6) & 0x3F] : '=';
+        m_buffer[m_length++] = (b + 2 < out.length) ? BASE64[triple & 0x3F] : '=';
+    }
+    m_buffer[m_length] = '\0';
+    return true;
+}
+
+bool PacketCodec::decode(const char* text, size_t len, std::string& json, std::string* schemaVersion) {
+    json.clear();
+    if (text == nullptr) return false;
+    size_t lineStart = 0;
+    bool first = true;
+    for (size_t i = 0; i <= len; i++) {
+        if (i < len && text[i] != '\n') continue;
+        size_t lineEnd = i;
+        if (lineEnd > lineStart && text[lineEnd - 1] == '\r') lineEnd--;
+        if (lineEnd > lineStart) {
+            if (!first) json += '\n';
+            first = false;
+            if (text[lineStart] != TEXT_PREFIX) json.append(text + lineStart, lineEnd - lineStart); //Plain JSON
+            else if (!decodeLine(text + lineStart + 1, lineEnd - lineStart - 1, json, schemaVersion)) return false;
+        }
+        lineStart = i + 1;
+    }
+    return true;
+}
+
+bool PacketCodec::decodeLine(const char* text, size_t len, std::string& json, std::string* schemaVersion) {
+    //Base64 to bytes
+    std::string bytes;
+    bytes.reserve((len / 4) * 3);
+    uint32_t accumulator = 0;
+    uint8_t bits = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (text[i] == '=') break;
+        int value = base64Value(text[i]);
+        if (value < 0) return false;
+        accumulator = (accumulator << 6) | value;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            bytes += (char)((accumulator >> bits) & 0xFF);
+        }
+    }
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(bytes.data());
+    size_t dataLen = bytes.size();
+    if (dataLen < HEADER_LENGTH || data[0] != FORMAT_VERSION) return false;
+    if (schemaVersion != nullptr) {
+        *schemaVersion = std::to_string(data[1]) + "." + std::to_string(data[2]) + "." + std::to_string(data[3]);
+    }
+
+    bool isObject[MAX_DEPTH];
+    uint16_t count[MAX_DEPTH]; //Keys and values written in the current container
+    uint8_t depth = 0;
+    bool done = false;
+    size_t pos = HEADER_LENGTH;
+    while (pos < dataLen) {
+        uint8_t token = data[pos++];
+        if (done) return false;
+        if (token == T_OBJ_END || token == T_ARR_END) {
+            bool object = (token == T_OBJ_END);
+            if (depth == 0 || isObject[depth - 1] != object) return false;
+            if (object && (count[depth - 1] % 2) != 0) return false; //Key without value
+            json += object ? '}' : ']';
+            depth--;
+            done = (depth == 0);
+            continue;
+        }
+        //Every other token is a key or a value, place the separator implied by its position
+        bool isKey = false;
+        if (depth > 0) {
+            uint16_t n = count[depth - 1]++;
+            if (isObject[depth - 1]) {
+                isKey = (n % 2) == 0;
+                if (isKey && n > 0) json += ',';
+                else if (!isKey) json += ':';
+            }
+            else if (n > 0) json += ',';
+        }
+        else if (token != T_OBJ_BEGIN) return false;
+
+        bool isString = (token == T_STR) || (token & T_DICT);
+        if (isKey && !isString) return false;
+        if (token & T_DICT) {
+            uint8_t id = token & 0x7F;
+            if (id >= DICTIONARY_SIZE) return false;
+            json += '"';
+            json += DICTIONARY[id];
+            json += '"';
+        }
+        else if (token == T_STR || token == T_RAW) {
+            uint64_t strLen;
+            if (!readVarint(data, dataLen, pos, strLen) || strLen > dataLen - pos) return false;
+            if (token == T_STR) json += '"';
+            json.append(reinterpret_cast<const char*>(data + pos), strLen);
+            if (token == T_STR) json += '"';
+            pos += strLen;
+        }
+        else if ((token & 0xF0) == T_NUM) {
+            uint64_t zigzag;
+            if (!readVarint(data, dataLen, pos, zigzag)) return false;
+            int64_t mantissa = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+            appendDecimal(json, mantissa, token & 0x0F);
+        }
+        else if (token == T_TRUE) json += "true";
+        else if (token == T_FALSE) json += "false";
+        else if (token == T_NULL) json += "null";
+        else if (token == T_OBJ_BEGIN || token == T_ARR_BEGIN) {
+            if (depth >= MAX_DEPTH) return false;
+            isObject[depth] = (token == T_OBJ_BEGIN);
+            count[depth] = 0;
+            depth++;
+            json += isObject[depth - 1] ? '{' : '[';
+        }
+        else return false;
+    }
+    return done;
+}
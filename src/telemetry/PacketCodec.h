@@ -0,0 +1,81 @@
+/**
+ * @file PacketCodec.h
+ * @brief Compact binary encoding of JSON packets for FRAM storage and publish.
+ *
+ * Packets repeat the same key strings ("Devices", "Loc", "Packet ID", sensor
+ * names) in every record and carry all numbers as text. The codec replaces
+ * known strings with one byte dictionary references, stores numbers as a
+ * scaled integer varint and drops the punctuation implied by structure. The
+ * result is Base64 encoded so it still travels as text through FRAM, SD and
+ * Particle.publish(), and is prefixed so it can never be mistaken for JSON.
+ *
+ * Encoded record layout, before Base64:
+ *   [FORMAT_VERSION][schema major][schema minor][schema patch][tokens...]
+ *
+ * decode() expands a record back to the original JSON (minus insignificant
+ * whitespace) and is used by the host side packet_decode tool.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef PACKET_CODEC_H
+#define PACKET_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+/**
+ * @brief Encodes newline separated JSON packets into prefixed Base64 lines
+ *
+ * Encoding uses only the caller's text buffer and a fixed internal scratch
+ * buffer, no heap. If a packet is not JSON the codec understands, or does not
+ * fit, encode() fails and the caller sends the JSON unchanged.
+ */
+class PacketCodec {
+public:
+    static const uint8_t FORMAT_VERSION = 1; ///< Bump when tokens or the dictionary change incompatibly
+    static const char TEXT_PREFIX = '~'; ///< First character of every encoded line, JSON always starts with '{'
+    static const size_t MAX_BINARY_LENGTH = 2048; ///< Largest encoded packet (one line) before Base64
+
+    // Encoding selected by the packetEncoding config field
+    static const uint8_t ENCODING_JSON = 0;
+    static const uint8_t ENCODING_BINARY = 1;
+
+    /**
+     * @param buffer Storage for the encoded text, must outlive the codec
+     * @param capacity Size of buffer in bytes, including the null terminator
+     */
+    PacketCodec(char* buffer, size_t capacity);
+
+    /**
+     * @brief Encode one or more packets separated by '\n'
+     * @param schemaVersion Schema version string ("2.3.0"), stored in each record header
+     * @return true if every packet was encoded, result is in c_str()
+     */
+    bool encode(const char* json, size_t len, const char* schemaVersion);
+
+    const char* c_str() const { return m_buffer; }
+    size_t length() const { return m_length; }
+
+    /**
+     * @brief Expand encoded lines back to JSON
+     *
+     * Lines that are not encoded (start with '{') are passed through, so mixed
+     * streams decode line by line.
+     * @param schemaVersion If not null, set to the schema version of the last record
+     * @return false if any encoded line is malformed or of an unknown format
+     */
+    static bool decode(const char* text, size_t len, std::string& json, std::string* schemaVersion = nullptr);
+
+private:
+    bool encodeLine(const char* json, size_t len, const uint8_t* header);
+    static bool decodeLine(const char* text, size_t len, std::string& json, std::string* schemaVersion);
+
+    char* m_buffer;
+    size_t m_capacity;
+    size_t m_length;
+    uint8_t m_binary[MAX_BINARY_LENGTH];
+};
+
+#endif // PACKET_CODEC_H
@@ -0,0 +1,51 @@
+/**
+ * @file PacketHeaderCache.cpp
+ * @brief Implementation of PacketHeaderCache class
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "PacketHeaderCache.h"
+#include <string.h>
+
+PacketHeaderCache::PacketHeaderCache()
+    : m_isNodeID(false), m_valid(false), m_truncated(false), m_uses(0) {
+    m_time[0] = '\0';
+    m_lat[0] = '\0';
+    m_lon[0] = '\0';
+    m_alt[0] = '\0';
+    m_posTime[0] = '\0';
+    m_id[0] = '\0';
+}
+
+bool PacketHeaderCache::copyField(char* dest, size_t size, const String& src) {
+    size_t len = src.length();
+    bool fits = (len < size);
+    if (!fits) len = size - 1; //Truncate rather than overrun, fields are sized for the longest expected value
+    memcpy(dest, src.c_str(), len);
+    dest[len] = '\0';
+    return fits;
+}
+
+void PacketHeaderCache::capture(const String& time, const String& lat, const String& lon, const String& alt,
+                                const String& posTime, const String& id, bool isNodeID) {
+    bool fits = copyField(m_time, sizeof(m_time), time);
+    fits &= copyField(m_lat, sizeof(m_lat), lat); //Copy every field even after one is cut short
+    fits &= copyField(m_lon, sizeof(m_lon), lon);
+    fits &= copyField(m_alt, sizeof(m_alt), alt);
+    fits &= copyField(m_posTime, sizeof(m_posTime), posTime);
+    fits &= copyField(m_id, sizeof(m_id), id);
+    m_truncated = !fits;
+    m_isNodeID = isNodeID;
+    m_valid = true;
+    m_uses = 0;
+}
+
+void PacketHeaderCache::writeTo(PacketWriter& output) {
+    output.append("\"Time\":").append(m_time).append(',');
+    output.append("\"Loc\":[").append(m_lat).append(',').append(m_lon).append(',').append(m_alt).append(',').append(m_posTime).append("],");
+    if (m_isNodeID) output.append("\"Node ID\":\"");
+    else output.append("\"Device ID\":\"");
+    output.append(m_id).append("\",");
+    m_uses++;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file PacketHeaderCache.h
+ * @brief Snapshot of the shared packet leader fields for one log event.
+ *
+ * Every packet leader carries the same time, location and node/device ID.
+ * Capturing them once per logEvents() cycle avoids re-reading the RTC and GPS
+ * for each packet built during that cycle.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef PACKET_HEADER_CACHE_H
+#define PACKET_HEADER_CACHE_H
+
+#include <stdint.h>
+#include "Particle.h"
+#include "PacketWriter.h"
+
+/**
+ * @brief Holds the leader fields captured at the start of a log event
+ *
+ * Values are copied into fixed size fields so holding a snapshot does not
+ * keep any heap allocations alive between cycles. The fields are sized for
+ * the Kestrel formats (Unix time, GPS degrees and metres, 24 character device
+ * ID, node ID of at most 8); a longer value is cut short and flagged.
+ */
+class PacketHeaderCache {
+public:
+    static const uint8_t READS_PER_HEADER = 5; ///< 1 RTC (time) + 4 GPS (lat, long, alt, fix time)
+
+    PacketHeaderCache();
+
+    /**
+     * @brief Store a new snapshot and reset the per cycle counters
+     * @param id Node ID if set, otherwise the device ID
+     * @param isNodeID true if id is a node ID, selects the key written
+     */
+    void capture(const String& time, const String& lat, const String& lon, const String& alt,
+                 const String& posTime, const String& id, bool isNodeID);
+
+    /**
+     * @brief Mark the snapshot stale, next packet must capture again
+     */
+    void invalidate() { m_valid = false; }
+    bool isValid() const { return m_valid; }
+
+    /**
+     * @brief Write the Time, Loc and ID fields (each followed by a comma)
+     */
+    void writeTo(PacketWriter& output);
+
+    /**
+     * @brief Number of leaders written from the current snapshot
+     */
+    uint16_t getUses() const { return m_uses; }
+
+    /**
+     * @brief RTC/GPS reads avoided this cycle, the first use is the one real read
+     */
+    uint16_t getReadsSaved() const { return m_uses > 1 ? (m_uses - 1) * READS_PER_HEADER : 0; }
+
+    /**
+     * @brief true if any field of the current snapshot was cut short to fit
+     */
+    bool isTruncated() const { return m_truncated; }
+
+private:
+    static bool copyField(char* dest, size_t size, const String& src);
+
+    char m_time[24];
+    char m_lat[16];
+    char m_lon[16];
+    char m_alt[16];
+    char m_posTime[24];
+    char m_id[32];
+    bool m_isNodeID;
+    bool m_valid;
+    bool m_truncated;
+    uint16_t m_uses;
+};
+
+#endif // PACKET_HEADER_CACHE_H
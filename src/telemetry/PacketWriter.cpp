@@ -0,0 +1,185 @@
+/**
+ * @file PacketWriter.cpp
+ * @brief Implementation of PacketWriter class
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "PacketWriter.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+    const char CLOSER[] = "]}}";
+    const size_t CLOSER_LENGTH = sizeof(CLOSER) - 1;
+}
+
+PacketWriter::PacketWriter(char* buffer, size_t capacity, size_t maxMessageLength)
+    : m_buffer(buffer),
+      m_capacity(capacity),
+      m_maxMessageLength(maxMessageLength),
+      m_length(0),
+      m_leaderLength(0),
+      m_lineStart(0),
+      m_deviceCount(0),
+      m_lineDeviceCount(0),
+      m_packetCount(0),
+      m_droppedCount(0),
+      m_deviceStart(0),
+      m_overflow(false),
+      m_overflowBeforeDevice(false) {
+    if (m_buffer != nullptr && m_capacity > 0) m_buffer[0] = '\0';
+}
+
+bool PacketWriter::fits(size_t len) {
+    if (m_buffer == nullptr || m_length + len + 1 > m_capacity) { //Leave room for null terminator
+        m_overflow = true;
+        return false;
+    }
+    return true;
+}
+
+PacketWriter& PacketWriter::append(const char* str, size_t len) {
+    if (str == nullptr || len == 0 || !fits(len)) return *this;
+    memcpy(m_buffer + m_length, str, len);
+    m_length += len;
+    m_buffer[m_length] = '\0';
+    return *this;
+}
+
+PacketWriter& PacketWriter::append(const char* str) {
+    if (str == nullptr) return *this;
+    return append(str, strlen(str));
+}
+
+PacketWriter& PacketWriter::append(const String& str) {
+    return append(str.c_str(), str.length());
+}
+
+PacketWriter& PacketWriter::append(char c) {
+    return append(&c, 1);
+}
+
+PacketWriter& PacketWriter::append(int value) {
+    char buf[12];
+    int len = snprintf(buf, sizeof(buf), "%d", value);
+    return append(buf, len);
+}
+
+PacketWriter& PacketWriter::append(unsigned int value) {
+    char buf[12];
+    int len = snprintf(buf, sizeof(buf), "%u", value);
+    return append(buf, len);
+}
+
+PacketWriter& PacketWriter::append(long value) {
+    char buf[21];
+    int len = snprintf(buf, sizeof(buf), "%ld", value);
+    return append(buf, len);
+}
+
+PacketWriter& PacketWriter::append(unsigned long value) {
+    char buf[21];
+    int len = snprintf(buf, sizeof(buf), "%lu", value);
+    return append(buf, len);
+}
+
+void PacketWriter::endLeader() {
+    m_leaderLength = m_length - m_lineStart;
+    m_lineDeviceCount = 0;
+    if (m_packetCount == 0) m_packetCount = 1;
+}
+
+bool PacketWriter::appendDevice(const String& entry) {
+    return appendDevice(entry.c_str(), entry.length());
+}
+
+bool PacketWriter::appendDevice(const char* entry, size_t len) {
+    if (entry == nullptr || len == 0) return true; //Only append if not empty string
+    bool split;
+    if (!reserveDevice(len, split)) return false;
+    openDevice(split);
+    append(entry, len);
+    append('}');
+    m_deviceCount++;
+    m_lineDeviceCount++;
+    return true;
+}
+
+void PacketWriter::beginDevice() {
+    m_deviceStart = m_length;
+    m_overflowBeforeDevice = m_overflow;
+    m_overflow = false; //Set again by any append that does not fit
+    if (m_lineDeviceCount > 0) append(',');
+    append('{');
+}
+
+void PacketWriter::endDevice() {
+    bool truncated = m_overflow;
+    m_overflow = m_overflow || m_overflowBeforeDevice;
+    size_t contentStart = m_deviceStart + (m_lineDeviceCount > 0 ? 1 : 0) + 1; //Behind the comma and brace from beginDevice()
+    size_t len = m_length > contentStart ? m_length - contentStart : 0;
+    m_length = m_deviceStart; //Placed again below, the same way as appendDevice() would
+    m_buffer[m_length] = '\0';
+    if (truncated) { //Part of the content was refused, drop the whole entry
+        m_droppedCount++;
+        return;
+    }
+    bool split;
+    if (!reserveDevice(len, split)) return;
+    size_t target = m_deviceStart + (split ? CLOSER_LENGTH + 1 + m_leaderLength : (m_lineDeviceCount > 0 ? 1 : 0)) + 1;
+    if (target != contentStart) memmove(m_buffer + target, m_buffer + contentStart, len); //Move the content clear of the new packet's leader
+    char first = m_buffer[target];
+    openDevice(split);
+    m_buffer[target] = first; //Put back over the null terminator written by openDevice()
+    m_length += len; //Content is already in place
+    append('}');
+    m_deviceCount++;
+    m_lineDeviceCount++;
+}
+
+bool PacketWriter::reserveDevice(size_t len, bool& split) {
+    size_t lineLength = m_length - m_lineStart;
+    size_t entryLength = len + 2 + (m_lineDeviceCount > 0 ? 1 : 0); //Braces plus preceeding comma
+    split = m_lineDeviceCount > 0 && lineLength + entryLength + CLOSER_LENGTH >= m_maxMessageLength;
+    if (split) entryLength = CLOSER_LENGTH + 1 + m_leaderLength + len + 2; //Close this packet, then leader and entry on a new line
+    if (!fits(entryLength + CLOSER_LENGTH)) { //Always leave room for close()
+        m_droppedCount++;
+        return false;
+    }
+    return true;
+}
+
+void PacketWriter::openDevice(bool split) {
+    if (split) { //End this packet and start a new one with a copy of the leader
+        append(CLOSER, CLOSER_LENGTH);
+        append('\n');
+        size_t leaderStart = m_lineStart;
+        m_lineStart = m_length;
+        memcpy(m_buffer + m_length, m_buffer + leaderStart, m_leaderLength); //Leader lives at the start of the previous line
+        m_length += m_leaderLength;
+        m_buffer[m_length] = '\0';
+        m_lineDeviceCount = 0;
+        m_packetCount++;
+    }
+    else if (m_lineDeviceCount > 0) append(',');
+    append('{');
+}
+
+void PacketWriter::close() {
+    append(CLOSER, CLOSER_LENGTH);
+}
+
+void PacketWriter::reset() {
+    m_length = 0;
+    m_leaderLength = 0;
+    m_lineStart = 0;
+    m_deviceCount = 0;
+    m_lineDeviceCount = 0;
+    m_packetCount = 0;
+    m_droppedCount = 0;
+    m_deviceStart = 0;
+    m_overflow = false;
+    m_overflowBeforeDevice = false;
+    if (m_buffer != nullptr && m_capacity > 0) m_buffer[0] = '\0';
+}
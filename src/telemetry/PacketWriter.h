@@ -0,0 +1,120 @@
+/**
+ * @file PacketWriter.h
+ * @brief Fixed-capacity writer for data, diagnostic, metadata and error packets.
+ *
+ * Replaces repeated String concatenation when building packets. Content is
+ * appended directly into a caller supplied buffer (the packet arena) and is
+ * split into newline separated packets whenever the next device entry would
+ * push the current packet past the maximum message length.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef PACKET_WRITER_H
+#define PACKET_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Particle.h"
+
+/**
+ * @brief Builds one or more JSON packets in a preallocated buffer
+ *
+ * Usage follows the packet layout used by FlightControl:
+ * append the leader (everything up to and including `"Devices":[`), call
+ * endLeader(), add each device with appendDevice(), then call close().
+ * When a device will not fit in the current packet, the packet is closed with
+ * `]}}`, a newline is written and the leader is repeated from the start of
+ * the buffer before the device is added. Nothing already written is moved.
+ */
+class PacketWriter {
+public:
+    /**
+     * @brief Constructor
+     * @param buffer Storage to write packets into, must outlive the writer
+     * @param capacity Size of buffer in bytes, including the null terminator
+     * @param maxMessageLength Maximum length of a single packet (line)
+     */
+    PacketWriter(char* buffer, size_t capacity, size_t maxMessageLength);
+
+    // Raw appends, used for the leader and for streamed entries
+    PacketWriter& append(const char* str);
+    PacketWriter& append(const char* str, size_t len);
+    PacketWriter& append(const String& str);
+    PacketWriter& append(char c);
+    PacketWriter& append(int value);
+    PacketWriter& append(unsigned int value);
+    PacketWriter& append(long value);
+    PacketWriter& append(unsigned long value);
+
+    /**
+     * @brief Mark everything written so far as the leader repeated on each split
+     */
+    void endLeader();
+
+    /**
+     * @brief Append a device entry as `{entry}`, splitting the packet if needed
+     *
+     * Room for the closing `]}}` is always kept, so close() succeeds after any
+     * number of accepted entries.
+     * @param entry Device content without enclosing braces, ignored if empty
+     * @return true if the entry was written, false if the arena is full
+     */
+    bool appendDevice(const String& entry);
+    bool appendDevice(const char* entry, size_t len);
+
+    /**
+     * @brief Open a device entry whose content is written with append()
+     *
+     * endDevice() places the finished entry like appendDevice(): it splits the
+     * packet if needed and keeps room for close(). An entry that does not fit,
+     * or whose content was cut short by a full arena, is removed whole and
+     * counted in droppedCount(). No other entry may be added in between.
+     */
+    void beginDevice();
+    void endDevice();
+
+    /**
+     * @brief Close the current packet with `]}}`
+     */
+    void close();
+
+    /**
+     * @brief Discard all content, keeps the buffer
+     */
+    void reset();
+
+    const char* c_str() const { return m_buffer; }
+    size_t length() const { return m_length; }
+    size_t capacity() const { return m_capacity; }
+    uint16_t deviceCount() const { return m_deviceCount; }
+    uint8_t packetCount() const { return m_packetCount; }
+    bool overflowed() const { return m_overflow; }
+    uint16_t droppedCount() const { return m_droppedCount; } ///< Device entries refused because the arena was full
+
+    /**
+     * @brief Copy the finished packet(s) out to a String (single allocation)
+     */
+    String toString() const { return String(m_buffer); }
+
+private:
+    bool fits(size_t len);
+    bool reserveDevice(size_t len, bool& split); ///< Room check for an entry, counts it dropped if it does not fit
+    void openDevice(bool split); ///< Write the split, comma and brace before an entry
+
+    char* m_buffer;
+    size_t m_capacity;
+    size_t m_maxMessageLength;
+    size_t m_length;
+    size_t m_leaderLength;
+    size_t m_lineStart;
+    uint16_t m_deviceCount;
+    uint16_t m_lineDeviceCount;
+    uint8_t m_packetCount;
+    uint16_t m_droppedCount;
+    size_t m_deviceStart; ///< Length when beginDevice() was called
+    bool m_overflow;
+    bool m_overflowBeforeDevice;
+};
+
+#endif // PACKET_WRITER_H
@@ -0,0 +1,205 @@
+/**
+ * @file RecordRing.cpp
+ * @brief Implementation of the FRAM record ring
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "RecordRing.h"
+#include "hardware/IFram.h"
+#include <stddef.h>
+#include <string.h>
+
+namespace {
+
+//CRC-16/CCITT, continued from a previous value
+uint16_t crc16(const uint8_t* data, size_t len, uint16_t crc)
+{
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+//Header fields covered by the record CRC, everything but the CRC itself
+uint16_t headerCrc(const RecordRing::Header& header)
+{
+    uint16_t crc = crc16((const uint8_t*)&header, offsetof(RecordRing::Header, crc), 0xFFFF);
+    return crc16((const uint8_t*)&header.sequence, sizeof(header.sequence), crc);
+}
+
+uint16_t controlCrc(const RecordRing::Control& control)
+{
+    return crc16((const uint8_t*)&control.generation, sizeof(control) - offsetof(RecordRing::Control, generation), 0xFFFF);
+}
+
+} // namespace
+
+RecordRing::RecordRing(IFram& fram, uint32_t base, uint32_t size)
+    : m_fram(fram),
+      m_base(base),
+      m_ringSize(size > 2 * CONTROL_SIZE ? size - 2 * CONTROL_SIZE : 0),
+      m_tail(0),
+      m_head(0),
+      m_tailSequence(1),
+      m_headSequence(1),
+      m_generation(0),
+      m_used(0),
+      m_count(0),
+      m_peekLength(0)
+{
+}
+
+bool RecordRing::begin()
+{
+    if (m_ringSize <= HEADER_SIZE) return false;
+    Control control;
+    bool found = false;
+    for (uint8_t slot = 0; slot < 2; slot++) {
+        Control candidate;
+        if (!m_fram.readData(m_base + slot * CONTROL_SIZE, (uint8_t*)&candidate, sizeof(candidate))) return false;
+        if (candidate.marker != CONTROL_MARKER || candidate.version != VERSION || candidate.crc != controlCrc(candidate)) continue;
+        if (candidate.tail >= m_ringSize) continue;
+        if (!found || candidate.generation > control.generation) control = candidate;
+        found = true;
+    }
+    if (!found) return erase(); //Blank FRAM, another layout, or both blocks torn
+
+    m_generation = control.generation;
+    m_tail = control.tail;
+    m_tailSequence = control.nextSequence;
+    m_head = m_tail;
+    m_headSequence = m_tailSequence;
+    m_used = 0;
+    m_count = 0;
+    m_peekLength = 0;
+    while (true) { //Walk forward to the write position, stopping at the first record that does not check out
+        Header header;
+        uint16_t crc;
+        if (!readHeader(m_head, m_headSequence, header, crc)) break;
+        if (m_used + HEADER_SIZE + header.length + 1 > m_ringSize) break;
+        if (payloadCrc(advance(m_head, HEADER_SIZE), header.length, crc) != header.crc) break; //Torn append
+        m_head = advance(m_head, HEADER_SIZE + header.length);
+        m_used += HEADER_SIZE + header.length;
+        m_headSequence++;
+        m_count++;
+    }
+    return writeEndMarker(); //Whatever follows the last good record must not read as a record
+}
+
+bool RecordRing::append(const char* data, size_t len, uint8_t dataType, uint8_t destination)
+{
+    if (len == 0 || len > 0xFFFF) return false;
+    if (m_used + HEADER_SIZE + len + 1 > m_ringSize) return false; //One byte stays free for the end marker
+    Header header;
+    header.marker = RECORD_MARKER;
+    header.dataType = dataType;
+    header.destination = destination;
+    header.reserved = 0;
+    header.length = (uint16_t)len;
+    header.sequence = m_headSequence;
+    header.crc = crc16((const uint8_t*)data, len, headerCrc(header));
+    if (!writeRing(m_head, (const uint8_t*)&header, HEADER_SIZE)) return false;
+    if (!writeRing(advance(m_head, HEADER_SIZE), (const uint8_t*)data, len)) return false;
+    m_head = advance(m_head, HEADER_SIZE + len);
+    m_used += HEADER_SIZE + len;
+    m_headSequence++;
+    m_count++;
+    return writeEndMarker();
+}
+
+bool RecordRing::peek(Header& header, char* buffer, size_t capacity)
+{
+    m_peekLength = 0;
+    if (m_count == 0) return false;
+    uint16_t crc;
+    if (!readHeader(m_tail, m_tailSequence, header, crc)) return false;
+    if ((size_t)header.length + 1 > capacity) return false;
+    if (!readRing(advance(m_tail, HEADER_SIZE), (uint8_t*)buffer, header.length)) return false;
+    if (crc16((const uint8_t*)buffer, header.length, crc) != header.crc) return false;
+    buffer[header.length] = '\0';
+    m_peekLength = header.length;
+    return true;
+}
+
+bool RecordRing::acknowledge()
+{
+    if (m_peekLength == 0) return false;
+    m_tail = advance(m_tail, HEADER_SIZE + m_peekLength);
+    m_used -= HEADER_SIZE + m_peekLength;
+    m_tailSequence++;
+    m_count--;
+    m_peekLength = 0;
+    return writeControl();
+}
+
+bool RecordRing::erase()
+{
+    m_tail = 0;
+    m_head = 0;
+    m_tailSequence = m_headSequence; //Keep counting so records from before can never follow on
+    m_used = 0;
+    m_count = 0;
+    m_peekLength = 0;
+    if (!writeEndMarker()) return false;
+    return writeControl() && writeControl(); //Both blocks, so an old one can not win on the next begin()
+}
+
+bool RecordRing::readRing(uint32_t offset, uint8_t* data, size_t len)
+{
+    uint32_t first = m_ringSize - offset;
+    uint32_t start = m_base + 2 * CONTROL_SIZE;
+    if (len <= first) return m_fram.readData(start + offset, data, len);
+    return m_fram.readData(start + offset, data, first) && m_fram.readData(start, data + first, len - first);
+}
+
+bool RecordRing::writeRing(uint32_t offset, const uint8_t* data, size_t len)
+{
+    uint32_t first = m_ringSize - offset;
+    uint32_t start = m_base + 2 * CONTROL_SIZE;
+    if (len <= first) return m_fram.writeData(start + offset, data, len);
+    return m_fram.writeData(start + offset, data, first) && m_fram.writeData(start, data + first, len - first);
+}
+
+bool RecordRing::readHeader(uint32_t offset, uint32_t expectedSequence, Header& header, uint16_t& crc)
+{
+    if (!readRing(offset, (uint8_t*)&header, HEADER_SIZE)) return false;
+    if (header.marker != RECORD_MARKER || header.sequence != expectedSequence || header.length == 0) return false;
+    crc = headerCrc(header);
+    return true;
+}
+
+bool RecordRing::writeControl()
+{
+    m_generation++;
+    Control control;
+    control.marker = CONTROL_MARKER;
+    control.version = VERSION;
+    control.generation = m_generation;
+    control.tail = m_tail;
+    control.nextSequence = m_tailSequence;
+    control.crc = controlCrc(control);
+    return m_fram.writeData(m_base + (m_generation % 2) * CONTROL_SIZE, (const uint8_t*)&control, sizeof(control)); //Alternate blocks, a torn write leaves the other
+}
+
+bool RecordRing::writeEndMarker()
+{
+    uint8_t end = 0;
+    return writeRing(m_head, &end, 1);
+}
+
+uint16_t RecordRing::payloadCrc(uint32_t offset, size_t len, uint16_t crc)
+{
+    uint8_t chunk[32];
+    while (len > 0) {
+        size_t part = len < sizeof(chunk) ? len : sizeof(chunk);
+        if (!readRing(offset, chunk, part)) return (uint16_t)~crc; //Unreadable never matches
+        crc = crc16(chunk, part, crc);
+        offset = advance(offset, part);
+        len -= part;
+    }
+    return crc;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file RecordRing.h
+ * @brief FRAM ring buffer of backhaul records with a persisted acknowledge cursor.
+ *
+ * Records are appended behind a fixed header and read back oldest first. A
+ * record only leaves the ring once acknowledged, and the acknowledge cursor is
+ * written to FRAM each time, so a dump cut short by a dropped connection or a
+ * reset resumes at the first record that was not confirmed sent.
+ *
+ * Window layout (offsets from base):
+ *   [0, 2 * CONTROL_SIZE)  Two alternating control blocks, newest valid one wins
+ *   [2 * CONTROL_SIZE, size)  Ring of records, each [Header][payload], wrapping
+ *
+ * Only the cursor is persisted. The write position is recovered on begin() by
+ * walking records from the cursor while headers check out and sequence numbers
+ * follow on, so an append is two FRAM writes: the record, then an end marker.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef RECORD_RING_H
+#define RECORD_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class IFram;
+
+/**
+ * @brief Persistent FIFO of records in a window of FRAM
+ */
+class RecordRing {
+public:
+    static const uint8_t VERSION = 1;
+    static const uint8_t RECORD_MARKER = 0xA5;
+    static const uint8_t CONTROL_MARKER = 0x5A;
+
+    struct Header {
+        uint8_t marker; ///< RECORD_MARKER, anything else ends the ring
+        uint8_t dataType;
+        uint8_t destination;
+        uint8_t reserved;
+        uint16_t length; ///< Payload bytes
+        uint16_t crc; ///< CRC-16/CCITT over the sequence, the fields above and the payload
+        uint32_t sequence; ///< One more than the record before it
+    };
+
+    struct Control {
+        uint8_t marker;
+        uint8_t version;
+        uint16_t crc; ///< CRC-16/CCITT over the fields below
+        uint32_t generation; ///< Higher wins between the two blocks
+        uint32_t tail; ///< Ring offset of the oldest unacknowledged record
+        uint32_t nextSequence; ///< Sequence expected at tail
+    };
+
+    static const size_t HEADER_SIZE = sizeof(Header);
+    static const size_t CONTROL_SIZE = sizeof(Control);
+
+    /**
+     * @param base First FRAM address of the window
+     * @param size Window size in bytes, control blocks included
+     */
+    RecordRing(IFram& fram, uint32_t base, uint32_t size);
+
+    /**
+     * @brief Recover the cursor and write position from FRAM, formats the window if none is found
+     * @return false if FRAM could not be read or written
+     */
+    bool begin();
+
+    /**
+     * @brief Add a record, O(1)
+     * @return false if the record does not fit in the free space, nothing is written
+     */
+    bool append(const char* data, size_t len, uint8_t dataType, uint8_t destination);
+
+    /**
+     * @brief Read the oldest unacknowledged record
+     * @param buffer Receives the payload, null terminated
+     * @return false if the ring is empty, the record is larger than buffer, or FRAM fails
+     */
+    bool peek(Header& header, char* buffer, size_t capacity);
+
+    /**
+     * @brief Remove the record returned by peek() and persist the cursor
+     */
+    bool acknowledge();
+
+    /**
+     * @brief Drop every record and rewrite the control blocks
+     */
+    bool erase();
+
+    uint16_t getCount() const { return m_count; }
+    uint32_t getUsed() const { return m_used; }
+    uint32_t getCapacity() const { return m_ringSize; }
+    uint32_t getFree() const { return m_ringSize > m_used + 1 ? m_ringSize - m_used - 1 : 0; } ///< Bytes left for records, headers included
+    uint8_t getUtilisation() const { return m_ringSize == 0 ? 100 : (uint8_t)((m_used * 100UL) / m_ringSize); }
+    uint32_t getNextSequence() const { return m_headSequence; }
+
+private:
+    bool readRing(uint32_t offset, uint8_t* data, size_t len);
+    bool writeRing(uint32_t offset, const uint8_t* data, size_t len);
+    bool readHeader(uint32_t offset, uint32_t expectedSequence, Header& header, uint16_t& crc);
+    bool writeControl();
+    bool writeEndMarker();
+    uint16_t payloadCrc(uint32_t offset, size_t len, uint16_t crc);
+    uint32_t advance(uint32_t offset, uint32_t count) const { return (offset + count) % m_ringSize; }
+
+    IFram& m_fram;
+    uint32_t m_base;
+    uint32_t m_ringSize;
+    uint32_t m_tail;
+    uint32_t m_head;
+    uint32_t m_tailSequence;
+    uint32_t m_headSequence;
+    uint32_t m_generation;
+    uint32_t m_used;
+    uint16_t m_count;
+    uint16_t m_peekLength; ///< Length of the record returned by peek(), 0 if none
+};
+
+#endif // RECORD_RING_H
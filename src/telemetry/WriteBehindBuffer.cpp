@@ -0,0 +1,148 @@
+/**
+ * @file WriteBehindBuffer.cpp
+ * @brief Implementation of the SD write-behind buffer
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "WriteBehindBuffer.h"
+#include <string.h>
+#include <string>
+
+WriteBehindBuffer::WriteBehindBuffer(char* buffer, size_t capacity, WriteHandler handler)
+    : m_buffer(buffer),
+      m_slotSize(capacity / MAX_STREAMS),
+      m_deadline(0),
+      m_handler(handler),
+      m_lines(0),
+      m_writes(0)
+{
+    memset(m_streams, 0, sizeof(m_streams));
+}
+
+void WriteBehindBuffer::configure(unsigned long deadlineMs)
+{
+    flush();
+    m_deadline = m_slotSize > BLOCK_SIZE ? deadlineMs : 0; //A slot that can not hold a block would never fill one
+}
+
+void WriteBehindBuffer::add(const char* record, size_t len, uint8_t dataType, unsigned long now)
+{
+    if (!isEnabled()) {
+        m_handler(record, len, dataType);
+        for (size_t i = 0; i < len; i++) {
+            if ((i == 0 || record[i - 1] == '\n') && record[i] != '\n') m_lines++;
+        }
+        m_writes++;
+        return;
+    }
+    size_t start = 0;
+    while (start < len) {
+        const char* end = (const char*)memchr(record + start, '\n', len - start);
+        size_t lineLength = end == nullptr ? len - start : (size_t)(end - (record + start));
+        if (lineLength > 0) addLine(record + start, lineLength, dataType, now);
+        start += lineLength + 1;
+    }
+}
+
+void WriteBehindBuffer::poll(unsigned long now)
+{
+    for (uint8_t s = 0; s < MAX_STREAMS; s++) {
+        if (m_streams[s].used && now - m_streams[s].started >= m_deadline) writeOut(s, m_streams[s].length);
+    }
+}
+
+void WriteBehindBuffer::flush()
+{
+    for (uint8_t s = 0; s < MAX_STREAMS; s++) {
+        if (m_streams[s].used) writeOut(s, m_streams[s].length);
+    }
+}
+
+size_t WriteBehindBuffer::getBuffered() const
+{
+    size_t buffered = 0;
+    for (uint8_t s = 0; s < MAX_STREAMS; s++) {
+        if (m_streams[s].used) buffered += m_streams[s].length;
+    }
+    return buffered;
+}
+
+int WriteBehindBuffer::findStream(uint8_t dataType)
+{
+    for (uint8_t s = 0; s < MAX_STREAMS; s++) {
+        if (m_streams[s].used && m_streams[s].dataType == dataType) return s;
+    }
+    return -1;
+}
+
+void WriteBehindBuffer::addLine(const char* line, size_t len, uint8_t dataType, unsigned long now)
+{
+    int index = findStream(dataType);
+    if (len + 1 > m_slotSize) { //Never fits a slot, write it on its own after what is already held
+        if (index >= 0) writeOut(index, m_streams[index].length);
+        std::string single(line, len);
+        m_handler(single.c_str(), len, dataType);
+        m_lines++;
+        m_writes++;
+        return;
+    }
+    if (index < 0) {
+        for (uint8_t s = 0; s < MAX_STREAMS && index < 0; s++) {
+            if (!m_streams[s].used) index = s;
+        }
+        if (index < 0) { //Every slot busy with other types, make room by writing out the oldest
+            index = 0;
+            for (uint8_t s = 1; s < MAX_STREAMS; s++) {
+                if (m_streams[s].started - m_streams[index].started > 0x7FFFFFFFUL) index = s;
+            }
+            writeOut(index, m_streams[index].length);
+        }
+    }
+    else if (m_streams[index].length + len + 1 > m_slotSize) writeOut(index, m_streams[index].length);
+
+    Stream& stream = m_streams[index];
+    if (!stream.used) {
+        stream.dataType = dataType;
+        stream.used = true;
+        stream.length = 0;
+        stream.lines = 0;
+        stream.started = now;
+    }
+    char* data = slot(index);
+    memcpy(data + stream.length, line, len);
+    stream.length += len;
+    data[stream.length++] = '\n';
+    stream.lines++;
+    writeBlocks(index);
+}
+
+void WriteBehindBuffer::writeBlocks(uint8_t index)
+{
+    Stream& stream = m_streams[index];
+    size_t blocks = (stream.length / BLOCK_SIZE) * BLOCK_SIZE;
+    if (blocks == 0) return;
+    const char* data = slot(index);
+    size_t cut = blocks;
+    while (cut > 0 && data[cut - 1] != '\n') cut--; //Whole lines only
+    if (cut > 0) writeOut(index, cut);
+}
+
+void WriteBehindBuffer::writeOut(uint8_t index, size_t len)
+{
+    Stream& stream = m_streams[index];
+    if (!stream.used || len == 0) return;
+    char* data = slot(index);
+    uint16_t lines = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (data[i] == '\n') lines++;
+    }
+    data[len - 1] = '\0'; //Drop the last newline, the record is written as lines
+    m_handler(data, len - 1, stream.dataType);
+    m_lines += lines;
+    m_writes++;
+    memmove(data, data + len, stream.length - len);
+    stream.length -= len;
+    stream.lines -= lines;
+    if (stream.length == 0) stream.used = false;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file WriteBehindBuffer.h
+ * @brief Collects SD bound records in RAM and writes them in block sized appends.
+ *
+ * Every record written with DestCodes::SD or Both becomes its own SD append,
+ * and each append costs a FAT and directory update on top of the data. The
+ * buffer holds SD bound lines per DataType and writes them once they fill at
+ * least one BLOCK_SIZE block: the write is the longest run of whole lines
+ * that fits in the largest whole number of blocks held, the rest waits for
+ * the next one. Lines are never split, since KestrelFileHandler owns the file
+ * and appends each record as lines. Everything is written once the oldest
+ * line passes the deadline, and on flush().
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef WRITE_BEHIND_BUFFER_H
+#define WRITE_BEHIND_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Per DataType SD write-behind in a caller supplied buffer
+ *
+ * The buffer is split into MAX_STREAMS slots, no heap. When disabled every
+ * record goes straight to the write handler, as before.
+ */
+class WriteBehindBuffer {
+public:
+    static const uint8_t MAX_STREAMS = 4; ///< Error, Data, Diagnostic and Metadata
+    static const size_t BLOCK_SIZE = 512; ///< SD sector
+
+    typedef void (*WriteHandler)(const char* block, size_t len, uint8_t dataType);
+
+    /**
+     * @param buffer Storage, split evenly between the streams, each slot should hold at least two blocks
+     * @param handler Receives each write, null terminated lines separated by '\n'
+     */
+    WriteBehindBuffer(char* buffer, size_t capacity, WriteHandler handler);
+
+    /**
+     * @param deadlineMs Longest time a line is held in RAM, 0 disables the buffer
+     */
+    void configure(unsigned long deadlineMs);
+
+    bool isEnabled() const { return m_deadline > 0; }
+
+    /**
+     * @brief Queue a record of one or more lines separated by '\n'
+     * @param now Current millis()
+     */
+    void add(const char* record, size_t len, uint8_t dataType, unsigned long now);
+
+    /**
+     * @brief Write out every stream whose oldest line has passed the deadline
+     */
+    void poll(unsigned long now);
+
+    /**
+     * @brief Write out everything held
+     */
+    void flush();
+
+    size_t getBuffered() const;
+
+    // Statistics since the last resetStats()
+    unsigned long getLineCount() const { return m_lines; } ///< Lines handed to the handler
+    unsigned long getWriteCount() const { return m_writes; } ///< Handler calls, one SD append each
+    float getLinesPerWrite() const { return m_writes == 0 ? 0.0f : (float)m_lines / (float)m_writes; }
+    void resetStats() { m_lines = 0; m_writes = 0; }
+
+private:
+    struct Stream {
+        uint8_t dataType;
+        bool used;
+        size_t length; ///< Bytes held, every line ends in '\n'
+        uint16_t lines;
+        unsigned long started; ///< millis() of the oldest line held
+    };
+
+    int findStream(uint8_t dataType);
+    void addLine(const char* line, size_t len, uint8_t dataType, unsigned long now);
+    void writeBlocks(uint8_t index);
+    void writeOut(uint8_t index, size_t len);
+    char* slot(uint8_t index) const { return m_buffer + index * m_slotSize; }
+
+    char* m_buffer;
+    size_t m_slotSize;
+    unsigned long m_deadline;
+    WriteHandler m_handler;
+    Stream m_streams[MAX_STREAMS];
+    unsigned long m_lines;
+    unsigned long m_writes;
+};
+
+#endif // WRITE_BEHIND_BUFFER_H
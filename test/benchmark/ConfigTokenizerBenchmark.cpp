@@ -0,0 +1,144 @@
+/**
+ * @file ConfigTokenizerBenchmark.cpp
+ * @brief Host benchmark of configuration parse throughput
+ *
+ * Parses a representative config.json, pretty printed as it is written to the
+ * SD card, once with the whitespace strip and per key search previously used by
+ * ConfigurationManager and once with ConfigTokenizer, and reports the time per
+ * parse and throughput of each:
+ *
+ *   ./config_tokenizer_benchmark [iterations]
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <string>
+#include "configuration/ConfigTokenizer.h"
+
+namespace {
+    const char* const CONFIG =
+        "{\n"
+        "    \"config\": {\n"
+        "        \"system\": {\n"
+        "            \"logPeriod\": 300,\n"
+        "            \"backhaulCount\": 4,\n"
+        "            \"powerSaveMode\": 1,\n"
+        "            \"loggingMode\": 0,\n"
+        "            \"numAuxTalons\": 1,\n"
+        "            \"numI2CTalons\": 1,\n"
+        "            \"numSDI12Talons\": 1,\n"
+        "            \"packetEncoding\": 1,\n"
+        "            \"keyframeInterval\": 12,\n"
+        "            \"diffDeadband\": 0,\n"
+        "            \"batchDeadline\": 900,\n"
+        "            \"sdDeadline\": 600\n"
+        "        },\n"
+        "        \"sensors\": {\n"
+        "            \"numET\": 1,\n"
+        "            \"numHaar\": 0,\n"
+        "            \"numSoil\": 3,\n"
+        "            \"numApogeeSolar\": 1,\n"
+        "            \"numCO2\": 0,\n"
+        "            \"numO2\": 0,\n"
+        "            \"numPressure\": 0,\n"
+        "            \"numAnalogMux\": 0,\n"
+        "            \"periodSoil\": 900,\n"
+        "            \"periodApogeeSolar_1\": 60\n"
+        "        }\n"
+        "    }\n"
+        "}\n";
+
+    const char* const SYSTEM_KEYS[] = {"logPeriod", "backhaulCount", "powerSaveMode", "loggingMode", "numAuxTalons", "numI2CTalons",
+        "numSDI12Talons", "packetEncoding", "keyframeInterval", "diffDeadband", "batchDeadline", "sdDeadline"};
+    const char* const SENSOR_KEYS[] = {"numET", "numHaar", "numSoil", "numApogeeSolar", "numCO2", "numO2", "numPressure", "numAnalogMux"};
+    const char* const PERIOD_TYPES[] = {"ET", "Haar", "Soil", "ApogeeSolar", "CO2", "O2", "Pressure", "AnalogMux"};
+
+    // Previous ConfigurationManager parse, kept here as the baseline
+    std::string legacyField(const std::string& json, const std::string& fieldName) {
+        std::string searchStr = "\"" + fieldName + "\":";
+        size_t fieldStart = json.find(searchStr);
+        if (fieldStart == std::string::npos) return "";
+        fieldStart += searchStr.length();
+        if (json[fieldStart] == '"') {
+            size_t valueEnd = json.find('"', fieldStart + 1);
+            if (valueEnd == std::string::npos) return "";
+            return json.substr(fieldStart + 1, valueEnd - fieldStart - 1);
+        }
+        size_t valueEnd = fieldStart;
+        while (valueEnd < json.length() && (isalnum(json[valueEnd]) || json[valueEnd] == '.' || json[valueEnd] == '-')) valueEnd++;
+        return json.substr(fieldStart, valueEnd - fieldStart);
+    }
+
+    int legacySection(const std::string& json, const char* name, size_t& start) {
+        start = json.find(std::string("\"") + name + "\":{");
+        if (start == std::string::npos) return -1;
+        start += strlen(name) + 3;
+        int depth = 0;
+        for (size_t i = start; i < json.length(); i++) {
+            if (json[i] == '{') depth++;
+            else if (json[i] == '}' && --depth == 0) return (int)i;
+        }
+        return -1;
+    }
+
+    long legacyParse(const std::string& config) {
+        std::string cleaned = config;
+        cleaned.erase(std::remove_if(cleaned.begin(), cleaned.end(), [](char c) { return std::isspace(c); }), cleaned.end());
+        long sum = 0;
+        size_t start;
+        int end = legacySection(cleaned, "system", start);
+        if (end > 0) {
+            std::string section = cleaned.substr(start, end - start);
+            for (const char* key : SYSTEM_KEYS) sum += atoi(legacyField(section, key).c_str());
+        }
+        end = legacySection(cleaned, "sensors", start);
+        if (end > 0) {
+            std::string section = cleaned.substr(start, end - start);
+            int counts[8];
+            for (int i = 0; i < 8; i++) sum += counts[i] = atoi(legacyField(section, SENSOR_KEYS[i]).c_str());
+            for (int t = 0; t < 8; t++) {
+                sum += atoi(legacyField(section, std::string("period") + PERIOD_TYPES[t]).c_str());
+                for (int i = 1; i <= counts[t]; i++) sum += atoi(legacyField(section, std::string("period") + PERIOD_TYPES[t] + "_" + std::to_string(i)).c_str());
+            }
+        }
+        return sum;
+    }
+
+    void sumField(const ConfigTokenizer::Field& field, void* context) {
+        if (field.type == ConfigTokenizer::VALUE_NUMBER) *static_cast<long*>(context) += field.number;
+    }
+
+    long tokenizerParse(const std::string& config) {
+        long sum = 0;
+        ConfigTokenizer tokenizer;
+        if (!tokenizer.parse(config.data(), config.length(), sumField, &sum)) return -1;
+        return sum;
+    }
+
+    template <typename Parse>
+    void measure(const char* name, Parse parse, const std::string& config, long iterations) {
+        volatile long sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < iterations; i++) sink = sink + parse(config);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double perParse = seconds / iterations;
+        printf("%-16s %12.2f %12.1f %12ld\n", name, perParse * 1e6, config.length() / perParse / 1e6, (long)sink / iterations);
+    }
+}
+
+int main(int argc, char** argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 200000;
+    if (iterations <= 0) iterations = 1;
+    const std::string config(CONFIG);
+    printf("Parse of a %zu byte config.json, %ld iterations\n", config.length(), iterations);
+    printf("%-16s %12s %12s %12s\n", "Method", "us/parse", "MB/s", "Checksum");
+    measure("Strip + search", legacyParse, config, iterations);
+    measure("ConfigTokenizer", tokenizerParse, config, iterations);
+    return 0;
+}
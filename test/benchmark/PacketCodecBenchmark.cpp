@@ -0,0 +1,79 @@
+/**
+ * @file PacketCodecBenchmark.cpp
+ * @brief Host benchmark of PacketCodec size reduction on recorded packets
+ *
+ * Encodes every packet of a recording (one JSON packet per line, as found in
+ * the SD card logs) and reports JSON and encoded sizes per packet type, and
+ * checks each one decodes back to the original. Defaults to the sample
+ * recording in benchmark/data:
+ *
+ *   ./packet_codec_benchmark [recording.txt]
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "telemetry/PacketCodec.h"
+
+#ifndef BENCHMARK_DATA_DIR
+#define BENCHMARK_DATA_DIR "."
+#endif
+
+namespace {
+    const char* const TYPES[] = {"Data", "Diagnostic", "Metadata", "Error"};
+    const int NUM_TYPES = 4;
+
+    int packetType(const char* line) {
+        for (int t = 0; t < NUM_TYPES; t++) {
+            size_t len = strlen(TYPES[t]);
+            if (strncmp(line + 2, TYPES[t], len) == 0 && line[2 + len] == '"') return t;
+        }
+        return -1;
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : BENCHMARK_DATA_DIR "/recorded_packets.txt";
+    FILE* input = fopen(path, "r");
+    if (input == nullptr) {
+        fprintf(stderr, "Can not open %s\n", path);
+        return 1;
+    }
+    static char line[16384];
+    static char encoded[16384];
+    PacketCodec codec(encoded, sizeof(encoded));
+    unsigned long jsonBytes[NUM_TYPES + 1] = {0};
+    unsigned long codecBytes[NUM_TYPES + 1] = {0};
+    unsigned long packets[NUM_TYPES + 1] = {0};
+    int failures = 0;
+    std::string decoded;
+    while (fgets(line, sizeof(line), input) != nullptr) {
+        size_t len = strcspn(line, "\r\n");
+        if (len < 4) continue;
+        int type = packetType(line);
+        if (type < 0) type = NUM_TYPES; //Unknown packet type, count under "Other"
+        bool ok = codec.encode(line, len, "2.2.9") && PacketCodec::decode(codec.c_str(), codec.length(), decoded) && decoded == std::string(line, len);
+        if (!ok) {
+            failures++;
+            continue;
+        }
+        packets[type]++;
+        jsonBytes[type] += len;
+        codecBytes[type] += codec.length();
+    }
+    fclose(input);
+
+    printf("%-12s %8s %12s %12s %8s\n", "Type", "Packets", "JSON bytes", "Encoded", "Ratio");
+    unsigned long totalJson = 0, totalCodec = 0;
+    for (int t = 0; t <= NUM_TYPES; t++) {
+        if (packets[t] == 0) continue;
+        printf("%-12s %8lu %12lu %12lu %7.1f%%\n", t < NUM_TYPES ? TYPES[t] : "Other", packets[t], jsonBytes[t], codecBytes[t], 100.0 * codecBytes[t] / jsonBytes[t]);
+        totalJson += jsonBytes[t];
+        totalCodec += codecBytes[t];
+    }
+    if (totalJson > 0) printf("%-12s %8s %12lu %12lu %7.1f%%\n", "Total", "", totalJson, totalCodec, 100.0 * totalCodec / totalJson);
+    if (failures > 0) printf("%d packets could not be encoded and would be sent as JSON\n", failures);
+    return 0;
+}
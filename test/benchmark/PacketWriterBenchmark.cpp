@@ -0,0 +1,93 @@
+/**
+ * @file PacketWriterBenchmark.cpp
+ * @brief Host benchmark comparing String concatenation with PacketWriter
+ *
+ * Builds the packets of a full type 3 log event (data, diagnostic, metadata)
+ * for a representative node, once with the String + String pattern previously
+ * used by FlightControl and once with PacketWriter, and reports the heap
+ * allocations and bytes copied by the mock String for each.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include <stdio.h>
+#include "Particle.h"
+#include "telemetry/PacketWriter.h"
+
+namespace {
+    const size_t MAX_MESSAGE_LENGTH = 1024;
+    const int NUM_DEVICES = 10; //3 core + 3 Talons + 4 sensors
+    const int NUM_PACKETS = 3; //Data, diagnostic and metadata
+
+    String deviceEntry(int index) {
+        char buf[160];
+        snprintf(buf, sizeof(buf), "\"TDR315H\":{\"VWC\":%d.12,\"Temperature\":21.5,\"Permitivity\":18.3,\"EC\":0.12,\"Pos\":[%d,%d]}", index, index % 4 + 1, index % 3 + 1);
+        return String(buf);
+    }
+
+    String concatenationPacket(const String& time, const String* entries) {
+        String leader = "{\"Data\":{";
+        leader = leader + "\"Time\":" + time + ",";
+        leader = leader + "\"Loc\":[" + "44.97" + "," + "-93.23" + "," + "256.0" + "," + time + "],";
+        leader = leader + "\"Node ID\":\"" + "TestNode" + "\",";
+        leader = leader + "\"Packet ID\":" + String(123456789UL) + ",";
+        leader = leader + "\"NumDevices\":" + String(NUM_DEVICES) + ",";
+        leader = leader + "\"Devices\":[";
+        const String closer = "]}}";
+        String output = leader;
+        uint8_t deviceCount = 0;
+        for (int i = 0; i < NUM_DEVICES; i++) {
+            const String& val = entries[i];
+            if (output.length() + val.length() + closer.length() + 1 < MAX_MESSAGE_LENGTH) {
+                if (deviceCount > 0) output = output + ",";
+                output = output + "{" + val + "}";
+                deviceCount++;
+            }
+            else {
+                output = output + closer + "\n";
+                output = output + leader + "{" + val + "}";
+            }
+        }
+        output = output + closer;
+        return output;
+    }
+
+    String writerPacket(char* arena, size_t arenaSize, const String& time, const String* entries) {
+        PacketWriter output(arena, arenaSize, MAX_MESSAGE_LENGTH);
+        output.append("{\"Data\":{");
+        output.append("\"Time\":").append(time).append(',');
+        output.append("\"Loc\":[").append("44.97").append(',').append("-93.23").append(',').append("256.0").append(',').append(time).append("],");
+        output.append("\"Node ID\":\"").append("TestNode").append("\",");
+        output.append("\"Packet ID\":").append(123456789UL).append(',');
+        output.append("\"NumDevices\":").append(NUM_DEVICES).append(',');
+        output.append("\"Devices\":[");
+        output.endLeader();
+        for (int i = 0; i < NUM_DEVICES; i++) output.appendDevice(entries[i]);
+        output.close();
+        return output.toString();
+    }
+
+    void report(const char* name, unsigned long allocations, unsigned long bytes, size_t packetLength) {
+        printf("%-16s %12lu %14lu %12zu\n", name, allocations, bytes, packetLength);
+    }
+}
+
+int main() {
+    static char arena[8192];
+    const String time("1700000000");
+    String entries[NUM_DEVICES];
+    for (int i = 0; i < NUM_DEVICES; i++) entries[i] = deviceEntry(i);
+
+    printf("Per cycle cost of a type 3 log event (%d packets, %d devices each)\n", NUM_PACKETS, NUM_DEVICES);
+    printf("%-16s %12s %14s %12s\n", "Method", "Allocations", "Bytes copied", "Packet len");
+
+    size_t length = 0;
+    StringStats::reset();
+    for (int p = 0; p < NUM_PACKETS; p++) length = concatenationPacket(time, entries).length();
+    report("String concat", StringStats::allocations, StringStats::bytesCopied, length);
+
+    StringStats::reset();
+    for (int p = 0; p < NUM_PACKETS; p++) length = writerPacket(arena, sizeof(arena), time, entries).length();
+    report("PacketWriter", StringStats::allocations, StringStats::bytesCopied, length);
+    return 0;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file MockFram.h
+ * @brief Mock implementation of IFram for testing.
+ *
+ * This class uses Google Mock to create a testable version of the FRAM interface.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+ #ifndef MOCK_FRAM_H
+ #define MOCK_FRAM_H
+ 
+ #include <gmock/gmock.h>
+ #include "hardware/IFram.h"
+ 
+ /**
+  * @brief Google Mock implementation of IFram for testing.
+  */
+ class MockFram : public IFram {
+ public:
+     // Mock all methods defined in the interface
+     MOCK_METHOD(bool, begin, (), (override));
+     MOCK_METHOD(size_t, length, (), (override));
+     MOCK_METHOD(bool, readData, (uint32_t framAddr, uint8_t* data, size_t dataLen), (override));
+     MOCK_METHOD(bool, writeData, (uint32_t framAddr, const uint8_t* data, size_t dataLen), (override));
+ };
+ 
+ #endif // MOCK_FRAM_H
@@ -0,0 +1,18 @@
+/**
+ * @file MockParticle.h
+ * @brief Particle API used by firmware sources when built with TESTING
+ *
+ * FlightControl.cpp and ConfigurationManager.cpp include this header instead
+ * of the Device OS Particle.h. It resolves to whichever Particle.h comes first
+ * on the include path: the mock String/EEPROM for unit tests, or the
+ * simulated runtime in test/simulator for the host simulator.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef MOCK_PARTICLE_WRAPPER_H
+#define MOCK_PARTICLE_WRAPPER_H
+
+#include "Particle.h"
+
+#endif // MOCK_PARTICLE_WRAPPER_H
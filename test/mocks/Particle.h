@@ -6,6 +6,7 @@
 
 #include <string>
 #include <cstring>
+#include <strings.h> // For strcasecmp
 #include <cstdlib>
 #include <cctype>
 #include <algorithm> // For std::min and std::max
@@ -43,6 +44,28 @@ using std::isnan;
 // Forward declaration
 class StringSumHelper;
 
+/**
+ * Allocation counters for the mock String
+ * 
+ * Used by the host benchmarks to compare how many heap allocations and how
+ * many bytes of copying different packet building strategies cost. Growth
+ * through realloc is counted as a full copy of the existing buffer (worst case).
+ */
+struct StringStats {
+    static inline unsigned long allocations = 0;
+    static inline unsigned long bytesCopied = 0;
+
+    static void reset() {
+        allocations = 0;
+        bytesCopied = 0;
+    }
+
+    static void record(unsigned long bytes) {
+        allocations++;
+        bytesCopied += bytes;
+    }
+};
+
 /**
  * Mock implementation of Particle's String class for testing
  * 
@@ -58,6 +81,18 @@ public:
             if (_buffer) {
                 _length = strlen(cstr);
                 _capacity = _length;
+                StringStats::record(_length + 1);
+            }
+        }
+    }
+    
+    String(const char *cstr, unsigned int length) {
+        if (cstr) {
+            _buffer = strndup(cstr, length);
+            if (_buffer) {
+                _length = strlen(_buffer);
+                _capacity = _length;
+                StringStats::record(_length + 1);
             }
         }
     }
@@ -66,6 +101,7 @@ public:
     
     explicit String(char c) {
         _buffer = (char*)malloc(2);
+        StringStats::record(2);
         if (_buffer) {
             _buffer[0] = c;
             _buffer[1] = 0;
@@ -137,6 +173,7 @@ public:
         if (_buffer) free(_buffer);
         if (rhs._buffer) {
             _buffer = strdup(rhs._buffer);
+            StringStats::record(rhs._length + 1);
             _length = rhs._length;
             _capacity = rhs._capacity;
         } else {
@@ -153,6 +190,7 @@ public:
             _buffer = strdup(cstr);
             _length = strlen(cstr);
             _capacity = _length;
+            StringStats::record(_length + 1);
         } else {
             _buffer = nullptr;
             _length = 0;
@@ -177,6 +215,7 @@ public:
         unsigned int newLen = _length + length;
         char *newBuffer = (char*)realloc(_buffer, newLen + 1);
         if (!newBuffer) return 0;
+        StringStats::record(newLen + 1);
         
         _buffer = newBuffer;
         memcpy(_buffer + _length, cstr, length);
@@ -328,6 +367,25 @@ public:
         return (strcmp(_buffer + (_length - suffix_len), suffix) == 0);
     }
 
+    bool startsWith(const String &prefix) const {
+        if (!_buffer || !prefix._buffer) return false;
+        if (prefix._length > _length) return false;
+        return (strncmp(_buffer, prefix._buffer, prefix._length) == 0);
+    }
+
+    unsigned char equalsIgnoreCase(const String &s) const {
+        if (_length != s._length) return 0;
+        if (!_buffer || !s._buffer) return (_buffer == s._buffer);
+        return (strcasecmp(_buffer, s._buffer) == 0);
+    }
+
+    int lastIndexOf(char ch) const {
+        if (!_buffer) return -1;
+        const char* temp = strrchr(_buffer, ch);
+        if (temp == nullptr) return -1;
+        return temp - _buffer;
+    }
+
     void toCharArray(char *buf, unsigned int bufsize, unsigned int index = 0) const {
         if (buf == nullptr || bufsize == 0) {
             return; // Nothing to do
@@ -395,6 +453,18 @@ public:
         return *this;
     }
     
+    String& replace(const String& find, const String& replace) {
+        if (!_buffer || !find._length) return *this;
+        std::string result(_buffer, _length);
+        size_t pos = 0;
+        while ((pos = result.find(find.c_str(), pos)) != std::string::npos) {
+            result.replace(pos, find._length, replace.c_str());
+            pos += replace._length;
+        }
+        *this = result.c_str();
+        return *this;
+    }
+    
     String& trim() {
         if (!_buffer || !_length) return *this;
         
@@ -473,19 +543,34 @@ inline StringSumHelper operator + (const String &lhs, int num) {
     return result;
 }
 
-// Mock EEPROM class
+// Mock EEPROM class, backed by RAM so values written can be read back
 class EEPROMClass {
 public:
+    static const int SIZE = 4096; // Emulated EEPROM size on Gen 3 devices
+
+    EEPROMClass() { clear(); }
+
     template<typename T>
     void get(int address, T& value) {
-        // Simple mock implementation - just provide default values
-        value = T();
+        if (address < 0 || address + (int)sizeof(T) > SIZE) {
+            value = T();
+            return;
+        }
+        memcpy(&value, _data + address, sizeof(T));
     }
     
     template<typename T>
     void put(int address, const T& value) {
-        // Mock implementation - doesn't actually store anything
+        if (address < 0 || address + (int)sizeof(T) > SIZE) return;
+        memcpy(_data + address, &value, sizeof(T));
     }
+
+    int length() { return SIZE; }
+
+    void clear() { memset(_data, 0xFF, SIZE); } // Erased EEPROM reads 0xFF
+
+private:
+    uint8_t _data[SIZE];
 };
 
 // Global EEPROM instance - use inline to avoid multiple definition errors
@@ -0,0 +1,291 @@
+/**
+ * @file Particle.h
+ * @brief Simulated Particle Device OS runtime for the host simulator
+ *
+ * Extends the mock String/EEPROM from test/mocks with the global objects and
+ * functions firmware and drivers use directly (Serial, Wire, System, Particle,
+ * Time, millis(), delay(), waitFor()). Everything runs against VirtualClock.
+ * This directory is placed ahead of test/mocks on the include path for the
+ * simulator target only, so unit tests keep using the plain mock.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef SIM_PARTICLE_H
+#define SIM_PARTICLE_H
+
+#include "../mocks/Particle.h"
+#include "VirtualClock.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <functional>
+#include <map>
+#include <string>
+
+#ifndef HIGH
+#define HIGH 1
+#endif
+#ifndef LOW
+#define LOW 0
+#endif
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define INPUT_PULLDOWN 3
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define SERIAL_8N1 0
+#define SERIAL_8E1 1
+#define SERIAL_8O1 2
+
+#define FEATURE_RESET_INFO 1
+#define RESET_REASON_NONE 0
+#define RESET_REASON_UNKNOWN 10
+#define RESET_REASON_PIN_RESET 20
+#define RESET_REASON_POWER_MANAGEMENT 30
+#define RESET_REASON_POWER_DOWN 40
+#define RESET_REASON_WATCHDOG 60
+#define RESET_REASON_USER 140
+#define RESET_NO_WAIT 1
+
+#define PRIVATE 0
+#define PUBLIC 1
+#define NO_ACK 2
+#define WITH_ACK 4
+
+#define SYSTEM_MODE(mode)
+#define SYSTEM_THREAD(state)
+#define PRODUCT_VERSION(version)
+#define STARTUP(code)
+
+inline unsigned long millis() { return (unsigned long)VirtualClock::instance().millis(); }
+inline unsigned long micros() { //Read tick applies as for millis(), so busy waits on either make progress
+    uint64_t now = VirtualClock::instance().peekMicros();
+    VirtualClock::instance().millis();
+    return (unsigned long)now;
+}
+inline void delay(unsigned long ms) { VirtualClock::instance().advance(ms); }
+inline void delayMicroseconds(unsigned int us) { VirtualClock::instance().advanceMicros(us); }
+
+/**
+ * @brief Bus latency models, the time simulated transfers take on the device
+ *
+ * Applied to SimWire, the I2C mocks (IO expanders, FRAM) and stage timing in
+ * SensorProfiler sees them. Set from the simulator command line, 0 disables.
+ */
+struct SimLatency {
+    static inline uint32_t i2cTransactionUs = 300; ///< Address plus two bytes at 100 kHz
+    static inline uint32_t framByteUs = 25;        ///< MB85RC256V at 400 kHz, per byte transferred
+
+    static void i2cTransaction() { VirtualClock::instance().advanceMicros(i2cTransactionUs); }
+    static void framTransfer(size_t len) { VirtualClock::instance().advanceMicros(i2cTransactionUs + framByteUs * (uint64_t)len); }
+};
+
+inline void pinMode(uint16_t pin, uint8_t mode) {}
+inline void digitalWrite(uint16_t pin, uint8_t value) {}
+inline int32_t digitalRead(uint16_t pin) { return LOW; }
+inline int32_t analogRead(uint16_t pin) { return 0; }
+inline void attachInterrupt(uint16_t pin, void (*handler)(), int mode) {}
+inline void detachInterrupt(uint16_t pin) {}
+
+/**
+ * @brief Serial port that optionally echoes to stdout
+ */
+class SimSerial {
+public:
+    bool echo = false;
+
+    void begin(unsigned long speed) {}
+    void begin(unsigned long speed, uint32_t config) {}
+    void end() {}
+    int available() { return 0; }
+    int read() { return -1; }
+    int peek() { return -1; }
+    void flush() {}
+    size_t write(uint8_t c) { if (echo) putchar(c); return 1; }
+    void setTimeout(unsigned long timeout) {}
+
+    size_t print(const char* str) { if (echo) fputs(str, stdout); return strlen(str); }
+    size_t print(const String& str) { return print(str.c_str()); }
+    size_t print(char c) { return write(c); }
+    size_t print(int value, int base = 10) { return printNumber("%d", value); }
+    size_t print(unsigned int value, int base = 10) { return printNumber("%u", value); }
+    size_t print(long value, int base = 10) { return printNumber("%ld", value); }
+    size_t print(unsigned long value, int base = 10) { return printNumber("%lu", value); }
+    size_t print(long long value, int base = 10) { return printNumber("%lld", value); }
+    size_t print(unsigned long long value, int base = 10) { return printNumber("%llu", value); }
+    size_t print(double value, int digits = 2) { return printNumber("%f", value); }
+
+    template<typename T>
+    size_t println(const T& value) { size_t n = print(value); return n + println(); }
+    template<typename T>
+    size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+    size_t println() { if (echo) putchar('\n'); return 1; }
+
+    template<typename... Args>
+    size_t printf(const char* format, Args... args) { if (echo) return ::printf(format, args...); return 0; }
+    template<typename... Args>
+    size_t printlnf(const char* format, Args... args) { size_t n = printf(format, args...); return n + println(); }
+
+    explicit operator bool() const { return true; }
+
+private:
+    template<typename T>
+    size_t printNumber(const char* format, T value) {
+        if (echo) return ::printf(format, value);
+        return 0;
+    }
+};
+
+/**
+ * @brief I2C bus with no devices attached, every address NACKs
+ */
+class SimWire {
+public:
+    uint8_t nackCode = 2; //Address NACK, reported for every transmission
+
+    void begin() {}
+    void end() {}
+    void setClock(uint32_t speed) {}
+    bool isEnabled() { return true; }
+    void beginTransmission(int address) {}
+    uint8_t endTransmission(bool stop = true) { SimLatency::i2cTransaction(); return nackCode; }
+    size_t write(uint8_t data) { return 1; }
+    size_t write(const uint8_t* data, size_t len) { return len; }
+    uint8_t requestFrom(int address, int quantity, int stop = true) { SimLatency::i2cTransaction(); return 0; }
+    int available() { return 0; }
+    int read() { return -1; }
+    int reset() { return 0; }
+};
+
+/**
+ * @brief Host heap use, counted by the malloc wrappers in SimulatorHeap.cpp
+ *
+ * Counters stay at zero where the wrappers are not built (non glibc hosts).
+ */
+struct SimHeap {
+    static inline size_t liveBytes = 0;
+    static inline size_t liveAllocations = 0;
+    static inline size_t peakBytes = 0; ///< Highest liveBytes since resetPeak()
+    static inline size_t baseline = 0;  ///< liveBytes that System.freeMemory() treats as already used
+
+    static void resetPeak() { peakBytes = liveBytes; }
+    static void setBaseline() { baseline = liveBytes; }
+};
+
+/**
+ * @brief System API backed by VirtualClock
+ */
+class SimSystem {
+public:
+    int resetReasonValue = RESET_REASON_POWER_DOWN;
+    uint32_t freeMemoryValue = 80000; //Free heap at SimHeap::baseline
+    unsigned long resetCount = 0;
+
+    void enableFeature(int feature) {}
+    int resetReason() { return resetReasonValue; }
+    String deviceID() { return String("e00fce68sim0000000000000"); }
+    String version() { return String("6.1.1"); }
+    uint64_t millis() { return VirtualClock::instance().millis(); }
+    uint32_t uptime() { return (uint32_t)(VirtualClock::instance().peekMillis() / 1000); }
+    uint32_t freeMemory() { //Free heap at the baseline, less what the firmware has allocated since
+        size_t used = SimHeap::liveBytes > SimHeap::baseline ? SimHeap::liveBytes - SimHeap::baseline : 0;
+        return used < freeMemoryValue ? freeMemoryValue - (uint32_t)used : 0;
+    }
+    void reset() { resetCount++; }
+    void reset(int flags) { resetCount++; }
+
+    template<typename Condition>
+    bool waitCondition(Condition condition, unsigned long timeout) {
+        uint64_t start = VirtualClock::instance().peekMillis();
+        while (!condition()) {
+            if (VirtualClock::instance().peekMillis() - start >= timeout) return false;
+            VirtualClock::instance().advance(10);
+        }
+        return true;
+    }
+};
+
+#define waitFor(condition, timeout) System.waitCondition([&]{ return (condition)(); }, (timeout))
+#define waitUntil(condition) System.waitCondition([&]{ return (condition)(); }, 0xFFFFFFFF)
+
+/**
+ * @brief Particle cloud API that records functions and published events
+ */
+class SimCloud {
+public:
+    typedef std::function<int(String)> CloudFunction;
+
+    static inline bool connectedState = true; //Cellular available unless a scenario turns it off
+    unsigned long connectAttempts = 0;
+    unsigned long publishCount = 0;
+    unsigned long publishBytes = 0;
+    std::map<std::string, CloudFunction> functions;
+
+    void connect() { connectAttempts++; }
+    void disconnect() {}
+    static bool connected() { return connectedState; } //Static so waitFor(Particle.connected, ...) compiles as on device
+    bool process() { return true; }
+    bool syncTime() { return true; }
+    bool syncTimePending() { return false; }
+    bool syncTimeDone() { return true; }
+
+    bool function(const char* name, int (*handler)(String)) {
+        functions[name] = handler;
+        return true;
+    }
+
+    template<typename... Flags>
+    bool publish(const char* name, const char* data, Flags... flags) {
+        publishCount++;
+        if (data != nullptr) publishBytes += strlen(data);
+        return connectedState;
+    }
+    template<typename... Flags>
+    bool publish(const char* name, const String& data, Flags... flags) { return publish(name, data.c_str(), flags...); }
+    template<typename... Flags>
+    bool publish(const String& name, const String& data, Flags... flags) { return publish(name.c_str(), data.c_str(), flags...); }
+
+    /**
+     * @brief Invoke a registered cloud function, as the console would
+     * @return Function result, or -1 if no function with that name exists
+     */
+    int call(const std::string& name, const String& argument) {
+        auto it = functions.find(name);
+        if (it == functions.end()) return -1;
+        return it->second(argument);
+    }
+};
+
+/**
+ * @brief Time API backed by VirtualClock
+ */
+class SimTime {
+public:
+    time_t now() { return VirtualClock::instance().now(); }
+    bool isValid() { return true; }
+    void zone(float offset) {}
+    void setTime(time_t t) {}
+    int year(time_t t) { struct tm tm; gmtime_r(&t, &tm); return tm.tm_year + 1900; }
+    int month(time_t t) { struct tm tm; gmtime_r(&t, &tm); return tm.tm_mon + 1; }
+    int day(time_t t) { struct tm tm; gmtime_r(&t, &tm); return tm.tm_mday; }
+    int hour(time_t t) { struct tm tm; gmtime_r(&t, &tm); return tm.tm_hour; }
+    int minute(time_t t) { struct tm tm; gmtime_r(&t, &tm); return tm.tm_min; }
+    int second(time_t t) { struct tm tm; gmtime_r(&t, &tm); return tm.tm_sec; }
+    int year() { return year(now()); }
+    int month() { return month(now()); }
+    int day() { return day(now()); }
+    int hour() { return hour(now()); }
+    int minute() { return minute(now()); }
+    int second() { return second(now()); }
+};
+
+extern SimSerial Serial;
+extern SimSerial Serial1;
+extern SimWire Wire;
+extern SimSystem System;
+extern SimCloud Particle;
+extern SimTime Time;
+
+#endif // SIM_PARTICLE_H
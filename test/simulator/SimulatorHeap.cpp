@@ -0,0 +1,107 @@
+/**
+ * @file SimulatorHeap.cpp
+ * @brief Counting malloc wrappers for the host simulator
+ *
+ * Replaces malloc, calloc, realloc, the aligned allocators and free for the
+ * simulator binary so SimHeap sees every allocation, String and operator new
+ * included. The wrappers forward to the glibc allocator and size blocks with
+ * malloc_usable_size(), so counts are host bytes, not Device OS bytes; they
+ * are meant for per cycle bounds and leak checks, not absolute sizes.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "Particle.h"
+
+#if defined(__GLIBC__)
+#include <errno.h>
+#include <malloc.h>
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+void* __libc_memalign(size_t alignment, size_t size);
+}
+
+namespace {
+
+void track(void* ptr)
+{
+    if (ptr == nullptr) return;
+    SimHeap::liveBytes += malloc_usable_size(ptr);
+    SimHeap::liveAllocations++;
+    if (SimHeap::liveBytes > SimHeap::peakBytes) SimHeap::peakBytes = SimHeap::liveBytes;
+}
+
+void untrack(void* ptr)
+{
+    if (ptr == nullptr) return;
+    SimHeap::liveBytes -= malloc_usable_size(ptr);
+    SimHeap::liveAllocations--;
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size)
+{
+    void* ptr = __libc_malloc(size);
+    track(ptr);
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size)
+{
+    void* ptr = __libc_calloc(count, size);
+    track(ptr);
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    if (ptr == nullptr) return malloc(size);
+    if (size == 0) { //glibc frees the block
+        free(ptr);
+        return nullptr;
+    }
+    size_t oldSize = malloc_usable_size(ptr);
+    void* result = __libc_realloc(ptr, size);
+    if (result == nullptr) return nullptr; //Failed, old block untouched
+    SimHeap::liveBytes = SimHeap::liveBytes - oldSize + malloc_usable_size(result);
+    if (SimHeap::liveBytes > SimHeap::peakBytes) SimHeap::peakBytes = SimHeap::liveBytes;
+    return result;
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    void* ptr = __libc_memalign(alignment, size);
+    track(ptr);
+    return ptr;
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size)
+{
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) return EINVAL;
+    void* ptr = memalign(alignment, size);
+    if (ptr == nullptr) return ENOMEM;
+    *out = ptr;
+    return 0;
+}
+
+void free(void* ptr)
+{
+    untrack(ptr);
+    __libc_free(ptr);
+}
+
+} // extern "C"
+
+#endif // __GLIBC__
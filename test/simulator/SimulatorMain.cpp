@@ -0,0 +1,144 @@
+/**
+ * @file SimulatorMain.cpp
+ * @brief Entry point for the headless FlightControl host simulator
+ *
+ * Runs setup() once and loop() for the requested number of cycles against
+ * the simulated platform, then reports simulated time, wall time, packet
+ * volume, String heap traffic and heap use.
+ *
+ * --heap-limit fails the run when the heap in use during any cycle peaks
+ * above BYTES more than it was after setup(). --leak-limit fails it when the
+ * heap held at the end of a cycle has grown more than BYTES since the end of
+ * the first cycle, which leaves out buffers that are allocated once.
+ * --late-limit fails it when a sample started more than MS after its
+ * deadline, or a sample deadline was skipped.
+ *
+ * --i2c-latency and --fram-latency set the SimLatency bus models in
+ * microseconds (per transaction and per FRAM byte). --profile prints the
+ * per sensor stage timing (diagnostic level 6) collected over the run.
+ *
+ * Usage: flight_simulator [--cycles N] [--verbose] [--heap-limit BYTES] [--leak-limit BYTES]
+ *                         [--late-limit MS] [--i2c-latency US] [--fram-latency US] [--profile]
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SimulatorPlatform.h"
+#include "Particle.h"
+#include "acquisition/TaskScheduler.h"
+#include "acquisition/SensorProfiler.h"
+#include "telemetry/HeapMonitor.h"
+
+extern TaskScheduler scheduler;
+extern HeapMonitor::Probe heapProbe;
+extern SensorProfiler::Clock profileClock;
+void setup();
+void loop();
+String getDiagnosticString(uint8_t level);
+
+namespace {
+    void readSimHeap(HeapMonitor::Sample& sample) {
+        sample.freeBytes = System.freeMemory();
+        sample.largestFreeBlock = sample.freeBytes; //No fragmentation model on the host
+        sample.allocations = SimHeap::liveAllocations;
+    }
+
+    uint32_t readSimMicros() {
+        return (uint32_t)VirtualClock::instance().peekMicros(); //Reading the profile clock must not move simulated time
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned long cycles = 1000;
+    size_t heapLimit = 0; //0 for no limit
+    size_t leakLimit = 0;
+    bool checkLeak = false;
+    unsigned long lateLimit = 0;
+    bool checkLate = false;
+    bool profile = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) cycles = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--verbose") == 0) Serial.echo = true;
+        else if (strcmp(argv[i], "--heap-limit") == 0 && i + 1 < argc) heapLimit = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--leak-limit") == 0 && i + 1 < argc) {
+            leakLimit = strtoul(argv[++i], nullptr, 10);
+            checkLeak = true;
+        }
+        else if (strcmp(argv[i], "--late-limit") == 0 && i + 1 < argc) {
+            lateLimit = strtoul(argv[++i], nullptr, 10);
+            checkLate = true;
+        }
+        else if (strcmp(argv[i], "--i2c-latency") == 0 && i + 1 < argc) SimLatency::i2cTransactionUs = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--fram-latency") == 0 && i + 1 < argc) SimLatency::framByteUs = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--profile") == 0) profile = true;
+        else {
+            fprintf(stderr, "Usage: %s [--cycles N] [--verbose] [--heap-limit BYTES] [--leak-limit BYTES] [--late-limit MS] [--i2c-latency US] [--fram-latency US] [--profile]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    SimHeap::setBaseline(); //Free memory counts down from here, as on a freshly booted device
+    configureSimulatorPlatform();
+    heapProbe = readSimHeap;
+    profileClock = readSimMicros;
+    VirtualClock& clock = VirtualClock::instance();
+    auto wallStart = std::chrono::steady_clock::now();
+
+    setup();
+    uint64_t setupMillis = clock.peekMillis();
+    StringStats::reset();
+    size_t setupBytes = SimHeap::liveBytes;
+    size_t firstCycleBytes = 0;
+    size_t peakCycleBytes = 0; //Largest per cycle peak above setupBytes
+    unsigned long peakCycle = 0;
+    int result = 0;
+
+    for (unsigned long i = 0; i < cycles; i++) {
+        SimHeap::resetPeak();
+        loop();
+        size_t cyclePeak = SimHeap::peakBytes > setupBytes ? SimHeap::peakBytes - setupBytes : 0;
+        if (cyclePeak > peakCycleBytes) {
+            peakCycleBytes = cyclePeak;
+            peakCycle = i;
+        }
+        if (heapLimit > 0 && cyclePeak > heapLimit && result == 0) {
+            fprintf(stderr, "Heap limit exceeded in cycle %lu: %zu bytes above setup, limit %zu\n", i, cyclePeak, heapLimit);
+            result = 2;
+        }
+        if (i == 0) firstCycleBytes = SimHeap::liveBytes;
+        else if (checkLeak && SimHeap::liveBytes > firstCycleBytes + leakLimit && result == 0) {
+            fprintf(stderr, "Leak limit exceeded after cycle %lu: %zu bytes held since the first cycle, limit %zu\n", i, SimHeap::liveBytes - firstCycleBytes, leakLimit);
+            result = 3;
+        }
+    }
+
+    long heldBytes = cycles > 0 ? (long)SimHeap::liveBytes - (long)firstCycleBytes : 0L; //Before printf allocates the stdout buffer
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    uint64_t loopMillis = clock.peekMillis() - setupMillis;
+    printf("Cycles: %lu\n", cycles);
+    printf("Simulated time: %llu ms setup, %llu ms loop (%.1f ms/cycle)\n",
+           (unsigned long long)setupMillis, (unsigned long long)loopMillis,
+           cycles > 0 ? (double)loopMillis / cycles : 0.0);
+    printf("Wall time: %.3f s\n", wallSeconds);
+    printf("Publishes: %lu (%lu bytes)\n", Particle.publishCount, Particle.publishBytes);
+    printf("String allocations: %lu (%lu bytes copied)\n", StringStats::allocations, StringStats::bytesCopied);
+    printf("Heap: %zu bytes after setup, %zu bytes peak above setup (cycle %lu), %ld bytes held since the first cycle\n",
+           setupBytes, peakCycleBytes, peakCycle, heldBytes);
+    const uint8_t sampleTask = 0; //Tasks::SAMPLE
+    printf("Schedule: %lu samples, %lu ms latest start, %lu deadlines missed\n",
+           scheduler.getRuns(sampleTask), scheduler.getMaxLateMs(sampleTask), scheduler.getMissed(sampleTask));
+    if (checkLate && result == 0 && (scheduler.getMaxLateMs(sampleTask) > lateLimit || scheduler.getMissed(sampleTask) > 0)) {
+        fprintf(stderr, "Late limit exceeded: a sample started %lu ms after its deadline, %lu deadlines missed, limit %lu ms\n",
+                scheduler.getMaxLateMs(sampleTask), scheduler.getMissed(sampleTask), lateLimit);
+        result = 4;
+    }
+    printf("Resets requested: %lu\n", System.resetCount);
+    if (profile) printf("Profile: %s\n", getDiagnosticString(6).c_str()); //SensorProfiler::DIAGNOSTIC_LEVEL
+    fflush(stdout);
+    quick_exit(result); //The platform mocks are globals and gmock's registry is gone before they are destroyed, so skip static destructors
+}
@@ -0,0 +1,151 @@
+/**
+ * @file SimulatorPlatform.cpp
+ * @brief Definitions and default behaviour of the simulator platform mocks
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include "SimulatorPlatform.h"
+#include "Particle.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::An;
+
+SimSerial Serial;
+SimSerial Serial1;
+SimWire Wire;
+SimSystem System;
+SimCloud Particle;
+SimTime Time;
+
+::testing::NiceMock<MockTimeProvider> realTimeProvider;
+::testing::NiceMock<MockGpio> realGpio;
+::testing::NiceMock<MockSystem> realSystem;
+::testing::NiceMock<MockWire> realWire;
+::testing::NiceMock<MockCloud> realCloud;
+::testing::NiceMock<MockSerial> realSerialDebug;
+::testing::NiceMock<MockSerial> realSerialSdi12;
+
+::testing::NiceMock<MockPCAL9535A> realIoOB;
+::testing::NiceMock<MockPCAL9535A> realIoTalon;
+::testing::NiceMock<MockPAC1934> realCsaAlpha;
+::testing::NiceMock<MockPAC1934> realCsaBeta;
+::testing::NiceMock<MockPCA9634> realLed;
+::testing::NiceMock<MockMCP79412> realRtc;
+::testing::NiceMock<MockVEML3328> realAls;
+::testing::NiceMock<MockSFE_UBLOX_GNSS> realGps;
+::testing::NiceMock<MockAdafruit_SHT4X> realTempHumidity;
+::testing::NiceMock<MockMXC6655> realAccel;
+::testing::NiceMock<MockBMA456> realBackupAccel;
+::testing::NiceMock<MockPCAL9535A> ioAlpha;
+::testing::NiceMock<MockPCAL9535A> ioBeta;
+::testing::NiceMock<MockFram> realFram;
+
+namespace {
+    void configureTime() {
+        VirtualClock& clock = VirtualClock::instance();
+        ON_CALL(realTimeProvider, millis()).WillByDefault(Invoke([&clock]() { return (uint32_t)clock.millis(); }));
+        ON_CALL(realTimeProvider, delay(_)).WillByDefault(Invoke([&clock](uint32_t ms) { clock.advance(ms); }));
+        ON_CALL(realTimeProvider, now()).WillByDefault(Invoke([&clock]() { return clock.now(); }));
+        ON_CALL(realTimeProvider, isValid()).WillByDefault(Return(true));
+        ON_CALL(realTimeProvider, year()).WillByDefault(Invoke([]() { return Time.year(); }));
+        ON_CALL(realTimeProvider, month()).WillByDefault(Invoke([]() { return Time.month(); }));
+        ON_CALL(realTimeProvider, day()).WillByDefault(Invoke([]() { return Time.day(); }));
+        ON_CALL(realTimeProvider, hour()).WillByDefault(Invoke([]() { return Time.hour(); }));
+        ON_CALL(realTimeProvider, minute()).WillByDefault(Invoke([]() { return Time.minute(); }));
+        ON_CALL(realTimeProvider, second()).WillByDefault(Invoke([]() { return Time.second(); }));
+        ON_CALL(realTimeProvider, year(_)).WillByDefault(Invoke([](time_t t) { return Time.year(t); }));
+        ON_CALL(realTimeProvider, month(_)).WillByDefault(Invoke([](time_t t) { return Time.month(t); }));
+        ON_CALL(realTimeProvider, day(_)).WillByDefault(Invoke([](time_t t) { return Time.day(t); }));
+        ON_CALL(realTimeProvider, hour(_)).WillByDefault(Invoke([](time_t t) { return Time.hour(t); }));
+        ON_CALL(realTimeProvider, minute(_)).WillByDefault(Invoke([](time_t t) { return Time.minute(t); }));
+        ON_CALL(realTimeProvider, second(_)).WillByDefault(Invoke([](time_t t) { return Time.second(t); }));
+
+        ON_CALL(realRtc, getTimeUnix()).WillByDefault(Invoke([&clock]() { return clock.now(); }));
+        ON_CALL(realRtc, getUUIDString()).WillByDefault(Return(String("0000000000000000")));
+
+        ON_CALL(realSystem, freeMemory()).WillByDefault(Invoke([]() { return System.freeMemory(); }));
+        ON_CALL(realSystem, waitForCondition(_, _)).WillByDefault(Invoke([](std::function<bool()> condition, std::chrono::milliseconds timeout) {
+            return System.waitCondition(condition, (unsigned long)timeout.count());
+        }));
+    }
+
+    void configureCloud() {
+        ON_CALL(realCloud, connected()).WillByDefault(Invoke([]() { return SimCloud::connected(); }));
+        ON_CALL(realCloud, syncTime()).WillByDefault(Return(true));
+        ON_CALL(realCloud, syncTimeDone()).WillByDefault(Return(true));
+        ON_CALL(realCloud, process()).WillByDefault(Return(true));
+    }
+
+    void configureGps() {
+        ON_CALL(realGps, begin()).WillByDefault(Return(true));
+        ON_CALL(realGps, getFixType()).WillByDefault(Return(3)); //3D fix, so setup() does not wait out maxConnectTime
+        ON_CALL(realGps, getGnssFixOk()).WillByDefault(Return(true));
+        ON_CALL(realGps, getPVT()).WillByDefault(Return(true));
+        ON_CALL(realGps, getSIV()).WillByDefault(Return(9));
+        ON_CALL(realGps, getLatitude()).WillByDefault(Return(449765000L)); //St. Paul, MN
+        ON_CALL(realGps, getLongitude()).WillByDefault(Return(-931806000L));
+        ON_CALL(realGps, getAltitude()).WillByDefault(Return(256000L));
+        ON_CALL(realGps, getDateValid()).WillByDefault(Return(true));
+        ON_CALL(realGps, getTimeValid()).WillByDefault(Return(true));
+        ON_CALL(realGps, getTimeFullyResolved()).WillByDefault(Return(true));
+    }
+
+    void configureFram() {
+        static std::vector<uint8_t> fram(32768, 0xFF); //MB85RC256V, kept for the whole run like the real part across resets
+        ON_CALL(realFram, begin()).WillByDefault(Return(true));
+        ON_CALL(realFram, length()).WillByDefault(Return(fram.size()));
+        ON_CALL(realFram, readData(_, _, _)).WillByDefault(Invoke([](uint32_t addr, uint8_t* data, size_t len) {
+            SimLatency::framTransfer(len);
+            if (addr + len > fram.size()) return false;
+            memcpy(data, &fram[addr], len);
+            return true;
+        }));
+        ON_CALL(realFram, writeData(_, _, _)).WillByDefault(Invoke([](uint32_t addr, const uint8_t* data, size_t len) {
+            SimLatency::framTransfer(len);
+            if (addr + len > fram.size()) return false;
+            memcpy(&fram[addr], data, len);
+            return true;
+        }));
+    }
+
+    void configureExpander(::testing::NiceMock<MockPCAL9535A>& io) { //Each pin operation is one register read-modify-write on the device
+        auto transaction = Invoke([]() { SimLatency::i2cTransaction(); SimLatency::i2cTransaction(); return 0; });
+        ON_CALL(io, pinMode(_, _)).WillByDefault(::testing::WithoutArgs(transaction));
+        ON_CALL(io, pinMode(_, _, _)).WillByDefault(::testing::WithoutArgs(transaction));
+        ON_CALL(io, digitalWrite(_, _)).WillByDefault(::testing::WithoutArgs(transaction));
+        ON_CALL(io, digitalWrite(_, _, _)).WillByDefault(::testing::WithoutArgs(transaction));
+        ON_CALL(io, digitalRead(_)).WillByDefault(::testing::WithoutArgs(transaction));
+        ON_CALL(io, digitalRead(_, _)).WillByDefault(::testing::WithoutArgs(transaction));
+    }
+
+    void configurePower(::testing::NiceMock<MockPAC1934>& csa) {
+        ON_CALL(csa, begin()).WillByDefault(Return(true));
+        ON_CALL(csa, update(_)).WillByDefault(Return(0));
+        ON_CALL(csa, getBusVoltage(_, _)).WillByDefault(Return(3.3f));
+        ON_CALL(csa, getBusVoltage(_, _, _)).WillByDefault(Return(3.3f));
+        ON_CALL(csa, getCurrent(_, _)).WillByDefault(Return(5.0f)); //mA
+        ON_CALL(csa, getCurrent(_, _, _)).WillByDefault(Return(5.0f));
+        ON_CALL(csa, getPowerAvg(_)).WillByDefault(Return(16.5f)); //mW
+        ON_CALL(csa, getPowerAvg(_, _)).WillByDefault(Return(16.5f));
+    }
+}
+
+void configureSimulatorPlatform() {
+    configureTime();
+    configureCloud();
+    configureGps();
+    configureFram();
+    configureExpander(realIoOB);
+    configureExpander(realIoTalon);
+    configureExpander(ioAlpha);
+    configureExpander(ioBeta);
+    configurePower(realCsaAlpha);
+    configurePower(realCsaBeta);
+    ON_CALL(realWire, isEnabled()).WillByDefault(Return(true));
+    ON_CALL(realWire, endTransmission()).WillByDefault(Invoke([]() { SimLatency::i2cTransaction(); return Wire.nackCode; })); //No I2C devices on the simulated bus
+    ON_CALL(realAls, getLux()).WillByDefault(Return(250.0f));
+    ON_CALL(realAccel, getTemp()).WillByDefault(Return(22.0f));
+}
@@ -0,0 +1,68 @@
+/**
+ * @file SimulatorPlatform.h
+ * @brief Mock-backed platform and hardware objects for the host simulator
+ *
+ * Declares the same object names FlightControl.cpp defines on device
+ * (realTimeProvider, realWire, realRtc, ...) as NiceMocks, so the firmware
+ * constructs Kestrel against them unchanged. configureSimulatorPlatform()
+ * installs default behaviour driven by VirtualClock.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef SIMULATOR_PLATFORM_H
+#define SIMULATOR_PLATFORM_H
+
+#include <gmock/gmock.h>
+
+#include "mocks/MockTimeProvider.h"
+#include "mocks/MockGpio.h"
+#include "mocks/MockSystem.h"
+#include "mocks/MockWire.h"
+#include "mocks/MockCloud.h"
+#include "mocks/MockSerial.h"
+#include "mocks/MockPCAL9535A.h"
+#include "mocks/MockPAC1934.h"
+#include "mocks/MockPCA9634.h"
+#include "mocks/MockMCP79412.h"
+#include "mocks/MockVEML3328.h"
+#include "mocks/MockSFE_UBLOX_GNSS.h"
+#include "mocks/MockAdafruit_SHT4X.h"
+#include "mocks/MockMXC6655.h"
+#include "mocks/MockBMA456.h"
+#include "mocks/MockFram.h"
+
+extern ::testing::NiceMock<MockTimeProvider> realTimeProvider;
+extern ::testing::NiceMock<MockGpio> realGpio;
+extern ::testing::NiceMock<MockSystem> realSystem;
+extern ::testing::NiceMock<MockWire> realWire;
+extern ::testing::NiceMock<MockCloud> realCloud;
+extern ::testing::NiceMock<MockSerial> realSerialDebug;
+extern ::testing::NiceMock<MockSerial> realSerialSdi12;
+
+extern ::testing::NiceMock<MockPCAL9535A> realIoOB;
+extern ::testing::NiceMock<MockPCAL9535A> realIoTalon;
+extern ::testing::NiceMock<MockPAC1934> realCsaAlpha;
+extern ::testing::NiceMock<MockPAC1934> realCsaBeta;
+extern ::testing::NiceMock<MockPCA9634> realLed;
+extern ::testing::NiceMock<MockMCP79412> realRtc;
+extern ::testing::NiceMock<MockVEML3328> realAls;
+extern ::testing::NiceMock<MockSFE_UBLOX_GNSS> realGps;
+extern ::testing::NiceMock<MockAdafruit_SHT4X> realTempHumidity;
+extern ::testing::NiceMock<MockMXC6655> realAccel;
+extern ::testing::NiceMock<MockBMA456> realBackupAccel;
+extern ::testing::NiceMock<MockPCAL9535A> ioAlpha;
+extern ::testing::NiceMock<MockPCAL9535A> ioBeta;
+extern ::testing::NiceMock<MockFram> realFram;
+
+/**
+ * @brief Install default simulator behaviour on every platform mock
+ *
+ * Time sources read VirtualClock, delays advance it, the cloud and GPS
+ * report connected with a fix, and the CSAs report a nominal 3.3V rail.
+ * I2C, IO expander and FRAM calls advance the clock by SimLatency.
+ * Call once before setup().
+ */
+void configureSimulatorPlatform();
+
+#endif // SIMULATOR_PLATFORM_H
@@ -0,0 +1,69 @@
+/**
+ * @file VirtualClock.h
+ * @brief Simulated time base for the host simulator
+ *
+ * All simulated time sources (millis(), Time, the mocked RTC and time
+ * provider) read from this clock, and delay()/sleep advance it instantly,
+ * so thousands of logging cycles run in seconds of wall time.
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#ifndef VIRTUAL_CLOCK_H
+#define VIRTUAL_CLOCK_H
+
+#include <stdint.h>
+#include <time.h>
+
+class VirtualClock {
+public:
+    static VirtualClock& instance() {
+        static VirtualClock clock;
+        return clock;
+    }
+
+    /**
+     * @brief Current simulated uptime in ms
+     *
+     * Every read advances the clock by the read tick (1 ms by default) so
+     * firmware busy-wait loops that poll millis() always make progress.
+     */
+    uint64_t millis() {
+        uint64_t now = m_micros / 1000;
+        m_micros += (uint64_t)m_readTick * 1000;
+        return now;
+    }
+
+    /**
+     * @brief Current simulated uptime in ms without advancing the clock
+     */
+    uint64_t peekMillis() const { return m_micros / 1000; }
+
+    /**
+     * @brief Current simulated uptime in us without advancing the clock
+     *
+     * Sub millisecond time only comes from advanceMicros(), the latency
+     * models of simulated buses.
+     */
+    uint64_t peekMicros() const { return m_micros; }
+
+    /**
+     * @brief Current simulated wall clock time (unix seconds)
+     */
+    time_t now() const { return m_epoch + (time_t)(m_micros / 1000000); }
+
+    void advance(uint64_t ms) { m_micros += ms * 1000; }
+    void advanceMicros(uint64_t us) { m_micros += us; }
+    void setEpoch(time_t epoch) { m_epoch = epoch; }
+    void setReadTick(uint32_t ms) { m_readTick = ms; }
+    void reset() { m_micros = 0; }
+
+private:
+    VirtualClock() : m_micros(0), m_epoch(1704067200), m_readTick(1) {} //Start at 2024-01-01 00:00:00 UTC
+
+    uint64_t m_micros;
+    time_t m_epoch;
+    uint32_t m_readTick;
+};
+
+#endif // VIRTUAL_CLOCK_H
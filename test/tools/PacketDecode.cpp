@@ -0,0 +1,69 @@
+/**
+ * @file PacketDecode.cpp
+ * @brief Host tool expanding PacketCodec records back to JSON
+ *
+ * Reads records (one per line, as published or as written to SD) from a file
+ * or stdin and prints the JSON packets. Plain JSON lines pass through, so
+ * logs mixing both encodings can be decoded in one go. Batched payloads are
+ * split into their packets, one per output line. Diff data packets are
+ * rebuilt into full packets against their keyframe, so records must be given
+ * in the order they were logged:
+ *
+ *   ./packet_decode backhaul.txt > packets.json
+ *
+ * © 2025 Regents of the University of Minnesota. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "telemetry/PacketCodec.h"
+#include "telemetry/BackhaulBatcher.h"
+#include "telemetry/DataDiff.h"
+
+int main(int argc, char** argv) {
+    FILE* input = stdin;
+    if (argc > 1) {
+        input = fopen(argv[1], "r");
+        if (input == nullptr) {
+            fprintf(stderr, "Can not open %s\n", argv[1]);
+            return 1;
+        }
+    }
+    int failures = 0;
+    unsigned long lineNumber = 0;
+    static char line[16384];
+    std::string json;
+    std::string schema;
+    std::string full;
+    DataDiffDecoder diffDecoder;
+    std::vector<std::string> packets;
+    while (fgets(line, sizeof(line), input) != nullptr) {
+        lineNumber++;
+        size_t len = strcspn(line, "\r\n");
+        if (len == 0) continue;
+        packets.clear();
+        BackhaulBatcher::split(line, len, packets);
+        for (const std::string& packet : packets) {
+            if (!PacketCodec::decode(packet.c_str(), packet.length(), json, &schema)) {
+                fprintf(stderr, "Line %lu: not a valid record\n", lineNumber);
+                failures++;
+                continue;
+            }
+            size_t start = 0;
+            while (start < json.length()) { //One record may hold several packets
+                size_t end = json.find('\n', start);
+                if (end == std::string::npos) end = json.length();
+                if (diffDecoder.apply(json.substr(start, end - start), full)) printf("%s\n", full.c_str());
+                else {
+                    fprintf(stderr, "Line %lu: diff packet without its keyframe\n", lineNumber);
+                    failures++;
+                }
+                start = end + 1;
+            }
+        }
+    }
+    if (input != stdin) fclose(input);
+    return failures > 0 ? 1 : 0;
+}
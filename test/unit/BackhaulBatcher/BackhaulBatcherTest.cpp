@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include "telemetry/BackhaulBatcher.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Written {
+    std::string payload;
+    uint8_t dataType;
+    uint8_t destination;
+};
+
+std::vector<Written> written;
+
+void capture(const char* payload, size_t len, uint8_t dataType, uint8_t destination)
+{
+    written.push_back({std::string(payload, len), dataType, destination});
+}
+
+} // namespace
+
+class BackhaulBatcherTest : public ::testing::Test {
+protected:
+    BackhaulBatcherTest() : batcher(arena, sizeof(arena), capture) {
+        written.clear();
+        batcher.configure(64, 60000);
+    }
+
+    void add(const std::string& record, uint8_t dataType, unsigned long now = 0, uint8_t destination = 3) {
+        batcher.add(record.c_str(), record.length(), dataType, destination, now);
+    }
+
+    char arena[4 * 80];
+    BackhaulBatcher batcher;
+};
+
+TEST_F(BackhaulBatcherTest, DisabledWritesRecordsUnchanged) {
+    batcher.configure(64, 0);
+    add("{\"a\":1}\n{\"a\":2}", 1);
+    ASSERT_EQ(written.size(), 1u);
+    EXPECT_EQ(written[0].payload, "{\"a\":1}\n{\"a\":2}");
+    EXPECT_EQ(batcher.getPacketCount(), 2u);
+    EXPECT_EQ(batcher.getPayloadCount(), 2u);
+}
+
+TEST_F(BackhaulBatcherTest, JoinsPacketsOfOneTypeIntoArray) {
+    add("{\"a\":1}", 1);
+    add("{\"a\":2}\n{\"a\":3}", 1);
+    EXPECT_TRUE(written.empty()); //Held until flushed
+    batcher.flush();
+    ASSERT_EQ(written.size(), 1u);
+    EXPECT_EQ(written[0].payload, "[{\"a\":1},{\"a\":2},{\"a\":3}]");
+    EXPECT_FLOAT_EQ(batcher.getPacketsPerPayload(), 3.0f);
+}
+
+TEST_F(BackhaulBatcherTest, SinglePacketBatchIsUnchanged) {
+    add("{\"a\":1}", 1);
+    batcher.flush();
+    ASSERT_EQ(written.size(), 1u);
+    EXPECT_EQ(written[0].payload, "{\"a\":1}");
+}
+
+TEST_F(BackhaulBatcherTest, GroupsByTypeAndDestination) {
+    add("{\"d\":1}", 1);
+    add("{\"g\":1}", 2);
+    add("{\"d\":2}", 1, 0, 2);
+    add("{\"d\":3}", 1);
+    batcher.flush();
+    ASSERT_EQ(written.size(), 3u);
+    EXPECT_EQ(written[0].payload, "[{\"d\":1},{\"d\":3}]");
+    EXPECT_EQ(written[0].dataType, 1);
+    EXPECT_EQ(written[1].payload, "{\"g\":1}");
+    EXPECT_EQ(written[2].payload, "{\"d\":2}");
+    EXPECT_EQ(written[2].destination, 2);
+}
+
+TEST_F(BackhaulBatcherTest, FullBatchIsWrittenBeforeOverflow) {
+    std::string packet = "{\"v\":\"" + std::string(20, 'x') + "\"}"; //28 bytes, two fit in 64 with brackets
+    add(packet, 1);
+    add(packet, 1);
+    add(packet, 1);
+    ASSERT_EQ(written.size(), 1u);
+    EXPECT_EQ(written[0].payload, "[" + packet + "," + packet + "]");
+    EXPECT_LE(written[0].payload.length(), 64u);
+    batcher.flush();
+    ASSERT_EQ(written.size(), 2u);
+    EXPECT_EQ(written[1].payload, packet);
+}
+
+TEST_F(BackhaulBatcherTest, OversizePacketIsSentAlone) {
+    add("{\"a\":1}", 1);
+    std::string big = "{\"v\":\"" + std::string(80, 'x') + "\"}";
+    add(big, 1);
+    ASSERT_EQ(written.size(), 2u);
+    EXPECT_EQ(written[0].payload, "{\"a\":1}"); //Queued packet keeps its order
+    EXPECT_EQ(written[1].payload, big);
+}
+
+TEST_F(BackhaulBatcherTest, OversizePacketOfMultiLineRecordKeepsItsLength) {
+    std::string big = "{\"v\":\"" + std::string(80, 'x') + "\"}";
+    add(big + "\n{\"a\":1}", 1);
+    ASSERT_EQ(written.size(), 1u);
+    EXPECT_EQ(written[0].payload, big); //Sent straight from the record, the next line is left out
+}
+
+TEST_F(BackhaulBatcherTest, PayloadFillingTheLastSlotStaysInside) {
+    for (size_t length = 77; length <= 80; length++) { //Around the largest payload a slot holds
+        written.clear();
+        char buffer[4 * 80 + 1];
+        buffer[4 * 80] = 'G'; //Guard byte past the last slot
+        BackhaulBatcher full(buffer, 4 * 80, capture);
+        full.configure(200, 60000); //Clamped to the slot
+        for (uint8_t type = 0; type < 3; type++) full.add("{}", 2, type, 3, 0); //Last slot goes to the fourth group
+        std::string packet = "{\"v\":\"" + std::string(length - 8, 'x') + "\"}";
+        full.add(packet.c_str(), packet.length(), 3, 3, 0);
+        full.flush();
+        ASSERT_EQ(written.size(), 4u);
+        bool sent = false;
+        for (const Written& w : written) sent |= w.dataType == 3 && w.payload == packet; //Oversize packets go out before the flush
+        EXPECT_TRUE(sent) << length;
+        EXPECT_EQ(buffer[4 * 80], 'G') << length;
+    }
+}
+
+TEST_F(BackhaulBatcherTest, DeadlineFlushesOldBatches) {
+    add("{\"a\":1}", 1, 1000);
+    add("{\"b\":1}", 2, 30000);
+    batcher.poll(60999);
+    EXPECT_TRUE(written.empty());
+    batcher.poll(61000);
+    ASSERT_EQ(written.size(), 1u);
+    EXPECT_EQ(written[0].payload, "{\"a\":1}");
+    EXPECT_EQ(batcher.getPendingGroups(), 1);
+}
+
+TEST_F(BackhaulBatcherTest, EncodedPacketsAreConcatenated) {
+    add("~AAAA", 1);
+    add("~BBBB", 1);
+    add("{\"a\":1}", 1); //Not encodable, can not share the batch
+    batcher.flush();
+    ASSERT_EQ(written.size(), 2u);
+    EXPECT_EQ(written[0].payload, "~AAAA~BBBB");
+    EXPECT_EQ(written[1].payload, "{\"a\":1}");
+}
+
+TEST_F(BackhaulBatcherTest, OldestGroupMakesRoomForNewType) {
+    for (uint8_t type = 0; type < BackhaulBatcher::MAX_GROUPS; type++) add("{\"t\":" + std::to_string(type) + "}", type, type);
+    add("{\"t\":9}", 9, 10);
+    ASSERT_EQ(written.size(), 1u);
+    EXPECT_EQ(written[0].dataType, 0);
+    EXPECT_EQ(batcher.getPendingGroups(), (int)BackhaulBatcher::MAX_GROUPS);
+}
+
+TEST_F(BackhaulBatcherTest, SplitRecoversPackets) {
+    std::vector<std::string> packets;
+    std::string array = "[{\"a\":\"x,]\"},{\"b\":[1,2]}]";
+    BackhaulBatcher::split(array.c_str(), array.length(), packets);
+    ASSERT_EQ(packets.size(), 2u);
+    EXPECT_EQ(packets[0], "{\"a\":\"x,]\"}");
+    EXPECT_EQ(packets[1], "{\"b\":[1,2]}");
+
+    packets.clear();
+    std::string encoded = "~AAAA~BB==";
+    BackhaulBatcher::split(encoded.c_str(), encoded.length(), packets);
+    ASSERT_EQ(packets.size(), 2u);
+    EXPECT_EQ(packets[1], "~BB==");
+
+    packets.clear();
+    BackhaulBatcher::split("{\"a\":1}", 7, packets);
+    ASSERT_EQ(packets.size(), 1u);
+}
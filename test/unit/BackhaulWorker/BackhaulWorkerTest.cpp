@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "telemetry/BackhaulWorker.h"
+
+class BackhaulWorkerTest : public ::testing::Test {
+protected:
+    BackhaulWorker worker;
+};
+
+TEST_F(BackhaulWorkerTest, IdleWithoutRequest) {
+    EXPECT_EQ(worker.step(0, true), BackhaulWorker::IDLE);
+    EXPECT_FALSE(worker.isBusy());
+}
+
+TEST_F(BackhaulWorkerTest, TransfersAtOnceWhenNoConnectNeeded) {
+    worker.request(1000, false, 300000);
+    EXPECT_TRUE(worker.isBusy());
+    EXPECT_EQ(worker.step(1000, false), BackhaulWorker::TRANSFER); //Same as the old path, dump regardless
+    EXPECT_EQ(worker.step(1500, false), BackhaulWorker::WAIT);
+    worker.transferDone(3000);
+    EXPECT_FALSE(worker.isBusy());
+    EXPECT_EQ(worker.getTransfers(), 1);
+    EXPECT_EQ(worker.getLastTransferMs(), 2000u);
+}
+
+TEST_F(BackhaulWorkerTest, ConnectsThenTransfers) {
+    worker.request(1000, true, 300000);
+    EXPECT_EQ(worker.step(1000, false), BackhaulWorker::CONNECT);
+    EXPECT_EQ(worker.step(5000, false), BackhaulWorker::WAIT);
+    EXPECT_TRUE(worker.isBusy());
+    EXPECT_EQ(worker.step(46000, true), BackhaulWorker::TRANSFER);
+    EXPECT_EQ(worker.getLastConnectMs(), 45000u);
+    worker.transferDone(47000);
+    EXPECT_FALSE(worker.isBusy());
+}
+
+TEST_F(BackhaulWorkerTest, SkipsConnectWhenAlreadyConnected) {
+    worker.request(0, true, 300000);
+    EXPECT_EQ(worker.step(0, true), BackhaulWorker::TRANSFER);
+}
+
+TEST_F(BackhaulWorkerTest, GivesUpAfterTimeout) {
+    worker.request(1000, true, 300000);
+    EXPECT_EQ(worker.step(1000, false), BackhaulWorker::CONNECT);
+    EXPECT_EQ(worker.step(300999, false), BackhaulWorker::WAIT);
+    EXPECT_EQ(worker.step(301000, false), BackhaulWorker::IDLE);
+    EXPECT_FALSE(worker.isBusy());
+    EXPECT_EQ(worker.getTimeouts(), 1);
+    EXPECT_EQ(worker.getTransfers(), 0);
+}
+
+TEST_F(BackhaulWorkerTest, MergesRequestsNotYetStarted) {
+    worker.request(0, false, 0);
+    worker.request(10, true, 300000);
+    EXPECT_EQ(worker.getMerged(), 1);
+    EXPECT_EQ(worker.step(20, false), BackhaulWorker::CONNECT); //Merged request keeps the connect
+}
+
+TEST_F(BackhaulWorkerTest, RequestDuringTransferIsMerged) {
+    worker.request(0, false, 0);
+    EXPECT_EQ(worker.step(0, true), BackhaulWorker::TRANSFER);
+    worker.request(100, false, 0); //Records written after the transfer started go with the next request
+    EXPECT_EQ(worker.step(200, true), BackhaulWorker::WAIT);
+    worker.transferDone(300);
+    EXPECT_FALSE(worker.isBusy());
+    EXPECT_EQ(worker.step(400, true), BackhaulWorker::IDLE);
+    EXPECT_EQ(worker.getTransfers(), 1);
+    EXPECT_EQ(worker.getMerged(), 1);
+}
+
+TEST_F(BackhaulWorkerTest, RequestWhileConnectingKeepsTimeout) {
+    worker.request(1000, true, 300000);
+    EXPECT_EQ(worker.step(1000, false), BackhaulWorker::CONNECT);
+    worker.request(200000, true, 300000);
+    EXPECT_EQ(worker.getMerged(), 1);
+    EXPECT_EQ(worker.step(301000, false), BackhaulWorker::IDLE); //Timed out from the first request
+    EXPECT_EQ(worker.getTimeouts(), 1);
+    EXPECT_FALSE(worker.isBusy());
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "hardware/ConcurrentSDI12Talon.h"
+#include "MockSDI12Talon.h"
+#include "MockTimeProvider.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+class ConcurrentSDI12TalonTest : public ::testing::Test {
+protected:
+    NiceMock<MockSDI12Talon> talon;
+    NiceMock<MockTimeProvider> timeProvider;
+    ConcurrentSDI12Talon concurrent{talon, timeProvider};
+    uint32_t now = 1000;
+
+    void SetUp() override {
+        ON_CALL(timeProvider, millis()).WillByDefault(Invoke([this]() { return now; }));
+        ON_CALL(timeProvider, delay(_)).WillByDefault(Invoke([this](uint32_t ms) { now += ms; }));
+    }
+
+    //First cycle, driver measures normally and is learned as a participant
+    void learn(uint8_t talonPort, uint8_t sensorPort, int address) {
+        concurrent.setActivePort(talonPort, sensorPort);
+        concurrent.startMeasurment(address);
+    }
+};
+
+TEST_F(ConcurrentSDI12TalonTest, LearnsSensorsMeasuringThroughInterface) {
+    EXPECT_CALL(talon, startMeasurment(0)).WillOnce(Return(2));
+    learn(1, 2, 0);
+    EXPECT_EQ(concurrent.getParticipantCount(), 1);
+    EXPECT_EQ(concurrent.getParticipantTalonPort(0), 1);
+    EXPECT_EQ(concurrent.getParticipantSensorPort(0), 2);
+}
+
+TEST_F(ConcurrentSDI12TalonTest, DoesNotLearnWithoutActivePort) {
+    concurrent.startMeasurment(0);
+    EXPECT_EQ(concurrent.getParticipantCount(), 0);
+}
+
+TEST_F(ConcurrentSDI12TalonTest, WaitsOnlyForLongestMeasurement) {
+    learn(1, 1, 0);
+    learn(1, 2, 0);
+    learn(1, 3, 1);
+    EXPECT_CALL(talon, command(String("C"), _))
+        .WillOnce(Return(String("00023\r\n")))
+        .WillOnce(Return(String("00053")))
+        .WillOnce(Return(String("10013")));
+    for (uint8_t i = 0; i < concurrent.getParticipantCount(); i++) EXPECT_TRUE(concurrent.startConcurrent(i));
+    EXPECT_CALL(timeProvider, delay(5000)).Times(1);
+    concurrent.waitForMeasurements();
+    EXPECT_EQ(concurrent.getWaitSavedMs(), 3000u); //2 + 5 + 1 seconds sequential, 5 concurrent
+}
+
+TEST_F(ConcurrentSDI12TalonTest, ServesCollectedDataToDriver) {
+    learn(2, 1, 0);
+    EXPECT_CALL(talon, command(String("C"), 0)).WillOnce(Return(String("00013")));
+    EXPECT_CALL(talon, command(String("D0"), 0)).WillOnce(Return(String("0+1.5-2.25+3")));
+    ASSERT_TRUE(concurrent.startConcurrent(0));
+    concurrent.waitForMeasurements();
+    ASSERT_TRUE(concurrent.collect(0));
+
+    concurrent.setActivePort(2, 1);
+    EXPECT_CALL(talon, startMeasurment(_)).Times(0); //No new measurement on the sensor
+    EXPECT_EQ(concurrent.startMeasurment(0), 0);
+    EXPECT_EQ(concurrent.command("D0", 0), String("0+1.5-2.25+3"));
+}
+
+TEST_F(ConcurrentSDI12TalonTest, CollectsFurtherDataCommandsUntilAllValuesRead) {
+    learn(1, 1, 0);
+    EXPECT_CALL(talon, command(String("C"), 0)).WillOnce(Return(String("000004")));
+    EXPECT_CALL(talon, command(String("D0"), 0)).WillOnce(Return(String("0+1+2")));
+    EXPECT_CALL(talon, command(String("D1"), 0)).WillOnce(Return(String("0+3-4")));
+    EXPECT_CALL(talon, command(String("D2"), 0)).Times(0);
+    ASSERT_TRUE(concurrent.startConcurrent(0));
+    ASSERT_TRUE(concurrent.collect(0));
+    concurrent.setActivePort(1, 1);
+    concurrent.startMeasurment(0);
+    EXPECT_EQ(concurrent.command("D1", 0), String("0+3-4"));
+}
+
+TEST_F(ConcurrentSDI12TalonTest, SameAddressOnDifferentPortsIsSeparate) {
+    learn(1, 1, 0);
+    learn(1, 2, 0);
+    EXPECT_CALL(talon, command(String("C"), 0)).WillRepeatedly(Return(String("00001")));
+    EXPECT_CALL(talon, command(String("D0"), 0)).WillOnce(Return(String("0+1"))).WillOnce(Return(String("0+2")));
+    concurrent.startConcurrent(0);
+    concurrent.startConcurrent(1);
+    concurrent.collect(0);
+    concurrent.collect(1);
+    concurrent.setActivePort(1, 2);
+    concurrent.startMeasurment(0);
+    EXPECT_EQ(concurrent.command("D0", 0), String("0+2"));
+}
+
+TEST_F(ConcurrentSDI12TalonTest, FallsBackWhenNotCollected) {
+    learn(1, 1, 0);
+    ON_CALL(talon, command(String("C"), 0)).WillByDefault(Return(String(""))); //No response to aC!
+    EXPECT_FALSE(concurrent.startConcurrent(0));
+    EXPECT_FALSE(concurrent.collect(0));
+    concurrent.setActivePort(1, 1);
+    EXPECT_CALL(talon, startMeasurment(0)).WillOnce(Return(1));
+    EXPECT_EQ(concurrent.startMeasurment(0), 1);
+}
+
+TEST_F(ConcurrentSDI12TalonTest, EndCycleDropsCollectedData) {
+    learn(1, 1, 0);
+    EXPECT_CALL(talon, command(String("C"), 0)).WillRepeatedly(Return(String("00001")));
+    EXPECT_CALL(talon, command(String("D0"), 0)).WillOnce(Return(String("0+1")));
+    concurrent.startConcurrent(0);
+    concurrent.collect(0);
+    concurrent.endCycle();
+    concurrent.setActivePort(1, 1);
+    EXPECT_CALL(talon, startMeasurment(0)).WillOnce(Return(1));
+    concurrent.startMeasurment(0);
+    EXPECT_EQ(concurrent.getParticipantCount(), 1);
+}
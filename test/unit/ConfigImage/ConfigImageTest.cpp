@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "configuration/ConfigImage.h"
+#include "MockParticle.h"
+
+class ConfigImageTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        EEPROM.clear();
+        image.setValue(ConfigImage::LOG_PERIOD, 86400); //Beyond the 16 bits of the system UID
+        image.setValue(ConfigImage::NUM_AUX_TALONS, 5); //Beyond 2 bits
+        image.setValue(ConfigImage::NUM_SOIL, 24); //Beyond 4 bits
+        image.setValue(ConfigImage::SD_DEADLINE, 600);
+        ASSERT_TRUE(image.addPeriod(2, 0, 3600));
+        ASSERT_TRUE(image.addPeriod(2, 17, 90000));
+    }
+
+    ConfigImage image;
+};
+
+TEST_F(ConfigImageTest, NothingStoredDoesNotLoad) {
+    ConfigImage restored;
+    EXPECT_FALSE(restored.load());
+}
+
+TEST_F(ConfigImageTest, RoundTripsThroughEEPROM) {
+    image.save();
+    ConfigImage restored;
+    ASSERT_TRUE(restored.load());
+    EXPECT_EQ(restored.getValue(ConfigImage::LOG_PERIOD), 86400);
+    EXPECT_EQ(restored.getValue(ConfigImage::NUM_AUX_TALONS), 5);
+    EXPECT_EQ(restored.getValue(ConfigImage::NUM_SOIL), 24);
+    EXPECT_EQ(restored.getValue(ConfigImage::SD_DEADLINE), 600);
+    EXPECT_EQ(restored.getValue(ConfigImage::NUM_ET), 0);
+    ASSERT_EQ(restored.getPeriodCount(), 2);
+    EXPECT_EQ(restored.getPeriodType(1), 2);
+    EXPECT_EQ(restored.getPeriodInstance(1), 17);
+    EXPECT_EQ(restored.getPeriodSeconds(1), 90000u);
+    EXPECT_EQ(restored.getPeriodSeconds(2), 0u); //Out of range
+}
+
+TEST_F(ConfigImageTest, RejectsCorruptedImage) {
+    image.save();
+    uint8_t value;
+    EEPROM.get(ConfigImage::EEPROM_ADDR + 4, value); //Low byte of logPeriod
+    EEPROM.put(ConfigImage::EEPROM_ADDR + 4, (uint8_t)(value ^ 0x01));
+    ConfigImage restored;
+    EXPECT_FALSE(restored.load());
+}
+
+TEST_F(ConfigImageTest, RejectsOtherVersion) {
+    image.save();
+    EEPROM.put(ConfigImage::EEPROM_ADDR + 1, (uint8_t)(ConfigImage::VERSION + 1));
+    ConfigImage restored;
+    EXPECT_FALSE(restored.load());
+}
+
+TEST_F(ConfigImageTest, EraseInvalidatesStoredImage) {
+    image.save();
+    image.erase();
+    ConfigImage restored;
+    EXPECT_FALSE(restored.load());
+}
+
+TEST_F(ConfigImageTest, HoldsAtMostMaxPeriods) {
+    image.clear();
+    for (int i = 0; i < ConfigImage::MAX_PERIODS; i++) EXPECT_TRUE(image.addPeriod(0, i + 1, 60));
+    EXPECT_FALSE(image.addPeriod(0, 0, 60));
+    EXPECT_EQ(image.getPeriodCount(), (uint8_t)ConfigImage::MAX_PERIODS);
+}
+
+TEST_F(ConfigImageTest, StaysClearOfDetectionMap) {
+    EXPECT_GE(ConfigImage::EEPROM_ADDR, 512 + 256); //DetectionMap image is under 256 bytes
+    EXPECT_LE((size_t)ConfigImage::EEPROM_ADDR + 512, (size_t)EEPROMClass::SIZE);
+}
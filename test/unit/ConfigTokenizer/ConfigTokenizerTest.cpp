@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <climits>
+#include <string>
+#include <vector>
+#include "configuration/ConfigTokenizer.h"
+
+namespace {
+    struct Seen {
+        std::string section;
+        std::string name;
+        ConfigTokenizer::ValueType type;
+        std::string value;
+        long number;
+    };
+
+    void collect(const ConfigTokenizer::Field& field, void* context) {
+        static_cast<std::vector<Seen>*>(context)->push_back({
+            std::string(field.section, field.sectionLength),
+            std::string(field.name, field.nameLength),
+            field.type,
+            std::string(field.value, field.valueLength),
+            field.number
+        });
+    }
+}
+
+class ConfigTokenizerTest : public ::testing::Test {
+protected:
+    ConfigTokenizer tokenizer;
+    std::vector<Seen> fields;
+
+    bool parse(const std::string& json) {
+        fields.clear();
+        return tokenizer.parse(json.data(), json.length(), collect, &fields);
+    }
+
+    void expectError(const std::string& json, ConfigTokenizer::Error error, size_t offset) {
+        EXPECT_FALSE(parse(json)) << json;
+        EXPECT_EQ(tokenizer.getError(), error) << json;
+        EXPECT_EQ(tokenizer.getErrorOffset(), offset) << json;
+    }
+};
+
+TEST_F(ConfigTokenizerTest, ReportsMembersWithTheirSection) {
+    ASSERT_TRUE(parse("{\"config\":{\"system\":{\"logPeriod\":300,\"name\":\"a\"},\"sensors\":{\"numSoil\":3}}}"));
+    ASSERT_EQ(fields.size(), 6u);
+    EXPECT_EQ(fields[0].name, "config");
+    EXPECT_EQ(fields[0].section, "");
+    EXPECT_EQ(fields[0].type, ConfigTokenizer::VALUE_OBJECT);
+    EXPECT_EQ(fields[1].name, "system");
+    EXPECT_EQ(fields[1].section, "config");
+    EXPECT_EQ(fields[2].section, "system");
+    EXPECT_EQ(fields[2].name, "logPeriod");
+    EXPECT_EQ(fields[2].type, ConfigTokenizer::VALUE_NUMBER);
+    EXPECT_EQ(fields[2].number, 300);
+    EXPECT_EQ(fields[3].type, ConfigTokenizer::VALUE_STRING);
+    EXPECT_EQ(fields[3].value, "a");
+    EXPECT_EQ(fields[5].section, "sensors");
+    EXPECT_EQ(fields[5].number, 3);
+    EXPECT_EQ(tokenizer.getError(), ConfigTokenizer::ERROR_NONE);
+}
+
+TEST_F(ConfigTokenizerTest, IgnoresWhitespace) {
+    ASSERT_TRUE(parse(" \r\n{ \"a\" :\t-12 ,\n\"b\" : true , \"c\":false,\"d\" : null }\n "));
+    ASSERT_EQ(fields.size(), 4u);
+    EXPECT_EQ(fields[0].number, -12);
+    EXPECT_EQ(fields[1].type, ConfigTokenizer::VALUE_TRUE);
+    EXPECT_EQ(fields[1].number, 1);
+    EXPECT_EQ(fields[2].type, ConfigTokenizer::VALUE_FALSE);
+    EXPECT_EQ(fields[3].type, ConfigTokenizer::VALUE_NULL);
+}
+
+TEST_F(ConfigTokenizerTest, NumbersKeepIntegerPartAndSaturate) {
+    ASSERT_TRUE(parse("{\"a\":2.75,\"b\":1e3,\"c\":-0.5E-2,\"d\":99999999999999999999999,\"e\":-99999999999999999999999}"));
+    EXPECT_EQ(fields[0].number, 2);
+    EXPECT_EQ(fields[0].value, "2.75");
+    EXPECT_EQ(fields[1].number, 1);
+    EXPECT_EQ(fields[2].number, 0);
+    EXPECT_EQ(fields[3].number, LONG_MAX);
+    EXPECT_EQ(fields[4].number, LONG_MIN);
+}
+
+TEST_F(ConfigTokenizerTest, ArrayElementsAreNotReported) {
+    ASSERT_TRUE(parse("{\"list\":[1,{\"hidden\":2},[3]],\"after\":4}"));
+    ASSERT_EQ(fields.size(), 2u);
+    EXPECT_EQ(fields[0].type, ConfigTokenizer::VALUE_ARRAY);
+    EXPECT_EQ(fields[1].name, "after");
+    EXPECT_EQ(fields[1].section, "");
+}
+
+TEST_F(ConfigTokenizerTest, StringsKeepEscapesAsWritten) {
+    ASSERT_TRUE(parse("{\"s\":\"a\\\"b\\\\c\\u00e9\\n\"}"));
+    ASSERT_EQ(fields.size(), 1u);
+    EXPECT_EQ(fields[0].value, "a\\\"b\\\\c\\u00e9\\n");
+}
+
+TEST_F(ConfigTokenizerTest, EmptyContainersAndScalars) {
+    EXPECT_TRUE(parse("{}"));
+    EXPECT_TRUE(parse("[]"));
+    EXPECT_TRUE(parse("{\"a\":{},\"b\":[]}"));
+    EXPECT_TRUE(parse("7"));
+    EXPECT_TRUE(fields.empty());
+}
+
+TEST_F(ConfigTokenizerTest, ReportsOffsetOfSyntaxErrors) {
+    expectError("", ConfigTokenizer::ERROR_UNEXPECTED_END, 0);
+    expectError("{\"a\":1", ConfigTokenizer::ERROR_UNEXPECTED_END, 6);
+    expectError("{\"a\" 1}", ConfigTokenizer::ERROR_UNEXPECTED_CHARACTER, 5);
+    expectError("{\"a\":1,}", ConfigTokenizer::ERROR_UNEXPECTED_CHARACTER, 7);
+    expectError("{\"a\":1 \"b\":2}", ConfigTokenizer::ERROR_UNEXPECTED_CHARACTER, 7);
+    expectError("{a:1}", ConfigTokenizer::ERROR_UNEXPECTED_CHARACTER, 1);
+    expectError("[1,]", ConfigTokenizer::ERROR_UNEXPECTED_CHARACTER, 3);
+    expectError("{\"a\":\"x\ty\"}", ConfigTokenizer::ERROR_BAD_STRING, 7);
+    expectError("{\"a\":\"\\q\"}", ConfigTokenizer::ERROR_BAD_STRING, 7);
+    expectError("{\"a\":\"\\u12g4\"}", ConfigTokenizer::ERROR_BAD_STRING, 10);
+    expectError("{\"a\":\"abc", ConfigTokenizer::ERROR_UNEXPECTED_END, 9);
+    expectError("{\"a\":-x}", ConfigTokenizer::ERROR_BAD_NUMBER, 6);
+    expectError("{\"a\":1.}", ConfigTokenizer::ERROR_BAD_NUMBER, 7);
+    expectError("{\"a\":1e+}", ConfigTokenizer::ERROR_BAD_NUMBER, 8);
+    expectError("{\"a\":tru}", ConfigTokenizer::ERROR_BAD_LITERAL, 8);
+    expectError("{\"a\":nul", ConfigTokenizer::ERROR_UNEXPECTED_END, 8);
+    expectError("{\"a\":1}}", ConfigTokenizer::ERROR_TRAILING_CHARACTERS, 7);
+    expectError("{\"a\":01}", ConfigTokenizer::ERROR_UNEXPECTED_CHARACTER, 6);
+}
+
+TEST_F(ConfigTokenizerTest, RejectsNestingBeyondLimit) {
+    std::string ok(ConfigTokenizer::MAX_DEPTH, '[');
+    ok += std::string(ConfigTokenizer::MAX_DEPTH, ']');
+    EXPECT_TRUE(parse(ok));
+    std::string deep((size_t)ConfigTokenizer::MAX_DEPTH + 1, '[');
+    deep += std::string((size_t)ConfigTokenizer::MAX_DEPTH + 1, ']');
+    expectError(deep, ConfigTokenizer::ERROR_TOO_DEEP, (size_t)ConfigTokenizer::MAX_DEPTH);
+}
+
+TEST_F(ConfigTokenizerTest, StopsReportingAtTheError) {
+    EXPECT_FALSE(parse("{\"a\":1,\"b\":?,\"c\":3}"));
+    ASSERT_EQ(fields.size(), 1u); //Caller must discard what it saw, ConfigurationManager stages into a copy
+    EXPECT_EQ(tokenizer.getErrorOffset(), 11u);
+}
+
+TEST_F(ConfigTokenizerTest, ValidatesWithoutHandler) {
+    const std::string json = "{\"a\":[1,2,{\"b\":null}]}";
+    EXPECT_TRUE(tokenizer.parse(json.data(), json.length(), nullptr, nullptr));
+    EXPECT_FALSE(tokenizer.parse(nullptr, 10, nullptr, nullptr));
+    EXPECT_EQ(tokenizer.getError(), ConfigTokenizer::ERROR_UNEXPECTED_END);
+}
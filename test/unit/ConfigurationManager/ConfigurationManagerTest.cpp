@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "configuration/ConfigurationManager.h"
+#include "configuration/SensorArena.h"
+#include "MockParticle.h"
+#include "MockTimeProvider.h"
+#include "MockSDI12Talon.h"
+#include <SDI12Talon.h>
 
 class ConfigurationManagerTest : public ::testing::Test {
 protected:
@@ -103,6 +108,54 @@ TEST_F(ConfigurationManagerTest, InvalidConfiguration) {
     EXPECT_EQ(configManager.getBackhaulCount(), 4);
 }
 
+// Test malformed configuration is rejected as a whole
+TEST_F(ConfigurationManagerTest, SyntaxErrorKeepsConfiguration) {
+    configManager.setConfiguration(configManager.getDefaultConfigurationJson());
+
+    std::string badConfig = "{\"config\":{\"system\":{\"logPeriod\":60,}}}";
+    EXPECT_FALSE(configManager.setConfiguration(badConfig));
+    EXPECT_EQ(configManager.getParseErrorOffset(), 36u);
+
+    // Values should remain unchanged
+    EXPECT_EQ(configManager.getLogPeriod(), 300);
+}
+
+// Test which groups of settings a new configuration changes
+TEST_F(ConfigurationManagerTest, CompareReportsChangedGroups) {
+    configManager.setConfiguration(configManager.getDefaultConfigurationJson());
+    ConfigurationManager previous(configManager);
+    EXPECT_EQ(configManager.compare(previous), 0);
+
+    std::string newConfig = "{\"config\":{\"system\":{\"logPeriod\":600,\"powerSaveMode\":2},\"sensors\":{\"numSoil\":3,\"numCO2\":1}}}";
+    ASSERT_TRUE(configManager.setConfiguration(newConfig));
+    EXPECT_EQ(configManager.compare(previous), ConfigurationManager::CHANGE_SCHEDULE | ConfigurationManager::CHANGE_POWER_SAVE | ConfigurationManager::CHANGE_SENSORS);
+
+    previous = configManager;
+    ASSERT_TRUE(configManager.setConfiguration("{\"config\":{\"system\":{\"logPeriod\":600,\"powerSaveMode\":2,\"numAuxTalons\":2},\"sensors\":{\"numCO2\":1,\"periodSoil\":900}}}"));
+    EXPECT_EQ(configManager.compare(previous), ConfigurationManager::CHANGE_TALONS | ConfigurationManager::CHANGE_SAMPLE_PERIODS);
+}
+
+// Test the EEPROM backup restores configurations the UIDs can not encode
+TEST_F(ConfigurationManagerTest, EEPROMBackupHoldsFullConfiguration) {
+    EEPROM.clear();
+    std::string largeConfig = "{\"config\":{\"system\":{\"logPeriod\":86400,\"numAuxTalons\":5,\"packetEncoding\":1,\"keyframeInterval\":12,\"sdDeadline\":600},"
+                              "\"sensors\":{\"numSoil\":20,\"periodSoil\":3600,\"periodSoil_17\":60}}}";
+    ASSERT_TRUE(configManager.setConfiguration(largeConfig)); // Saves the backup
+    std::string saved = configManager.getConfiguration();
+
+    ConfigurationManager restored;
+    ASSERT_TRUE(restored.loadConfigFromEEPROM());
+    EXPECT_EQ(restored.getLogPeriod(), 86400);
+    EXPECT_EQ(restored.getNumAuxTalons(), 5);
+    EXPECT_EQ(restored.getNumSoil(), 20);
+    EXPECT_EQ(restored.getSamplePeriod("Soil", 17), 60);
+    EXPECT_EQ(restored.getSamplePeriod("Soil", 2), 3600);
+    EXPECT_EQ(restored.getConfiguration(), saved);
+
+    restored.clearConfigEEPROM();
+    EXPECT_FALSE(ConfigurationManager().loadConfigFromEEPROM());
+}
+
 // Test partial configuration
 TEST_F(ConfigurationManagerTest, PartialConfiguration) {
     // Apply default configuration
@@ -199,44 +252,32 @@ TEST_F(ConfigurationManagerTest, ConfigurationSerialization) {
     EXPECT_EQ(newManager.getLoggingMode(), 1);
 }
 
-// Test Factory Methods
+// Test the type registry factories
 TEST_F(ConfigurationManagerTest, FactoryMethods) {
-    // Test that factory methods create non-null objects
-    auto auxTalon = ConfigurationManager::createAuxTalon();
-    EXPECT_NE(auxTalon, nullptr);
-    
-    auto i2cTalon = ConfigurationManager::createI2CTalon();
-    EXPECT_NE(i2cTalon, nullptr);
-    
-    auto sdi12Talon = ConfigurationManager::createSDI12Talon();
-    EXPECT_NE(sdi12Talon, nullptr);
-    
-    auto haarSensor = ConfigurationManager::createHaarSensor();
-    EXPECT_NE(haarSensor, nullptr);
-    
-    // For sensors that need talons, we need to pass in real talons
-    auto sdi12TalonObj = ConfigurationManager::createSDI12Talon();
-    
-    auto o2Sensor = ConfigurationManager::createO2Sensor(*sdi12TalonObj);
-    EXPECT_NE(o2Sensor, nullptr);
-    
-    auto solarSensor = ConfigurationManager::createSolarSensor(*sdi12TalonObj);
-    EXPECT_NE(solarSensor, nullptr);
-    
-    auto soilSensor = ConfigurationManager::createSoilSensor(*sdi12TalonObj);
-    EXPECT_NE(soilSensor, nullptr);
-    
-    auto co2Sensor = ConfigurationManager::createCO2Sensor();
-    EXPECT_NE(co2Sensor, nullptr);
-    
-    auto humiditySensor = ConfigurationManager::createHumiditySensor();
-    EXPECT_NE(humiditySensor, nullptr);
-    
-    // For ET sensor, we need real time provider and SDI12 talon
-    // This would require mocking in a real test
-    // auto etSensor = ConfigurationManager::createETSensor(timeProvider, sdi12Interface);
-    // EXPECT_NE(etSensor, nullptr);
-    
-    auto pressureSensor = ConfigurationManager::createPressureSensor(*sdi12TalonObj);
-    EXPECT_NE(pressureSensor, nullptr);
-}
\ No newline at end of file
+    SensorArena arena;
+    MockTimeProvider timeProvider;
+    MockSDI12Talon sdi12Interface;
+    SensorTypes::CreateContext context = {&arena, nullptr, &timeProvider, &sdi12Interface};
+
+    // Talons first, SDI12-based sensors need one
+    for (uint8_t i = 0; i < SensorTypes::NUM_KINDS; i++) {
+        const SensorTypes::TypeInfo& type = SensorTypes::get((SensorTypes::Kind)i);
+        SensorTypes::Created created = type.create(context);
+        EXPECT_NE(created.sensor, nullptr) << type.name;
+        EXPECT_EQ(created.talon != nullptr, type.bus == SensorTypes::BUS_TALON) << type.name;
+        if (i == SensorTypes::SDI12_TALON) context.sdi12Talon = static_cast<SDI12Talon*>(created.object);
+    }
+    EXPECT_EQ(arena.getCount(), SensorTypes::NUM_KINDS);
+}
+
+// Counts are parsed and printed by registry name
+TEST_F(ConfigurationManagerTest, CountsFollowTypeRegistry) {
+    ASSERT_TRUE(configManager.setConfiguration("{\"config\":{\"system\":{\"numI2CTalons\":2},\"sensors\":{\"numPressure\":4,\"numHumidity\":2}}}"));
+    EXPECT_EQ(configManager.getCount(SensorTypes::I2C_TALON), 2);
+    EXPECT_EQ(configManager.getCount(SensorTypes::PRESSURE), 4);
+    EXPECT_EQ(configManager.getCount(SensorTypes::SOIL), 3); // Registry default
+    std::string config = configManager.getConfiguration();
+    EXPECT_NE(config.find("\"numPressure\":4"), std::string::npos);
+    EXPECT_EQ(config.find("numHumidity"), std::string::npos); // Not a registered type
+    EXPECT_EQ(configManager.updateSensorConfigurationUid() & 0xF0, 4 << 4); // Pressure keeps its released UID bits
+}
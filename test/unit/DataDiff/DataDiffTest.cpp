@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "telemetry/DataDiff.h"
+#include "telemetry/PacketWriter.h"
+#include <string.h>
+
+class DataDiffTest : public ::testing::Test {
+protected:
+    char keyframeBuffer[2048];
+    char arena[4096];
+    DataDiffEncoder encoder{keyframeBuffer, sizeof(keyframeBuffer)};
+    DataDiffDecoder decoder;
+
+    //Build a data packet the way getDataString() does, entries by sensor index
+    std::string packet(const std::vector<std::pair<uint16_t, std::string>>& devices, unsigned long packetId, size_t maxLength = 1024) {
+        PacketWriter output(arena, sizeof(arena), maxLength);
+        encoder.beginPacket();
+        output.append("{\"Data\":{\"Time\":1729180800,\"Device ID\":\"e00f\",\"Packet ID\":").append(packetId).append(',');
+        encoder.writeLeader(output);
+        output.append("\"Devices\":[");
+        output.endLeader();
+        for (const auto& device : devices) encoder.appendDevice(output, device.first, device.second.c_str(), device.second.length());
+        output.close();
+        return std::string(output.c_str(), output.length());
+    }
+
+    //Reference packet without diff fields, what the decoder must rebuild
+    std::string expected(const std::vector<std::pair<uint16_t, std::string>>& devices, unsigned long packetId) {
+        std::string json = "{\"Data\":{\"Time\":1729180800,\"Device ID\":\"e00f\",\"Packet ID\":" + std::to_string(packetId) + ",\"Devices\":[";
+        for (size_t i = 0; i < devices.size(); i++) json += (i > 0 ? ",{" : "{") + devices[i].second + "}";
+        return json + "]}}";
+    }
+
+    std::string decode(const std::string& json) {
+        std::string full;
+        EXPECT_TRUE(decoder.apply(json, full)) << json;
+        return full;
+    }
+};
+
+TEST_F(DataDiffTest, DisabledSendsEveryPacketUnchanged) {
+    std::vector<std::pair<uint16_t, std::string>> devices = {{3, "\"Kestrel\":{\"ALS\":412}"}};
+    std::string json = packet(devices, 1);
+    EXPECT_EQ(json, expected(devices, 1));
+    EXPECT_EQ(decode(json), json);
+}
+
+TEST_F(DataDiffTest, DiffCarriesOnlyChangedFields) {
+    encoder.configure(4, 0);
+    std::vector<std::pair<uint16_t, std::string>> devices = {
+        {3, "\"Talon-SDI12\":{\"PORT_V\":[3.30,3.31],\"PORT_I\":[2.1,2.0]}"},
+        {8, "\"TDR315H\":{\"VWC\":0.2312,\"Temperature\":14.56,\"Pos\":[3,1]}"},
+    };
+    std::string key = packet(devices, 10);
+    EXPECT_NE(key.find("\"KeyFrame\":1,"), std::string::npos);
+    EXPECT_EQ(decode(key), expected(devices, 10));
+
+    devices[1].second = "\"TDR315H\":{\"VWC\":0.2400,\"Temperature\":14.56,\"Pos\":[3,1]}";
+    std::string diff = packet(devices, 11);
+    EXPECT_NE(diff.find("\"DiffOf\":1,"), std::string::npos);
+    EXPECT_NE(diff.find("{\"Talon-SDI12\":{\"Idx\":0}}"), std::string::npos);
+    EXPECT_NE(diff.find("{\"TDR315H\":{\"Idx\":1,\"VWC\":0.2400}}"), std::string::npos);
+    EXPECT_LT(diff.length(), key.length());
+    EXPECT_EQ(decode(diff), expected(devices, 11));
+    EXPECT_GT(encoder.getBytesSaved(), 0u);
+}
+
+TEST_F(DataDiffTest, EveryNthPacketIsKeyframe) {
+    encoder.configure(3, 0);
+    std::vector<std::pair<uint16_t, std::string>> devices = {{3, "\"Kestrel\":{\"ALS\":412}"}};
+    EXPECT_NE(packet(devices, 1).find("\"KeyFrame\":1"), std::string::npos);
+    EXPECT_NE(packet(devices, 2).find("\"DiffOf\":1"), std::string::npos);
+    EXPECT_NE(packet(devices, 3).find("\"DiffOf\":1"), std::string::npos);
+    EXPECT_NE(packet(devices, 4).find("\"KeyFrame\":2"), std::string::npos);
+}
+
+TEST_F(DataDiffTest, DeadbandIsRelativeToKeyframe) {
+    encoder.configure(10, 10); //1%
+    std::vector<std::pair<uint16_t, std::string>> devices = {{5, "\"Gonk\":{\"CellV\":4.00,\"PORT_V\":[3.30,5.00]}"}};
+    decode(packet(devices, 1));
+    devices[0].second = "\"Gonk\":{\"CellV\":4.03,\"PORT_V\":[3.32,4.96]}"; //Within 1%
+    std::string quiet = packet(devices, 2);
+    EXPECT_NE(quiet.find("{\"Gonk\":{\"Idx\":0}}"), std::string::npos);
+    EXPECT_EQ(decode(quiet), expected({{5, "\"Gonk\":{\"CellV\":4.00,\"PORT_V\":[3.30,5.00]}"}}, 2)); //Keyframe values stand in
+    devices[0].second = "\"Gonk\":{\"CellV\":4.05,\"PORT_V\":[3.30,5.00,0.00]}"; //Beyond 1% of keyframe, array grew
+    std::string diff = packet(devices, 3);
+    EXPECT_NE(diff.find("{\"Gonk\":{\"CellV\":4.05,\"PORT_V\":[3.30,5.00,0.00]}}"), std::string::npos); //Every field changed, full entry is shorter than the diff
+    EXPECT_EQ(decode(diff), expected(devices, 3));
+}
+
+TEST_F(DataDiffTest, NewOrChangedDeviceSentInFullAndForcesKeyframe) {
+    encoder.configure(10, 0);
+    std::vector<std::pair<uint16_t, std::string>> devices = {{3, "\"Kestrel\":{\"ALS\":412,\"RH\":41.2}"}};
+    decode(packet(devices, 1));
+    devices.push_back({9, "\"TDR315H\":{\"VWC\":0.23}"}); //Detected since the keyframe
+    devices[0].second = "\"Kestrel\":{\"ALS\":412}"; //Field dropped
+    std::string diff = packet(devices, 2);
+    EXPECT_NE(diff.find("{\"TDR315H\":{\"VWC\":0.23}}"), std::string::npos);
+    EXPECT_NE(diff.find("{\"Kestrel\":{\"ALS\":412}}"), std::string::npos);
+    EXPECT_EQ(decode(diff), expected(devices, 2));
+    EXPECT_NE(packet(devices, 3).find("\"KeyFrame\":2"), std::string::npos);
+}
+
+TEST_F(DataDiffTest, InvalidateForcesKeyframe) {
+    encoder.configure(10, 0);
+    std::vector<std::pair<uint16_t, std::string>> devices = {{3, "\"Kestrel\":{\"ALS\":412}"}};
+    packet(devices, 1);
+    encoder.invalidate(); //Sensors detected again
+    EXPECT_NE(packet(devices, 2).find("\"KeyFrame\":2"), std::string::npos);
+}
+
+TEST_F(DataDiffTest, DecodesKeyframeSplitAcrossPackets) {
+    encoder.configure(4, 0);
+    std::vector<std::pair<uint16_t, std::string>> devices;
+    for (uint16_t i = 0; i < 6; i++) devices.push_back({i, "\"TDR315H\":{\"VWC\":0.2" + std::to_string(i) + ",\"Temperature\":14.56,\"Permitivity\":11.82,\"EC\":0.102,\"Pos\":[3," + std::to_string(i) + "]}"});
+    std::string key = packet(devices, 7, 300);
+    ASSERT_NE(key.find('\n'), std::string::npos);
+    size_t start = 0;
+    while (start < key.length()) { //Each line arrives as its own publish
+        size_t end = key.find('\n', start);
+        if (end == std::string::npos) end = key.length();
+        decode(key.substr(start, end - start));
+        start = end + 1;
+    }
+    devices[5].second = "\"TDR315H\":{\"VWC\":0.99,\"Temperature\":14.56,\"Permitivity\":11.82,\"EC\":0.102,\"Pos\":[3,5]}";
+    std::string diff = packet(devices, 8, 1024);
+    EXPECT_NE(diff.find("\"Idx\":5,\"VWC\":0.99"), std::string::npos);
+    EXPECT_EQ(decode(diff), expected(devices, 8));
+}
+
+TEST_F(DataDiffTest, DecoderRejectsDiffWithoutKeyframe) {
+    std::string full;
+    EXPECT_FALSE(decoder.apply("{\"Data\":{\"Device ID\":\"e00f\",\"Packet ID\":2,\"DiffOf\":3,\"Devices\":[{\"Kestrel\":{\"Idx\":0}}]}}", full));
+}
+
+TEST_F(DataDiffTest, DecoderPassesOtherPacketsThrough) {
+    std::string json = "{\"Diagnostic\":{\"Time\":1,\"Devices\":[{\"Kestrel\":{\"FreeMem\":61240}}]}}";
+    EXPECT_EQ(decode(json), json);
+}
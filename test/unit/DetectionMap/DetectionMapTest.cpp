@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include "configuration/DetectionMap.h"
+#include "MockParticle.h"
+
+class DetectionMapTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        EEPROM.clear();
+        ASSERT_TRUE(map.clear(2, 6));
+        map.setTalonPort(0, 1);
+        map.setTalonPort(1, 3);
+        map.setSensor(5, 3, 2, 2); //SDI-12 sensor on Talon port 3, sensor port 2
+    }
+
+    DetectionMap map;
+};
+
+TEST_F(DetectionMapTest, NothingStoredDoesNotLoad) {
+    DetectionMap restored;
+    EXPECT_FALSE(restored.load(0x1234, 2, 6));
+}
+
+TEST_F(DetectionMapTest, RoundTripsThroughEEPROM) {
+    map.save(0x1234);
+    DetectionMap restored;
+    ASSERT_TRUE(restored.load(0x1234, 2, 6));
+    EXPECT_EQ(restored.getTalonPort(0), 1);
+    EXPECT_EQ(restored.getTalonPort(1), 3);
+    EXPECT_EQ(restored.getSensorTalonPort(5), 3);
+    EXPECT_EQ(restored.getSensorPort(5), 2);
+    EXPECT_EQ(restored.getSensorInterface(5), 2);
+    EXPECT_EQ(restored.getSensorTalonPort(4), 0); //Not detected
+}
+
+TEST_F(DetectionMapTest, RejectsDifferentConfiguration) {
+    map.save(0x1234);
+    DetectionMap restored;
+    EXPECT_FALSE(restored.load(0x1235, 2, 6)); //Sensor config UID changed
+    EXPECT_FALSE(restored.load(0x1234, 3, 6)); //Talon added
+    EXPECT_FALSE(restored.load(0x1234, 2, 7)); //Sensor added
+}
+
+TEST_F(DetectionMapTest, RejectsCorruptedImage) {
+    map.save(0x1234);
+    uint8_t port;
+    EEPROM.get(DetectionMap::EEPROM_ADDR + 8, port); //First Talon port
+    EEPROM.put(DetectionMap::EEPROM_ADDR + 8, (uint8_t)(port + 1));
+    DetectionMap restored;
+    EXPECT_FALSE(restored.load(0x1234, 2, 6));
+}
+
+TEST_F(DetectionMapTest, EraseInvalidatesStoredMap) {
+    map.save(0x1234);
+    map.erase();
+    DetectionMap restored;
+    EXPECT_FALSE(restored.load(0x1234, 2, 6));
+}
+
+TEST_F(DetectionMapTest, RejectsCountsBeyondCapacity) {
+    EXPECT_FALSE(map.clear(DetectionMap::MAX_TALONS + 1, 4));
+    EXPECT_FALSE(map.clear(2, DetectionMap::MAX_SENSORS + 1));
+}
+
+TEST_F(DetectionMapTest, IgnoresOutOfRangeIndices) {
+    map.setTalonPort(2, 4);
+    map.setSensor(6, 1, 1, 1);
+    EXPECT_EQ(map.getTalonPort(2), 0);
+    EXPECT_EQ(map.getSensorPort(6), 0);
+}
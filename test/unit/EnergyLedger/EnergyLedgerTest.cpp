@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "acquisition/EnergyLedger.h"
+
+class EnergyLedgerTest : public ::testing::Test {
+protected:
+    EnergyLedger ledger;
+};
+
+TEST_F(EnergyLedgerTest, EmptyUntilACycleEnds) {
+    ledger.beginCycle();
+    ledger.addPhase(EnergyLedger::SAMPLE, 100.0f, 2000000); //100 mW for 2 s
+    EXPECT_EQ(ledger.getCycles(), 0);
+    EXPECT_EQ(ledger.getPhaseLastUj(EnergyLedger::SAMPLE), 0u);
+    EXPECT_EQ(ledger.getCycleMeanUj(), 0u);
+}
+
+TEST_F(EnergyLedgerTest, PowerTimesDuration) {
+    ledger.beginCycle();
+    ledger.addPhase(EnergyLedger::SAMPLE, 100.0f, 2000000);
+    ledger.addPhase(EnergyLedger::SAMPLE, 50.0f, 1000);
+    ledger.beginCycle();
+    EXPECT_EQ(ledger.getCycles(), 1);
+    EXPECT_EQ(ledger.getPhaseLastUj(EnergyLedger::SAMPLE), 200050u); //200 mJ + 50 uJ
+    EXPECT_EQ(ledger.getPhaseMeanUj(EnergyLedger::SAMPLE), 200050u);
+}
+
+TEST_F(EnergyLedgerTest, MeansOverCycles) {
+    ledger.beginCycle();
+    ledger.addPhase(EnergyLedger::WAKE, 10.0f, 1000000);
+    ledger.addSensor(3, 20.0f, 500000);
+    ledger.beginCycle();
+    ledger.addPhase(EnergyLedger::WAKE, 30.0f, 1000000);
+    ledger.beginCycle(); //Sensor not sampled this cycle
+    EXPECT_EQ(ledger.getCycles(), 2);
+    EXPECT_EQ(ledger.getPhaseLastUj(EnergyLedger::WAKE), 30000u);
+    EXPECT_EQ(ledger.getPhaseMeanUj(EnergyLedger::WAKE), 20000u);
+    EXPECT_EQ(ledger.getSensorLastUj(3), 0u);
+    EXPECT_EQ(ledger.getSensorMeanUj(3), 5000u);
+    EXPECT_TRUE(ledger.hasSensor(3));
+    EXPECT_FALSE(ledger.hasSensor(2));
+}
+
+TEST_F(EnergyLedgerTest, CycleMeanIsPhasesOnly) {
+    ledger.beginCycle();
+    ledger.addPhase(EnergyLedger::WAKE, 10.0f, 1000000);
+    ledger.addPhase(EnergyLedger::SAMPLE, 40.0f, 1000000);
+    ledger.addPhase(EnergyLedger::BACKHAUL, 500.0f, 10000);
+    ledger.addSensor(0, 30.0f, 1000000); //Part of SAMPLE, not added again
+    ledger.beginCycle();
+    EXPECT_EQ(ledger.getCycleMeanUj(), 55000u);
+    EXPECT_FLOAT_EQ(ledger.estimatePowerMw(60000), 55000.0f / 60000.0f);
+    EXPECT_EQ(ledger.estimatePowerMw(0), 0.0f);
+}
+
+TEST_F(EnergyLedgerTest, ResetWindowKeepsLastCycle) {
+    ledger.beginCycle();
+    ledger.addPhase(EnergyLedger::SAMPLE, 10.0f, 1000000);
+    ledger.beginCycle();
+    ledger.resetWindow();
+    EXPECT_EQ(ledger.getCycles(), 0);
+    EXPECT_EQ(ledger.getPhaseMeanUj(EnergyLedger::SAMPLE), 0u);
+    EXPECT_EQ(ledger.getPhaseLastUj(EnergyLedger::SAMPLE), 10000u);
+}
+
+TEST_F(EnergyLedgerTest, IgnoresBadReadsAndRanges) {
+    ledger.beginCycle();
+    ledger.addPhase(EnergyLedger::SAMPLE, -5.0f, 1000000);
+    ledger.addPhase(EnergyLedger::SAMPLE, 0.0f / 0.0f, 1000000);
+    ledger.addPhase(EnergyLedger::NUM_PHASES, 10.0f, 1000000);
+    ledger.addSensor(EnergyLedger::MAX_SENSORS, 10.0f, 1000000);
+    ledger.addSensor(-1, 10.0f, 1000000);
+    ledger.beginCycle();
+    EXPECT_EQ(ledger.getCycleMeanUj(), 0u);
+    EXPECT_FALSE(ledger.hasSensor(EnergyLedger::MAX_SENSORS));
+}
+
+TEST_F(EnergyLedgerTest, Saturates) {
+    ledger.beginCycle();
+    ledger.addPhase(EnergyLedger::BACKHAUL, 1000000.0f, UINT32_MAX);
+    ledger.addPhase(EnergyLedger::BACKHAUL, 1000.0f, 1000000);
+    ledger.beginCycle();
+    EXPECT_EQ(ledger.getPhaseLastUj(EnergyLedger::BACKHAUL), UINT32_MAX);
+}
+
+TEST_F(EnergyLedgerTest, PhaseNames) {
+    EXPECT_STREQ(EnergyLedger::phaseName(EnergyLedger::WAKE), "Wake");
+    EXPECT_STREQ(EnergyLedger::phaseName(EnergyLedger::BACKHAUL), "Backhaul");
+    EXPECT_STREQ(EnergyLedger::phaseName(EnergyLedger::NUM_PHASES), "Unknown");
+}
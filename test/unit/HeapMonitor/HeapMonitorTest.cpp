@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include "telemetry/HeapMonitor.h"
+
+class HeapMonitorTest : public ::testing::Test {
+protected:
+    HeapMonitor monitor;
+
+    void cycle(uint32_t wakeFree, uint32_t dataFree, uint32_t sleepFree) {
+        monitor.record(HeapMonitor::WAKE, {wakeFree, wakeFree / 2, 10});
+        monitor.record(HeapMonitor::DATA, {dataFree, dataFree / 2, 12});
+        monitor.record(HeapMonitor::SLEEP, {sleepFree, sleepFree / 2, 10});
+    }
+};
+
+TEST_F(HeapMonitorTest, EmptyUntilRecorded) {
+    EXPECT_FALSE(monitor.hasSamples());
+    EXPECT_EQ(monitor.getCycles(), 0);
+    EXPECT_EQ(monitor.getTrend(), 0);
+}
+
+TEST_F(HeapMonitorTest, TracksLowPointsAndPhase) {
+    cycle(60000, 52000, 59000);
+    EXPECT_TRUE(monitor.hasSamples());
+    EXPECT_EQ(monitor.getMinFree(), 52000u);
+    EXPECT_EQ(monitor.getMinFreePhase(), HeapMonitor::DATA);
+    EXPECT_EQ(monitor.getMinLargestBlock(), 26000u);
+    EXPECT_EQ(monitor.getMaxAllocations(), 12u);
+    EXPECT_EQ(monitor.getLast(HeapMonitor::WAKE).freeBytes, 60000u);
+}
+
+TEST_F(HeapMonitorTest, FirstSleepOnlyStartsTrend) {
+    cycle(60000, 52000, 59000);
+    EXPECT_EQ(monitor.getCycles(), 0);
+    cycle(59000, 51000, 58900);
+    cycle(58900, 50900, 58800);
+    EXPECT_EQ(monitor.getCycles(), 2);
+    EXPECT_EQ(monitor.getTrend(), -100);
+}
+
+TEST_F(HeapMonitorTest, ResetKeepsTrendContinuous) {
+    cycle(60000, 52000, 59000);
+    cycle(59000, 51000, 58000);
+    monitor.resetWindow();
+    EXPECT_FALSE(monitor.hasSamples());
+    EXPECT_EQ(monitor.getCycles(), 0);
+    cycle(58000, 57000, 58000); //Steady from the last reported sleep
+    EXPECT_EQ(monitor.getTrend(), 0);
+    EXPECT_EQ(monitor.getMinFree(), 57000u);
+}
+
+TEST_F(HeapMonitorTest, PhaseNames) {
+    EXPECT_STREQ(HeapMonitor::phaseName(HeapMonitor::WAKE), "wake");
+    EXPECT_STREQ(HeapMonitor::phaseName(HeapMonitor::FRAM_WRITE), "fram");
+    EXPECT_STREQ(HeapMonitor::phaseName(HeapMonitor::SLEEP), "sleep");
+    EXPECT_STREQ(HeapMonitor::phaseName(HeapMonitor::NUM_PHASES), "unknown");
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "telemetry/PacketCodec.h"
+#include <string.h>
+
+class PacketCodecTest : public ::testing::Test {
+protected:
+    char buffer[4096];
+    PacketCodec codec{buffer, sizeof(buffer)};
+
+    std::string roundTrip(const std::string& json) {
+        EXPECT_TRUE(codec.encode(json.c_str(), json.length(), "2.2.9"));
+        std::string decoded;
+        EXPECT_TRUE(PacketCodec::decode(codec.c_str(), codec.length(), decoded));
+        return decoded;
+    }
+};
+
+TEST_F(PacketCodecTest, RoundTripsDataPacket) {
+    std::string json = "{\"Data\":{\"Time\":1700000000,\"Loc\":[44.97,-93.23,256.0,1700000000],\"Node ID\":\"TestNode\",\"Packet ID\":123456789,\"NumDevices\":10,\"Devices\":[{\"TDR315H\":{\"VWC\":0.12,\"Temperature\":21.5,\"Permitivity\":18.3,\"EC\":0.12,\"Pos\":[1,2]}},{\"Kestrel\":{\"ALS\":null,\"OK\":true,\"Fault\":false}}]}}";
+    EXPECT_EQ(roundTrip(json), json);
+}
+
+TEST_F(PacketCodecTest, EncodedLineIsPrefixedAndSmaller) {
+    std::string json = "{\"Diagnostic\":{\"Time\":1700000000,\"Loc\":[44.97,-93.23,256.0,1700000000],\"Device ID\":\"e00fce68b1a2c3d4e5f60718\",\"Packet ID\":4012345678,\"NumDevices\":8,\"Devices\":[{\"FlightControl\":{\"TalonRestarts\":2,\"RestartsSkipped\":6,\"RestartSaved\":720,\"PortWritesSkipped\":18,\"SDI12WaitSaved\":1000}}]}}";
+    ASSERT_TRUE(codec.encode(json.c_str(), json.length(), "2.2.9"));
+    EXPECT_EQ(codec.c_str()[0], PacketCodec::TEXT_PREFIX);
+    EXPECT_LT(codec.length(), json.length() * 3 / 4);
+    EXPECT_EQ(strchr(codec.c_str(), '{'), nullptr);
+}
+
+TEST_F(PacketCodecTest, KeepsNumberTextExactly) {
+    const char* values[] = {"0", "-1", "0.05", "-0.50", "100.000", "123456789012345678", "1e5", "-0", "-0.0", "007", "1.", "nan", "-93.2300"};
+    for (const char* value : values) {
+        std::string json = std::string("{\"v\":[") + value + "]}";
+        EXPECT_EQ(roundTrip(json), json) << value;
+    }
+}
+
+TEST_F(PacketCodecTest, KeepsStringEscapes) {
+    std::string json = "{\"Error\":{\"CODES\":[\"0xF00A0000\",\"say \\\"hi\\\"\",\"\"],\"NUM\":2}}";
+    EXPECT_EQ(roundTrip(json), json);
+}
+
+TEST_F(PacketCodecTest, EncodesEachLineSeparately) {
+    std::string json = "{\"Data\":{\"Devices\":[{\"A\":1}]}}\n{\"Data\":{\"Devices\":[{\"B\":2}]}}";
+    ASSERT_TRUE(codec.encode(json.c_str(), json.length(), "2.2.9"));
+    const char* newline = strchr(codec.c_str(), '\n');
+    ASSERT_NE(newline, nullptr);
+    EXPECT_EQ(newline[1], PacketCodec::TEXT_PREFIX);
+    std::string decoded;
+    ASSERT_TRUE(PacketCodec::decode(codec.c_str(), codec.length(), decoded));
+    EXPECT_EQ(decoded, json);
+}
+
+TEST_F(PacketCodecTest, DropsInsignificantWhitespace) {
+    std::string json = "{ \"Data\" : { \"Time\" : 5 , \"Pos\" : [ 1 , 2 ] } }";
+    EXPECT_EQ(roundTrip(json), "{\"Data\":{\"Time\":5,\"Pos\":[1,2]}}");
+}
+
+TEST_F(PacketCodecTest, RejectsInputItCanNotReproduce) {
+    const char* inputs[] = {"", "not json", "{\"a\":1", "{\"a\" 1}", "{\"a\":1,}", "{1:2}", "[1,2]", "{\"a\":1}}", "{\"a\":[1 2]}"};
+    for (const char* input : inputs) {
+        EXPECT_FALSE(codec.encode(input, strlen(input), "2.2.9")) << input;
+        EXPECT_EQ(codec.length(), 0u);
+    }
+}
+
+TEST_F(PacketCodecTest, FailsWhenBufferTooSmall) {
+    char small[16];
+    PacketCodec tiny(small, sizeof(small));
+    std::string json = "{\"Data\":{\"Time\":1700000000,\"Packet ID\":123456789}}";
+    EXPECT_FALSE(tiny.encode(json.c_str(), json.length(), "2.2.9"));
+}
+
+TEST_F(PacketCodecTest, DecodeReportsSchemaVersion) {
+    std::string json = "{\"Metadata\":{\"Time\":1}}";
+    ASSERT_TRUE(codec.encode(json.c_str(), json.length(), "2.2.9"));
+    std::string decoded, schema;
+    ASSERT_TRUE(PacketCodec::decode(codec.c_str(), codec.length(), decoded, &schema));
+    EXPECT_EQ(schema, "2.2.9");
+}
+
+TEST_F(PacketCodecTest, DecodePassesPlainJsonThrough) {
+    std::string json = "{\"Data\":{\"Time\":1}}";
+    std::string decoded;
+    ASSERT_TRUE(PacketCodec::decode(json.c_str(), json.length(), decoded));
+    EXPECT_EQ(decoded, json);
+}
+
+TEST_F(PacketCodecTest, DecodeRejectsCorruptRecords) {
+    std::string decoded;
+    const char* inputs[] = {"~", "~!!!!", "~AQ==", "~AgICCQE="}; //Empty, bad Base64, header only, wrong format version
+    for (const char* input : inputs) {
+        EXPECT_FALSE(PacketCodec::decode(input, strlen(input), decoded)) << input;
+    }
+}
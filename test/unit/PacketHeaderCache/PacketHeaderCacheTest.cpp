@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "Particle.h"
+#include "telemetry/PacketHeaderCache.h"
+
+class PacketHeaderCacheTest : public ::testing::Test {
+protected:
+    PacketHeaderCache cache;
+    char buffer[256];
+
+    void captureDefault(bool isNodeID = true) {
+        cache.capture(String("1700000000"), String("44.97"), String("-93.23"), String("256.0"), String("1699999990"),
+                      String(isNodeID ? "Node1" : "e00fce68"), isNodeID);
+    }
+};
+
+TEST_F(PacketHeaderCacheTest, StartsInvalid) {
+    EXPECT_FALSE(cache.isValid());
+    EXPECT_EQ(cache.getReadsSaved(), 0);
+}
+
+TEST_F(PacketHeaderCacheTest, WritesNodeIDFields) {
+    captureDefault(true);
+    PacketWriter writer(buffer, sizeof(buffer), 1024);
+    cache.writeTo(writer);
+    EXPECT_STREQ(writer.c_str(), "\"Time\":1700000000,\"Loc\":[44.97,-93.23,256.0,1699999990],\"Node ID\":\"Node1\",");
+}
+
+TEST_F(PacketHeaderCacheTest, WritesDeviceIDWhenNoNodeID) {
+    captureDefault(false);
+    PacketWriter writer(buffer, sizeof(buffer), 1024);
+    cache.writeTo(writer);
+    EXPECT_THAT(writer.c_str(), ::testing::HasSubstr("\"Device ID\":\"e00fce68\","));
+}
+
+TEST_F(PacketHeaderCacheTest, CountsReadsSavedPerCycle) {
+    captureDefault();
+    PacketWriter writer(buffer, sizeof(buffer), 1024);
+    for (int i = 0; i < 5; i++) { //Type 3 log event: data, diagnostic, metadata, error + init
+        writer.reset();
+        cache.writeTo(writer);
+    }
+    EXPECT_EQ(cache.getUses(), 5);
+    EXPECT_EQ(cache.getReadsSaved(), 4 * PacketHeaderCache::READS_PER_HEADER);
+
+    captureDefault(); //New cycle resets the counters
+    EXPECT_EQ(cache.getReadsSaved(), 0);
+}
+
+TEST_F(PacketHeaderCacheTest, InvalidateMarksStale) {
+    captureDefault();
+    EXPECT_TRUE(cache.isValid());
+    cache.invalidate();
+    EXPECT_FALSE(cache.isValid());
+}
+
+TEST_F(PacketHeaderCacheTest, TruncatesOversizedFields) {
+    cache.capture(String("1700000000"), String("44.970000000000000000000"), String("-93.23"), String("256.0"), String("0"),
+                  String("Node1"), true);
+    PacketWriter writer(buffer, sizeof(buffer), 1024);
+    cache.writeTo(writer);
+    EXPECT_THAT(writer.c_str(), ::testing::HasSubstr("\"Loc\":[44.970000000000,"));
+    EXPECT_TRUE(cache.isTruncated());
+
+    captureDefault();
+    EXPECT_FALSE(cache.isTruncated()); //Flag belongs to the snapshot, not the cache
+}
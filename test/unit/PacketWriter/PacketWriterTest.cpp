@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <string>
+#include "Particle.h"
+#include "telemetry/PacketWriter.h"
+
+class PacketWriterTest : public ::testing::Test {
+protected:
+    char buffer[1024];
+
+    void writeLeader(PacketWriter& writer) {
+        writer.append("{\"Data\":{\"Time\":").append(1700000000UL).append(',');
+        writer.append("\"Devices\":[");
+        writer.endLeader();
+    }
+};
+
+TEST_F(PacketWriterTest, BuildsSinglePacket) {
+    PacketWriter writer(buffer, sizeof(buffer), 1024);
+    writeLeader(writer);
+    writer.appendDevice(String("\"A\":1"));
+    writer.appendDevice(String("\"B\":2"));
+    writer.close();
+
+    EXPECT_STREQ(writer.c_str(), "{\"Data\":{\"Time\":1700000000,\"Devices\":[{\"A\":1},{\"B\":2}]}}");
+    EXPECT_EQ(writer.deviceCount(), 2);
+    EXPECT_EQ(writer.packetCount(), 1);
+    EXPECT_FALSE(writer.overflowed());
+}
+
+TEST_F(PacketWriterTest, SkipsEmptyEntries) {
+    PacketWriter writer(buffer, sizeof(buffer), 1024);
+    writeLeader(writer);
+    writer.appendDevice(String(""));
+    writer.appendDevice(String("\"A\":1"));
+    writer.appendDevice(String(""));
+    writer.close();
+
+    EXPECT_STREQ(writer.c_str(), "{\"Data\":{\"Time\":1700000000,\"Devices\":[{\"A\":1}]}}");
+    EXPECT_EQ(writer.deviceCount(), 1);
+}
+
+TEST_F(PacketWriterTest, SplitsAtMaxMessageLength) {
+    const size_t maxLength = 80;
+    PacketWriter writer(buffer, sizeof(buffer), maxLength);
+    writeLeader(writer);
+    std::string leader = writer.c_str();
+    for (int i = 0; i < 6; i++) {
+        writer.appendDevice(String("\"Sensor\":\"0123456789\""));
+    }
+    writer.close();
+
+    std::string output = writer.c_str();
+    EXPECT_GT(writer.packetCount(), 1);
+    EXPECT_EQ(writer.deviceCount(), 6);
+
+    // Every line must be a complete packet that starts with the leader and fits
+    size_t lineStart = 0;
+    int lines = 0;
+    while (lineStart < output.length()) {
+        size_t lineEnd = output.find('\n', lineStart);
+        if (lineEnd == std::string::npos) lineEnd = output.length();
+        std::string line = output.substr(lineStart, lineEnd - lineStart);
+        EXPECT_EQ(line.compare(0, leader.length(), leader), 0);
+        EXPECT_EQ(line.substr(line.length() - 3), "]}}");
+        EXPECT_LT(line.length(), maxLength);
+        EXPECT_EQ(line.find("[,"), std::string::npos);
+        lineStart = lineEnd + 1;
+        lines++;
+    }
+    EXPECT_EQ(lines, writer.packetCount());
+}
+
+TEST_F(PacketWriterTest, StreamedDeviceIsSeparatedByComma) {
+    PacketWriter writer(buffer, sizeof(buffer), 1024);
+    writeLeader(writer);
+    writer.beginDevice();
+    writer.append("\"System\":{\"Update\":").append(300).append('}');
+    writer.endDevice();
+    writer.appendDevice(String("\"A\":1"));
+    writer.close();
+
+    EXPECT_STREQ(writer.c_str(), "{\"Data\":{\"Time\":1700000000,\"Devices\":[{\"System\":{\"Update\":300}},{\"A\":1}]}}");
+}
+
+TEST_F(PacketWriterTest, StreamedDeviceSplitsLikeAppendedDevice) {
+    const size_t maxLength = 80;
+    PacketWriter writer(buffer, sizeof(buffer), maxLength);
+    writeLeader(writer);
+    std::string leader = writer.c_str();
+    writer.appendDevice(String("\"Sensor\":\"0123456789\""));
+    writer.beginDevice();
+    writer.append("\"System\":{\"Update\":").append(300).append(",\"Backhaul\":").append(4).append('}');
+    writer.endDevice();
+    writer.close();
+
+    std::string expected = leader + "{\"Sensor\":\"0123456789\"}]}}\n" + leader + "{\"System\":{\"Update\":300,\"Backhaul\":4}}]}}";
+    EXPECT_EQ(std::string(writer.c_str()), expected);
+    EXPECT_EQ(writer.packetCount(), 2);
+    EXPECT_EQ(writer.deviceCount(), 2);
+    EXPECT_EQ(writer.droppedCount(), 0);
+}
+
+TEST_F(PacketWriterTest, StreamedDeviceThatDoesNotFitIsDroppedWhole) {
+    char small[64];
+    PacketWriter writer(small, sizeof(small), 1024);
+    writeLeader(writer);
+    EXPECT_TRUE(writer.appendDevice(String("\"A\":1")));
+    writer.beginDevice();
+    writer.append("\"System\":{\"Update\":").append(300).append('}'); //Runs out of arena part way
+    writer.endDevice();
+    EXPECT_EQ(writer.droppedCount(), 1);
+    EXPECT_EQ(writer.deviceCount(), 1);
+    EXPECT_TRUE(writer.overflowed());
+    writer.close();
+    EXPECT_STREQ(writer.c_str(), "{\"Data\":{\"Time\":1700000000,\"Devices\":[{\"A\":1}]}}");
+}
+
+TEST_F(PacketWriterTest, StreamedDeviceKeepsRoomToClose) {
+    char small[48]; //Same as KeepsRoomToCloseWhenNearlyFull, the entry fits but the closer would not
+    PacketWriter writer(small, sizeof(small), 1024);
+    writeLeader(writer);
+    writer.beginDevice();
+    writer.append("\"A\":1");
+    writer.endDevice();
+    EXPECT_EQ(writer.droppedCount(), 1);
+    writer.close();
+    EXPECT_STREQ(writer.c_str(), "{\"Data\":{\"Time\":1700000000,\"Devices\":[]}}");
+}
+
+TEST_F(PacketWriterTest, ReportsOverflowWithoutWritingPastCapacity) {
+    char small[52];
+    PacketWriter writer(small, sizeof(small), 1024);
+    writeLeader(writer);
+    EXPECT_TRUE(writer.appendDevice(String("\"A\":1")));
+    EXPECT_FALSE(writer.appendDevice(String("\"Long\":\"0123456789012345678901234567890\"")));
+    EXPECT_TRUE(writer.overflowed());
+    EXPECT_EQ(writer.droppedCount(), 1);
+    EXPECT_LT(writer.length(), sizeof(small));
+    EXPECT_EQ(strlen(writer.c_str()), writer.length());
+}
+
+TEST_F(PacketWriterTest, KeepsRoomToCloseWhenNearlyFull) {
+    char small[48]; //Leader and {"A":1} fit, the closing ]}} would not
+    PacketWriter writer(small, sizeof(small), 1024);
+    writeLeader(writer);
+    EXPECT_FALSE(writer.appendDevice(String("\"A\":1"))); //Would fit, but then close() would not
+    EXPECT_EQ(writer.droppedCount(), 1);
+    writer.close();
+    EXPECT_STREQ(writer.c_str(), "{\"Data\":{\"Time\":1700000000,\"Devices\":[]}}");
+}
+
+TEST_F(PacketWriterTest, SplitPacketIsAlwaysClosed) {
+    const size_t maxLength = 60;
+    char small[110]; //Room for the first packet and the leader of a second, not a second entry plus closer
+    PacketWriter writer(small, sizeof(small), maxLength);
+    writeLeader(writer);
+    EXPECT_TRUE(writer.appendDevice(String("\"Sensor\":\"0123456\"")));
+    EXPECT_FALSE(writer.appendDevice(String("\"Sensor\":\"0123456789012345\"")));
+    writer.close();
+    std::string output = writer.c_str();
+    EXPECT_EQ(output.substr(output.length() - 3), "]}}");
+    EXPECT_EQ(output.find('\n'), std::string::npos);
+}
+
+TEST_F(PacketWriterTest, ToStringAllocatesOnce) {
+    PacketWriter writer(buffer, sizeof(buffer), 1024);
+    writeLeader(writer);
+    String entry("\"A\":1");
+    StringStats::reset();
+    for (int i = 0; i < 10; i++) writer.appendDevice(entry);
+    writer.close();
+    EXPECT_EQ(StringStats::allocations, 0);
+    String result = writer.toString();
+    EXPECT_EQ(StringStats::allocations, 1);
+    EXPECT_EQ(result.length(), writer.length());
+}
+
+TEST_F(PacketWriterTest, ResetClearsContent) {
+    PacketWriter writer(buffer, sizeof(buffer), 1024);
+    writeLeader(writer);
+    writer.appendDevice(String("\"A\":1"));
+    writer.reset();
+    EXPECT_EQ(writer.length(), 0);
+    EXPECT_STREQ(writer.c_str(), "");
+    EXPECT_EQ(writer.deviceCount(), 0);
+}
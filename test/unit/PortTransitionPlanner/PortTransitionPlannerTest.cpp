@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "acquisition/PortTransitionPlanner.h"
+
+class PortTransitionPlannerTest : public ::testing::Test {
+protected:
+    PortTransitionPlanner planner;
+
+    //Run one pass the way FlightControl does, returns the order visited
+    std::vector<uint16_t> runPass(bool restartTalon = false) {
+        std::vector<uint16_t> order;
+        planner.plan();
+        for (uint16_t step = 0; step < planner.size(); step++) {
+            order.push_back(planner.getSensorIndex(step));
+            const Entry& entry = entries[planner.getSensorIndex(step)];
+            planner.selectKestrelPort(entry.talonPort, entry.isCore);
+            planner.selectBus();
+            if (restartTalon && entry.talonPort > 0) {
+                planner.invalidateBus();
+                planner.invalidateTalonPorts();
+            }
+            if (entry.talonPort > 0 && entry.sensorPort > 0) {
+                planner.clearTalonPorts();
+                planner.selectSensorPort(entry.sensorPort);
+            }
+            planner.selectBus();
+            if (entry.talonPort > 0 && entry.sensorPort > 0) planner.releaseSensorPort(step);
+        }
+        return order;
+    }
+
+    void add(uint8_t talonPort, uint8_t sensorPort, bool isCore = false) {
+        planner.addSensor(entries.size(), talonPort, sensorPort, isCore);
+        entries.push_back({talonPort, sensorPort, isCore});
+    }
+
+    struct Entry {
+        uint8_t talonPort;
+        uint8_t sensorPort;
+        bool isCore;
+    };
+    std::vector<Entry> entries;
+};
+
+TEST_F(PortTransitionPlannerTest, GroupsByTalonThenSensorPort) {
+    planner.beginPass();
+    add(0, 0, true); //Core
+    add(2, 0); //Talon on port 2
+    add(1, 0); //Talon on port 1
+    add(2, 3);
+    add(1, 1);
+    add(2, 1);
+    EXPECT_EQ(runPass(), (std::vector<uint16_t>{0, 2, 4, 1, 5, 3}));
+}
+
+TEST_F(PortTransitionPlannerTest, KeepsCoreAndUndetectedInOrderAtFront) {
+    planner.beginPass();
+    add(1, 1);
+    add(0, 0, true);
+    add(0, 0); //Undetected sensor
+    add(0, 0, true);
+    EXPECT_EQ(runPass(), (std::vector<uint16_t>{1, 2, 3, 0}));
+}
+
+TEST_F(PortTransitionPlannerTest, SameTalonSkipsKestrelPortSwitch) {
+    planner.beginPass();
+    add(1, 1);
+    add(1, 2);
+    planner.plan();
+    EXPECT_TRUE(planner.selectKestrelPort(1, false));
+    EXPECT_TRUE(planner.selectBus());
+    EXPECT_TRUE(planner.clearTalonPorts());
+    EXPECT_TRUE(planner.selectSensorPort(1));
+    EXPECT_TRUE(planner.releaseSensorPort(0));
+
+    EXPECT_FALSE(planner.selectKestrelPort(1, false));
+    EXPECT_FALSE(planner.selectBus());
+    EXPECT_FALSE(planner.clearTalonPorts()); //All ports already off
+    EXPECT_TRUE(planner.selectSensorPort(2));
+    EXPECT_TRUE(planner.releaseSensorPort(1)); //Last step always releases
+}
+
+TEST_F(PortTransitionPlannerTest, SharedSensorPortStaysOn) {
+    planner.beginPass();
+    add(1, 2); //Three SDI-12 probes on one port
+    add(1, 2);
+    add(1, 2);
+    runPass();
+    //Port enabled once and released once, instead of three times each
+    EXPECT_EQ(planner.getWritesIssued(),
+              PortTransitionPlanner::WRITES_KESTREL_PORT + PortTransitionPlanner::WRITES_BUS +
+              PortTransitionPlanner::WRITES_TALON_CLEAR + 2 * PortTransitionPlanner::WRITES_SENSOR_PORT);
+    EXPECT_GT(planner.getWritesSkipped(), 0);
+}
+
+TEST_F(PortTransitionPlannerTest, CoreDeviceInvalidatesState) {
+    planner.beginPass();
+    EXPECT_TRUE(planner.selectKestrelPort(0, true));
+    EXPECT_TRUE(planner.selectBus());
+    EXPECT_TRUE(planner.selectKestrelPort(0, true)); //Core always reselects
+    EXPECT_TRUE(planner.selectBus());
+    EXPECT_TRUE(planner.selectKestrelPort(0, false));
+    EXPECT_TRUE(planner.selectBus());
+    EXPECT_FALSE(planner.selectKestrelPort(0, false)); //Second undetected sensor, nothing changed
+}
+
+TEST_F(PortTransitionPlannerTest, RestartForcesTalonReclear) {
+    planner.beginPass();
+    add(1, 1);
+    add(1, 2);
+    runPass(true);
+    EXPECT_EQ(planner.getWritesIssued(),
+              PortTransitionPlanner::WRITES_KESTREL_PORT + 3 * PortTransitionPlanner::WRITES_BUS +
+              2 * (PortTransitionPlanner::WRITES_TALON_CLEAR + 2 * PortTransitionPlanner::WRITES_SENSOR_PORT));
+}
+
+TEST_F(PortTransitionPlannerTest, CountersResetPerCycle) {
+    planner.beginPass();
+    add(1, 1);
+    add(1, 2);
+    runPass();
+    EXPECT_GT(planner.getWritesSkipped(), 0);
+    planner.resetCounters();
+    EXPECT_EQ(planner.getWritesSkipped(), 0);
+    EXPECT_EQ(planner.getWritesIssued(), 0);
+}
+
+TEST_F(PortTransitionPlannerTest, FaultReadOncePerTalonPerPass) {
+    planner.beginPass();
+    add(1, 1);
+    add(1, 2);
+    add(2, 1);
+    planner.plan();
+    EXPECT_TRUE(planner.checkFault(1));
+    EXPECT_FALSE(planner.checkFault(1)); //Second sensor on the same Talon
+    EXPECT_TRUE(planner.checkFault(2));
+    EXPECT_EQ(planner.getWritesSkipped(), 1); //The repeated read
+    planner.beginPass();
+    EXPECT_TRUE(planner.checkFault(1)); //New pass reads again
+}
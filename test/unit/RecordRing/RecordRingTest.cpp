@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include "telemetry/RecordRing.h"
+#include "hardware/IFram.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief RAM backed FRAM that can cut power part way through a write
+ */
+class FakeFram : public IFram {
+public:
+    explicit FakeFram(size_t size) : bytes(size, 0xFF) {}
+
+    bool begin() override { return true; }
+    size_t length() override { return bytes.size(); }
+    bool readData(uint32_t framAddr, uint8_t* data, size_t dataLen) override {
+        if (framAddr + dataLen > bytes.size()) return false;
+        memcpy(data, &bytes[framAddr], dataLen);
+        return true;
+    }
+    bool writeData(uint32_t framAddr, const uint8_t* data, size_t dataLen) override {
+        if (framAddr + dataLen > bytes.size()) return false;
+        if (writeBudget >= 0) { //Power is lost once the budget runs out
+            size_t allowed = (size_t)writeBudget < dataLen ? (size_t)writeBudget : dataLen;
+            memcpy(&bytes[framAddr], data, allowed);
+            writeBudget -= allowed;
+            return allowed == dataLen;
+        }
+        memcpy(&bytes[framAddr], data, dataLen);
+        return true;
+    }
+
+    std::vector<uint8_t> bytes;
+    long writeBudget = -1; ///< Bytes that still reach FRAM, -1 for unlimited
+};
+
+} // namespace
+
+class RecordRingTest : public ::testing::Test {
+protected:
+    RecordRingTest() : fram(1024) {}
+
+    std::string next(RecordRing& ring, RecordRing::Header* header = nullptr) {
+        RecordRing::Header h;
+        char buffer[256];
+        if (!ring.peek(h, buffer, sizeof(buffer))) return "";
+        if (header != nullptr) *header = h;
+        return std::string(buffer);
+    }
+
+    FakeFram fram;
+    static const uint32_t BASE = 128;
+    static const uint32_t SIZE = 512;
+};
+
+TEST_F(RecordRingTest, FormatsBlankWindow) {
+    RecordRing ring(fram, BASE, SIZE);
+    ASSERT_TRUE(ring.begin());
+    EXPECT_EQ(ring.getCount(), 0);
+    EXPECT_EQ(ring.getCapacity(), SIZE - 2 * RecordRing::CONTROL_SIZE);
+    for (uint32_t i = 0; i < BASE; i++) EXPECT_EQ(fram.bytes[i], 0xFF); //Nothing outside the window
+    for (uint32_t i = BASE + SIZE; i < fram.bytes.size(); i++) EXPECT_EQ(fram.bytes[i], 0xFF);
+}
+
+TEST_F(RecordRingTest, ReadsBackInOrderWithHeaders) {
+    RecordRing ring(fram, BASE, SIZE);
+    ring.begin();
+    ASSERT_TRUE(ring.append("{\"a\":1}", 7, 1, 3));
+    ASSERT_TRUE(ring.append("{\"b\":2}", 7, 2, 1));
+    EXPECT_EQ(ring.getCount(), 2);
+    EXPECT_EQ(ring.getUsed(), 2 * (RecordRing::HEADER_SIZE + 7));
+    RecordRing::Header header;
+    EXPECT_EQ(next(ring, &header), "{\"a\":1}");
+    EXPECT_EQ(header.dataType, 1);
+    EXPECT_EQ(header.destination, 3);
+    EXPECT_EQ(next(ring), "{\"a\":1}"); //Peek again without acknowledge gives the same record
+    ASSERT_TRUE(ring.acknowledge());
+    EXPECT_EQ(next(ring, &header), "{\"b\":2}");
+    EXPECT_EQ(header.sequence, 2u);
+    ASSERT_TRUE(ring.acknowledge());
+    EXPECT_EQ(next(ring), "");
+    EXPECT_FALSE(ring.acknowledge());
+}
+
+TEST_F(RecordRingTest, ResumesAfterResetWithoutResending) {
+    {
+        RecordRing ring(fram, BASE, SIZE);
+        ring.begin();
+        ring.append("one", 3, 1, 3);
+        ring.append("two", 3, 1, 3);
+        ring.append("three", 5, 1, 3);
+        next(ring);
+        ring.acknowledge(); //"one" sent, then the connection drops and the logger resets
+    }
+    RecordRing ring(fram, BASE, SIZE);
+    ASSERT_TRUE(ring.begin());
+    EXPECT_EQ(ring.getCount(), 2);
+    EXPECT_EQ(next(ring), "two");
+    ring.acknowledge();
+    EXPECT_EQ(next(ring), "three");
+    ASSERT_TRUE(ring.append("four", 4, 1, 3)); //Appends continue after recovered records
+    ring.acknowledge();
+    EXPECT_EQ(next(ring), "four");
+}
+
+TEST_F(RecordRingTest, WrapsAroundTheEnd) {
+    RecordRing ring(fram, BASE, SIZE);
+    ring.begin();
+    std::string payload(100, 'x');
+    for (int round = 0; round < 20; round++) { //Far more data than the window holds
+        payload[0] = 'a' + round;
+        ASSERT_TRUE(ring.append(payload.c_str(), payload.length(), 1, 3)) << round;
+        EXPECT_EQ(next(ring), payload);
+        ring.acknowledge();
+    }
+    ring.append(payload.c_str(), payload.length(), 1, 3);
+    RecordRing restored(fram, BASE, SIZE);
+    ASSERT_TRUE(restored.begin());
+    EXPECT_EQ(next(restored), payload);
+}
+
+TEST_F(RecordRingTest, RejectsRecordsThatDoNotFit) {
+    RecordRing ring(fram, BASE, SIZE);
+    ring.begin();
+    std::string payload(200, 'x');
+    EXPECT_TRUE(ring.append(payload.c_str(), payload.length(), 1, 3));
+    EXPECT_TRUE(ring.append(payload.c_str(), payload.length(), 1, 3));
+    EXPECT_FALSE(ring.append(payload.c_str(), payload.length(), 1, 3)); //Unsent records are never overwritten
+    EXPECT_EQ(ring.getCount(), 2);
+    EXPECT_GT(ring.getUtilisation(), 80);
+    EXPECT_LT(ring.getFree(), RecordRing::HEADER_SIZE + payload.length());
+    char small[16];
+    RecordRing::Header header;
+    EXPECT_FALSE(ring.peek(header, small, sizeof(small))); //Buffer too small
+}
+
+TEST_F(RecordRingTest, TornAppendIsDropped) {
+    {
+        RecordRing ring(fram, BASE, SIZE);
+        ring.begin();
+        ring.append("kept", 4, 1, 3);
+        fram.writeBudget = RecordRing::HEADER_SIZE + 3; //Power fails part way through the payload
+        EXPECT_FALSE(ring.append("partial", 7, 1, 3));
+        fram.writeBudget = -1;
+    }
+    RecordRing ring(fram, BASE, SIZE);
+    ASSERT_TRUE(ring.begin());
+    EXPECT_EQ(ring.getCount(), 1);
+    EXPECT_EQ(next(ring), "kept");
+    ring.acknowledge();
+    ASSERT_TRUE(ring.append("after", 5, 1, 3));
+    EXPECT_EQ(next(ring), "after");
+}
+
+TEST_F(RecordRingTest, TornCursorWriteKeepsPreviousCursor) {
+    {
+        RecordRing ring(fram, BASE, SIZE);
+        ring.begin();
+        ring.append("one", 3, 1, 3);
+        ring.append("two", 3, 1, 3);
+        next(ring);
+        fram.writeBudget = 4; //Cursor write torn, the acknowledge is lost
+        EXPECT_FALSE(ring.acknowledge());
+        fram.writeBudget = -1;
+    }
+    RecordRing ring(fram, BASE, SIZE);
+    ASSERT_TRUE(ring.begin());
+    EXPECT_EQ(ring.getCount(), 2); //Resent rather than lost
+    EXPECT_EQ(next(ring), "one");
+}
+
+TEST_F(RecordRingTest, EraseDropsEverything) {
+    RecordRing ring(fram, BASE, SIZE);
+    ring.begin();
+    ring.append("one", 3, 1, 3);
+    ASSERT_TRUE(ring.erase());
+    EXPECT_EQ(ring.getCount(), 0);
+    RecordRing restored(fram, BASE, SIZE);
+    restored.begin();
+    EXPECT_EQ(restored.getCount(), 0);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "configuration/SensorArena.h"
+#include <stdint.h>
+
+namespace {
+    int liveObjects = 0;
+
+    class Small {
+    public:
+        Small(int value) : value(value) { liveObjects++; }
+        virtual ~Small() { liveObjects--; }
+        int value;
+    };
+
+    class Large : public Small {
+    public:
+        Large(int value, double scale) : Small(value), scale(scale) {}
+        double scale;
+        char padding[40];
+    };
+}
+
+class SensorArenaTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        liveObjects = 0;
+    }
+};
+
+TEST_F(SensorArenaTest, ObjectsArePlacedBackToBackInTheArena) {
+    SensorArena arena;
+    size_t bytes = SensorArena::bytesFor<Small>(2) + SensorArena::bytesFor<Large>(1);
+    ASSERT_TRUE(arena.reserve(bytes));
+    Small* first = arena.create<Small>(1);
+    Large* large = arena.create<Large>(2, 0.5);
+    Small* second = arena.create<Small>(3);
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(large, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(large->value, 2);
+    EXPECT_EQ(large->scale, 0.5);
+    EXPECT_EQ(arena.getUsed(), bytes);
+    EXPECT_EQ(arena.getHeapObjects(), 0u);
+    EXPECT_EQ((uintptr_t)large % SensorArena::ALIGNMENT, 0u);
+    EXPECT_EQ((uint8_t*)large - (uint8_t*)first, (ptrdiff_t)SensorArena::bytesFor<Small>(1));
+    EXPECT_EQ(liveObjects, 3);
+}
+
+TEST_F(SensorArenaTest, FullArenaFallsBackToHeap) {
+    SensorArena arena;
+    ASSERT_TRUE(arena.reserve(SensorArena::bytesFor<Small>(1)));
+    Small* inArena = arena.create<Small>(1);
+    Small* onHeap = arena.create<Small>(2);
+    ASSERT_NE(onHeap, nullptr);
+    EXPECT_EQ(onHeap->value, 2);
+    EXPECT_EQ(arena.getHeapObjects(), 1u);
+    EXPECT_EQ(arena.getCount(), 2);
+    arena.destroy(onHeap);
+    arena.destroy(inArena);
+    EXPECT_EQ(liveObjects, 0);
+    EXPECT_EQ(arena.getUsed(), 0u);
+}
+
+TEST_F(SensorArenaTest, DestroyingTheLastObjectReclaimsItsSpace) {
+    SensorArena arena;
+    ASSERT_TRUE(arena.reserve(SensorArena::bytesFor<Small>(3)));
+    Small* first = arena.create<Small>(1);
+    Small* middle = arena.create<Small>(2);
+    Small* last = arena.create<Small>(3);
+    arena.destroy(middle); //Not on top, space stays used
+    EXPECT_EQ(arena.getUsed(), SensorArena::bytesFor<Small>(3));
+    arena.destroy(last); //Gives back its own and the middle slot
+    EXPECT_EQ(arena.getUsed(), SensorArena::bytesFor<Small>(1));
+    Small* again = arena.create<Small>(4);
+    EXPECT_EQ((uint8_t*)again, (uint8_t*)first + SensorArena::bytesFor<Small>(1));
+    EXPECT_EQ(liveObjects, 2);
+}
+
+TEST_F(SensorArenaTest, ClearRunsEveryDestructorAndKeepsTheBlock) {
+    SensorArena arena;
+    ASSERT_TRUE(arena.reserve(SensorArena::bytesFor<Large>(2)));
+    arena.create<Large>(1, 1.0);
+    arena.create<Large>(2, 2.0);
+    arena.create<Large>(3, 3.0); //Heap
+    arena.clear();
+    EXPECT_EQ(liveObjects, 0);
+    EXPECT_EQ(arena.getCount(), 0);
+    EXPECT_EQ(arena.getUsed(), 0u);
+    EXPECT_EQ(arena.getCapacity(), SensorArena::bytesFor<Large>(2));
+}
+
+TEST_F(SensorArenaTest, ReserveRefusedWhileObjectsAreHeld) {
+    SensorArena arena;
+    ASSERT_TRUE(arena.reserve(SensorArena::bytesFor<Small>(1)));
+    arena.create<Small>(1);
+    EXPECT_FALSE(arena.reserve(SensorArena::bytesFor<Small>(4)));
+    arena.clear();
+    EXPECT_TRUE(arena.reserve(SensorArena::bytesFor<Small>(4)));
+    EXPECT_EQ(arena.getCapacity(), SensorArena::bytesFor<Small>(4));
+}
+
+TEST_F(SensorArenaTest, StopsAtMaxObjects) {
+    SensorArena arena;
+    for (int i = 0; i < SensorArena::MAX_OBJECTS; i++) ASSERT_NE(arena.create<Small>(i), nullptr);
+    EXPECT_EQ(arena.create<Small>(0), nullptr);
+    EXPECT_EQ(liveObjects, SensorArena::MAX_OBJECTS);
+}
+
+TEST_F(SensorArenaTest, DestructorReleasesEverything) {
+    {
+        SensorArena arena;
+        arena.reserve(SensorArena::bytesFor<Small>(1));
+        arena.create<Small>(1);
+        arena.create<Large>(2, 2.0);
+    }
+    EXPECT_EQ(liveObjects, 0);
+}
@@ -1,16 +1,18 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "configuration/SensorManager.h"
-#include "MockConfiguration.h"
+#include "configuration/ConfigurationManager.h"
 #include "MockTimeProvider.h"
 #include "MockSDI12Talon.h"
+#include <Sensor.h>
+#include <algorithm>
 
 class SensorManagerTest : public ::testing::Test {
 protected:
-    MockConfiguration mockConfig;
-    SensorManager sensorManager{mockConfig};
-    MockTimeProvider mockTimeProvider;
-    MockSDI12Talon mockSDI12Talon;
+    ConfigurationManager configManager;
+    SensorManager sensorManager{configManager};
+    ::testing::NiceMock<MockTimeProvider> mockTimeProvider;
+    ::testing::NiceMock<MockSDI12Talon> mockSDI12Talon;
     
     void SetUp() override {
         // Apply a known configuration
@@ -46,17 +48,17 @@ TEST_F(SensorManagerTest, InitializeSensors) {
     sensorManager.initializeSensors(mockTimeProvider, mockSDI12Talon);
     
     // Check that talons were created
-    EXPECT_EQ(sensorManager.getAuxTalons().size(), 1);
-    EXPECT_EQ(sensorManager.getI2CTalons().size(), 1);
-    EXPECT_EQ(sensorManager.getSDI12Talons().size(), 1);
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::AUX_TALON), 1);
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::I2C_TALON), 1);
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::SDI12_TALON), 1);
     
     // Check that sensors were created
     auto allSensors = sensorManager.getAllSensors();
     // Expected: 1 ET + 1 Haar + 2 Soil + 1 Solar + 1 CO2 + 1 O2 + 1 Pressure = 8
     EXPECT_EQ(allSensors.size(), 8);
     
-    // Check total sensor count (including 3 core sensors)
-    EXPECT_EQ(sensorManager.getTotalSensorCount(), 11);
+    // Check total sensor count: 3 core sensors, 3 Talons and 8 sensors
+    EXPECT_EQ(sensorManager.getTotalSensorCount(), 14);
 }
 
 // Test clearing all sensors
@@ -68,9 +70,9 @@ TEST_F(SensorManagerTest, ClearAllSensors) {
     sensorManager.clearAllSensors();
     
     // Check that all collections are empty
-    EXPECT_EQ(sensorManager.getAuxTalons().size(), 0);
-    EXPECT_EQ(sensorManager.getI2CTalons().size(), 0);
-    EXPECT_EQ(sensorManager.getSDI12Talons().size(), 0);
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::AUX_TALON), 0);
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::I2C_TALON), 0);
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::SDI12_TALON), 0);
     EXPECT_EQ(sensorManager.getAllSensors().size(), 0);
     EXPECT_EQ(sensorManager.getTotalSensorCount(), 3); // Core sensors still counted
 }
@@ -98,7 +100,7 @@ TEST_F(SensorManagerTest, ConfigurationChanges) {
     sensorManager.initializeSensors(mockTimeProvider, mockSDI12Talon);
     
     // Check initial state
-    EXPECT_EQ(sensorManager.getAuxTalons().size(), 1);
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::AUX_TALON), 1);
     EXPECT_EQ(sensorManager.getAllSensors().size(), 8);
     
     // Change configuration
@@ -130,7 +132,7 @@ TEST_F(SensorManagerTest, ConfigurationChanges) {
     sensorManager.initializeSensors(mockTimeProvider, mockSDI12Talon);
     
     // Check that counts have changed
-    EXPECT_EQ(sensorManager.getAuxTalons().size(), 2);
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::AUX_TALON), 2);
     EXPECT_EQ(sensorManager.getAllSensors().size(), 5); // Only soil sensors now
 }
 
@@ -159,7 +161,7 @@ TEST_F(SensorManagerTest, SensorTalonRelationship) {
     sensorManager.initializeSensors(mockTimeProvider, mockSDI12Talon);
     
     // Check that we have one SDI12 talon and one soil sensor
-    EXPECT_EQ(sensorManager.getSDI12Talons().size(), 1);
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::SDI12_TALON), 1);
     EXPECT_EQ(sensorManager.getAllSensors().size(), 1);
     
     // The soil sensor should be created using the first SDI12 talon
@@ -177,11 +179,74 @@ TEST_F(SensorManagerTest, EmptyConfiguration) {
     sensorManager.initializeSensors(mockTimeProvider, mockSDI12Talon);
     
     // Should fall back to defaults
-    EXPECT_EQ(sensorManager.getAuxTalons().size(), 1);
-    EXPECT_EQ(sensorManager.getI2CTalons().size(), 1);
-    EXPECT_EQ(sensorManager.getSDI12Talons().size(), 1);
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::AUX_TALON), 1);
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::I2C_TALON), 1);
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::SDI12_TALON), 1);
     
     // Default sensor counts from ConfigurationManager
     auto allSensors = sensorManager.getAllSensors();
     EXPECT_EQ(allSensors.size(), 3); // Default 3 soil sensors
-}
\ No newline at end of file
+}
+
+// Test that every object is placed in the arena reserved for the configuration
+TEST_F(SensorManagerTest, ObjectsLiveInTheArena) {
+    sensorManager.initializeSensors(mockTimeProvider, mockSDI12Talon);
+
+    EXPECT_GT(sensorManager.getArenaUsed(), 0u);
+    EXPECT_LE(sensorManager.getArenaUsed(), sensorManager.getArenaCapacity());
+    EXPECT_EQ(sensorManager.getHeapObjects(), 0u);
+}
+
+// Test that resizing keeps the objects already created and adds to the end of a type
+TEST_F(SensorManagerTest, ResizeKeepsExistingObjects) {
+    sensorManager.initializeSensors(mockTimeProvider, mockSDI12Talon);
+    ASSERT_EQ(sensorManager.getCount(SensorTypes::SOIL), 2);
+    std::vector<Sensor*> before = sensorManager.getAllSensors();
+
+    ASSERT_TRUE(configManager.setConfiguration("{\"config\":{\"system\":{\"numAuxTalons\":1,\"numI2CTalons\":1,\"numSDI12Talons\":1},"
+                                               "\"sensors\":{\"numET\":1,\"numHaar\":1,\"numSoil\":3,\"numApogeeSolar\":1,\"numCO2\":1,\"numO2\":1,\"numPressure\":1}}}"));
+    EXPECT_TRUE(sensorManager.resizeSensors(mockTimeProvider, &mockSDI12Talon));
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::SOIL), 3);
+
+    const std::vector<Sensor*>& after = sensorManager.getAllSensors();
+    ASSERT_EQ(after.size(), before.size() + 1);
+    for (Sensor* sensor : before) { // Nothing recreated
+        EXPECT_NE(std::find(after.begin(), after.end(), sensor), after.end());
+    }
+    EXPECT_FALSE(sensorManager.resizeSensors(mockTimeProvider, &mockSDI12Talon)); // Already matches
+}
+
+// Test that growth past the arena reserved at initialization falls back to the heap
+TEST_F(SensorManagerTest, GrowthPastReservationUsesHeap) {
+    sensorManager.initializeSensors(mockTimeProvider, mockSDI12Talon);
+    ASSERT_TRUE(configManager.setConfiguration("{\"config\":{\"system\":{\"numAuxTalons\":1,\"numI2CTalons\":1,\"numSDI12Talons\":1},"
+                                               "\"sensors\":{\"numET\":1,\"numHaar\":1,\"numSoil\":6,\"numApogeeSolar\":1,\"numCO2\":1,\"numO2\":1,\"numPressure\":1}}}"));
+    sensorManager.resizeSensors(mockTimeProvider, &mockSDI12Talon);
+
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::SOIL), 6);
+    EXPECT_GT(sensorManager.getHeapObjects(), 0u);
+}
+
+// Test that sensor counts and sampling periods come from the type registry names
+TEST_F(SensorManagerTest, SamplePeriodsFollowRegistryNames) {
+    ASSERT_TRUE(configManager.setConfiguration("{\"config\":{\"system\":{\"numAuxTalons\":0,\"numI2CTalons\":0,\"numSDI12Talons\":1},"
+                                               "\"sensors\":{\"numSoil\":2,\"numO2\":1,\"periodSoil\":3600,\"periodSoil_2\":60}}}"));
+    sensorManager.initializeSensors(mockTimeProvider, mockSDI12Talon);
+
+    std::vector<unsigned long> periods = sensorManager.getSamplePeriods();
+    ASSERT_EQ(periods.size(), 3u); // Registry order, O2 ahead of Soil
+    EXPECT_EQ(periods[0], 0u);
+    EXPECT_EQ(periods[1], 3600u);
+    EXPECT_EQ(periods[2], 60u);
+}
+
+// Test that SDI-12 sensors are not created without an SDI-12 Talon to reach them through
+TEST_F(SensorManagerTest, SDI12SensorsNeedSDI12Talon) {
+    ASSERT_TRUE(configManager.setConfiguration("{\"config\":{\"system\":{\"numAuxTalons\":0,\"numI2CTalons\":1,\"numSDI12Talons\":0},"
+                                               "\"sensors\":{\"numSoil\":2,\"numHaar\":1}}}"));
+    sensorManager.initializeSensors(mockTimeProvider, mockSDI12Talon);
+
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::SOIL), 0);
+    EXPECT_EQ(sensorManager.getCount(SensorTypes::HAAR), 1);
+    EXPECT_EQ(sensorManager.getSDI12Talon(0), nullptr);
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "acquisition/SensorProfiler.h"
+
+class SensorProfilerTest : public ::testing::Test {
+protected:
+    SensorProfiler profiler;
+};
+
+TEST_F(SensorProfilerTest, EmptyUntilRecorded) {
+    EXPECT_FALSE(profiler.hasSamples(0));
+    EXPECT_EQ(profiler.get(0, SensorProfiler::GET_DATA).count, 0u);
+    EXPECT_EQ(profiler.get(0, SensorProfiler::GET_DATA).getMeanUs(), 0u);
+    EXPECT_EQ(profiler.getSlowestSensor(), -1);
+}
+
+TEST_F(SensorProfilerTest, KeepsMinMeanMax) {
+    profiler.record(2, SensorProfiler::GET_DATA, 3000);
+    profiler.record(2, SensorProfiler::GET_DATA, 1000);
+    profiler.record(2, SensorProfiler::GET_DATA, 2000);
+    const SensorProfiler::Stats& stats = profiler.get(2, SensorProfiler::GET_DATA);
+    EXPECT_EQ(stats.count, 3u);
+    EXPECT_EQ(stats.minUs, 1000u);
+    EXPECT_EQ(stats.maxUs, 3000u);
+    EXPECT_EQ(stats.getMeanUs(), 2000u);
+    EXPECT_TRUE(profiler.hasSamples(2));
+    EXPECT_FALSE(profiler.hasSamples(1));
+}
+
+TEST_F(SensorProfilerTest, ZeroDurationIsAMinimum) {
+    profiler.record(0, SensorProfiler::PORT_DISABLE, 50);
+    profiler.record(0, SensorProfiler::PORT_DISABLE, 0);
+    EXPECT_EQ(profiler.get(0, SensorProfiler::PORT_DISABLE).minUs, 0u);
+}
+
+TEST_F(SensorProfilerTest, LoggerRowSeparateFromSensors) {
+    profiler.record(SensorProfiler::LOGGER, SensorProfiler::FRAM_WRITE, 800);
+    EXPECT_TRUE(profiler.hasSamples(SensorProfiler::LOGGER));
+    EXPECT_EQ(profiler.get(SensorProfiler::LOGGER, SensorProfiler::FRAM_WRITE).maxUs, 800u);
+    EXPECT_EQ(profiler.getSlowestSensor(), -1);
+}
+
+TEST_F(SensorProfilerTest, IgnoresSensorsOutOfRange) {
+    profiler.record(SensorProfiler::MAX_SENSORS, SensorProfiler::GET_DATA, 100);
+    profiler.record(-2, SensorProfiler::GET_DATA, 100);
+    EXPECT_FALSE(profiler.hasSamples(SensorProfiler::MAX_SENSORS));
+    EXPECT_EQ(profiler.get(SensorProfiler::MAX_SENSORS, SensorProfiler::GET_DATA).count, 0u);
+    EXPECT_FALSE(profiler.hasSamples(SensorProfiler::LOGGER));
+}
+
+TEST_F(SensorProfilerTest, TotalSaturates) {
+    profiler.record(1, SensorProfiler::GET_DATA, UINT32_MAX - 10);
+    profiler.record(1, SensorProfiler::GET_DATA, 100);
+    EXPECT_EQ(profiler.get(1, SensorProfiler::GET_DATA).totalUs, UINT32_MAX);
+}
+
+TEST_F(SensorProfilerTest, SlowestSensorByMeanTotal) {
+    profiler.record(0, SensorProfiler::SENSOR_TOTAL, 5000);
+    profiler.record(3, SensorProfiler::SENSOR_TOTAL, 90000); //One slow read
+    profiler.record(3, SensorProfiler::SENSOR_TOTAL, 10000);
+    profiler.record(4, SensorProfiler::SENSOR_TOTAL, 40000);
+    EXPECT_EQ(profiler.getSlowestSensor(), 3);
+}
+
+TEST_F(SensorProfilerTest, ResetClears) {
+    profiler.record(0, SensorProfiler::GET_DATA, 100);
+    profiler.reset();
+    EXPECT_FALSE(profiler.hasSamples(0));
+}
+
+TEST_F(SensorProfilerTest, StageNames) {
+    EXPECT_STREQ(SensorProfiler::stageName(SensorProfiler::PORT_ENABLE), "Enable");
+    EXPECT_STREQ(SensorProfiler::stageName(SensorProfiler::FRAM_WRITE), "FRAMWrite");
+    EXPECT_STREQ(SensorProfiler::stageName(SensorProfiler::NUM_STAGES), "Unknown");
+}
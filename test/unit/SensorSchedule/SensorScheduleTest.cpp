@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include "acquisition/SensorSchedule.h"
+
+namespace {
+
+const unsigned long LOG = 300000; //5 minute log period
+
+} // namespace
+
+class SensorScheduleTest : public ::testing::Test {
+protected:
+    SensorScheduleTest() {
+        schedule.configure({0, LOG * 12, LOG * 3}, LOG / 2, 0); //Every log, hourly, every third log
+    }
+
+    SensorSchedule schedule;
+};
+
+TEST_F(SensorScheduleTest, EverySensorDueOnFirstPass) {
+    for (uint16_t i = 0; i < 3; i++) EXPECT_TRUE(schedule.take(i, 0));
+    EXPECT_EQ(schedule.getSkipped(), 0);
+}
+
+TEST_F(SensorScheduleTest, SlowSensorReadOncePerPeriod) {
+    unsigned long reads[3] = {0, 0, 0};
+    for (unsigned long log = 0; log < 24; log++) {
+        unsigned long now = log * LOG + (log % 3) * 7000; //Logs land a few seconds either side of the grid
+        for (uint16_t i = 0; i < 3; i++) {
+            if (schedule.take(i, now)) reads[i]++;
+        }
+    }
+    EXPECT_EQ(reads[0], 24u);
+    EXPECT_EQ(reads[1], 2u);
+    EXPECT_EQ(reads[2], 8u);
+    EXPECT_EQ(schedule.getSkipped(), 22 + 16);
+}
+
+TEST_F(SensorScheduleTest, EarlyLogWithinToleranceStillReads) {
+    schedule.take(1, 0);
+    EXPECT_FALSE(schedule.isDue(1, LOG * 12 - LOG / 2 - 1));
+    EXPECT_TRUE(schedule.take(1, LOG * 12 - 10000)); //Log a little before the deadline
+    EXPECT_FALSE(schedule.isDue(1, LOG * 13)); //Next deadline stays on the grid
+    EXPECT_TRUE(schedule.isDue(1, LOG * 24));
+}
+
+TEST_F(SensorScheduleTest, UnconfiguredIndexAlwaysDue) {
+    EXPECT_TRUE(schedule.take(10, 12345));
+    schedule.resetCounters();
+    schedule.take(1, 0);
+    EXPECT_FALSE(schedule.take(1, LOG));
+    EXPECT_EQ(schedule.getSkipped(), 1);
+}
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include "acquisition/TalonPortIndex.h"
+
+class TalonPortIndexTest : public ::testing::Test {
+protected:
+    TalonPortIndex index;
+};
+
+TEST_F(TalonPortIndexTest, EmptyReturnsNotFound) {
+    for (int port = 0; port <= TalonPortIndex::MAX_PORTS; port++) {
+        EXPECT_EQ(index.indexOf(port), -1);
+    }
+}
+
+TEST_F(TalonPortIndexTest, FindsAssignedTalons) {
+    index.assign(3, 0); //SDI-12 Talon
+    index.assign(1, 1); //Aux Talon
+    EXPECT_EQ(index.indexOf(3), 0);
+    EXPECT_EQ(index.indexOf(1), 1);
+    EXPECT_EQ(index.indexOf(2), -1);
+}
+
+TEST_F(TalonPortIndexTest, FirstTalonOnPortWins) {
+    index.assign(0, 2); //Two undetected Talons
+    index.assign(0, 4);
+    EXPECT_EQ(index.indexOf(0), 2);
+}
+
+TEST_F(TalonPortIndexTest, OutOfRangePortsNotFound) {
+    index.assign(TalonPortIndex::MAX_PORTS + 1, 0);
+    EXPECT_EQ(index.indexOf(TalonPortIndex::MAX_PORTS + 1), -1);
+    EXPECT_EQ(index.indexOf(-1), -1);
+}
+
+TEST_F(TalonPortIndexTest, ClearForgetsAssignments) {
+    index.assign(2, 0);
+    index.clear();
+    EXPECT_EQ(index.indexOf(2), -1);
+    index.assign(2, 1); //Rebuilt after ports changed
+    EXPECT_EQ(index.indexOf(2), 1);
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "acquisition/TalonRestartTracker.h"
+
+class TalonRestartTrackerTest : public ::testing::Test {
+protected:
+    TalonRestartTracker tracker;
+};
+
+TEST_F(TalonRestartTrackerTest, StartsInvalid) {
+    EXPECT_TRUE(tracker.needsRestart(1));
+    EXPECT_EQ(tracker.getRestartsSkipped(), 0);
+}
+
+TEST_F(TalonRestartTrackerTest, RestartsOncePerCycle) {
+    tracker.beginCycle();
+    ASSERT_TRUE(tracker.needsRestart(2)); //Wake
+    tracker.recordRestart(2, 120);
+    for (int i = 0; i < 3; i++) { //Three TDR315H probes on the same Talon
+        EXPECT_FALSE(tracker.needsRestart(2));
+    }
+    EXPECT_EQ(tracker.getRestarts(), 1);
+    EXPECT_EQ(tracker.getRestartsSkipped(), 3);
+    EXPECT_EQ(tracker.getTimeSavedMs(), 360u);
+}
+
+TEST_F(TalonRestartTrackerTest, NewCycleInvalidatesAndResetsCounters) {
+    tracker.recordRestart(1, 50);
+    EXPECT_FALSE(tracker.needsRestart(1));
+    tracker.beginCycle();
+    EXPECT_EQ(tracker.getRestartsSkipped(), 0);
+    EXPECT_EQ(tracker.getTimeSavedMs(), 0u);
+    EXPECT_TRUE(tracker.needsRestart(1));
+}
+
+TEST_F(TalonRestartTrackerTest, InvalidateForcesRestart) {
+    tracker.recordRestart(3, 50);
+    tracker.invalidate(3); //Power cycled or fault reported
+    EXPECT_TRUE(tracker.needsRestart(3));
+    EXPECT_FALSE(tracker.isValid(3));
+}
+
+TEST_F(TalonRestartTrackerTest, PortsAreIndependent) {
+    tracker.recordRestart(1, 50);
+    EXPECT_FALSE(tracker.needsRestart(1));
+    EXPECT_TRUE(tracker.needsRestart(2));
+}
+
+TEST_F(TalonRestartTrackerTest, UntrackedPortsAlwaysRestart) {
+    tracker.recordRestart(0, 50);
+    tracker.recordRestart(TalonRestartTracker::MAX_PORTS + 1, 50);
+    EXPECT_TRUE(tracker.needsRestart(0));
+    EXPECT_TRUE(tracker.needsRestart(TalonRestartTracker::MAX_PORTS + 1));
+    EXPECT_EQ(tracker.getRestarts(), 2);
+}
+
+TEST_F(TalonRestartTrackerTest, HeldPortDefersRestartUntilReleased) {
+    tracker.recordRestart(2, 50);
+    tracker.hold(2); //SDI-12 measurements running on this Talon
+    tracker.invalidate(2); //Fault reported mid pass
+    EXPECT_FALSE(tracker.needsRestart(2));
+    EXPECT_EQ(tracker.getRestartsSkipped(), 0); //Deferred, not saved
+    EXPECT_TRUE(tracker.needsRestart(1)); //Other ports unaffected
+    tracker.releaseAll();
+    EXPECT_FALSE(tracker.isHeld(2));
+    EXPECT_TRUE(tracker.needsRestart(2));
+}
+
+TEST_F(TalonRestartTrackerTest, NewCycleReleasesHeldPorts) {
+    tracker.hold(1);
+    tracker.beginCycle();
+    EXPECT_FALSE(tracker.isHeld(1));
+    EXPECT_TRUE(tracker.needsRestart(1));
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "acquisition/TaskScheduler.h"
+#include "simulator/VirtualClock.h"
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+
+enum { SAMPLE, DIAGNOSTIC, METADATA, BACKHAUL, TIME_SYNC, LOCATION };
+
+const unsigned long MINUTE = 60000UL;
+const unsigned long WEEK = 7UL * 24 * 60 * MINUTE;
+
+} // namespace
+
+class TaskSchedulerTest : public ::testing::Test {
+protected:
+    TaskScheduler scheduler;
+};
+
+TEST_F(TaskSchedulerTest, NothingDueBeforeFirstPeriod) {
+    scheduler.setTask(SAMPLE, 300000, 0, 1000);
+    EXPECT_EQ(scheduler.takeNext(300999), -1);
+    EXPECT_EQ(scheduler.timeUntilNext(1000), 300000u);
+    EXPECT_EQ(scheduler.takeNext(301000), SAMPLE);
+    EXPECT_EQ(scheduler.timeUntilNext(301000), 300000u);
+}
+
+TEST_F(TaskSchedulerTest, HighestPriorityFirst) {
+    scheduler.setTask(BACKHAUL, 1000, 2, 0);
+    scheduler.setTask(SAMPLE, 1000, 0, 0);
+    scheduler.setTask(DIAGNOSTIC, 1000, 1, 0);
+    EXPECT_EQ(scheduler.takeNext(1000), SAMPLE);
+    EXPECT_EQ(scheduler.takeNext(1000), DIAGNOSTIC);
+    EXPECT_EQ(scheduler.takeNext(1000), BACKHAUL);
+    EXPECT_EQ(scheduler.takeNext(1000), -1);
+}
+
+TEST_F(TaskSchedulerTest, TakeFoldsADueTaskIntoAnother) {
+    scheduler.setTask(SAMPLE, 1000, 0, 0);
+    scheduler.setTask(METADATA, 4000, 1, 0);
+    for (unsigned long t = 1000; t < 4000; t += 1000) {
+        EXPECT_EQ(scheduler.takeNext(t), SAMPLE);
+        EXPECT_FALSE(scheduler.take(METADATA, t));
+    }
+    EXPECT_EQ(scheduler.takeNext(4000), SAMPLE);
+    EXPECT_TRUE(scheduler.take(METADATA, 4000));
+    EXPECT_EQ(scheduler.takeNext(4000), -1);
+}
+
+TEST_F(TaskSchedulerTest, DisabledTaskNeverRuns) {
+    scheduler.setTask(DIAGNOSTIC, 0, 1, 0);
+    EXPECT_FALSE(scheduler.isEnabled(DIAGNOSTIC));
+    EXPECT_EQ(scheduler.takeNext(WEEK), -1);
+    EXPECT_EQ(scheduler.timeUntilNext(0), 0xFFFFFFFFUL);
+}
+
+TEST_F(TaskSchedulerTest, SamePeriodKeepsPhase) {
+    scheduler.setTask(SAMPLE, 300000, 0, 0);
+    scheduler.setTask(SAMPLE, 300000, 0, 200000); //Configuration reloaded mid period
+    EXPECT_EQ(scheduler.takeNext(300000), SAMPLE);
+    scheduler.setTask(SAMPLE, 60000, 0, 310000); //New period starts from now
+    EXPECT_EQ(scheduler.timeUntilNext(310000), 60000u);
+}
+
+TEST_F(TaskSchedulerTest, LateRunDoesNotShiftTheGrid) {
+    scheduler.setTask(SAMPLE, 300000, 0, 0);
+    EXPECT_EQ(scheduler.takeNext(300000 + 4000), SAMPLE);
+    EXPECT_EQ(scheduler.timeUntilNext(304000), 296000u);
+    EXPECT_EQ(scheduler.getMaxLateMs(SAMPLE), 4000u);
+}
+
+TEST_F(TaskSchedulerTest, StallSkipsMissedPeriodsOnce) {
+    scheduler.setTask(SAMPLE, 300000, 0, 0);
+    EXPECT_EQ(scheduler.takeNext(300000 * 4 + 1000), SAMPLE); //Due at 1, 2, 3 and 4 periods
+    EXPECT_EQ(scheduler.takeNext(300000 * 4 + 1000), -1);
+    EXPECT_EQ(scheduler.getMissed(SAMPLE), 3u);
+    EXPECT_EQ(scheduler.timeUntilNext(300000 * 4 + 1000), 299000u);
+}
+
+TEST_F(TaskSchedulerTest, SurvivesMillisRollover) {
+    unsigned long start = (unsigned long)0 - 150000;
+    scheduler.setTask(SAMPLE, 300000, 0, start);
+    EXPECT_EQ(scheduler.takeNext(start + 299999), -1);
+    EXPECT_EQ(scheduler.takeNext(start + 300000), SAMPLE);
+    EXPECT_EQ(scheduler.timeUntilNext(start + 300000), 300000u);
+}
+
+/*
+ * A week of the firmware schedule on the virtual clock. Each wake up is set
+ * by a whole second RTC alarm, arrives up to 250 ms late and the work takes up
+ * to 20 s, as loop() does. Every deadline must still be met once, on its grid.
+ */
+TEST_F(TaskSchedulerTest, WeekOfSimulatedScheduleStaysOnTheGrid) {
+    VirtualClock& clock = VirtualClock::instance();
+    clock.reset();
+    clock.setReadTick(0);
+    srand(42);
+
+    unsigned long start = clock.peekMillis();
+    scheduler.setTask(SAMPLE, 5 * MINUTE, 0, start);
+    scheduler.setTask(DIAGNOSTIC, 40 * MINUTE, 1, start);
+    scheduler.setTask(METADATA, 80 * MINUTE, 2, start);
+    scheduler.setTask(BACKHAUL, 20 * MINUTE, 3, start);
+    scheduler.setTask(TIME_SYNC, 60 * MINUTE, 4, start);
+    scheduler.setTask(LOCATION, 360 * MINUTE, 5, start);
+
+    std::vector<unsigned long> sampleTimes;
+    unsigned long wakes = 0;
+    while (clock.peekMillis() - start < WEEK) {
+        unsigned long wait = scheduler.timeUntilNext(clock.peekMillis());
+        clock.advance(((wait + 999) / 1000) * 1000 + rand() % 250); //Sleep on the RTC alarm
+        wakes++;
+        int task;
+        while ((task = scheduler.takeNext(clock.peekMillis())) >= 0) {
+            if (task == SAMPLE) {
+                sampleTimes.push_back(clock.peekMillis() - start);
+                scheduler.take(DIAGNOSTIC, clock.peekMillis());
+                scheduler.take(METADATA, clock.peekMillis());
+            }
+            clock.advance(rand() % 20000);
+        }
+    }
+    clock.setReadTick(1);
+
+    ASSERT_EQ(sampleTimes.size(), (size_t)(WEEK / (5 * MINUTE)));
+    for (size_t i = 0; i < sampleTimes.size(); i++) {
+        unsigned long deadline = (i + 1) * 5 * MINUTE;
+        ASSERT_GE(sampleTimes[i], deadline);
+        ASSERT_LT(sampleTimes[i] - deadline, 1250u) << "sample " << i;
+    }
+    for (uint8_t id = SAMPLE; id <= LOCATION; id++) {
+        EXPECT_EQ(scheduler.getMissed(id), 0u);
+        EXPECT_EQ(scheduler.getRuns(id), WEEK / scheduler.getPeriod(id));
+    }
+    EXPECT_EQ(wakes, (unsigned long)sampleTimes.size()); //Every other deadline falls on a sample, no extra wake ups
+}
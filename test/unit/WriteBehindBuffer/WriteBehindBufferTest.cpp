@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "telemetry/WriteBehindBuffer.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Written {
+    std::string block;
+    uint8_t dataType;
+};
+
+std::vector<Written> written;
+
+void capture(const char* block, size_t len, uint8_t dataType)
+{
+    EXPECT_EQ(strlen(block), len);
+    written.push_back({std::string(block, len), dataType});
+}
+
+std::string line(char fill, size_t len)
+{
+    return "{\"v\":\"" + std::string(len - 8, fill) + "\"}";
+}
+
+} // namespace
+
+class WriteBehindBufferTest : public ::testing::Test {
+protected:
+    WriteBehindBufferTest() : buffer(arena, sizeof(arena), capture) {
+        written.clear();
+        buffer.configure(60000);
+    }
+
+    void add(const std::string& record, uint8_t dataType, unsigned long now = 0) {
+        buffer.add(record.c_str(), record.length(), dataType, now);
+    }
+
+    char arena[4 * 1536];
+    WriteBehindBuffer buffer;
+};
+
+TEST_F(WriteBehindBufferTest, DisabledWritesEachRecord) {
+    buffer.configure(0);
+    add("{\"a\":1}\n{\"a\":2}", 1);
+    ASSERT_EQ(written.size(), 1u);
+    EXPECT_EQ(written[0].block, "{\"a\":1}\n{\"a\":2}");
+    EXPECT_EQ(buffer.getLineCount(), 2u);
+    EXPECT_EQ(buffer.getWriteCount(), 1u);
+}
+
+TEST_F(WriteBehindBufferTest, HoldsLinesUntilABlockIsFull) {
+    std::string l = line('a', 100); //100 bytes plus newline
+    for (int i = 0; i < 5; i++) add(l, 1);
+    EXPECT_TRUE(written.empty()); //505 bytes, short of a block
+    add(l, 1);
+    ASSERT_EQ(written.size(), 1u);
+    EXPECT_EQ(written[0].block.length(), 5 * 101 - 1u); //Whole lines up to the block boundary
+    EXPECT_EQ(buffer.getBuffered(), 101u); //Sixth line waits for the next block
+}
+
+TEST_F(WriteBehindBufferTest, WritesWholeBlocksWhenLinesLineUp) {
+    std::string l = line('a', 127); //128 bytes with newline, four make one block
+    for (int i = 0; i < 4; i++) add(l, 1);
+    ASSERT_EQ(written.size(), 1u);
+    EXPECT_EQ(written[0].block.length() + 1, (size_t)WriteBehindBuffer::BLOCK_SIZE);
+    EXPECT_EQ(buffer.getBuffered(), 0u);
+}
+
+TEST_F(WriteBehindBufferTest, KeepsTypesApart) {
+    add("{\"d\":1}", 1);
+    add("{\"g\":1}", 2);
+    add("{\"d\":2}", 1);
+    buffer.flush();
+    ASSERT_EQ(written.size(), 2u);
+    EXPECT_EQ(written[0].block, "{\"d\":1}\n{\"d\":2}");
+    EXPECT_EQ(written[0].dataType, 1);
+    EXPECT_EQ(written[1].block, "{\"g\":1}");
+    EXPECT_FLOAT_EQ(buffer.getLinesPerWrite(), 1.5f);
+}
+
+TEST_F(WriteBehindBufferTest, DeadlineWritesPartialBlock) {
+    add("{\"a\":1}", 1, 1000);
+    buffer.poll(60999);
+    EXPECT_TRUE(written.empty());
+    buffer.poll(61000);
+    ASSERT_EQ(written.size(), 1u);
+    EXPECT_EQ(written[0].block, "{\"a\":1}");
+    EXPECT_EQ(buffer.getBuffered(), 0u);
+}
+
+TEST_F(WriteBehindBufferTest, LongLinesPassThrough) {
+    add("{\"a\":1}", 1);
+    std::string big = line('x', 2000);
+    add(big, 1);
+    ASSERT_EQ(written.size(), 2u);
+    EXPECT_EQ(written[0].block, "{\"a\":1}"); //Order kept
+    EXPECT_EQ(written[1].block, big);
+}
+
+TEST_F(WriteBehindBufferTest, LinesCrossingABlockWaitForTheNextBoundary) {
+    std::string l = line('a', 700);
+    add(l, 1);
+    EXPECT_TRUE(written.empty()); //No whole line ends within the first block
+    add(l, 1);
+    ASSERT_EQ(written.size(), 1u); //First line ends within two blocks
+    EXPECT_EQ(written[0].block, l);
+    add(l, 1);
+    buffer.flush();
+    size_t total = 0;
+    for (const Written& w : written) total += w.block.length() + 1;
+    EXPECT_EQ(total, 3 * 701u);
+}